@@ -0,0 +1,137 @@
+// GPU 实例剔除: 视锥 + 上一帧深度金字塔 (Hi-Z) 遮挡测试, 每线程一个实例
+// 可见实例累加所属实例化命令的 instanceCount, 并把自身下标写入该命令的实例索引区间
+// 缓冲区全部经 bindless 存储缓冲区数组访问, 索引由 push constant 给出
+
+struct CullConstants {
+    uint instanceCount;
+    uint instanceStride; // 实例记录字节跨度, world 矩阵 (列主序) 位于记录开头
+    uint boundsBuffer;   // 每实例 32 字节: min, 所属命令下标, max
+    uint instanceBuffer;
+    uint inputCommands;
+    uint outputCommands; // 已由输入命令拷贝, instanceCount 为 0
+    uint instanceIndices;
+    uint countBuffer;
+    uint viewBuffer;
+    uint pyramidTexture;
+};
+
+[[vk::push_constant]]
+ConstantBuffer<CullConstants> pc;
+
+[[vk::binding(1, 0)]]
+Texture2D textures[];
+
+[[vk::binding(2, 0)]]
+RWByteAddressBuffer buffers[];
+
+// viewBuffer 布局
+static const uint VIEW_PLANES = 0;           // float4 x 6
+static const uint VIEW_OCCLUSION_MATRIX = 96; // float4x4 列主序, 构建金字塔时的 viewProj
+static const uint VIEW_DEPTH_SIZE = 160;     // float2 深度图尺寸
+static const uint VIEW_PYRAMID_MIPS = 168;
+static const uint VIEW_FLAGS = 172;          // bit0: 金字塔有效
+
+// countBuffer 布局
+static const uint COUNT_VISIBLE = 0;
+static const uint COUNT_FRUSTUM_CULLED = 8;
+static const uint COUNT_OCCLUSION_CULLED = 12;
+
+static const uint COMMAND_SIZE = 20;
+
+float4 loadFloat4(uint buffer, uint offset) {
+    return asfloat(buffers[buffer].Load4(offset));
+}
+
+float4 transformPoint(float4 c0, float4 c1, float4 c2, float4 c3, float3 p) {
+    return c0 * p.x + c1 * p.y + c2 * p.z + c3;
+}
+
+float pyramidDepth(int2 texel, uint level) {
+    return textures[pc.pyramidTexture].Load(int3(texel, level)).r;
+}
+
+bool isOccluded(float3 worldMin, float3 worldMax) {
+    uint view = pc.viewBuffer;
+    if ((buffers[view].Load(VIEW_FLAGS) & 1) == 0) return false;
+
+    float4 m0 = loadFloat4(view, VIEW_OCCLUSION_MATRIX);
+    float4 m1 = loadFloat4(view, VIEW_OCCLUSION_MATRIX + 16);
+    float4 m2 = loadFloat4(view, VIEW_OCCLUSION_MATRIX + 32);
+    float4 m3 = loadFloat4(view, VIEW_OCCLUSION_MATRIX + 48);
+
+    float2 uvMin = float2(1.0, 1.0);
+    float2 uvMax = float2(0.0, 0.0);
+    float nearestDepth = 1.0;
+    for (uint i = 0; i < 8; ++i) {
+        float3 corner = float3((i & 1) ? worldMax.x : worldMin.x, (i & 2) ? worldMax.y : worldMin.y, (i & 4) ? worldMax.z : worldMin.z);
+        float4 clip = transformPoint(m0, m1, m2, m3, corner);
+        // 跨越近平面的包围盒无法可靠投影, 视为可见
+        if (clip.w <= 1e-5) return false;
+        float3 ndc = clip.xyz / clip.w;
+        // 主 pass 视口 Y 翻转: 图像行 = (1 - ndc.y) / 2
+        float2 uv = float2(ndc.x * 0.5 + 0.5, 0.5 - ndc.y * 0.5);
+        uvMin = min(uvMin, uv);
+        uvMax = max(uvMax, uv);
+        nearestDepth = min(nearestDepth, ndc.z);
+    }
+    uvMin = saturate(uvMin);
+    uvMax = saturate(uvMax);
+
+    float2 depthSize = asfloat(buffers[view].Load2(VIEW_DEPTH_SIZE));
+    uint mips = buffers[view].Load(VIEW_PYRAMID_MIPS);
+    float2 pixelMin = uvMin * depthSize;
+    float2 pixelMax = uvMax * depthSize;
+    float extent = max(max(pixelMax.x - pixelMin.x, pixelMax.y - pixelMin.y), 1.0);
+    // 金字塔第 L 级的一个纹素覆盖 2^(L+1) 个深度像素, 选使矩形最多跨 2x2 纹素的级别
+    uint level = (uint)max(ceil(log2(extent)) - 1.0, 0.0);
+    if (level >= mips) return false;
+
+    float texelSpan = (float)(2u << level);
+    int2 texelMin = int2(pixelMin / texelSpan);
+    int2 texelMax = int2(min(pixelMax, depthSize - 1.0) / texelSpan);
+    float farthest = max(max(pyramidDepth(int2(texelMin.x, texelMin.y), level), pyramidDepth(int2(texelMax.x, texelMin.y), level)),
+                         max(pyramidDepth(int2(texelMin.x, texelMax.y), level), pyramidDepth(int2(texelMax.x, texelMax.y), level)));
+    return nearestDepth > farthest;
+}
+
+[numthreads(64, 1, 1)]
+void CSMain(uint3 dispatchId : SV_DispatchThreadID) {
+    uint index = dispatchId.x;
+    if (index >= pc.instanceCount) return;
+
+    // 局部包围盒 (已换算到顶点所在空间); min > max 表示无包围盒, 始终可见
+    float4 boundsMin = loadFloat4(pc.boundsBuffer, index * 32);
+    float3 localMin = boundsMin.xyz;
+    float3 localMax = loadFloat4(pc.boundsBuffer, index * 32 + 16).xyz;
+    uint batch = asuint(boundsMin.w);
+    bool visible = true;
+    if (all(localMin <= localMax)) {
+        uint base = index * pc.instanceStride;
+        float4 c0 = loadFloat4(pc.instanceBuffer, base);
+        float4 c1 = loadFloat4(pc.instanceBuffer, base + 16);
+        float4 c2 = loadFloat4(pc.instanceBuffer, base + 32);
+        float4 c3 = loadFloat4(pc.instanceBuffer, base + 48);
+
+        float3 center = transformPoint(c0, c1, c2, c3, (localMin + localMax) * 0.5).xyz;
+        float3 halfExtent = (localMax - localMin) * 0.5;
+        float3 worldExtent = abs(c0.xyz) * halfExtent.x + abs(c1.xyz) * halfExtent.y + abs(c2.xyz) * halfExtent.z;
+
+        for (uint p = 0; p < 6 && visible; ++p) {
+            float4 plane = loadFloat4(pc.viewBuffer, VIEW_PLANES + p * 16);
+            visible = dot(plane.xyz, center) + plane.w + dot(abs(plane.xyz), worldExtent) >= 0.0;
+        }
+        if (!visible) {
+            buffers[pc.countBuffer].InterlockedAdd(COUNT_FRUSTUM_CULLED, 1);
+        } else if (isOccluded(center - worldExtent, center + worldExtent)) {
+            visible = false;
+            buffers[pc.countBuffer].InterlockedAdd(COUNT_OCCLUSION_CULLED, 1);
+        }
+    }
+
+    if (!visible) return;
+    buffers[pc.countBuffer].InterlockedAdd(COUNT_VISIBLE, 1);
+    uint slot;
+    buffers[pc.outputCommands].InterlockedAdd(batch * COMMAND_SIZE + 4, 1, slot);
+    uint firstInstance = buffers[pc.inputCommands].Load(batch * COMMAND_SIZE + 16);
+    buffers[pc.instanceIndices].Store((firstInstance + slot) * 4, index);
+}
@@ -0,0 +1,30 @@
+// 深度金字塔 (Hi-Z) 构建: 每个输出纹素取源图对应 2x2 区域的最远深度 (max, 深度范围 [0,1], eLess)
+// 第 0 级由深度缓冲构建, 尺寸为深度图的一半 (向上取整); 之后每级由上一级构建
+
+struct PyramidConstants {
+    uint2 sourceSize;
+    uint2 destinationSize;
+};
+
+[[vk::push_constant]]
+ConstantBuffer<PyramidConstants> pc;
+
+[[vk::binding(0, 0)]]
+Texture2D source;
+
+[[vk::binding(1, 0)]] [[vk::image_format("r32f")]]
+RWTexture2D<float> destination;
+
+[numthreads(8, 8, 1)]
+void CSMain(uint3 dispatchId : SV_DispatchThreadID) {
+    if (any(dispatchId.xy >= pc.destinationSize)) return;
+
+    // 源尺寸为奇数时最后一个纹素与边缘重复采样, 钳制到源图范围内
+    int2 base = int2(dispatchId.xy * 2);
+    int2 last = int2(pc.sourceSize) - 1;
+    float d0 = source.Load(int3(min(base, last), 0)).r;
+    float d1 = source.Load(int3(min(base + int2(1, 0), last), 0)).r;
+    float d2 = source.Load(int3(min(base + int2(0, 1), last), 0)).r;
+    float d3 = source.Load(int3(min(base + int2(1, 1), last), 0)).r;
+    destination[dispatchId.xy] = max(max(d0, d1), max(d2, d3));
+}
@@ -1,7 +1,14 @@
 struct VSInput {
+#ifdef NX_COMPACT_VERTEX
+    // 16 字节压缩顶点: 位置为网格 AABB 内的 unorm16 (反量化已并入实例的 world), 法线为八面体编码
+    [[vk::location(0)]] float4 Pos : POSITION;
+    [[vk::location(1)]] float2 UV : TEXCOORD0;
+    [[vk::location(2)]] float2 Normal : NORMAL;
+#else
     [[vk::location(0)]] float3 Pos : POSITION;
     [[vk::location(1)]] float2 UV : TEXCOORD0;
     [[vk::location(2)]] float3 Normal : NORMAL;
+#endif
 };
 
 struct PSInput {
@@ -9,27 +16,26 @@ struct PSInput {
     [[vk::location(0)]] float3 WorldPos : POSITION0;
     [[vk::location(1)]] float3 Normal : NORMAL0;
     [[vk::location(2)]] float2 UV : TEXCOORD0;
+    [[vk::location(3)]] nointerpolation uint Instance : INSTANCE0;
 };
 
-struct BindlessConstants {
+// 每个实例一条记录, 经 instanceIndices 间接索引
+struct InstanceData {
+    float4x4 world; // 已并入网格反量化
+    float4 albedoFactor;
+    float4 highlightColor; // a > 0 表示选中
     uint textureIndex;
-    uint normalIndex;
-    uint metallicRoughnessIndex;
-    uint occlusionIndex;
-    uint emissiveIndex;
     uint samplerIndex;
-
-    float4 albedoFactor;
     float metallicFactor;
     float roughnessFactor;
-    float2 padding;
+};
 
-    float4x4 mvp;
-    float4 highlightColor;
+struct FrameConstants {
+    float4x4 viewProj;
 };
 
 [[vk::push_constant]]
-ConstantBuffer<BindlessConstants> constants;
+ConstantBuffer<FrameConstants> constants;
 
 [[vk::binding(0, 0)]]
 SamplerState samplers[];
@@ -37,17 +43,44 @@ SamplerState samplers[];
 [[vk::binding(1, 0)]]
 Texture2D textures[];
 
-PSInput VSMain(VSInput input) {
+[[vk::binding(0, 1)]]
+StructuredBuffer<InstanceData> instances;
+
+// 实例化命令的第 i 个实例 -> 实例记录; GPU 剔除只写入可见实例, 未剔除时为恒等映射
+[[vk::binding(1, 1)]]
+StructuredBuffer<uint> instanceIndices;
+
+float3 OctDecode(float2 e) {
+    float3 n = float3(e.x, e.y, 1.0 - abs(e.x) - abs(e.y));
+    float t = saturate(-n.z);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+PSInput VSMain(VSInput input, uint instanceIndex : SV_InstanceID) {
     PSInput output;
-    output.Pos = float4(input.Pos, 1.0) * constants.mvp;
-    output.WorldPos = input.Pos;
-    output.Normal = input.Normal;
+#ifdef NX_COMPACT_VERTEX
+    float3 pos = input.Pos.xyz;
+    float3 normal = OctDecode(input.Normal);
+#else
+    float3 pos = input.Pos;
+    float3 normal = input.Normal;
+#endif
+    // SV_InstanceID 对应 InstanceIndex, 已包含 firstInstance
+    uint instance = instanceIndices[instanceIndex];
+    float4 worldPos = float4(pos, 1.0) * instances[instance].world;
+    output.Pos = worldPos * constants.viewProj;
+    output.WorldPos = worldPos.xyz;
+    output.Normal = normal;
     output.UV = input.UV;
+    output.Instance = instance;
     return output;
 }
 
 float4 PSMain(PSInput input) : SV_TARGET {
-    float4 albedo = textures[constants.textureIndex].Sample(samplers[constants.samplerIndex], input.UV) * constants.albedoFactor;
+    InstanceData instance = instances[input.Instance];
+    float4 albedo = textures[instance.textureIndex].Sample(samplers[instance.samplerIndex], input.UV) * instance.albedoFactor;
 
     float3 lightDir = normalize(float3(1.0, 1.0, 1.0));
     float3 viewDir = normalize(float3(0.0, 0.0, 1.0));
@@ -56,14 +89,14 @@ float4 PSMain(PSInput input) : SV_TARGET {
     float3 N = normalize(input.Normal);
     float diff = max(dot(N, lightDir), 0.0);
 
-    float spec = pow(max(dot(N, halfDir), 0.0), 32.0) * constants.metallicFactor;
+    float spec = pow(max(dot(N, halfDir), 0.0), 32.0) * instance.metallicFactor;
 
     float ambient = 0.2;
     float3 finalColor = albedo.rgb * (diff + ambient) + spec;
 
     // 选中高亮混合
-    if (constants.highlightColor.a > 0.0) {
-        finalColor = lerp(finalColor, constants.highlightColor.rgb, constants.highlightColor.a);
+    if (instance.highlightColor.a > 0.0) {
+        finalColor = lerp(finalColor, instance.highlightColor.rgb, instance.highlightColor.a);
     }
 
     return float4(finalColor, albedo.a);
@@ -5,6 +5,7 @@
 #include "Log.h"
 #include "PhysicsThread.h"
 #include "ResourceLoader.h"
+#include "TraceExporter.h"
 #include <cmath>
 
 #if ENABLE_VULKAN
@@ -18,10 +19,14 @@
 #include "Core/Scene.h"
 #include "Core/HierarchySystem.h"
 #include "Core/RoboticsDynamicsSystem.h"
+#include "Core/BoundsSystem.h"
+#include "Core/LodSystem.h"
+#include "Core/TextureResidencySystem.h"
 #include "Core/RosBridgeSystem.h"
 #include "Core/SceneSerializer.h"
 #include "Core/SceneLoader.h"
 #include "Core/ModelLoader.h"
+#include "Core/MeshManager.h"
 #include "Core/TextureManager.h"
 
 using namespace Nexus;
@@ -152,6 +157,14 @@ void ProcessEventSync(const SDL_Event& sdlEvent) {
 }
 
 Status InitializeEngine(const EngineConfig& config) {
+    if (!config.tracePath.empty()) {
+        auto& trace = TraceExporter::get();
+        NX_RETURN_IF_ERROR(trace.open(config.tracePath));
+        trace.setTrackName(TraceExporter::TRACK_CPU, "RHI Thread");
+        trace.setTrackName(TraceExporter::TRACK_GPU, "GPU");
+        Log::info("Recording trace to {}", config.tracePath);
+    }
+
     g_ecsRegistry = std::make_unique<Registry>();
     
     auto entity = g_ecsRegistry->create();
@@ -179,11 +192,13 @@ Status InitializeEngine(const EngineConfig& config) {
 
 #if ENABLE_VULKAN
     auto vkContext = static_cast<VK_Context*>(g_context);
-    g_swapchain = std::make_unique<VK_Swapchain>(vkContext->getInstance(), vkContext->getPhysicalDevice(), vkContext->getDevice(), vkContext->getSurface());
+    g_swapchain = std::make_unique<VK_Swapchain>(vkContext->getInstance(), vkContext->getPhysicalDevice(), vkContext->getDevice(), vkContext->getSurface(),
+                                                  vkContext->getMemoryAllocator());
     NX_RETURN_IF_ERROR(g_swapchain->initialize(1280, 720));
     
-    g_renderer = std::make_unique<Core::RenderSystem>(vkContext, g_swapchain.get());
+    g_renderer = std::make_unique<Core::RenderSystem>(vkContext, g_swapchain.get(), config.vertexFormat);
     NX_RETURN_IF_ERROR(g_renderer->initialize());
+    g_renderer->getBridgeRenderer()->setDepthPrepass(config.depthPrepass);
 
     g_rhiThread = std::make_unique<RHIThread>(vkContext);
     g_rhiThread->setRenderer(g_renderer.get());
@@ -194,6 +209,11 @@ Status InitializeEngine(const EngineConfig& config) {
     g_editorUIManager->loadLayout("Data/UI/editor_layout.json");
 
     g_textureManager = std::make_unique<TextureManager>(vkContext);
+    g_textureManager->setCookTextures(config.cookTextures);
+    g_textureManager->setVramBudget(config.textureBudgetMB * 1024ull * 1024ull);
+    TextureManager::MipStreamingSettings streaming;
+    streaming.enabled = config.streamTextureMips;
+    g_textureManager->setMipStreaming(streaming);
 #endif
 
     // 从 JSON 场景文件加载
@@ -207,6 +227,8 @@ Status InitializeEngine(const EngineConfig& config) {
     g_scene = std::make_unique<Scene>(sceneConfig.sceneName);
 
 #if ENABLE_VULKAN
+    // 实体销毁与场景清空时释放网格区间; 场景先于渲染系统销毁
+    g_renderer->getMeshManager()->attachRegistry(g_scene->getRegistry());
     SceneLoader::createEntities(sceneConfig, g_scene.get(), g_renderer.get(), g_textureManager.get());
 #else
     SceneLoader::createEntities(sceneConfig, g_scene.get(), nullptr, nullptr);
@@ -255,6 +277,9 @@ Status InitializeEngine(const EngineConfig& config) {
 
 void ShutdownEngine() {
     if (g_rhiThread) g_rhiThread->stop();
+    if (auto status = TraceExporter::get().close(); !status.ok()) {
+        Log::warn("Failed to write trace: {}", status.message());
+    }
     
     if (g_physicsThread) g_physicsThread->stop();
 
@@ -455,6 +480,14 @@ void RunMainLoop() {
                 HierarchySystem::update(g_scene->getRegistry());
                 // 2. Dynamics 用 MuJoCo 数据覆盖 worldMatrix（物理运行时覆盖静态结果）
                 RoboticsDynamicsSystem::update(g_scene->getRegistry(), g_physicsSystem);
+                // 3. 基于最终 worldMatrix 批量更新世界包围体, 再按屏幕投影大小选择 LOD
+                BoundsSystem::update(g_scene->getRegistry());
+                LodSystem::update(g_scene->getRegistry());
+                // 4. 按渲染器上一帧视锥内的网格更新纹理使用帧与所需 mip, 超出显存预算时换出最久未用的纹理
+                if (g_textureManager && g_renderer && g_renderer->getBridgeRenderer()) {
+                    TextureResidencySystem::update(g_scene->getRegistry(), *g_textureManager,
+                                                   g_renderer->getBridgeRenderer()->getVisibleEntities(), (float)lastHeight);
+                }
                 if (g_rosBridge) {
                     g_rosBridge->publishReplicas(g_scene->getRegistry());
                     if (g_physicsSystem) g_rosBridge->publishModelInfo(g_physicsSystem);
@@ -490,6 +523,22 @@ int main(int argc, char* argv[]) {
         std::string arg = argv[i];
         if (arg == "--no-validation") {
             config.enableValidationLayers = false;
+        } else if (arg == "--compact-vertices") {
+            config.vertexFormat = VertexFormat::Compact;
+        } else if (arg == "--anisotropy" && i + 1 < argc) {
+            config.maxAnisotropy = std::stof(argv[++i]);
+        } else if (arg == "--cook-textures") {
+            config.cookTextures = true;
+        } else if (arg == "--texture-budget-mb" && i + 1 < argc) {
+            config.textureBudgetMB = std::stoull(argv[++i]);
+        } else if (arg == "--stream-texture-mips") {
+            config.streamTextureMips = true;
+        } else if (arg == "--depth-prepass") {
+            config.depthPrepass = true;
+        } else if (arg == "--frames-in-flight" && i + 1 < argc) {
+            config.framesInFlight = (uint32_t)std::stoul(argv[++i]);
+        } else if (arg == "--trace" && i + 1 < argc) {
+            config.tracePath = argv[++i];
         }
     }
 
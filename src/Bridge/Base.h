@@ -26,6 +26,9 @@ using absl::NotFoundError;
 using absl::InvalidArgumentError;
 using absl::InternalError;
 using absl::AbortedError;
+using absl::UnimplementedError;
+using absl::ResourceExhaustedError;
+using absl::DeadlineExceededError;
 
 namespace details {
 template <typename T>
@@ -0,0 +1,551 @@
+#include "BlockCompression.h"
+#include "ImageMips.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Nexus {
+
+namespace {
+
+constexpr uint32_t kTexels = 16;
+constexpr uint8_t kBC7Weights2[4] = {0, 21, 43, 64};
+constexpr uint8_t kBC7Weights3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+constexpr uint8_t kBC7Weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+/**
+ * @brief 按 LSB 优先顺序读写块内比特流 (BC7 规范的位序)
+ */
+class BitWriter {
+public:
+    explicit BitWriter(uint8_t* out, size_t bytes) : m_out(out) { std::memset(out, 0, bytes); }
+    void write(uint32_t value, uint32_t bits) {
+        for (uint32_t b = 0; b < bits; ++b, ++m_pos) {
+            if ((value >> b) & 1u) m_out[m_pos >> 3] |= (uint8_t)(1u << (m_pos & 7));
+        }
+    }
+
+private:
+    uint8_t* m_out;
+    uint32_t m_pos = 0;
+};
+
+class BitReader {
+public:
+    explicit BitReader(const uint8_t* in) : m_in(in) {}
+    uint32_t read(uint32_t bits) {
+        uint32_t value = 0;
+        for (uint32_t b = 0; b < bits; ++b, ++m_pos) {
+            value |= (uint32_t)((m_in[m_pos >> 3] >> (m_pos & 7)) & 1u) << b;
+        }
+        return value;
+    }
+
+private:
+    const uint8_t* m_in;
+    uint32_t m_pos = 0;
+};
+
+/**
+ * @brief 点集均值与主轴 (协方差矩阵幂迭代)
+ */
+template <int N>
+void principalAxis(const float (*points)[N], uint32_t count, float mean[N], float axis[N]) {
+    for (int c = 0; c < N; ++c) mean[c] = 0.0f;
+    for (uint32_t i = 0; i < count; ++i) {
+        for (int c = 0; c < N; ++c) mean[c] += points[i][c];
+    }
+    for (int c = 0; c < N; ++c) mean[c] /= (float)std::max(count, 1u);
+
+    float cov[N][N] = {};
+    for (uint32_t i = 0; i < count; ++i) {
+        for (int a = 0; a < N; ++a) {
+            for (int b = 0; b < N; ++b) cov[a][b] += (points[i][a] - mean[a]) * (points[i][b] - mean[b]);
+        }
+    }
+
+    // 以方差最大通道所在的行作为初值, 避免初值与主轴正交
+    int largest = 0;
+    for (int c = 1; c < N; ++c) {
+        if (cov[c][c] > cov[largest][largest]) largest = c;
+    }
+    for (int c = 0; c < N; ++c) axis[c] = cov[largest][c];
+    for (int iter = 0; iter < 8; ++iter) {
+        float next[N] = {};
+        float len = 0.0f;
+        for (int a = 0; a < N; ++a) {
+            for (int b = 0; b < N; ++b) next[a] += cov[a][b] * axis[b];
+            len += next[a] * next[a];
+        }
+        if (len < 1e-12f) break;
+        len = std::sqrt(len);
+        for (int c = 0; c < N; ++c) axis[c] = next[c] / len;
+    }
+}
+
+/**
+ * @brief 沿主轴投影, 返回两端点 (lo, hi)
+ */
+template <int N>
+void axisEndpoints(const float (*points)[N], uint32_t count, float lo[N], float hi[N]) {
+    float mean[N], axis[N];
+    principalAxis<N>(points, count, mean, axis);
+    float minT = 0.0f, maxT = 0.0f;
+    for (uint32_t i = 0; i < count; ++i) {
+        float t = 0.0f;
+        for (int c = 0; c < N; ++c) t += (points[i][c] - mean[c]) * axis[c];
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+    for (int c = 0; c < N; ++c) {
+        lo[c] = std::clamp(mean[c] + axis[c] * minT, 0.0f, 255.0f);
+        hi[c] = std::clamp(mean[c] + axis[c] * maxT, 0.0f, 255.0f);
+    }
+}
+
+uint16_t packRgb565(const float rgb[3]) {
+    uint32_t r = (uint32_t)std::lround(rgb[0] * 31.0f / 255.0f);
+    uint32_t g = (uint32_t)std::lround(rgb[1] * 63.0f / 255.0f);
+    uint32_t b = (uint32_t)std::lround(rgb[2] * 31.0f / 255.0f);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+void unpackRgb565(uint16_t value, uint8_t rgb[3]) {
+    uint32_t r = value >> 11, g = (value >> 5) & 63u, b = value & 31u;
+    rgb[0] = (uint8_t)((r << 3) | (r >> 2));
+    rgb[1] = (uint8_t)((g << 2) | (g >> 4));
+    rgb[2] = (uint8_t)((b << 3) | (b >> 2));
+}
+
+/**
+ * @brief BC1 调色板; 四色模式由 color0 > color1 决定 (BC3 的颜色块总是四色)
+ */
+void bc1Palette(uint16_t c0, uint16_t c1, bool forceFourColor, uint8_t palette[4][4]) {
+    unpackRgb565(c0, palette[0]);
+    unpackRgb565(c1, palette[1]);
+    palette[0][3] = palette[1][3] = 255;
+    if (forceFourColor || c0 > c1) {
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (uint8_t)((2 * palette[0][c] + palette[1][c]) / 3);
+            palette[3][c] = (uint8_t)((palette[0][c] + 2 * palette[1][c]) / 3);
+        }
+        palette[2][3] = palette[3][3] = 255;
+    } else {
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (uint8_t)((palette[0][c] + palette[1][c]) / 2);
+            palette[3][c] = 0;
+        }
+        palette[2][3] = 255;
+        palette[3][3] = 0;
+    }
+}
+
+void encodeColorBlock(const uint8_t texels[64], uint8_t out[8], bool allowTransparent) {
+    float points[kTexels][3];
+    uint32_t count = 0;
+    bool hasTransparent = false;
+    for (uint32_t i = 0; i < kTexels; ++i) {
+        if (allowTransparent && texels[i * 4 + 3] < 128) {
+            hasTransparent = true;
+            continue;
+        }
+        for (int c = 0; c < 3; ++c) points[count][c] = texels[i * 4 + c];
+        ++count;
+    }
+
+    uint16_t c0 = 0, c1 = 0;
+    if (count > 0) {
+        float lo[3], hi[3];
+        axisEndpoints<3>(points, count, lo, hi);
+        c0 = packRgb565(hi);
+        c1 = packRgb565(lo);
+    }
+    // 四色模式要求 c0 > c1, 带透明的三色模式要求 c0 <= c1
+    if (hasTransparent ? c0 > c1 : c0 < c1) std::swap(c0, c1);
+
+    uint8_t palette[4][4];
+    bc1Palette(c0, c1, !allowTransparent, palette);
+    const bool fourColor = !allowTransparent || c0 > c1;
+
+    uint32_t indices = 0;
+    for (uint32_t i = 0; i < kTexels; ++i) {
+        uint32_t best = 0;
+        if (hasTransparent && texels[i * 4 + 3] < 128) {
+            best = 3;
+        } else {
+            int bestError = INT32_MAX;
+            for (uint32_t p = 0; p < (fourColor ? 4u : 3u); ++p) {
+                int error = 0;
+                for (int c = 0; c < 3; ++c) {
+                    int d = (int)texels[i * 4 + c] - palette[p][c];
+                    error += d * d;
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    best = p;
+                }
+            }
+        }
+        indices |= best << (i * 2);
+    }
+
+    out[0] = (uint8_t)(c0 & 0xFF);
+    out[1] = (uint8_t)(c0 >> 8);
+    out[2] = (uint8_t)(c1 & 0xFF);
+    out[3] = (uint8_t)(c1 >> 8);
+    std::memcpy(out + 4, &indices, sizeof(indices));
+}
+
+void decodeColorBlock(const uint8_t in[8], uint8_t texels[64], bool forceFourColor) {
+    uint16_t c0 = (uint16_t)(in[0] | (in[1] << 8));
+    uint16_t c1 = (uint16_t)(in[2] | (in[3] << 8));
+    uint8_t palette[4][4];
+    bc1Palette(c0, c1, forceFourColor, palette);
+    uint32_t indices;
+    std::memcpy(&indices, in + 4, sizeof(indices));
+    for (uint32_t i = 0; i < kTexels; ++i) {
+        std::memcpy(texels + i * 4, palette[(indices >> (i * 2)) & 3u], 4);
+    }
+}
+
+/**
+ * @brief BC4 单通道块 (BC3 的 alpha, BC5 的 R/G)
+ */
+void bc4Palette(uint8_t a0, uint8_t a1, uint8_t palette[8]) {
+    palette[0] = a0;
+    palette[1] = a1;
+    if (a0 > a1) {
+        for (int i = 2; i < 8; ++i) palette[i] = (uint8_t)(((8 - i) * a0 + (i - 1) * a1) / 7);
+    } else {
+        for (int i = 2; i < 6; ++i) palette[i] = (uint8_t)(((6 - i) * a0 + (i - 1) * a1) / 5);
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+void encodeChannelBlock(const uint8_t texels[64], int channel, uint8_t out[8]) {
+    uint8_t lo = 255, hi = 0;
+    for (uint32_t i = 0; i < kTexels; ++i) {
+        lo = std::min(lo, texels[i * 4 + channel]);
+        hi = std::max(hi, texels[i * 4 + channel]);
+    }
+    uint8_t palette[8];
+    bc4Palette(hi, lo, palette);
+
+    uint64_t indices = 0;
+    for (uint32_t i = 0; i < kTexels; ++i) {
+        uint32_t best = 0;
+        int bestError = INT32_MAX;
+        for (uint32_t p = 0; p < 8; ++p) {
+            int error = std::abs((int)texels[i * 4 + channel] - palette[p]);
+            if (error < bestError) {
+                bestError = error;
+                best = p;
+            }
+        }
+        indices |= (uint64_t)best << (i * 3);
+    }
+
+    out[0] = hi;
+    out[1] = lo;
+    for (int b = 0; b < 6; ++b) out[2 + b] = (uint8_t)(indices >> (b * 8));
+}
+
+void decodeChannelBlock(const uint8_t in[8], uint8_t texels[64], int channel) {
+    uint8_t palette[8];
+    bc4Palette(in[0], in[1], palette);
+    uint64_t indices = 0;
+    for (int b = 0; b < 6; ++b) indices |= (uint64_t)in[2 + b] << (b * 8);
+    for (uint32_t i = 0; i < kTexels; ++i) {
+        texels[i * 4 + channel] = palette[(indices >> (i * 3)) & 7u];
+    }
+}
+
+uint8_t bc7Interpolate(uint32_t e0, uint32_t e1, uint32_t weight) {
+    return (uint8_t)(((64 - weight) * e0 + weight * e1 + 32) >> 6);
+}
+
+/**
+ * @brief 读取单子集模式的索引 (锚点 0 少 1 位)
+ */
+void readBC7Indices(BitReader& reader, uint32_t bits, uint8_t indices[16]) {
+    for (uint32_t i = 0; i < kTexels; ++i) {
+        indices[i] = (uint8_t)reader.read(i == 0 ? bits - 1 : bits);
+    }
+}
+
+} // namespace
+
+bool isBlockCompressed(TextureFormat format) {
+    return getBlockBytes(format) != 0;
+}
+
+uint32_t getBlockBytes(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::BC1_RGBA_UNORM_BLOCK: return 8;
+        case TextureFormat::BC3_UNORM_BLOCK:
+        case TextureFormat::BC5_UNORM_BLOCK:
+        case TextureFormat::BC7_UNORM_BLOCK: return 16;
+        default: return 0;
+    }
+}
+
+void encodeBC1Block(const uint8_t texels[64], uint8_t out[8]) {
+    encodeColorBlock(texels, out, true);
+}
+
+void encodeBC3Block(const uint8_t texels[64], uint8_t out[16]) {
+    encodeChannelBlock(texels, 3, out);
+    encodeColorBlock(texels, out + 8, false);
+}
+
+void encodeBC5Block(const uint8_t texels[64], uint8_t out[16]) {
+    encodeChannelBlock(texels, 0, out);
+    encodeChannelBlock(texels, 1, out + 8);
+}
+
+void encodeBC7Block(const uint8_t texels[64], uint8_t out[16]) {
+    float points[kTexels][4];
+    for (uint32_t i = 0; i < kTexels; ++i) {
+        for (int c = 0; c < 4; ++c) points[i][c] = texels[i * 4 + c];
+    }
+    float ends[2][4];
+    axisEndpoints<4>(points, kTexels, ends[0], ends[1]);
+
+    // 端点为 7 位 + 独立 p 位, 枚举四种 p 位组合取块误差最小者
+    uint32_t quantized[2][4] = {}, pbits[2] = {};
+    uint8_t indices[kTexels] = {};
+    int bestBlockError = INT32_MAX;
+    for (uint32_t combo = 0; combo < 4; ++combo) {
+        uint32_t q[2][4], p[2] = {combo & 1u, combo >> 1};
+        uint32_t endpoints[2][4];
+        for (int e = 0; e < 2; ++e) {
+            for (int c = 0; c < 4; ++c) {
+                q[e][c] = (uint32_t)std::clamp((int)std::lround((ends[e][c] - (float)p[e]) * 0.5f), 0, 127);
+                endpoints[e][c] = (q[e][c] << 1) | p[e];
+            }
+        }
+        uint8_t palette[16][4];
+        for (uint32_t w = 0; w < 16; ++w) {
+            for (int c = 0; c < 4; ++c) palette[w][c] = bc7Interpolate(endpoints[0][c], endpoints[1][c], kBC7Weights4[w]);
+        }
+        uint8_t candidate[kTexels];
+        int blockError = 0;
+        for (uint32_t i = 0; i < kTexels; ++i) {
+            int bestError = INT32_MAX;
+            for (uint32_t w = 0; w < 16; ++w) {
+                int error = 0;
+                for (int c = 0; c < 4; ++c) {
+                    int d = (int)texels[i * 4 + c] - palette[w][c];
+                    error += d * d;
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    candidate[i] = (uint8_t)w;
+                }
+            }
+            blockError += bestError;
+        }
+        if (blockError < bestBlockError) {
+            bestBlockError = blockError;
+            std::memcpy(quantized, q, sizeof(q));
+            pbits[0] = p[0];
+            pbits[1] = p[1];
+            std::memcpy(indices, candidate, sizeof(candidate));
+        }
+    }
+    // 锚点索引的最高位隐含为 0, 必要时交换端点
+    if (indices[0] & 8u) {
+        std::swap(quantized[0], quantized[1]);
+        std::swap(pbits[0], pbits[1]);
+        for (auto& index : indices) index = (uint8_t)(15u - index);
+    }
+
+    BitWriter writer(out, 16);
+    writer.write(1u << 6, 7);
+    for (int c = 0; c < 4; ++c) {
+        writer.write(quantized[0][c], 7);
+        writer.write(quantized[1][c], 7);
+    }
+    writer.write(pbits[0], 1);
+    writer.write(pbits[1], 1);
+    for (uint32_t i = 0; i < kTexels; ++i) writer.write(indices[i], i == 0 ? 3 : 4);
+}
+
+void decodeBC1Block(const uint8_t in[8], uint8_t texels[64]) {
+    decodeColorBlock(in, texels, false);
+}
+
+void decodeBC3Block(const uint8_t in[16], uint8_t texels[64]) {
+    decodeColorBlock(in + 8, texels, true);
+    decodeChannelBlock(in, texels, 3);
+}
+
+void decodeBC5Block(const uint8_t in[16], uint8_t texels[64]) {
+    decodeChannelBlock(in, texels, 0);
+    decodeChannelBlock(in + 8, texels, 1);
+    for (uint32_t i = 0; i < kTexels; ++i) {
+        texels[i * 4 + 2] = 0;
+        texels[i * 4 + 3] = 255;
+    }
+}
+
+Status decodeBC7Block(const uint8_t in[16], uint8_t texels[64]) {
+    uint32_t mode = 0;
+    while (mode < 8 && !((in[0] >> mode) & 1u)) ++mode;
+    if (mode == 8) {
+        // 保留模式按规范解码为全 0
+        std::memset(texels, 0, 64);
+        return OkStatus();
+    }
+    if (mode < 4 || mode == 7) return UnimplementedError("BC7 partitioned modes are not supported by the CPU decoder");
+
+    BitReader reader(in);
+    reader.read(mode + 1);
+    uint32_t e[2][4];
+    uint8_t colorIndices[16], alphaIndices[16];
+    const uint8_t* colorWeights = kBC7Weights2;
+    const uint8_t* alphaWeights = kBC7Weights2;
+    uint32_t rotation = 0;
+
+    if (mode == 6) {
+        for (int c = 0; c < 4; ++c) {
+            e[0][c] = reader.read(7);
+            e[1][c] = reader.read(7);
+        }
+        uint32_t p0 = reader.read(1), p1 = reader.read(1);
+        for (int c = 0; c < 4; ++c) {
+            e[0][c] = (e[0][c] << 1) | p0;
+            e[1][c] = (e[1][c] << 1) | p1;
+        }
+        readBC7Indices(reader, 4, colorIndices);
+        std::memcpy(alphaIndices, colorIndices, sizeof(colorIndices));
+        colorWeights = alphaWeights = kBC7Weights4;
+    } else {
+        rotation = reader.read(2);
+        const uint32_t indexSelection = mode == 4 ? reader.read(1) : 0;
+        const uint32_t colorBits = mode == 4 ? 5 : 7;
+        const uint32_t alphaBits = mode == 4 ? 6 : 8;
+        for (int c = 0; c < 3; ++c) {
+            for (int s = 0; s < 2; ++s) {
+                uint32_t v = reader.read(colorBits);
+                e[s][c] = (v << (8 - colorBits)) | (v >> (2 * colorBits - 8));
+            }
+        }
+        for (int s = 0; s < 2; ++s) {
+            uint32_t v = reader.read(alphaBits);
+            e[s][3] = alphaBits == 8 ? v : (v << 2) | (v >> 4);
+        }
+        if (mode == 5) {
+            readBC7Indices(reader, 2, colorIndices);
+            readBC7Indices(reader, 2, alphaIndices);
+        } else {
+            uint8_t primary[16], secondary[16];
+            readBC7Indices(reader, 2, primary);
+            readBC7Indices(reader, 3, secondary);
+            std::memcpy(colorIndices, indexSelection ? secondary : primary, 16);
+            std::memcpy(alphaIndices, indexSelection ? primary : secondary, 16);
+            colorWeights = indexSelection ? kBC7Weights3 : kBC7Weights2;
+            alphaWeights = indexSelection ? kBC7Weights2 : kBC7Weights3;
+        }
+    }
+
+    for (uint32_t i = 0; i < kTexels; ++i) {
+        uint8_t* t = texels + i * 4;
+        for (int c = 0; c < 3; ++c) t[c] = bc7Interpolate(e[0][c], e[1][c], colorWeights[colorIndices[i]]);
+        t[3] = bc7Interpolate(e[0][3], e[1][3], alphaWeights[alphaIndices[i]]);
+        if (rotation > 0) std::swap(t[3], t[rotation - 1]);
+    }
+    return OkStatus();
+}
+
+StatusOr<ImageData> compressImage(const ImageData& image, TextureFormat format) {
+    const uint32_t blockBytes = getBlockBytes(format);
+    if (blockBytes == 0) return InvalidArgumentError("compressImage: target format is not block compressed");
+    if (image.format != TextureFormat::R8G8B8A8_UNORM && image.format != TextureFormat::RGBA8_UNORM) {
+        return InvalidArgumentError("compressImage: source must be RGBA8");
+    }
+    if (image.width == 0 || image.height == 0) return InvalidArgumentError("compressImage: empty image");
+    const uint32_t endLevel = image.baseMip + image.mipLevels;
+    if (image.pixels.size() < imageLevelOffset(image, endLevel)) {
+        return InvalidArgumentError("compressImage: pixel data smaller than declared mip chain");
+    }
+
+    ImageData result;
+    result.width = image.width;
+    result.height = image.height;
+    result.channels = 4;
+    result.mipLevels = image.mipLevels;
+    result.baseMip = image.baseMip;
+    result.format = format;
+    result.pixels.resize(imageLevelOffset(result, endLevel));
+
+    uint8_t texels[64];
+    for (uint32_t level = image.baseMip; level < endLevel; ++level) {
+        const uint32_t w = mipExtent(image.width, level), h = mipExtent(image.height, level);
+        const uint8_t* src = image.pixels.data() + imageLevelOffset(image, level);
+        uint8_t* dst = result.pixels.data() + imageLevelOffset(result, level);
+        for (uint32_t by = 0; by < h; by += 4) {
+            for (uint32_t bx = 0; bx < w; bx += 4) {
+                // 边缘不足 4x4 的块复制边界纹素填充
+                for (uint32_t y = 0; y < 4; ++y) {
+                    for (uint32_t x = 0; x < 4; ++x) {
+                        const uint32_t sx = std::min(bx + x, w - 1), sy = std::min(by + y, h - 1);
+                        std::memcpy(texels + (y * 4 + x) * 4, src + ((size_t)sy * w + sx) * 4, 4);
+                    }
+                }
+                switch (format) {
+                    case TextureFormat::BC1_RGBA_UNORM_BLOCK: encodeBC1Block(texels, dst); break;
+                    case TextureFormat::BC3_UNORM_BLOCK: encodeBC3Block(texels, dst); break;
+                    case TextureFormat::BC5_UNORM_BLOCK: encodeBC5Block(texels, dst); break;
+                    default: encodeBC7Block(texels, dst); break;
+                }
+                dst += blockBytes;
+            }
+        }
+    }
+    return result;
+}
+
+StatusOr<ImageData> decompressImage(const ImageData& image) {
+    const uint32_t blockBytes = getBlockBytes(image.format);
+    if (blockBytes == 0) return InvalidArgumentError("decompressImage: source is not block compressed");
+    const uint32_t endLevel = image.baseMip + image.mipLevels;
+    if (image.pixels.size() < imageLevelOffset(image, endLevel)) {
+        return InvalidArgumentError("decompressImage: block data smaller than declared mip chain");
+    }
+
+    ImageData result;
+    result.width = image.width;
+    result.height = image.height;
+    result.channels = 4;
+    result.mipLevels = image.mipLevels;
+    result.baseMip = image.baseMip;
+    result.pixels.resize(imageLevelOffset(result, endLevel));
+
+    uint8_t texels[64];
+    for (uint32_t level = image.baseMip; level < endLevel; ++level) {
+        const uint32_t w = mipExtent(image.width, level), h = mipExtent(image.height, level);
+        const uint8_t* src = image.pixels.data() + imageLevelOffset(image, level);
+        uint8_t* dst = result.pixels.data() + imageLevelOffset(result, level);
+        for (uint32_t by = 0; by < h; by += 4) {
+            for (uint32_t bx = 0; bx < w; bx += 4) {
+                switch (image.format) {
+                    case TextureFormat::BC1_RGBA_UNORM_BLOCK: decodeBC1Block(src, texels); break;
+                    case TextureFormat::BC3_UNORM_BLOCK: decodeBC3Block(src, texels); break;
+                    case TextureFormat::BC5_UNORM_BLOCK: decodeBC5Block(src, texels); break;
+                    default: NX_RETURN_IF_ERROR(decodeBC7Block(src, texels)); break;
+                }
+                src += blockBytes;
+                for (uint32_t y = 0; y < 4 && by + y < h; ++y) {
+                    for (uint32_t x = 0; x < 4 && bx + x < w; ++x) {
+                        std::memcpy(dst + ((size_t)(by + y) * w + bx + x) * 4, texels + (y * 4 + x) * 4, 4);
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace Nexus
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Base.h"
+#include "CommonTypes.h"
+
+namespace Nexus {
+
+/**
+ * @brief 是否为 4x4 块压缩格式 (BC1/BC3/BC5/BC7)
+ */
+bool isBlockCompressed(TextureFormat format);
+
+/**
+ * @brief 单个 4x4 块的字节数 (BC1: 8, BC3/BC5/BC7: 16), 非块压缩格式返回 0
+ */
+uint32_t getBlockBytes(TextureFormat format);
+
+// 单块编码, texels 为 16 个行优先的 RGBA8 纹素
+void encodeBC1Block(const uint8_t texels[64], uint8_t out[8]);  // alpha < 128 的纹素编码为透明
+void encodeBC3Block(const uint8_t texels[64], uint8_t out[16]);
+void encodeBC5Block(const uint8_t texels[64], uint8_t out[16]); // 仅编码 R/G (切线空间法线)
+void encodeBC7Block(const uint8_t texels[64], uint8_t out[16]); // 模式 6: 单子集 RGBA, 4 位索引
+
+// 单块解码为 16 个 RGBA8 纹素 (BC5 输出 B = 0, A = 255, 与 GPU 采样一致)
+void decodeBC1Block(const uint8_t in[8], uint8_t texels[64]);
+void decodeBC3Block(const uint8_t in[16], uint8_t texels[64]);
+void decodeBC5Block(const uint8_t in[16], uint8_t texels[64]);
+
+/**
+ * @brief 解码 BC7 块
+ * @note 仅实现无分区的模式 4/5/6 (本引擎的编码器只输出模式 6); 其余模式返回 Unimplemented
+ */
+Status decodeBC7Block(const uint8_t in[16], uint8_t texels[64]);
+
+/**
+ * @brief 将 RGBA8 图像 (含全部 mip 级别) 逐块压缩为指定格式
+ */
+StatusOr<ImageData> compressImage(const ImageData& image, TextureFormat format);
+
+/**
+ * @brief 将块压缩图像解压为 RGBA8, 用于设备不支持 BC 采样时的 CPU 回退
+ */
+StatusOr<ImageData> decompressImage(const ImageData& image);
+
+} // namespace Nexus
@@ -8,7 +8,10 @@ namespace Nexus {
  * @return 返回上下文指针
  */
 ContextPtr CreateContext(const EngineConfig& config) {
-    return new VK_Context(config.enableValidationLayers);
+    auto* context = new VK_Context(config.enableValidationLayers);
+    context->setMaxAnisotropy(config.maxAnisotropy);
+    context->setFramesInFlight(config.framesInFlight);
+    return context;
 }
 #else
 /**
@@ -7,10 +7,26 @@ namespace Nexus {
 
 class ITexture;
 
+enum class TextureFormat {
+    Unknown,
+    RGBA8_UNORM,
+    BGRA8_UNORM,
+    D32_SFLOAT,
+    BC7_UNORM_BLOCK,
+    R8G8B8A8_UNORM,
+    R8G8B8A8_SRGB,
+    BC1_RGBA_UNORM_BLOCK,
+    BC3_UNORM_BLOCK,
+    BC5_UNORM_BLOCK
+};
+
 struct ImageData {
     uint32_t width = 0;
     uint32_t height = 0;
     uint32_t channels = 0;
+    uint32_t mipLevels = 1; // > 1 时 pixels 按级别依次紧密存放 (见 ImageMips.h)
+    uint32_t baseMip = 0;   // pixels 的第一级在 width x height 完整链中的级别 (mip 流式加载的部分链)
+    TextureFormat format = TextureFormat::R8G8B8A8_UNORM; // BC 格式时 pixels 为 4x4 块数据
     std::vector<uint8_t> pixels;
 };
 
@@ -43,16 +59,6 @@ struct Viewport {
     float minDepth;
     float maxDepth;
 };
-enum class TextureFormat {
-    Unknown,
-    RGBA8_UNORM,
-    BGRA8_UNORM,
-    D32_SFLOAT,
-    BC7_UNORM_BLOCK,
-    R8G8B8A8_UNORM,
-    R8G8B8A8_SRGB
-};
-
 enum class ImageLayout {
     Undefined,
     ColorAttachmentOptimal,
@@ -105,6 +111,31 @@ enum class IndexType {
     Uint32
 };
 
+/**
+ * @brief 全局顶点缓冲区的顶点格式
+ * Float32: Pos(3 x f32) UV(2 x f32) Normal(3 x f32), 32 字节
+ * Compact: Pos(4 x unorm16, 相对网格 AABB 量化) UV(2 x f16) Normal(2 x snorm16, 八面体编码), 16 字节
+ */
+enum class VertexFormat : uint8_t {
+    Float32,
+    Compact
+};
+
+inline uint32_t getVertexStride(VertexFormat format) {
+    return format == VertexFormat::Compact ? 16u : 32u;
+}
+
+/**
+ * @brief 网格 LOD 级别, 各级共享同一顶点区间
+ */
+struct MeshLod {
+    uint32_t indexOffset = 0;
+    uint32_t indexCount = 0;
+    float error = 0.0f; // 模型空间简化误差
+};
+
+constexpr uint32_t MAX_MESH_LODS = 4;
+
 /**
  * @brief 间接绘制指令
  */
@@ -49,6 +49,14 @@ namespace Nexus {
 
 struct EngineConfig {
     bool enableValidationLayers = true;
+    VertexFormat vertexFormat = VertexFormat::Float32;
+    float maxAnisotropy = 16.0f; // 采样器各向异性上限, <= 1 关闭
+    bool cookTextures = false;   // 导入纹理时压缩为 BC 格式并缓存为 <源文件>.ktx2
+    uint64_t textureBudgetMB = 0; // 纹理显存预算, 0 表示不限
+    bool streamTextureMips = false; // 纹理先加载小尺寸 mip, 再按屏幕纹素密度流式加载更精细的级别
+    bool depthPrepass = false; // 主 pass 前先只写深度, 减少重叠绘制的片元着色
+    uint32_t framesInFlight = 2; // 在途帧数 (2 或 3), 3 帧吞吐更高但多一帧输入延迟
+    std::string tracePath; // 非空时把 CPU 录制与各 pass 的 GPU 耗时导出为 Chrome trace JSON, 退出时写入
 };
 
 ContextPtr CreateContext(const EngineConfig& config = EngineConfig{});
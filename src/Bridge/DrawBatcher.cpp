@@ -0,0 +1,113 @@
+#include "DrawBatcher.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Nexus {
+
+size_t DrawBatcher::RangeKeyHash::operator()(const RangeKey& key) const {
+    uint64_t hash = (uint64_t)key.firstIndex * 0x9E3779B97F4A7C15ull;
+    hash ^= ((uint64_t)key.indexCount << 32 | (uint32_t)key.vertexOffset) + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+    return (size_t)hash;
+}
+
+void DrawBatcher::clear() {
+    m_items.clear();
+    m_order.clear();
+    m_commands.clear();
+    m_commandGroups.clear();
+}
+
+void DrawBatcher::reserve(uint32_t count) {
+    m_items.reserve(count);
+    m_entries.reserve(count);
+    m_sorted.reserve(count);
+    m_order.reserve(count);
+}
+
+void DrawBatcher::build(JobSystem* jobs) {
+    m_order.clear();
+    m_commands.clear();
+    m_commandGroups.clear();
+    if (m_items.empty()) return;
+
+    // 深度按本帧的范围线性量化, 非有限值排在最远
+    float minDepth = INFINITY;
+    float maxDepth = -INFINITY;
+    for (const Item& item : m_items) {
+        if (!std::isfinite(item.depth)) continue;
+        minDepth = std::min(minDepth, item.depth);
+        maxDepth = std::max(maxDepth, item.depth);
+    }
+    const float depthScale = maxDepth > minDepth ? (float)((1u << DEPTH_BITS) - 1) / (maxDepth - minDepth) : 0.0f;
+
+    m_rangeIds.clear();
+    m_entries.resize(m_items.size());
+    m_itemRanges.resize(m_items.size());
+    uint32_t maxGroup = 0;
+    for (uint32_t i = 0; i < m_items.size(); ++i) {
+        const Item& item = m_items[i];
+        const auto range = m_rangeIds.try_emplace({item.firstIndex, item.indexCount, item.vertexOffset}, (uint32_t)m_rangeIds.size()).first->second;
+        m_itemRanges[i] = range;
+        maxGroup = std::max(maxGroup, item.group);
+        const uint64_t depth = std::isfinite(item.depth) ? (uint64_t)((item.depth - minDepth) * depthScale) : (1u << DEPTH_BITS) - 1;
+        m_entries[i].key = (uint64_t)(item.group & ((1u << GROUP_BITS) - 1)) << GROUP_SHIFT |
+                           (uint64_t)(range & ((1u << RANGE_BITS) - 1)) << RANGE_SHIFT |
+                           depth << DEPTH_SHIFT |
+                           (item.material & ((1u << MATERIAL_BITS) - 1));
+        m_entries[i].value = i;
+    }
+    if (m_rangeIds.size() <= (1u << RANGE_BITS) && maxGroup < (1u << GROUP_BITS)) {
+        RadixSort::sort(m_entries, m_scratch, jobs);
+    } else {
+        // 键中的分组或区间号已被截断, 按完整字段排序; 低位 (深度, 材质) 仍取自键, 相同时按项下标保持稳定
+        std::sort(m_entries.begin(), m_entries.end(), [&](const RadixSort::Entry& lhs, const RadixSort::Entry& rhs) {
+            const Item& a = m_items[lhs.value];
+            const Item& b = m_items[rhs.value];
+            if (a.group != b.group) return a.group < b.group;
+            if (m_itemRanges[lhs.value] != m_itemRanges[rhs.value]) return m_itemRanges[lhs.value] < m_itemRanges[rhs.value];
+            const uint64_t lowMask = (1ull << RANGE_SHIFT) - 1;
+            if ((lhs.key & lowMask) != (rhs.key & lowMask)) return (lhs.key & lowMask) < (rhs.key & lowMask);
+            return lhs.value < rhs.value;
+        });
+    }
+
+    // 分组与网格区间都相同的相邻项合并为一个批次 (比较完整字段而非键中截断后的位)
+    m_batches.clear();
+    m_sorted.clear();
+    for (uint32_t i = 0; i < m_entries.size(); ++i) {
+        const Item& item = m_items[m_entries[i].value];
+        m_sorted.push_back(item.payload);
+        if (i > 0 && m_items[m_entries[i - 1].value].group == item.group && m_itemRanges[m_entries[i - 1].value] == m_itemRanges[m_entries[i].value]) {
+            m_batches.back().command.instanceCount++;
+            continue;
+        }
+        const uint32_t depth = (uint32_t)(m_entries[i].key >> DEPTH_SHIFT) & ((1u << DEPTH_BITS) - 1);
+        m_batches.push_back({{item.indexCount, 1, item.firstIndex, item.vertexOffset, i}, item.group, depth});
+    }
+
+    // 分组内批次按最近实例由近到远, 实例区间随之重排
+    m_batchOrder.resize(m_batches.size());
+    for (uint32_t i = 0; i < m_batchOrder.size(); ++i) m_batchOrder[i] = i;
+    std::sort(m_batchOrder.begin(), m_batchOrder.end(), [&](uint32_t a, uint32_t b) {
+        const Batch& lhs = m_batches[a];
+        const Batch& rhs = m_batches[b];
+        if (lhs.group != rhs.group) return lhs.group < rhs.group;
+        if (lhs.nearestDepth != rhs.nearestDepth) return lhs.nearestDepth < rhs.nearestDepth;
+        return a < b;
+    });
+
+    for (uint32_t index : m_batchOrder) {
+        DrawIndexedIndirectCommand command = m_batches[index].command;
+        const auto first = m_sorted.begin() + command.firstInstance;
+        command.firstInstance = (uint32_t)m_order.size();
+        m_order.insert(m_order.end(), first, first + command.instanceCount);
+        m_commands.push_back(command);
+        m_commandGroups.push_back(m_batches[index].group);
+    }
+}
+
+uint32_t DrawBatcher::getGroupBegin(uint32_t group) const {
+    return (uint32_t)(std::lower_bound(m_commandGroups.begin(), m_commandGroups.end(), group) - m_commandGroups.begin());
+}
+
+} // namespace Nexus
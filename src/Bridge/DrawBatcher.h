@@ -0,0 +1,102 @@
+#pragma once
+
+#include "CommonTypes.h"
+#include "RadixSort.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Nexus {
+
+class JobSystem;
+
+/**
+ * @brief 绘制排序与自动实例化
+ *
+ * 每个绘制项编码为 64 位排序键 (高位到低位): 通道 | 分组 | 网格区间 | 量化深度 | 材质, 经 RadixSort 排序.
+ * 分组对应管线与索引类型, 不同分组不合并, 命令按分组升序输出, 便于逐组绑定后绘制.
+ * 网格区间 (firstIndex, indexCount, vertexOffset) 相同的项合并为一条实例化命令, 批次内实例由近到远;
+ * 同一分组内的批次再按其最近实例的深度由近到远排列, 使不透明几何尽量先画近处以利用 early-Z.
+ * 材质参数位于逐实例记录 (bindless 索引), 只作为深度相同时的次序, 不拆分批次.
+ * 本帧不同网格区间数超过 2^RANGE_BITS 或分组号超过 2^GROUP_BITS 时键放不下, 改用按完整字段比较的 std::sort.
+ */
+class DrawBatcher {
+public:
+    struct Item {
+        uint32_t group;
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        int32_t vertexOffset;
+        uint32_t material;
+        float depth;      // 视空间深度, 越小越近
+        uint32_t payload; // 调用方的项索引
+    };
+
+    // 排序键布局; 当前只有不透明通道, 通道位恒为 0
+    static constexpr uint32_t MATERIAL_BITS = 16;
+    static constexpr uint32_t DEPTH_BITS = 16;
+    static constexpr uint32_t RANGE_BITS = 24;
+    static constexpr uint32_t GROUP_BITS = 6;
+    static constexpr uint32_t DEPTH_SHIFT = MATERIAL_BITS;
+    static constexpr uint32_t RANGE_SHIFT = DEPTH_SHIFT + DEPTH_BITS;
+    static constexpr uint32_t GROUP_SHIFT = RANGE_SHIFT + RANGE_BITS;
+    static constexpr uint32_t PASS_SHIFT = GROUP_SHIFT + GROUP_BITS;
+
+    void clear();
+    void reserve(uint32_t count);
+    void add(const Item& item) { m_items.push_back(item); }
+
+    /**
+     * @brief 排序并合并, 结果在下一次 clear / build 前有效
+     * @param jobs 项数较多时并行排序, 为空时在调用线程执行
+     */
+    void build(JobSystem* jobs = nullptr);
+
+    /**
+     * @brief 实例顺序: 第 i 个实例对应的 payload; 每条命令的实例区间连续且按命令顺序排列
+     */
+    const std::vector<uint32_t>& getOrder() const { return m_order; }
+
+    /**
+     * @brief 合并后的命令, firstInstance 为 getOrder 中的下标
+     */
+    const std::vector<DrawIndexedIndirectCommand>& getCommands() const { return m_commands; }
+
+    /**
+     * @brief 第一条分组号 >= group 的命令下标
+     */
+    uint32_t getGroupBegin(uint32_t group) const;
+
+    uint32_t size() const { return (uint32_t)m_items.size(); }
+
+private:
+    struct RangeKey {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        int32_t vertexOffset;
+        bool operator==(const RangeKey& other) const = default;
+    };
+    struct RangeKeyHash {
+        size_t operator()(const RangeKey& key) const;
+    };
+    struct Batch {
+        DrawIndexedIndirectCommand command;
+        uint32_t group;
+        uint32_t nearestDepth;
+    };
+
+    std::vector<Item> m_items;
+    std::vector<RadixSort::Entry> m_entries;
+    std::vector<RadixSort::Entry> m_scratch;
+    std::unordered_map<RangeKey, uint32_t, RangeKeyHash> m_rangeIds;
+    std::vector<uint32_t> m_itemRanges; // 每项的网格区间号
+    std::vector<Batch> m_batches;
+    std::vector<uint32_t> m_batchOrder;
+    std::vector<uint32_t> m_sorted; // 按排序键排列的 payload
+    std::vector<uint32_t> m_order;
+    std::vector<DrawIndexedIndirectCommand> m_commands;
+    std::vector<uint32_t> m_commandGroups;
+};
+
+} // namespace Nexus
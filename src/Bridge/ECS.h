@@ -30,6 +30,13 @@ public:
         m_registry.destroy(entity);
     }
 
+    /**
+     * @brief 实体是否仍然存活 (未被销毁)
+     */
+    bool valid(entt::entity entity) const {
+        return m_registry.valid(entity);
+    }
+
     /**
      * @brief 获取或添加组件 (模板转发)
      */
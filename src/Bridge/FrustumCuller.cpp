@@ -0,0 +1,132 @@
+#include "FrustumCuller.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NX_CULL_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace Nexus {
+
+FrustumCuller::Planes FrustumCuller::extractPlanes(const std::array<float, 16>& m) {
+    auto row = [&](int i) { return Plane{m[i], m[4 + i], m[8 + i], m[12 + i]}; };
+    auto combine = [](const Plane& a, const Plane& b, float sign) {
+        return Plane{a[0] + sign * b[0], a[1] + sign * b[1], a[2] + sign * b[2], a[3] + sign * b[3]};
+    };
+    const Plane r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+    Planes planes = {combine(r3, r0, 1.0f), combine(r3, r0, -1.0f), combine(r3, r1, 1.0f), combine(r3, r1, -1.0f),
+                     r2, combine(r3, r2, -1.0f)};
+    // 归一化后包围球半径才能直接与平面距离比较
+    for (auto& plane : planes) {
+        const float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        if (length > 0.0f) {
+            for (float& value : plane) value /= length;
+        }
+    }
+    return planes;
+}
+
+void FrustumCuller::clear() {
+    m_count = 0;
+    for (auto* values : {&m_sphereX, &m_sphereY, &m_sphereZ, &m_radius, &m_centerX, &m_centerY, &m_centerZ, &m_extentX, &m_extentY, &m_extentZ}) {
+        values->clear();
+    }
+}
+
+void FrustumCuller::reserve(uint32_t count) {
+    for (auto* values : {&m_sphereX, &m_sphereY, &m_sphereZ, &m_radius, &m_centerX, &m_centerY, &m_centerZ, &m_extentX, &m_extentY, &m_extentZ}) {
+        values->reserve(count);
+    }
+}
+
+uint32_t FrustumCuller::add(const std::array<float, 4>& sphere, const std::array<float, 3>& worldMin, const std::array<float, 3>& worldMax) {
+    m_sphereX.push_back(sphere[0]);
+    m_sphereY.push_back(sphere[1]);
+    m_sphereZ.push_back(sphere[2]);
+    m_radius.push_back(sphere[3]);
+    m_centerX.push_back((worldMin[0] + worldMax[0]) * 0.5f);
+    m_centerY.push_back((worldMin[1] + worldMax[1]) * 0.5f);
+    m_centerZ.push_back((worldMin[2] + worldMax[2]) * 0.5f);
+    m_extentX.push_back((worldMax[0] - worldMin[0]) * 0.5f);
+    m_extentY.push_back((worldMax[1] - worldMin[1]) * 0.5f);
+    m_extentZ.push_back((worldMax[2] - worldMin[2]) * 0.5f);
+    return m_count++;
+}
+
+uint32_t FrustumCuller::addUnbounded() {
+    // 半径与半长足够大, 到任何平面的有向距离都为正; 不用 FLT_MAX, 避免 0 * inf 产生 NaN
+    constexpr float huge = 1e30f;
+    return add({0.0f, 0.0f, 0.0f, huge}, {-huge, -huge, -huge}, {huge, huge, huge});
+}
+
+void FrustumCuller::cullRange(const Planes& planes, uint32_t begin, uint32_t end, std::vector<uint32_t>& out) const {
+    uint32_t i = begin;
+#if NX_CULL_SSE2
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= end; i += 4) {
+        const __m128 sx = _mm_loadu_ps(&m_sphereX[i]), sy = _mm_loadu_ps(&m_sphereY[i]), sz = _mm_loadu_ps(&m_sphereZ[i]);
+        const __m128 radius = _mm_loadu_ps(&m_radius[i]);
+        const __m128 cx = _mm_loadu_ps(&m_centerX[i]), cy = _mm_loadu_ps(&m_centerY[i]), cz = _mm_loadu_ps(&m_centerZ[i]);
+        const __m128 ex = _mm_loadu_ps(&m_extentX[i]), ey = _mm_loadu_ps(&m_extentY[i]), ez = _mm_loadu_ps(&m_extentZ[i]);
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (const Plane& plane : planes) {
+            const __m128 nx = _mm_set1_ps(plane[0]), ny = _mm_set1_ps(plane[1]), nz = _mm_set1_ps(plane[2]), d = _mm_set1_ps(plane[3]);
+            // 包围球: dot(n, s) + d + r >= 0
+            __m128 sphereDistance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, sx), _mm_mul_ps(ny, sy)), _mm_add_ps(_mm_mul_ps(nz, sz), d));
+            sphereDistance = _mm_add_ps(sphereDistance, radius);
+            // AABB: dot(n, c) + d + dot(|n|, e) >= 0
+            __m128 boxDistance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)), _mm_add_ps(_mm_mul_ps(nz, cz), d));
+            boxDistance = _mm_add_ps(boxDistance, _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(std::fabs(plane[0])), ex),
+                                                                        _mm_mul_ps(_mm_set1_ps(std::fabs(plane[1])), ey)),
+                                                             _mm_mul_ps(_mm_set1_ps(std::fabs(plane[2])), ez)));
+            inside = _mm_and_ps(inside, _mm_and_ps(_mm_cmpge_ps(sphereDistance, zero), _mm_cmpge_ps(boxDistance, zero)));
+            if (_mm_movemask_ps(inside) == 0) break;
+        }
+
+        const int mask = _mm_movemask_ps(inside);
+        for (int lane = 0; lane < 4; ++lane) {
+            if (mask & (1 << lane)) out.push_back(i + lane);
+        }
+    }
+#endif
+    for (; i < end; ++i) {
+        bool inside = true;
+        for (const Plane& plane : planes) {
+            const float sphereDistance = plane[0] * m_sphereX[i] + plane[1] * m_sphereY[i] + plane[2] * m_sphereZ[i] + plane[3] + m_radius[i];
+            const float boxDistance = plane[0] * m_centerX[i] + plane[1] * m_centerY[i] + plane[2] * m_centerZ[i] + plane[3] +
+                                      std::fabs(plane[0]) * m_extentX[i] + std::fabs(plane[1]) * m_extentY[i] + std::fabs(plane[2]) * m_extentZ[i];
+            if (!(sphereDistance >= 0.0f && boxDistance >= 0.0f)) {
+                inside = false;
+                break;
+            }
+        }
+        if (inside) out.push_back(i);
+    }
+}
+
+const std::vector<uint32_t>& FrustumCuller::cull(const std::array<float, 16>& viewProj, JobSystem* jobs) {
+    const Planes planes = extractPlanes(viewProj);
+    m_visible.clear();
+    if (!jobs || m_count <= CHUNK_SIZE) {
+        cullRange(planes, 0, m_count, m_visible);
+        return m_visible;
+    }
+
+    // 调用线程与工作线程共同领取块 (不排在后台任务之后), 每块写自己的结果, 返回后按块顺序拼接
+    const uint32_t chunkCount = (m_count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    m_chunkVisible.resize(chunkCount);
+    jobs->dispatch(chunkCount, [this, &planes](uint32_t chunk) {
+        auto& out = m_chunkVisible[chunk];
+        out.clear();
+        cullRange(planes, chunk * CHUNK_SIZE, std::min(m_count, (chunk + 1) * CHUNK_SIZE), out);
+    });
+    for (uint32_t chunk = 0; chunk < chunkCount; ++chunk) {
+        m_visible.insert(m_visible.end(), m_chunkVisible[chunk].begin(), m_chunkVisible[chunk].end());
+    }
+    return m_visible;
+}
+
+} // namespace Nexus
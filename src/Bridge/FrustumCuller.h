@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Nexus {
+
+class JobSystem;
+
+/**
+ * @brief CPU 视锥剔除
+ *
+ * 对象以 SoA 形式保存世界空间包围球与 AABB (中心 + 半长); 先测包围球, 通过的再测 AABB,
+ * 每次迭代 4 个对象 (SSE2), 非 x86 平台退化为标量实现.
+ * 对象数超过 CHUNK_SIZE 时经 JobSystem::dispatch 按块并行剔除 (调用线程也领取块), 结果按输入顺序拼接为紧凑的可见索引列表.
+ * 非线程安全: add 与 cull 由同一线程调用.
+ */
+class FrustumCuller {
+public:
+    using Plane = std::array<float, 4>; // dot(n, p) + d >= 0 为内侧
+    using Planes = std::array<Plane, 6>;
+
+    static constexpr uint32_t CHUNK_SIZE = 2048; // 4 的倍数
+
+    /**
+     * @brief 从列主序 viewProj 提取并归一化视锥平面 (Vulkan 深度范围 [0,1])
+     * 顺序: 左, 右, 下, 上, 近, 远
+     */
+    static Planes extractPlanes(const std::array<float, 16>& viewProj);
+
+    void clear();
+    void reserve(uint32_t count);
+
+    /**
+     * @brief 添加一个对象
+     * @param sphere 世界包围球 (center, radius)
+     * @return 对象索引 (按添加顺序)
+     */
+    uint32_t add(const std::array<float, 4>& sphere, const std::array<float, 3>& worldMin, const std::array<float, 3>& worldMax);
+
+    /**
+     * @brief 添加一个没有包围体的对象, 始终可见
+     */
+    uint32_t addUnbounded();
+
+    /**
+     * @brief 剔除全部对象
+     * @param jobs 为空时在调用线程串行执行
+     * @return 可见对象的索引 (升序), 在下一次 clear / cull 前有效
+     */
+    const std::vector<uint32_t>& cull(const std::array<float, 16>& viewProj, JobSystem* jobs = nullptr);
+
+    uint32_t size() const { return m_count; }
+
+private:
+    /**
+     * @brief 剔除 [begin, end), 可见索引追加到 out
+     */
+    void cullRange(const Planes& planes, uint32_t begin, uint32_t end, std::vector<uint32_t>& out) const;
+
+    uint32_t m_count = 0;
+    // SoA: 包围球与 AABB 的中心/半长
+    std::vector<float> m_sphereX, m_sphereY, m_sphereZ, m_radius;
+    std::vector<float> m_centerX, m_centerY, m_centerZ;
+    std::vector<float> m_extentX, m_extentY, m_extentZ;
+
+    std::vector<uint32_t> m_visible;
+    std::vector<std::vector<uint32_t>> m_chunkVisible; // 并行时每块的结果, 跨帧复用容量
+};
+
+} // namespace Nexus
@@ -0,0 +1,121 @@
+#include "ImageMips.h"
+#include "BlockCompression.h"
+#include <algorithm>
+
+namespace Nexus {
+
+namespace {
+constexpr uint32_t kBytesPerPixel = 4;
+}
+
+uint32_t computeMipLevelCount(uint32_t width, uint32_t height) {
+    uint32_t extent = std::max(width, height);
+    uint32_t levels = 1;
+    while (extent > 1) {
+        extent >>= 1;
+        ++levels;
+    }
+    return levels;
+}
+
+uint32_t mipExtent(uint32_t extent, uint32_t level) {
+    return std::max(1u, extent >> level);
+}
+
+uint64_t mipLevelOffset(uint32_t width, uint32_t height, uint32_t level) {
+    uint64_t offset = 0;
+    for (uint32_t i = 0; i < level; ++i) {
+        offset += (uint64_t)mipExtent(width, i) * mipExtent(height, i) * kBytesPerPixel;
+    }
+    return offset;
+}
+
+uint64_t mipLevelSize(uint32_t width, uint32_t height, uint32_t level, TextureFormat format) {
+    const uint64_t w = mipExtent(width, level), h = mipExtent(height, level);
+    if (isBlockCompressed(format)) {
+        return ((w + 3) / 4) * ((h + 3) / 4) * getBlockBytes(format);
+    }
+    return w * h * kBytesPerPixel;
+}
+
+uint64_t mipLevelOffset(uint32_t width, uint32_t height, uint32_t level, TextureFormat format) {
+    uint64_t offset = 0;
+    for (uint32_t i = 0; i < level; ++i) {
+        offset += mipLevelSize(width, height, i, format);
+    }
+    return offset;
+}
+
+uint64_t imageLevelOffset(const ImageData& image, uint32_t level) {
+    return mipLevelOffset(image.width, image.height, level, image.format) -
+           mipLevelOffset(image.width, image.height, image.baseMip, image.format);
+}
+
+StatusOr<ImageData> extractMipLevels(const ImageData& image, uint32_t firstLevel, uint32_t levelCount) {
+    if (firstLevel < image.baseMip || firstLevel + levelCount > image.baseMip + image.mipLevels) {
+        return InvalidArgumentError("extractMipLevels: requested levels are not present in the image");
+    }
+    const uint64_t begin = imageLevelOffset(image, firstLevel);
+    const uint64_t end = imageLevelOffset(image, firstLevel + levelCount);
+    if (image.pixels.size() < end) return InvalidArgumentError("extractMipLevels: pixel data smaller than declared mip chain");
+
+    ImageData result;
+    result.width = image.width;
+    result.height = image.height;
+    result.channels = image.channels;
+    result.format = image.format;
+    result.baseMip = firstLevel;
+    result.mipLevels = levelCount;
+    result.pixels.assign(image.pixels.begin() + begin, image.pixels.begin() + end);
+    return result;
+}
+
+uint32_t firstMipWithin(uint32_t width, uint32_t height, uint32_t maxExtent) {
+    const uint32_t levels = computeMipLevelCount(width, height);
+    uint32_t level = 0;
+    while (level + 1 < levels && std::max(mipExtent(width, level), mipExtent(height, level)) > maxExtent) ++level;
+    return level;
+}
+
+Status generateMipChain(ImageData& image) {
+    if (image.width == 0 || image.height == 0) return InvalidArgumentError("generateMipChain: empty image");
+    if (image.baseMip != 0) return InvalidArgumentError("generateMipChain: expects a chain starting at mip0");
+    if (image.pixels.size() < (size_t)image.width * image.height * kBytesPerPixel) {
+        return InvalidArgumentError("generateMipChain: expects RGBA8 pixels");
+    }
+
+    const uint32_t levels = computeMipLevelCount(image.width, image.height);
+    image.pixels.resize(mipLevelOffset(image.width, image.height, levels));
+
+    for (uint32_t level = 1; level < levels; ++level) {
+        const uint32_t srcW = mipExtent(image.width, level - 1), srcH = mipExtent(image.height, level - 1);
+        const uint32_t dstW = mipExtent(image.width, level), dstH = mipExtent(image.height, level);
+        const uint8_t* src = image.pixels.data() + mipLevelOffset(image.width, image.height, level - 1);
+        uint8_t* dst = image.pixels.data() + mipLevelOffset(image.width, image.height, level);
+
+        for (uint32_t y = 0; y < dstH; ++y) {
+            // 源尺寸为奇数时, 末尾的采样窗口扩展为 3 像素
+            const uint32_t y0 = std::min(y * 2, srcH - 1);
+            const uint32_t y1 = (y == dstH - 1) ? srcH - 1 : std::min(y0 + 1, srcH - 1);
+            for (uint32_t x = 0; x < dstW; ++x) {
+                const uint32_t x0 = std::min(x * 2, srcW - 1);
+                const uint32_t x1 = (x == dstW - 1) ? srcW - 1 : std::min(x0 + 1, srcW - 1);
+                for (uint32_t c = 0; c < kBytesPerPixel; ++c) {
+                    uint32_t sum = 0, count = 0;
+                    for (uint32_t sy = y0; sy <= y1; ++sy) {
+                        for (uint32_t sx = x0; sx <= x1; ++sx) {
+                            sum += src[((size_t)sy * srcW + sx) * kBytesPerPixel + c];
+                            ++count;
+                        }
+                    }
+                    dst[((size_t)y * dstW + x) * kBytesPerPixel + c] = (uint8_t)((sum + count / 2) / count);
+                }
+            }
+        }
+    }
+
+    image.mipLevels = levels;
+    return OkStatus();
+}
+
+} // namespace Nexus
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Base.h"
+#include "CommonTypes.h"
+
+namespace Nexus {
+
+/**
+ * @brief 完整 mip 链的级数 (floor(log2(max(w, h))) + 1)
+ */
+uint32_t computeMipLevelCount(uint32_t width, uint32_t height);
+
+/**
+ * @brief 指定级别的尺寸 (每级减半, 最小为 1)
+ */
+uint32_t mipExtent(uint32_t extent, uint32_t level);
+
+/**
+ * @brief 指定级别在 ImageData::pixels 中的字节偏移 (RGBA8)
+ */
+uint64_t mipLevelOffset(uint32_t width, uint32_t height, uint32_t level);
+
+/**
+ * @brief 指定格式下单个 mip 级别的字节数 (BC 格式按 4x4 块向上取整)
+ */
+uint64_t mipLevelSize(uint32_t width, uint32_t height, uint32_t level, TextureFormat format);
+
+/**
+ * @brief 指定格式下某级别在紧密存放的 mip 链中的字节偏移
+ */
+uint64_t mipLevelOffset(uint32_t width, uint32_t height, uint32_t level, TextureFormat format);
+
+/**
+ * @brief 绝对级别 level (>= image.baseMip) 在 image.pixels 中的字节偏移, 按 image.format 计算
+ */
+uint64_t imageLevelOffset(const ImageData& image, uint32_t level);
+
+/**
+ * @brief 截取 [firstLevel, firstLevel + levelCount) 级别, 结果的 baseMip 为 firstLevel
+ * @note 所需级别须全部包含在 image 中
+ */
+StatusOr<ImageData> extractMipLevels(const ImageData& image, uint32_t firstLevel, uint32_t levelCount);
+
+/**
+ * @brief 最大边不超过 maxExtent 的第一个级别
+ */
+uint32_t firstMipWithin(uint32_t width, uint32_t height, uint32_t maxExtent);
+
+/**
+ * @brief CPU 盒式滤波生成完整 mip 链 (RGBA8), 用于 GPU 不支持线性 blit 的格式
+ * 奇数尺寸时最后一行/列与相邻像素合并, 结果追加到 image.pixels 之后 (要求 baseMip 为 0)
+ */
+Status generateMipChain(ImageData& image);
+
+} // namespace Nexus
@@ -27,6 +27,46 @@ public:
     virtual std::unique_ptr<ITexture> createTexture(const ImageData& imageData, TextureUsage usage) = 0;
     virtual std::unique_ptr<ITexture> createTexture(uint32_t width, uint32_t height, TextureFormat format, TextureUsage usage) = 0;
 
+    /**
+     * @brief 异步纹理: 立即返回一个采样 placeholder 内容的纹理, 数据稍后经 uploadTextureAsync 提交
+     * @return 后端不支持时返回 nullptr, 调用方应回退到同步 createTexture
+     */
+    virtual std::unique_ptr<ITexture> createTextureAsync(ITexture* placeholder) { return nullptr; }
+
+    /**
+     * @brief 提交异步纹理的像素数据 (线程安全), 在下一次 sync 时批量上传
+     *
+     * 对已驻留的纹理再次提交时替换其 mip 范围: 新的最精细级别为 imageData.baseMip,
+     * pixels 中没有的更粗级别沿用现有数据 (mipLevels 为 0 表示只丢弃更精细的级别).
+     */
+    virtual void uploadTextureAsync(ITexture* texture, ImageData&& imageData) {}
+
+    /**
+     * @brief 为异步纹理申请可直接写入的上传内存 (线程安全), 调用方把 RGBA8 的 mip0 解码到返回的指针
+     * @return 后端不支持或暂无空间时返回 nullptr, 调用方应改用 uploadTextureAsync
+     */
+    virtual void* mapTextureUpload(ITexture* texture, uint32_t width, uint32_t height) { return nullptr; }
+
+    /**
+     * @brief 结束对 mapTextureUpload 内存的写入并排队上传; success 为 false 时放弃并归还内存
+     */
+    virtual void commitTextureUpload(ITexture* texture, bool success) {}
+
+    /**
+     * @brief 释放已驻留纹理的显存, bindless 槽位改为指向 placeholder, 之后可再次 uploadTextureAsync
+     * @note 在同步点调用; 在途帧仍可能采样旧图像, 其显存在这些帧完成后才释放
+     * @return 后端不支持或纹理不可换出时返回 false
+     */
+    virtual bool evictTexture(ITexture* texture, ITexture* placeholder) { return false; }
+
+    /**
+     * @brief 帧时间线: 已提交的最新帧值与 GPU 已完成的帧值 (后端不跟踪时均为 0)
+     *
+     * 在提交值 v 时释放的缓冲区区间, 须等完成值到达 v 后才能改写.
+     */
+    virtual uint64_t getSubmittedFrameValue() const { return 0; }
+    virtual uint64_t getCompletedFrameValue() const { return 0; }
+
     // Temporary: Global mesh buffers for the Bridge to access
     virtual IBuffer* getGlobalVertexBuffer() const { return nullptr; }
     virtual IBuffer* getGlobalIndexBuffer() const { return nullptr; }
@@ -123,6 +163,18 @@ public:
     virtual TextureFormat getFormat() const = 0;
     virtual uint32_t getBindlessTextureIndex() const { return 0; }
     virtual uint32_t getBindlessSamplerIndex() const { return 0; }
+    /**
+     * @brief 数据是否已上传到 GPU (异步纹理在此之前采样占位纹理)
+     */
+    virtual bool isResident() const { return true; }
+    /**
+     * @brief 占用的显存字节数 (未驻留时为 0)
+     */
+    virtual uint64_t getMemorySize() const { return 0; }
+    /**
+     * @brief 驻留的最精细 mip 级别 (mip 流式加载时可能大于 0)
+     */
+    virtual uint32_t getResidentMip() const { return 0; }
 };
 
 class Registry;
@@ -0,0 +1,112 @@
+#include "JobSystem.h"
+#include "Log.h"
+#include <algorithm>
+
+namespace Nexus {
+
+JobSystem::JobSystem(uint32_t workerCount) {
+    if (workerCount == 0) {
+        uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = std::max(1u, hardwareThreads > 1 ? hardwareThreads - 1 : 1u);
+    }
+    m_workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cv.notify_all();
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+void JobSystem::submit(std::function<void()> job) {
+    m_pendingJobs.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_cv.notify_one();
+}
+
+namespace {
+
+struct DispatchState {
+    std::atomic<uint32_t> next{0};
+    uint32_t count = 0;
+    const std::function<void(uint32_t)>* func = nullptr; // 只在领取到下标时访问, 此时 dispatch 尚未返回
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint32_t done = 0;
+};
+
+void runClaimed(DispatchState& state) {
+    for (uint32_t i = state.next.fetch_add(1, std::memory_order_relaxed); i < state.count; i = state.next.fetch_add(1, std::memory_order_relaxed)) {
+        try {
+            (*state.func)(i);
+        } catch (const std::exception& e) {
+            NX_CORE_ERROR("JobSystem: dispatched job threw exception: {}", e.what());
+        } catch (...) {
+            NX_CORE_ERROR("JobSystem: dispatched job threw unknown exception");
+        }
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (++state.done == state.count) state.cv.notify_all();
+    }
+}
+
+} // namespace
+
+void JobSystem::dispatch(uint32_t count, const std::function<void(uint32_t)>& func, const std::function<void()>& callerWork) {
+    if (count == 0) {
+        if (callerWork) callerWork();
+        return;
+    }
+    auto state = std::make_shared<DispatchState>();
+    state->count = count;
+    state->func = &func;
+    // 调用线程也会领取, 没有 callerWork 时少派一个帮手
+    const uint32_t helpers = std::min(getWorkerCount(), callerWork ? count : count - 1);
+    for (uint32_t i = 0; i < helpers; ++i) {
+        submit([state]() { runClaimed(*state); });
+    }
+    if (callerWork) callerWork();
+    runClaimed(*state);
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cv.wait(lock, [&state]() { return state->done == state->count; });
+}
+
+JobSystem& JobSystem::get() {
+    static JobSystem instance;
+    return instance;
+}
+
+void JobSystem::workerLoop() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+            // 退出前排空队列, 保证已提交的任务都会执行
+            if (m_jobs.empty()) return;
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        try {
+            job();
+        } catch (const std::exception& e) {
+            NX_CORE_ERROR("JobSystem: job threw exception: {}", e.what());
+        } catch (...) {
+            NX_CORE_ERROR("JobSystem: job threw unknown exception");
+        }
+        m_pendingJobs.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace Nexus
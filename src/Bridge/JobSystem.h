@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Base.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+namespace Nexus {
+
+/**
+ * @brief 通用工作线程池
+ *
+ * 用于解码、构建等可与主循环并行的 CPU 任务; 任务不得持有 Vulkan 队列.
+ */
+class JobSystem {
+public:
+    /**
+     * @param workerCount 工作线程数, 0 表示 hardware_concurrency - 1 (至少 1)
+     */
+    explicit JobSystem(uint32_t workerCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * @brief 提交一个无返回值的任务
+     */
+    void submit(std::function<void()> job);
+
+    /**
+     * @brief 提交任务并通过 future 获取结果
+     */
+    template<typename F>
+    auto submitTask(F&& func) -> std::future<std::invoke_result_t<F>> {
+        using Result = std::invoke_result_t<F>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(func));
+        std::future<Result> future = task->get_future();
+        submit([task]() { (*task)(); });
+        return future;
+    }
+
+    /**
+     * @brief 对 [0, count) 的每个下标执行 func, 返回时全部完成
+     *
+     * 调用线程与工作线程从共享计数器领取下标, 调用线程不会空等排在其它任务之后的帮手任务:
+     * 帮手开始时若下标已领完则直接返回, 调用方只等待已被工作线程领取的下标.
+     * @param callerWork 在调用线程上先于领取下标执行 (如只能在调用线程完成的工作), 此时帮手已开始领取
+     */
+    void dispatch(uint32_t count, const std::function<void(uint32_t)>& func, const std::function<void()>& callerWork = {});
+
+    /**
+     * @brief 排队与正在执行的任务数
+     */
+    uint32_t getPendingJobCount() const { return m_pendingJobs.load(std::memory_order_relaxed); }
+    uint32_t getWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+    /**
+     * @brief 引擎共享的全局线程池 (首次调用时创建)
+     */
+    static JobSystem& get();
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stopping = false;
+    std::atomic<uint32_t> m_pendingJobs{0};
+};
+
+} // namespace Nexus
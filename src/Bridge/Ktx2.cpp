@@ -0,0 +1,258 @@
+#include "Ktx2.h"
+#include "BlockCompression.h"
+#include "ImageMips.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace Nexus {
+
+namespace {
+
+constexpr uint8_t kIdentifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+constexpr size_t kHeaderSize = 80;      // 标识符 + 头部 + 索引
+constexpr size_t kLevelIndexEntry = 24; // byteOffset, byteLength, uncompressedByteLength
+
+// VkFormat 数值 (避免在 CPU 代码中依赖 Vulkan 头文件)
+constexpr uint32_t kVkR8G8B8A8Unorm = 37;
+constexpr uint32_t kVkBC1RgbaUnorm = 133;
+constexpr uint32_t kVkBC3Unorm = 137;
+constexpr uint32_t kVkBC5Unorm = 141;
+constexpr uint32_t kVkBC7Unorm = 145;
+
+// Khronos Data Format 颜色模型与通道
+constexpr uint8_t kModelRGBSDA = 1;
+constexpr uint8_t kModelBC1A = 128;
+constexpr uint8_t kModelBC3 = 130;
+constexpr uint8_t kModelBC5 = 132;
+constexpr uint8_t kModelBC7 = 134;
+
+uint32_t toVkFormat(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::RGBA8_UNORM:
+        case TextureFormat::R8G8B8A8_UNORM: return kVkR8G8B8A8Unorm;
+        case TextureFormat::BC1_RGBA_UNORM_BLOCK: return kVkBC1RgbaUnorm;
+        case TextureFormat::BC3_UNORM_BLOCK: return kVkBC3Unorm;
+        case TextureFormat::BC5_UNORM_BLOCK: return kVkBC5Unorm;
+        case TextureFormat::BC7_UNORM_BLOCK: return kVkBC7Unorm;
+        default: return 0;
+    }
+}
+
+TextureFormat fromVkFormat(uint32_t vkFormat) {
+    switch (vkFormat) {
+        case kVkR8G8B8A8Unorm: return TextureFormat::R8G8B8A8_UNORM;
+        case kVkBC1RgbaUnorm: return TextureFormat::BC1_RGBA_UNORM_BLOCK;
+        case kVkBC3Unorm: return TextureFormat::BC3_UNORM_BLOCK;
+        case kVkBC5Unorm: return TextureFormat::BC5_UNORM_BLOCK;
+        case kVkBC7Unorm: return TextureFormat::BC7_UNORM_BLOCK;
+        default: return TextureFormat::Unknown;
+    }
+}
+
+template <typename T>
+T readValue(const uint8_t* data, size_t offset) {
+    T value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+template <typename T>
+void appendValue(std::vector<uint8_t>& out, T value) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+void writeValue(std::vector<uint8_t>& out, size_t offset, T value) {
+    std::memcpy(out.data() + offset, &value, sizeof(T));
+}
+
+struct DfdSample {
+    uint16_t bitOffset;
+    uint8_t bitLength; // 实际位数 - 1
+    uint8_t channel;
+    uint32_t upper;
+};
+
+/**
+ * @brief 生成基本数据格式描述块 (含 dfdTotalSize)
+ */
+std::vector<uint8_t> buildDfd(TextureFormat format) {
+    uint8_t model = kModelRGBSDA;
+    uint8_t blockDim = 0;
+    uint8_t bytesPlane0 = 4;
+    std::vector<DfdSample> samples;
+    switch (format) {
+        case TextureFormat::BC1_RGBA_UNORM_BLOCK:
+            model = kModelBC1A;
+            samples = {{0, 63, 1, 0xFFFFFFFFu}}; // ALPHAPRESENT
+            break;
+        case TextureFormat::BC3_UNORM_BLOCK:
+            model = kModelBC3;
+            samples = {{0, 63, 15, 0xFFFFFFFFu}, {64, 63, 0, 0xFFFFFFFFu}}; // ALPHA, COLOR
+            break;
+        case TextureFormat::BC5_UNORM_BLOCK:
+            model = kModelBC5;
+            samples = {{0, 63, 0, 0xFFFFFFFFu}, {64, 63, 1, 0xFFFFFFFFu}}; // RED, GREEN
+            break;
+        case TextureFormat::BC7_UNORM_BLOCK:
+            model = kModelBC7;
+            samples = {{0, 127, 0, 0xFFFFFFFFu}}; // COLOR
+            break;
+        default:
+            samples = {{0, 7, 0, 255}, {8, 7, 1, 255}, {16, 7, 2, 255}, {24, 7, 15, 255}};
+            break;
+    }
+    if (model != kModelRGBSDA) {
+        blockDim = 3;
+        bytesPlane0 = (uint8_t)getBlockBytes(format);
+    }
+
+    const uint32_t blockSize = 24 + 16 * (uint32_t)samples.size();
+    std::vector<uint8_t> dfd;
+    appendValue<uint32_t>(dfd, 4 + blockSize);
+    appendValue<uint32_t>(dfd, 0);                        // vendorId = KHRONOS, descriptorType = BASICFORMAT
+    appendValue<uint32_t>(dfd, 2u | (blockSize << 16));   // versionNumber = 2
+    dfd.insert(dfd.end(), {model, 1 /* BT709 */, 1 /* LINEAR */, 0 /* straight alpha */});
+    dfd.insert(dfd.end(), {blockDim, blockDim, 0, 0});
+    dfd.insert(dfd.end(), {bytesPlane0, 0, 0, 0, 0, 0, 0, 0});
+    for (const auto& sample : samples) {
+        appendValue<uint16_t>(dfd, sample.bitOffset);
+        dfd.push_back(sample.bitLength);
+        dfd.push_back(sample.channel);
+        appendValue<uint32_t>(dfd, 0); // samplePosition
+        appendValue<uint32_t>(dfd, 0); // sampleLower
+        appendValue<uint32_t>(dfd, sample.upper);
+    }
+    return dfd;
+}
+
+} // namespace
+
+bool Ktx2::isKtx2(const uint8_t* data, size_t size) {
+    return data && size >= sizeof(kIdentifier) && std::memcmp(data, kIdentifier, sizeof(kIdentifier)) == 0;
+}
+
+Status Ktx2::probe(const uint8_t* data, size_t size, uint32_t& width, uint32_t& height, uint32_t& levels) {
+    if (!isKtx2(data, size) || size < kHeaderSize) return InvalidArgumentError("Not a KTX2 file");
+    width = readValue<uint32_t>(data, 20);
+    height = readValue<uint32_t>(data, 24);
+    levels = std::max(readValue<uint32_t>(data, 40), 1u);
+    if (width == 0 || height == 0) return InvalidArgumentError("KTX2: zero extent");
+    return OkStatus();
+}
+
+StatusOr<ImageData> Ktx2::read(const uint8_t* data, size_t size) {
+    return readLevels(data, size, 0, UINT32_MAX);
+}
+
+StatusOr<ImageData> Ktx2::readLevels(const uint8_t* data, size_t size, uint32_t firstLevel, uint32_t levelCount) {
+    if (!isKtx2(data, size) || size < kHeaderSize) return InvalidArgumentError("Not a KTX2 file");
+
+    const uint32_t vkFormat = readValue<uint32_t>(data, 12);
+    const uint32_t width = readValue<uint32_t>(data, 20);
+    const uint32_t height = readValue<uint32_t>(data, 24);
+    const uint32_t depth = readValue<uint32_t>(data, 28);
+    const uint32_t layers = readValue<uint32_t>(data, 32);
+    const uint32_t faces = readValue<uint32_t>(data, 36);
+    const uint32_t levels = std::max(readValue<uint32_t>(data, 40), 1u);
+    const uint32_t supercompression = readValue<uint32_t>(data, 44);
+
+    ImageData image;
+    image.format = fromVkFormat(vkFormat);
+    if (image.format == TextureFormat::Unknown) return UnimplementedError("KTX2: unsupported vkFormat " + std::to_string(vkFormat));
+    if (depth > 1 || layers > 1 || faces != 1) return UnimplementedError("KTX2: only single-layer 2D textures are supported");
+    if (supercompression != 0) return UnimplementedError("KTX2: supercompressed data is not supported");
+    if (width == 0 || height == 0) return InvalidArgumentError("KTX2: zero extent");
+    if (levels > computeMipLevelCount(width, height)) return InvalidArgumentError("KTX2: too many mip levels");
+    if (kHeaderSize + (size_t)levels * kLevelIndexEntry > size) return InvalidArgumentError("KTX2: truncated level index");
+
+    if (firstLevel >= levels) return InvalidArgumentError("KTX2: requested level " + std::to_string(firstLevel) + " not present");
+    const uint32_t endLevel = firstLevel + std::min(levelCount, levels - firstLevel);
+
+    image.width = width;
+    image.height = height;
+    image.channels = 4;
+    image.baseMip = firstLevel;
+    image.mipLevels = endLevel - firstLevel;
+    image.pixels.resize(imageLevelOffset(image, endLevel));
+    for (uint32_t level = firstLevel; level < endLevel; ++level) {
+        const size_t entry = kHeaderSize + (size_t)level * kLevelIndexEntry;
+        const uint64_t offset = readValue<uint64_t>(data, entry);
+        const uint64_t length = readValue<uint64_t>(data, entry + 8);
+        const uint64_t expected = mipLevelSize(width, height, level, image.format);
+        if (length < expected || offset > size || size - offset < expected) {
+            return InvalidArgumentError("KTX2: level " + std::to_string(level) + " out of range");
+        }
+        std::memcpy(image.pixels.data() + imageLevelOffset(image, level), data + offset, expected);
+    }
+    return image;
+}
+
+StatusOr<std::vector<uint8_t>> Ktx2::write(const ImageData& image) {
+    const uint32_t vkFormat = toVkFormat(image.format);
+    if (vkFormat == 0) return InvalidArgumentError("KTX2: unsupported texture format");
+    if (image.width == 0 || image.height == 0 || image.mipLevels == 0) return InvalidArgumentError("KTX2: empty image");
+    if (image.baseMip != 0) return InvalidArgumentError("KTX2: partial mip chains cannot be written");
+    if (image.pixels.size() < mipLevelOffset(image.width, image.height, image.mipLevels, image.format)) {
+        return InvalidArgumentError("KTX2: pixel data smaller than declared mip chain");
+    }
+
+    const std::vector<uint8_t> dfd = buildDfd(image.format);
+    const size_t dfdOffset = kHeaderSize + (size_t)image.mipLevels * kLevelIndexEntry;
+    // 级别数据按 lcm(块字节数, 4) 对齐
+    const size_t alignment = isBlockCompressed(image.format) ? getBlockBytes(image.format) : 4;
+
+    std::vector<uint8_t> out(kIdentifier, kIdentifier + sizeof(kIdentifier));
+    appendValue<uint32_t>(out, vkFormat);
+    appendValue<uint32_t>(out, 1);                 // typeSize
+    appendValue<uint32_t>(out, image.width);
+    appendValue<uint32_t>(out, image.height);
+    appendValue<uint32_t>(out, 0);                 // pixelDepth
+    appendValue<uint32_t>(out, 0);                 // layerCount
+    appendValue<uint32_t>(out, 1);                 // faceCount
+    appendValue<uint32_t>(out, image.mipLevels);
+    appendValue<uint32_t>(out, 0);                 // supercompressionScheme
+    appendValue<uint32_t>(out, (uint32_t)dfdOffset);
+    appendValue<uint32_t>(out, (uint32_t)dfd.size());
+    appendValue<uint32_t>(out, 0);                 // kvdByteOffset
+    appendValue<uint32_t>(out, 0);                 // kvdByteLength
+    appendValue<uint64_t>(out, 0);                 // sgdByteOffset
+    appendValue<uint64_t>(out, 0);                 // sgdByteLength
+    out.resize(dfdOffset);
+    out.insert(out.end(), dfd.begin(), dfd.end());
+
+    // 规范要求从最小的级别开始存放
+    for (uint32_t level = image.mipLevels; level-- > 0;) {
+        out.resize((out.size() + alignment - 1) / alignment * alignment);
+        const uint64_t offset = out.size();
+        const uint64_t length = mipLevelSize(image.width, image.height, level, image.format);
+        const uint8_t* src = image.pixels.data() + mipLevelOffset(image.width, image.height, level, image.format);
+        out.insert(out.end(), src, src + length);
+
+        const size_t entry = kHeaderSize + (size_t)level * kLevelIndexEntry;
+        writeValue<uint64_t>(out, entry, offset);
+        writeValue<uint64_t>(out, entry + 8, length);
+        writeValue<uint64_t>(out, entry + 16, length);
+    }
+    return out;
+}
+
+Status Ktx2::writeFile(const ImageData& image, const std::string& fullPath) {
+    NX_ASSIGN_OR_RETURN(std::vector<uint8_t> bytes, write(image));
+    const std::string tempPath = fullPath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return InternalError("Failed to open for writing: " + tempPath);
+        file.write(reinterpret_cast<const char*>(bytes.data()), (std::streamsize)bytes.size());
+        if (!file) return InternalError("Failed to write: " + tempPath);
+    }
+    std::error_code ec;
+    std::filesystem::rename(tempPath, fullPath, ec);
+    if (ec) return InternalError("Failed to rename " + tempPath + ": " + ec.message());
+    return OkStatus();
+}
+
+} // namespace Nexus
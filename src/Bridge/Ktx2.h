@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Base.h"
+#include "CommonTypes.h"
+#include <string>
+#include <vector>
+
+namespace Nexus {
+
+/**
+ * @brief KTX2 纹理容器 (单层 2D, 无超压缩)
+ *
+ * 写出的文件带 Khronos 基本数据格式描述 (DFD), 可被 ktx 工具链读取;
+ * 读取时只解析头部与级别索引, 支持 RGBA8 与 BC1/BC3/BC5/BC7.
+ */
+class Ktx2 {
+public:
+    /**
+     * @brief 检查文件标识符
+     */
+    static bool isKtx2(const uint8_t* data, size_t size);
+
+    /**
+     * @brief 只解析头部获取尺寸与级数
+     */
+    static Status probe(const uint8_t* data, size_t size, uint32_t& width, uint32_t& height, uint32_t& levels);
+
+    /**
+     * @brief 解析 KTX2 数据, 返回按级别紧密存放的 ImageData (mip0 在前)
+     */
+    static StatusOr<ImageData> read(const uint8_t* data, size_t size);
+
+    /**
+     * @brief 只读取 [firstLevel, firstLevel + levelCount) 级别 (超出的部分被截掉), 结果的 baseMip 为 firstLevel
+     * 文件为内存映射时未请求的级别不会被访问
+     */
+    static StatusOr<ImageData> readLevels(const uint8_t* data, size_t size, uint32_t firstLevel, uint32_t levelCount);
+
+    /**
+     * @brief 序列化为 KTX2 (文件内 mip 数据按规范从最小级别开始存放)
+     */
+    static StatusOr<std::vector<uint8_t>> write(const ImageData& image);
+
+    /**
+     * @brief 写出到文件 (先写临时文件再重命名, 避免读到半成品)
+     */
+    static Status writeFile(const ImageData& image, const std::string& fullPath);
+};
+
+} // namespace Nexus
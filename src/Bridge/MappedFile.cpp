@@ -0,0 +1,108 @@
+#include "MappedFile.h"
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Nexus {
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+        m_file = std::exchange(other.m_file, nullptr);
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+StatusOr<MappedFile> MappedFile::open(const std::string& fullPath) {
+    MappedFile file;
+    HANDLE handle = CreateFileA(fullPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) return NotFoundError("Failed to open file for mapping: " + fullPath);
+    file.m_file = handle;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize)) return InternalError("Failed to query file size: " + fullPath);
+    file.m_size = static_cast<size_t>(fileSize.QuadPart);
+    // 空文件无法创建映射, 以空视图表示
+    if (file.m_size == 0) return file;
+
+    file.m_mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!file.m_mapping) return InternalError("Failed to create file mapping: " + fullPath);
+    file.m_data = static_cast<const uint8_t*>(MapViewOfFile(file.m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!file.m_data) return InternalError("Failed to map view of file: " + fullPath);
+    return file;
+}
+
+void MappedFile::close() {
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file) CloseHandle(m_file);
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_file = nullptr;
+    m_size = 0;
+}
+
+#else
+
+StatusOr<MappedFile> MappedFile::open(const std::string& fullPath) {
+    int fd = ::open(fullPath.c_str(), O_RDONLY);
+    if (fd < 0) return NotFoundError("Failed to open file for mapping: " + fullPath);
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return InternalError("Failed to query file size: " + fullPath);
+    }
+
+    MappedFile file;
+    file.m_size = static_cast<size_t>(info.st_size);
+    if (file.m_size > 0) {
+        void* mapped = mmap(nullptr, file.m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            ::close(fd);
+            return InternalError("Failed to mmap file: " + fullPath);
+        }
+        // 解码器顺序读取整个文件
+        (void)madvise(mapped, file.m_size, MADV_SEQUENTIAL);
+        file.m_data = static_cast<const uint8_t*>(mapped);
+    }
+    // 映射建立后即可关闭描述符
+    ::close(fd);
+    return file;
+}
+
+void MappedFile::close() {
+    if (m_data) munmap(const_cast<uint8_t*>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+}
+
+#endif
+
+} // namespace Nexus
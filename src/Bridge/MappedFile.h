@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Base.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Nexus {
+
+/**
+ * @brief 只读内存映射文件 (POSIX mmap / Win32 file mapping)
+ *
+ * 映射期间文件内容按需由操作系统分页载入, 无需先整体读入堆内存.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief 映射整个文件
+     * @param fullPath 绝对路径或相对于工作目录的路径
+     */
+    static StatusOr<MappedFile> open(const std::string& fullPath);
+
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    void close();
+
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
+
+} // namespace Nexus
@@ -0,0 +1,87 @@
+#include "RadixSort.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <array>
+
+namespace Nexus {
+
+namespace {
+
+constexpr uint32_t RADIX_BITS = 8;
+constexpr uint32_t RADIX = 1u << RADIX_BITS;
+constexpr uint32_t MAX_CHUNKS = 16;
+
+using Histogram = std::array<uint32_t, RADIX>;
+
+/**
+ * @brief 对每个块调用 func(chunk); 调用线程与工作线程共同领取块, 不等待排在前面的其他任务
+ */
+template<typename F>
+void forEachChunk(JobSystem* jobs, uint32_t chunkCount, const F& func) {
+    if (chunkCount == 1) {
+        func(0u);
+        return;
+    }
+    jobs->dispatch(chunkCount, func);
+}
+
+} // namespace
+
+void RadixSort::sort(std::vector<Entry>& entries, std::vector<Entry>& scratch, JobSystem* jobs) {
+    const size_t count = entries.size();
+    if (count < 2) return;
+    scratch.resize(count);
+
+    const uint32_t chunkCount = (jobs && count >= PARALLEL_THRESHOLD) ? std::min(jobs->getWorkerCount() + 1, MAX_CHUNKS) : 1;
+    const size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+    auto chunkRange = [&](uint32_t chunk) {
+        return std::make_pair(std::min(count, chunk * chunkSize), std::min(count, (chunk + 1) * chunkSize));
+    };
+
+    // 与首个键不同的位, 为 0 的字节对应的趟可以跳过
+    std::array<uint64_t, MAX_CHUNKS> chunkDiff{};
+    const uint64_t firstKey = entries[0].key;
+    forEachChunk(jobs, chunkCount, [&](uint32_t chunk) {
+        auto [begin, end] = chunkRange(chunk);
+        uint64_t diff = 0;
+        for (size_t i = begin; i < end; ++i) diff |= entries[i].key ^ firstKey;
+        chunkDiff[chunk] = diff;
+    });
+    uint64_t diff = 0;
+    for (uint32_t chunk = 0; chunk < chunkCount; ++chunk) diff |= chunkDiff[chunk];
+
+    std::array<Histogram, MAX_CHUNKS> histograms;
+    Entry* source = entries.data();
+    Entry* destination = scratch.data();
+    for (uint32_t shift = 0; shift < 64; shift += RADIX_BITS) {
+        if (((diff >> shift) & (RADIX - 1)) == 0) continue;
+
+        forEachChunk(jobs, chunkCount, [&](uint32_t chunk) {
+            auto [begin, end] = chunkRange(chunk);
+            Histogram& histogram = histograms[chunk];
+            histogram.fill(0);
+            for (size_t i = begin; i < end; ++i) histogram[(source[i].key >> shift) & (RADIX - 1)]++;
+        });
+
+        // 桶优先, 块其次: 同一桶内保持块的先后顺序, 排序稳定
+        uint32_t offset = 0;
+        for (uint32_t bucket = 0; bucket < RADIX; ++bucket) {
+            for (uint32_t chunk = 0; chunk < chunkCount; ++chunk) {
+                const uint32_t bucketCount = histograms[chunk][bucket];
+                histograms[chunk][bucket] = offset;
+                offset += bucketCount;
+            }
+        }
+
+        forEachChunk(jobs, chunkCount, [&](uint32_t chunk) {
+            auto [begin, end] = chunkRange(chunk);
+            Histogram& offsets = histograms[chunk];
+            for (size_t i = begin; i < end; ++i) destination[offsets[(source[i].key >> shift) & (RADIX - 1)]++] = source[i];
+        });
+        std::swap(source, destination);
+    }
+
+    if (source != entries.data()) entries.swap(scratch);
+}
+
+} // namespace Nexus
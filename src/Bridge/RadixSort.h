@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Nexus {
+
+class JobSystem;
+
+/**
+ * @brief 64 位键的 LSD 基数排序 (每趟 8 位, 稳定)
+ *
+ * 所有键在某 8 位上相同时跳过该趟, 绘制排序键的高位通常只有少数取值.
+ * 元素数达到 PARALLEL_THRESHOLD 且给出 JobSystem 时, 每趟的直方图与分散按块经 JobSystem::dispatch 并行,
+ * 调用线程自己也领取块, 不会排在纹理解码或管线编译等后台任务之后等待.
+ */
+class RadixSort {
+public:
+    struct Entry {
+        uint64_t key;
+        uint32_t value;
+    };
+
+    static constexpr uint32_t PARALLEL_THRESHOLD = 16384;
+
+    /**
+     * @brief 按 key 升序排序
+     * @param scratch 暂存, 跨调用复用容量; 返回后内容未定义
+     * @param jobs 为空时在调用线程串行执行
+     */
+    static void sort(std::vector<Entry>& entries, std::vector<Entry>& scratch, JobSystem* jobs = nullptr);
+};
+
+} // namespace Nexus
@@ -1,7 +1,64 @@
 #include "ResourceLoader.h"
+#include "Ktx2.h"
 #include <fstream>
 #include <sstream>
 #include <filesystem>
+#include <cstdlib>
+#include <cstring>
+
+namespace Nexus {
+namespace {
+
+/**
+ * @brief 当前线程的解码目标内存
+ *
+ * stb_image 总是自行分配输出缓冲区. decodeImageInto 期间, 首个与输出大小完全一致的分配
+ * 直接返回调用方的内存, 使常见格式 (JPEG, 8 位 RGBA PNG) 解码时像素直接落在目标上;
+ * 若最终结果仍在别处 (需要格式转换等), 再退化为一次拷贝.
+ */
+struct DecodeTarget {
+    uint8_t* memory = nullptr;
+    size_t size = 0;
+    bool taken = false;
+};
+thread_local DecodeTarget t_decodeTarget;
+
+void* stbMalloc(size_t size) {
+    DecodeTarget& target = t_decodeTarget;
+    if (target.memory && !target.taken && size == target.size) {
+        target.taken = true;
+        return target.memory;
+    }
+    return std::malloc(size);
+}
+
+void stbFree(void* ptr) {
+    DecodeTarget& target = t_decodeTarget;
+    if (ptr && ptr == target.memory) {
+        target.taken = false;
+        return;
+    }
+    std::free(ptr);
+}
+
+void* stbRealloc(void* ptr, size_t size) {
+    DecodeTarget& target = t_decodeTarget;
+    if (ptr && ptr == target.memory) {
+        // 目标内存不能扩容, 迁出到堆上
+        void* moved = std::malloc(size);
+        if (moved) std::memcpy(moved, ptr, size < target.size ? size : target.size);
+        target.taken = false;
+        return moved;
+    }
+    return std::realloc(ptr, size);
+}
+
+} // namespace
+} // namespace Nexus
+
+#define STBI_MALLOC(size) ::Nexus::stbMalloc(size)
+#define STBI_REALLOC(ptr, size) ::Nexus::stbRealloc(ptr, size)
+#define STBI_FREE(ptr) ::Nexus::stbFree(ptr)
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 #include "thirdparty.h"
@@ -40,20 +97,15 @@ namespace {
 class STBImageReader : public IImageReader {
 public:
     virtual StatusOr<ImageData> read(const std::vector<uint8_t>& data) override {
-        int width, height, channels;
-        unsigned char* pixels = stbi_load_from_memory(data.data(), static_cast<int>(data.size()), &width, &height, &channels, 4);
-        
-        if (!pixels) {
-            return InternalError("Failed to decode image using STB");
-        }
+        return read(data.data(), data.size());
+    }
 
+    StatusOr<ImageData> read(const uint8_t* data, size_t size) {
         ImageData imageData;
-        imageData.width = static_cast<uint32_t>(width);
-        imageData.height = static_cast<uint32_t>(height);
+        NX_RETURN_IF_ERROR(ResourceLoader::probeImage(data, size, imageData.width, imageData.height));
         imageData.channels = 4;
-        imageData.pixels.assign(pixels, pixels + (width * height * 4));
-
-        stbi_image_free(pixels);
+        imageData.pixels.resize(static_cast<size_t>(imageData.width) * imageData.height * 4);
+        NX_RETURN_IF_ERROR(ResourceLoader::decodeImageInto(data, size, imageData.pixels.data(), imageData.width, imageData.height));
         return imageData;
     }
 };
@@ -89,18 +141,51 @@ StatusOr<std::vector<uint8_t>> ResourceLoader::loadBinaryFile(const std::string&
     return buffer;
 }
 
-StatusOr<ImageData> ResourceLoader::loadImage(const std::string& path) {
-    auto binaryRes = loadBinaryFile(path);
-    if (!binaryRes.ok()) return binaryRes.status();
+StatusOr<MappedFile> ResourceLoader::mapFile(const std::string& path) {
+    return MappedFile::open(s_basePath + path);
+}
 
-    STBImageReader reader;
-    return reader.read(binaryRes.value());
+StatusOr<ImageData> ResourceLoader::loadImage(const std::string& path) {
+    NX_ASSIGN_OR_RETURN(MappedFile file, mapFile(path));
+    return loadImageFromMemory(file.data(), file.size());
 }
 
 StatusOr<ImageData> ResourceLoader::loadImageFromMemory(const uint8_t* data, size_t size) {
-    std::vector<uint8_t> buffer(data, data + size);
+    // 烘焙后的块压缩纹理原样返回, 由 VK_Texture 决定直传还是解压
+    if (Ktx2::isKtx2(data, size)) return Ktx2::read(data, size);
     STBImageReader reader;
-    return reader.read(buffer);
+    return reader.read(data, size);
+}
+
+Status ResourceLoader::probeImage(const uint8_t* data, size_t size, uint32_t& width, uint32_t& height) {
+    int w = 0, h = 0, channels = 0;
+    if (!data || size == 0 || !stbi_info_from_memory(data, static_cast<int>(size), &w, &h, &channels)) {
+        return InvalidArgumentError("Unrecognized image format");
+    }
+    if (w <= 0 || h <= 0) return InvalidArgumentError("Image has zero extent");
+    width = static_cast<uint32_t>(w);
+    height = static_cast<uint32_t>(h);
+    return OkStatus();
+}
+
+Status ResourceLoader::decodeImageInto(const uint8_t* data, size_t size, uint8_t* dst, uint32_t width, uint32_t height) {
+    const size_t byteSize = static_cast<size_t>(width) * height * 4;
+    DecodeTarget& target = t_decodeTarget;
+    target = DecodeTarget{dst, byteSize, false};
+
+    int w = 0, h = 0, channels = 0;
+    unsigned char* pixels = stbi_load_from_memory(data, static_cast<int>(size), &w, &h, &channels, 4);
+    target = DecodeTarget{};
+
+    if (!pixels) return InternalError(std::string("Failed to decode image using STB: ") + stbi_failure_reason());
+    Status status = OkStatus();
+    if (static_cast<uint32_t>(w) != width || static_cast<uint32_t>(h) != height) {
+        status = InvalidArgumentError("Decoded image size does not match probed size");
+    } else if (pixels != dst) {
+        std::memcpy(dst, pixels, byteSize);
+    }
+    if (pixels != dst) stbi_image_free(pixels);
+    return status;
 }
 
 } // namespace Nexus
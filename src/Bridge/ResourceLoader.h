@@ -4,6 +4,7 @@
 #include "CommonTypes.h"
 #include <vector>
 #include "ImageReader.h"
+#include "MappedFile.h"
 
 namespace Nexus {
 
@@ -41,6 +42,12 @@ public:
      */
     static StatusOr<std::vector<uint8_t>> loadBinaryFile(const std::string& path);
 
+    /**
+     * @brief 以内存映射方式打开文件 (不拷贝到堆内存)
+     * @param path 相对于 basePath 的路径
+     */
+    static StatusOr<MappedFile> mapFile(const std::string& path);
+
     /**
      * @brief 加载图像数据
      * @param path 文件路径
@@ -54,6 +61,18 @@ public:
      */
     static StatusOr<ImageData> loadImageFromMemory(const uint8_t* data, size_t size);
 
+    /**
+     * @brief 只解析文件头获取图像尺寸, 不解码像素
+     */
+    static Status probeImage(const uint8_t* data, size_t size, uint32_t& width, uint32_t& height);
+
+    /**
+     * @brief 将图像解码为 RGBA8 并写入调用方提供的内存 (如映射的 staging 缓冲区)
+     * @param dst 至少 width * height * 4 字节
+     * @param width, height 须与 probeImage 的结果一致
+     */
+    static Status decodeImageInto(const uint8_t* data, size_t size, uint8_t* dst, uint32_t width, uint32_t height);
+
 private:
     static std::string s_basePath;
 };
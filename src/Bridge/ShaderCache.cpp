@@ -0,0 +1,131 @@
+#include "ShaderCache.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace Nexus {
+
+namespace {
+
+constexpr uint64_t kFnvOffset = 0xCBF29CE484222325ull;
+constexpr uint64_t kFnvPrime = 0x100000001B3ull;
+constexpr uint32_t kSpirvMagic = 0x07230203;
+
+uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+// 长度前缀避免相邻字段拼接产生歧义 ("ab"+"c" 与 "a"+"bc")
+uint64_t fnv1aField(uint64_t hash, std::string_view field) {
+    const uint64_t size = field.size();
+    hash = fnv1a(hash, &size, sizeof(size));
+    return fnv1a(hash, field.data(), field.size());
+}
+
+} // namespace
+
+ShaderCache::ShaderCache(std::string directory) : m_directory(std::move(directory)) {}
+
+uint64_t ShaderCache::computeKey(std::string_view source, std::string_view entryPoint, uint32_t stage, std::string_view options) {
+    uint64_t hash = fnv1a(kFnvOffset, &VERSION, sizeof(VERSION));
+    hash = fnv1aField(hash, source);
+    hash = fnv1aField(hash, entryPoint);
+    hash = fnv1a(hash, &stage, sizeof(stage));
+    return fnv1aField(hash, options);
+}
+
+uint64_t ShaderCache::computeIncludeKey(uint64_t sourceKey, std::span<const Include> includes) {
+    uint64_t hash = fnv1a(kFnvOffset, &sourceKey, sizeof(sourceKey));
+    const uint64_t count = includes.size();
+    hash = fnv1a(hash, &count, sizeof(count));
+    for (const auto& include : includes) {
+        hash = fnv1aField(hash, include.path);
+        hash = fnv1aField(hash, include.content);
+    }
+    return hash;
+}
+
+std::string ShaderCache::getPath(uint64_t key) const {
+    char name[24];
+    std::snprintf(name, sizeof(name), "%016llx.spv", (unsigned long long)key);
+    return (std::filesystem::path(m_directory) / name).string();
+}
+
+std::string ShaderCache::getIncludesPath(uint64_t sourceKey) const {
+    char name[24];
+    std::snprintf(name, sizeof(name), "%016llx.deps", (unsigned long long)sourceKey);
+    return (std::filesystem::path(m_directory) / name).string();
+}
+
+StatusOr<std::vector<ShaderCache::Include>> ShaderCache::loadIncludes(uint64_t sourceKey) const {
+    const std::string listPath = getIncludesPath(sourceKey);
+    std::ifstream list(listPath);
+    if (!list.is_open()) return NotFoundError("Shader include list miss: " + listPath);
+
+    // 每行一个路径
+    std::vector<Include> includes;
+    for (std::string path; std::getline(list, path);) {
+        if (path.empty()) continue;
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) return NotFoundError("Included shader file is gone: " + path);
+        std::stringstream content;
+        content << file.rdbuf();
+        includes.push_back({std::move(path), content.str()});
+    }
+    return includes;
+}
+
+Status ShaderCache::storeIncludes(uint64_t sourceKey, std::span<const Include> includes) const {
+    std::string list;
+    for (const auto& include : includes) list += include.path + "\n";
+    return writeFile(getIncludesPath(sourceKey), list.data(), list.size());
+}
+
+StatusOr<std::vector<uint32_t>> ShaderCache::load(uint64_t key) const {
+    const std::string path = getPath(key);
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return NotFoundError("Shader cache miss: " + path);
+    const std::streamsize size = file.tellg();
+    if (size < (std::streamsize)sizeof(uint32_t) || size % sizeof(uint32_t) != 0) return NotFoundError("Corrupt shader cache entry: " + path);
+
+    std::vector<uint32_t> spirv((size_t)size / sizeof(uint32_t));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(spirv.data()), size) || spirv[0] != kSpirvMagic) {
+        return NotFoundError("Corrupt shader cache entry: " + path);
+    }
+    return spirv;
+}
+
+Status ShaderCache::store(uint64_t key, std::span<const uint32_t> spirv) const {
+    return writeFile(getPath(key), spirv.data(), spirv.size_bytes());
+}
+
+Status ShaderCache::writeFile(const std::string& path, const void* data, size_t size) const {
+    std::error_code ec;
+    std::filesystem::create_directories(m_directory, ec);
+    if (ec) return InternalError("Failed to create shader cache directory " + m_directory + ": " + ec.message());
+
+    // 临时文件名带线程号, 并发写入同一个键时互不覆盖; 重命名是原子的, 后写者胜出且内容相同
+    const std::string tempPath = path + "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return InternalError("Failed to open for writing: " + tempPath);
+        file.write(static_cast<const char*>(data), (std::streamsize)size);
+        if (!file) return InternalError("Failed to write: " + tempPath);
+    }
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return InternalError("Failed to rename " + tempPath);
+    }
+    return OkStatus();
+}
+
+} // namespace Nexus
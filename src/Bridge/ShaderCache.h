@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Base.h"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Nexus {
+
+/**
+ * @brief 内容寻址的 SPIR-V 磁盘缓存
+ *
+ * 源码键为源码, 入口, 着色器阶段与编译选项 (含编译器指纹) 的 64 位 FNV-1a 哈希. 被 #include 的文件在编译前未知:
+ * 编译时记录解析后的包含文件, 以源码键写入 <源码键>.deps; 查找时读回该列表与这些文件的当前内容,
+ * 由 computeIncludeKey 得到最终键, 对应目录下的 <键>.spv. 任何输入变化即得到新键, 无需失效逻辑;
+ * 写入先落到临时文件再重命名, 可被多个线程同时调用.
+ */
+class ShaderCache {
+public:
+    /**
+     * @brief 缓存格式或编译器设置变化时递增, 使旧缓存项全部失效
+     */
+    static constexpr uint32_t VERSION = 2;
+
+    /**
+     * @brief 被包含的文件: 解析后的路径与内容
+     */
+    struct Include {
+        std::string path;
+        std::string content;
+    };
+
+    explicit ShaderCache(std::string directory);
+
+    static uint64_t computeKey(std::string_view source, std::string_view entryPoint, uint32_t stage, std::string_view options);
+
+    /**
+     * @brief 在源码键上并入全部包含文件的路径与内容 (按首次包含的顺序)
+     */
+    static uint64_t computeIncludeKey(uint64_t sourceKey, std::span<const Include> includes);
+
+    /**
+     * @brief 读回源码键对应的包含文件列表及其当前内容; 尚未记录或任一文件已不存在时返回 NotFound
+     */
+    StatusOr<std::vector<Include>> loadIncludes(uint64_t sourceKey) const;
+
+    /**
+     * @brief 记录源码键对应的包含文件路径 (可为空列表)
+     */
+    Status storeIncludes(uint64_t sourceKey, std::span<const Include> includes) const;
+
+    /**
+     * @brief 读取缓存的 SPIR-V, 未命中或文件损坏 (长度不是 4 的倍数或缺少 SPIR-V 魔数) 时返回 NotFound
+     */
+    StatusOr<std::vector<uint32_t>> load(uint64_t key) const;
+
+    /**
+     * @brief 写入缓存项, 必要时创建目录
+     */
+    Status store(uint64_t key, std::span<const uint32_t> spirv) const;
+
+    std::string getPath(uint64_t key) const;
+    std::string getIncludesPath(uint64_t sourceKey) const;
+    const std::string& getDirectory() const { return m_directory; }
+
+private:
+    Status writeFile(const std::string& path, const void* data, size_t size) const;
+
+    std::string m_directory;
+};
+
+} // namespace Nexus
@@ -0,0 +1,189 @@
+#include "TlsfAllocator.h"
+#include <algorithm>
+#include <bit>
+
+namespace Nexus {
+
+namespace {
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+uint32_t msb(uint64_t value) {
+    return (uint32_t)std::bit_width(value) - 1;
+}
+
+} // namespace
+
+TlsfAllocator::TlsfAllocator(uint64_t capacity) : m_capacity(capacity & ~(GRANULARITY - 1)) {
+    for (auto& row : m_heads) row.fill(NONE);
+    if (m_capacity == 0) return;
+    uint32_t index = newNode();
+    m_nodes[index].offset = 0;
+    m_nodes[index].size = m_capacity;
+    insertFree(index);
+}
+
+void TlsfAllocator::mapping(uint64_t size, uint32_t& fl, uint32_t& sl) {
+    if (size < SL_COUNT) {
+        fl = 0;
+        sl = (uint32_t)size;
+        return;
+    }
+    const uint32_t top = msb(size);
+    sl = (uint32_t)(size >> (top - SL_BITS)) ^ SL_COUNT;
+    fl = top - SL_BITS + 1;
+}
+
+uint32_t TlsfAllocator::findFree(uint64_t size) const {
+    // 向上取整到下一个桶的起点, 保证桶内任意区间都足够大
+    if (size >= SL_COUNT) size += (1ull << (msb(size) - SL_BITS)) - 1;
+    uint32_t fl = 0, sl = 0;
+    mapping(size, fl, sl);
+    if (fl >= FL_COUNT) return NONE;
+
+    uint32_t slMap = m_slBitmap[fl] & (~0u << sl);
+    if (!slMap) {
+        const uint64_t flMap = (fl + 1 < 64) ? (m_flBitmap & (~0ull << (fl + 1))) : 0;
+        if (!flMap) return NONE;
+        fl = (uint32_t)std::countr_zero(flMap);
+        slMap = m_slBitmap[fl];
+    }
+    sl = (uint32_t)std::countr_zero(slMap);
+    return m_heads[fl][sl];
+}
+
+uint32_t TlsfAllocator::newNode() {
+    if (!m_unusedNodes.empty()) {
+        uint32_t index = m_unusedNodes.back();
+        m_unusedNodes.pop_back();
+        m_nodes[index] = Node{};
+        return index;
+    }
+    m_nodes.emplace_back();
+    return (uint32_t)m_nodes.size() - 1;
+}
+
+void TlsfAllocator::releaseNode(uint32_t index) {
+    // 回收的节点标记为空闲但不在任何链表中, 重复 free 时被忽略
+    m_nodes[index] = Node{};
+    m_nodes[index].free = true;
+    m_unusedNodes.push_back(index);
+}
+
+void TlsfAllocator::insertFree(uint32_t index) {
+    Node& node = m_nodes[index];
+    uint32_t fl = 0, sl = 0;
+    mapping(node.size, fl, sl);
+    node.free = true;
+    node.prevFree = NONE;
+    node.nextFree = m_heads[fl][sl];
+    if (node.nextFree != NONE) m_nodes[node.nextFree].prevFree = index;
+    m_heads[fl][sl] = index;
+    m_flBitmap |= 1ull << fl;
+    m_slBitmap[fl] |= 1u << sl;
+}
+
+void TlsfAllocator::removeFree(uint32_t index) {
+    Node& node = m_nodes[index];
+    uint32_t fl = 0, sl = 0;
+    mapping(node.size, fl, sl);
+    if (node.prevFree != NONE) m_nodes[node.prevFree].nextFree = node.nextFree;
+    if (node.nextFree != NONE) m_nodes[node.nextFree].prevFree = node.prevFree;
+    if (m_heads[fl][sl] == index) {
+        m_heads[fl][sl] = node.nextFree;
+        if (node.nextFree == NONE) {
+            m_slBitmap[fl] &= ~(1u << sl);
+            if (!m_slBitmap[fl]) m_flBitmap &= ~(1ull << fl);
+        }
+    }
+    node.prevFree = NONE;
+    node.nextFree = NONE;
+    node.free = false;
+}
+
+uint32_t TlsfAllocator::allocate(uint64_t size, uint64_t alignment, uint64_t& outOffset) {
+    size = alignUp(std::max<uint64_t>(size, 1), GRANULARITY);
+    alignment = std::max(alignment, GRANULARITY);
+    // 空闲区间起点至少按 GRANULARITY 对齐, 最多需要 alignment - GRANULARITY 的前部填充
+    const uint64_t searchSize = size + alignment - GRANULARITY;
+    if (searchSize > m_capacity) return INVALID_HANDLE;
+
+    const uint32_t index = findFree(searchSize);
+    if (index == NONE) return INVALID_HANDLE;
+    removeFree(index);
+
+    const uint64_t aligned = alignUp(m_nodes[index].offset, alignment);
+    const uint64_t padding = aligned - m_nodes[index].offset;
+    if (padding > 0) {
+        uint32_t front = newNode();
+        Node& node = m_nodes[index];
+        m_nodes[front].offset = node.offset;
+        m_nodes[front].size = padding;
+        m_nodes[front].prevPhys = node.prevPhys;
+        m_nodes[front].nextPhys = index;
+        if (node.prevPhys != NONE) m_nodes[node.prevPhys].nextPhys = front;
+        node.prevPhys = front;
+        node.offset = aligned;
+        node.size -= padding;
+        insertFree(front);
+    }
+
+    if (m_nodes[index].size - size >= GRANULARITY) {
+        uint32_t back = newNode();
+        Node& node = m_nodes[index];
+        m_nodes[back].offset = node.offset + size;
+        m_nodes[back].size = node.size - size;
+        m_nodes[back].prevPhys = index;
+        m_nodes[back].nextPhys = node.nextPhys;
+        if (node.nextPhys != NONE) m_nodes[node.nextPhys].prevPhys = back;
+        node.nextPhys = back;
+        node.size = size;
+        insertFree(back);
+    }
+
+    m_usedBytes += m_nodes[index].size;
+    ++m_allocationCount;
+    outOffset = m_nodes[index].offset;
+    return index;
+}
+
+void TlsfAllocator::free(uint32_t handle) {
+    if (handle >= m_nodes.size() || m_nodes[handle].free) return;
+    m_usedBytes -= m_nodes[handle].size;
+    --m_allocationCount;
+
+    const uint32_t prev = m_nodes[handle].prevPhys;
+    if (prev != NONE && m_nodes[prev].free) {
+        removeFree(prev);
+        Node& node = m_nodes[handle];
+        node.offset = m_nodes[prev].offset;
+        node.size += m_nodes[prev].size;
+        node.prevPhys = m_nodes[prev].prevPhys;
+        if (node.prevPhys != NONE) m_nodes[node.prevPhys].nextPhys = handle;
+        releaseNode(prev);
+    }
+
+    const uint32_t next = m_nodes[handle].nextPhys;
+    if (next != NONE && m_nodes[next].free) {
+        removeFree(next);
+        Node& node = m_nodes[handle];
+        node.size += m_nodes[next].size;
+        node.nextPhys = m_nodes[next].nextPhys;
+        if (node.nextPhys != NONE) m_nodes[node.nextPhys].prevPhys = handle;
+        releaseNode(next);
+    }
+
+    insertFree(handle);
+}
+
+uint64_t TlsfAllocator::getLargestFreeRegion() const {
+    uint64_t largest = 0;
+    for (const auto& node : m_nodes) {
+        if (node.free) largest = std::max(largest, node.size);
+    }
+    return largest;
+}
+
+} // namespace Nexus
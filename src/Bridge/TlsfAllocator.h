@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Nexus {
+
+/**
+ * @brief TLSF (Two-Level Segregated Fit) 区间分配器
+ *
+ * 只管理 [0, capacity) 的偏移, 不持有任何内存, 供 GPU 内存块做子分配.
+ * 空闲区间按 (一级: log2 大小, 二级: 16 等分) 分桶, 分配与释放均为 O(1);
+ * 释放时与物理相邻的空闲区间立即合并. 非线程安全, 由调用方加锁.
+ */
+class TlsfAllocator {
+public:
+    static constexpr uint32_t INVALID_HANDLE = UINT32_MAX;
+    static constexpr uint64_t GRANULARITY = 16; // 区间大小与偏移的最小单位
+
+    explicit TlsfAllocator(uint64_t capacity);
+
+    /**
+     * @brief 分配区间
+     * @param alignment 偏移对齐 (2 的幂)
+     * @return 句柄, 空间不足时为 INVALID_HANDLE
+     */
+    uint32_t allocate(uint64_t size, uint64_t alignment, uint64_t& outOffset);
+
+    /**
+     * @brief 按句柄释放, 与相邻空闲区间合并
+     */
+    void free(uint32_t handle);
+
+    uint64_t getCapacity() const { return m_capacity; }
+    uint64_t getUsedBytes() const { return m_usedBytes; }
+    uint32_t getAllocationCount() const { return m_allocationCount; }
+    bool isEmpty() const { return m_allocationCount == 0; }
+
+    /**
+     * @brief 当前最大空闲区间 (用于碎片统计)
+     */
+    uint64_t getLargestFreeRegion() const;
+
+private:
+    static constexpr uint32_t SL_BITS = 4;
+    static constexpr uint32_t SL_COUNT = 1u << SL_BITS;
+    static constexpr uint32_t FL_COUNT = 64 - SL_BITS + 1;
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Node {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        uint32_t prevPhys = NONE;
+        uint32_t nextPhys = NONE;
+        uint32_t prevFree = NONE;
+        uint32_t nextFree = NONE;
+        bool free = false;
+    };
+
+    static void mapping(uint64_t size, uint32_t& fl, uint32_t& sl);
+    uint32_t findFree(uint64_t size) const;
+    uint32_t newNode();
+    void releaseNode(uint32_t index);
+    void insertFree(uint32_t index);
+    void removeFree(uint32_t index);
+
+    uint64_t m_capacity = 0;
+    uint64_t m_usedBytes = 0;
+    uint32_t m_allocationCount = 0;
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_unusedNodes;
+    uint64_t m_flBitmap = 0;
+    std::array<uint32_t, FL_COUNT> m_slBitmap{};
+    std::array<std::array<uint32_t, SL_COUNT>, FL_COUNT> m_heads;
+};
+
+} // namespace Nexus
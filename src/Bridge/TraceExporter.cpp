@@ -0,0 +1,142 @@
+#include "TraceExporter.h"
+#include <cstdio>
+#include <fstream>
+
+namespace Nexus {
+
+namespace {
+
+// JSON 字符串转义: 引号, 反斜杠与控制字符
+void appendEscaped(std::string& out, std::string_view text) {
+    for (const char c : text) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if ((unsigned char)c < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", (unsigned)c);
+                out += buf;
+            } else {
+                out += c;
+            }
+        }
+    }
+}
+
+void appendNumber(std::string& out, double value) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.3f", value);
+    out += buf;
+}
+
+} // namespace
+
+TraceExporter::~TraceExporter() {
+    (void)close();
+}
+
+Status TraceExporter::open(std::string path) {
+    if (path.empty()) return InvalidArgumentError("Trace path is empty");
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_path = std::move(path);
+    m_origin = std::chrono::steady_clock::now();
+    m_events.clear();
+    m_dropped = 0;
+    m_open.store(true, std::memory_order_release);
+    return OkStatus();
+}
+
+Status TraceExporter::close() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_open.exchange(false, std::memory_order_acq_rel)) return OkStatus();
+
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto beginEvent = [&]() {
+        if (!first) json += ",";
+        json += "\n{";
+        first = false;
+    };
+    for (const auto& [track, name] : m_trackNames) {
+        beginEvent();
+        json += "\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(track) + ",\"args\":{\"name\":\"";
+        appendEscaped(json, name);
+        json += "\"}}";
+    }
+    for (const auto& event : m_events) {
+        beginEvent();
+        json += "\"name\":\"";
+        appendEscaped(json, event.name);
+        json += "\",\"cat\":\"";
+        appendEscaped(json, event.category);
+        json += "\",\"ph\":\"X\",\"pid\":1,\"tid\":" + std::to_string(event.track) + ",\"ts\":";
+        appendNumber(json, event.startUs);
+        json += ",\"dur\":";
+        appendNumber(json, event.durationUs);
+        if (!event.args.empty()) {
+            json += ",\"args\":{";
+            for (size_t i = 0; i < event.args.size(); ++i) {
+                if (i > 0) json += ",";
+                json += "\"";
+                appendEscaped(json, event.args[i].first);
+                json += "\":";
+                appendNumber(json, event.args[i].second);
+            }
+            json += "}";
+        }
+        json += "}";
+    }
+    json += "\n]}\n";
+    m_events.clear();
+
+    std::ofstream file(m_path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return InternalError("Failed to open trace for writing: " + m_path);
+    file.write(json.data(), (std::streamsize)json.size());
+    if (!file) return InternalError("Failed to write trace: " + m_path);
+    return OkStatus();
+}
+
+void TraceExporter::setTrackName(uint32_t track, std::string name) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_trackNames[track] = std::move(name);
+}
+
+void TraceExporter::addEvent(std::string_view name, std::string_view category, uint32_t track, double startUs, double durationUs,
+                             std::span<const Arg> args) {
+    if (!isOpen()) return;
+    Event event{std::string(name), std::string(category), track, startUs, durationUs, {}};
+    event.args.reserve(args.size());
+    for (const auto& arg : args) event.args.emplace_back(std::string(arg.key), arg.value);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_open.load(std::memory_order_relaxed)) return;
+    if (m_events.size() >= MAX_EVENTS) {
+        ++m_dropped;
+        return;
+    }
+    m_events.push_back(std::move(event));
+}
+
+double TraceExporter::toTraceUs(std::chrono::steady_clock::time_point time) const {
+    return std::chrono::duration<double, std::micro>(time - m_origin).count();
+}
+
+size_t TraceExporter::getEventCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_events.size();
+}
+
+size_t TraceExporter::getDroppedCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_dropped;
+}
+
+TraceExporter& TraceExporter::get() {
+    static TraceExporter instance;
+    return instance;
+}
+
+} // namespace Nexus
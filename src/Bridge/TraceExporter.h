@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Base.h"
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Nexus {
+
+/**
+ * @brief 把 CPU/GPU 区间写成 Chrome trace-event JSON (chrome://tracing, Perfetto 可直接打开)
+ *
+ * open 之后各线程以 addEvent 追加完整事件 ("ph":"X"), close 时一次写出; 未 open 时 addEvent 直接返回.
+ * 时间以 open 时刻为零点, 单位微秒; track 对应 trace 中的一行 (tid), 可用 setTrackName 命名.
+ */
+class TraceExporter {
+public:
+    struct Arg {
+        std::string_view key;
+        double value = 0.0;
+    };
+
+    static constexpr uint32_t TRACK_CPU = 1;
+    static constexpr uint32_t TRACK_GPU = 2;
+    static constexpr size_t MAX_EVENTS = 1u << 20; // 超出后丢弃新事件, 避免长时间运行耗尽内存
+
+    TraceExporter() = default;
+    ~TraceExporter();
+
+    TraceExporter(const TraceExporter&) = delete;
+    TraceExporter& operator=(const TraceExporter&) = delete;
+
+    /**
+     * @brief 开始记录, close 时写入 path
+     */
+    Status open(std::string path);
+
+    /**
+     * @brief 写出全部事件并停止记录
+     */
+    Status close();
+
+    bool isOpen() const { return m_open.load(std::memory_order_acquire); }
+
+    void setTrackName(uint32_t track, std::string name);
+
+    /**
+     * @brief 追加一个区间 (线程安全)
+     * @param startUs 相对 open 时刻的微秒数, 见 toTraceUs
+     */
+    void addEvent(std::string_view name, std::string_view category, uint32_t track, double startUs, double durationUs,
+                  std::span<const Arg> args = {});
+
+    double toTraceUs(std::chrono::steady_clock::time_point time) const;
+    double nowUs() const { return toTraceUs(std::chrono::steady_clock::now()); }
+
+    size_t getEventCount() const;
+    size_t getDroppedCount() const;
+
+    /**
+     * @brief 引擎共享的全局实例 (由 --trace 开启)
+     */
+    static TraceExporter& get();
+
+private:
+    struct Event {
+        std::string name;
+        std::string category;
+        uint32_t track = 0;
+        double startUs = 0.0;
+        double durationUs = 0.0;
+        std::vector<std::pair<std::string, double>> args;
+    };
+
+    std::atomic<bool> m_open{false};
+    std::string m_path;
+    std::chrono::steady_clock::time_point m_origin;
+    mutable std::mutex m_mutex;
+    std::vector<Event> m_events;
+    std::map<uint32_t, std::string> m_trackNames;
+    size_t m_dropped = 0;
+};
+
+} // namespace Nexus
@@ -1,9 +1,16 @@
 #include "VK_BindlessManager.h"
+#include "VK_FrameTimeline.h"
 #include "Log.h"
+#include <algorithm>
 
 namespace Nexus {
 
-VK_BindlessManager::VK_BindlessManager(vk::Device device) : m_device(device), m_pool(nullptr), m_layout(nullptr), m_set(nullptr) {}
+VK_BindlessManager::VK_BindlessManager(vk::Device device, const VK_FrameTimeline* frameTimeline)
+    : m_device(device), m_frameTimeline(frameTimeline), m_pool(nullptr), m_layout(nullptr), m_set(nullptr), m_textureLastUse(MAX_TEXTURES, 0) {
+    m_textureSlots.capacity = MAX_TEXTURES;
+    m_samplerSlots.capacity = MAX_SAMPLERS;
+    m_storageBufferSlots.capacity = MAX_STORAGE_BUFFERS;
+}
 
 VK_BindlessManager::~VK_BindlessManager() {
     shutdown();
@@ -12,7 +19,8 @@ VK_BindlessManager::~VK_BindlessManager() {
 Status VK_BindlessManager::initialize() {
     std::vector<vk::DescriptorPoolSize> poolSizes = {
         { vk::DescriptorType::eSampler, MAX_SAMPLERS },
-        { vk::DescriptorType::eSampledImage, MAX_TEXTURES }
+        { vk::DescriptorType::eSampledImage, MAX_TEXTURES },
+        { vk::DescriptorType::eStorageBuffer, MAX_STORAGE_BUFFERS }
     };
 
     vk::DescriptorPoolCreateInfo poolInfo;
@@ -26,7 +34,7 @@ Status VK_BindlessManager::initialize() {
     m_pool = poolRes.value;
     NX_CORE_INFO("Bindless Descriptor Pool created successfully.");
 
-    std::vector<vk::DescriptorSetLayoutBinding> bindings(2);
+    std::vector<vk::DescriptorSetLayoutBinding> bindings(3);
     bindings[0].binding = 0;
     bindings[0].descriptorType = vk::DescriptorType::eSampler;
     bindings[0].descriptorCount = MAX_SAMPLERS;
@@ -37,10 +45,15 @@ Status VK_BindlessManager::initialize() {
     bindings[1].descriptorCount = MAX_TEXTURES;
     bindings[1].stageFlags = vk::ShaderStageFlagBits::eAll;
 
-    std::vector<vk::DescriptorBindingFlags> bindingFlags = {
-        vk::DescriptorBindingFlagBits::ePartiallyBound | vk::DescriptorBindingFlagBits::eUpdateAfterBind,
-        vk::DescriptorBindingFlagBits::ePartiallyBound | vk::DescriptorBindingFlagBits::eUpdateAfterBind
-    };
+    bindings[2].binding = 2;
+    bindings[2].descriptorType = vk::DescriptorType::eStorageBuffer;
+    bindings[2].descriptorCount = MAX_STORAGE_BUFFERS;
+    bindings[2].stageFlags = vk::ShaderStageFlagBits::eAll;
+
+    // 同步点不再等待设备空闲, 写入未被在途帧使用的槽位需要 UpdateUnusedWhilePending (在用槽位见 flushWrites)
+    const vk::DescriptorBindingFlags slotFlags = vk::DescriptorBindingFlagBits::ePartiallyBound | vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+                                                 vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending;
+    std::vector<vk::DescriptorBindingFlags> bindingFlags = {slotFlags, slotFlags, slotFlags};
 
     vk::DescriptorSetLayoutBindingFlagsCreateInfo flagsInfo;
     flagsInfo.bindingCount = static_cast<uint32_t>(bindingFlags.size());
@@ -74,48 +87,249 @@ void VK_BindlessManager::shutdown() {
     if (m_pool) {
         m_device.destroyDescriptorPool(m_pool);
         m_pool = nullptr;
+        m_set = nullptr;
+    }
+    std::vector<PendingWrite> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        pending.swap(m_pendingWrites);
+        m_shadowSlots.clear();
+    }
+    // 关闭时设备已空闲, 被替换的图像可以直接销毁
+    for (auto& write : pending) {
+        for (auto& callback : write.onReplaced) callback();
+    }
+}
+
+bool VK_BindlessManager::SlotPool::allocate(uint32_t& index) {
+    if (!free.empty()) {
+        index = free.back();
+        free.pop_back();
+        return true;
     }
+    if (next >= capacity) return false;
+    index = next++;
+    return true;
+}
+
+void VK_BindlessManager::SlotPool::release(uint32_t index, uint64_t frameValue) {
+    retiring.emplace_back(index, frameValue);
+}
+
+void VK_BindlessManager::SlotPool::reclaim(uint64_t completedValue, const std::vector<uint64_t>* lastUse) {
+    for (auto it = retiring.begin(); it != retiring.end();) {
+        if (it->second <= completedValue && (!lastUse || (*lastUse)[it->first] <= completedValue)) {
+            free.push_back(it->first);
+            it = retiring.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+uint64_t VK_BindlessManager::getSubmittedValue() const {
+    if (!m_frameTimeline) return 0;
+    // 有渲染器时正在录制的帧可能已引用该槽位, 它提交时取下一个值
+    return m_frameTimeline->getSubmittedValue() + (m_deferLiveWrites ? 1 : 0);
+}
+
+uint64_t VK_BindlessManager::getCompletedValue() const {
+    return m_frameTimeline ? m_frameTimeline->getCompletedValue() : UINT64_MAX;
+}
+
+bool VK_BindlessManager::isSlotBusy(uint32_t index) const {
+    return m_frameTimeline && !m_frameTimeline->isComplete(m_textureLastUse[index]);
+}
+
+void VK_BindlessManager::releaseShadow(uint32_t index) {
+    auto it = m_shadowSlots.find(index);
+    if (it == m_shadowSlots.end()) return;
+    m_textureSlots.release(it->second.index, getSubmittedValue());
+    m_shadowSlots.erase(it);
 }
 
-uint32_t VK_BindlessManager::registerTexture(vk::ImageView view) {
-    uint32_t index = m_nextTextureIndex++;
-    
+StatusOr<uint32_t> VK_BindlessManager::registerTexture(vk::ImageView view) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint32_t index = 0;
+    if (!m_textureSlots.allocate(index)) return ResourceExhaustedError("Bindless texture table is full");
     vk::DescriptorImageInfo imageInfo;
     imageInfo.imageView = view;
     imageInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-
-    vk::WriteDescriptorSet write;
-    write.dstSet = m_set;
-    write.dstBinding = 1;
-    write.dstArrayElement = index;
-    write.descriptorType = vk::DescriptorType::eSampledImage;
-    write.descriptorCount = 1;
-    write.pImageInfo = &imageInfo;
-
-    m_device.updateDescriptorSets(1, &write, 0, nullptr);
-    NX_CORE_INFO("[Bindless] Registered Texture View: {}, Index: {}", (void*)view, index);
-    
+    queueWrite(1, index, imageInfo);
     return index;
 }
 
-uint32_t VK_BindlessManager::registerSampler(vk::Sampler sampler) {
-    uint32_t index = m_nextSamplerIndex++;
+void VK_BindlessManager::updateTexture(uint32_t index, vk::ImageView view, std::function<void()> onReplaced) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    vk::DescriptorImageInfo imageInfo;
+    imageInfo.imageView = view;
+    imageInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    PendingWrite& write = queueWrite(1, index, imageInfo);
+    write.live = true;
+    if (onReplaced) write.onReplaced.push_back(std::move(onReplaced));
+}
 
+void VK_BindlessManager::markTexturesUsed(std::span<const uint32_t> indices, uint64_t frameValue) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (uint32_t index : indices) {
+        if (index < MAX_TEXTURES) m_textureLastUse[index] = std::max(m_textureLastUse[index], frameValue);
+    }
+}
+
+void VK_BindlessManager::setDeferLiveWrites(bool defer) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_deferLiveWrites = defer;
+}
+
+void VK_BindlessManager::getTextureSlotTable(std::vector<uint32_t>& table) const {
+    table.resize(MAX_TEXTURES);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (uint32_t i = 0; i < MAX_TEXTURES; ++i) table[i] = i;
+    for (const auto& [index, shadow] : m_shadowSlots) table[index] = shadow.index;
+}
+
+void VK_BindlessManager::releaseTexture(uint32_t index) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // 未写入的改写不再写入 (其 view 随纹理一并销毁), 回调在下一次 flushWrites 执行 (旧图像经帧时间线延迟销毁); 影子槽位一并归还
+    for (auto& write : m_pendingWrites) {
+        if (write.binding == 1 && write.index == index) write.released = true;
+    }
+    releaseShadow(index);
+    m_textureSlots.release(index, getSubmittedValue());
+}
+
+StatusOr<uint32_t> VK_BindlessManager::registerSampler(vk::Sampler sampler) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint32_t index = 0;
+    if (!m_samplerSlots.allocate(index)) return ResourceExhaustedError("Bindless sampler table is full");
     vk::DescriptorImageInfo samplerInfo;
     samplerInfo.sampler = sampler;
+    queueWrite(0, index, samplerInfo);
+    return index;
+}
 
-    vk::WriteDescriptorSet write;
-    write.dstSet = m_set;
-    write.dstBinding = 0;
-    write.dstArrayElement = index;
-    write.descriptorType = vk::DescriptorType::eSampler;
-    write.descriptorCount = 1;
-    write.pImageInfo = &samplerInfo;
-
-    m_device.updateDescriptorSets(1, &write, 0, nullptr);
-    NX_CORE_INFO("[Bindless] Registered Sampler: {}, Index: {}", (void*)sampler, index);
+void VK_BindlessManager::releaseSampler(uint32_t index) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_samplerSlots.release(index, getSubmittedValue());
+}
 
+StatusOr<uint32_t> VK_BindlessManager::registerStorageBuffer(vk::Buffer buffer) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint32_t index = 0;
+    if (!m_storageBufferSlots.allocate(index)) return ResourceExhaustedError("Bindless storage buffer table is full");
+    queueWrite(2, index, vk::DescriptorImageInfo(), vk::DescriptorBufferInfo(buffer, 0, VK_WHOLE_SIZE));
     return index;
 }
 
+void VK_BindlessManager::releaseStorageBuffer(uint32_t index) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_storageBufferSlots.release(index, getSubmittedValue());
+}
+
+VK_BindlessManager::PendingWrite& VK_BindlessManager::queueWrite(uint32_t binding, uint32_t index, const vk::DescriptorImageInfo& info,
+                                                                  const vk::DescriptorBufferInfo& bufferInfo) {
+    // 同一槽位在一帧内多次写入时只保留最后一次 (回调全部保留)
+    for (auto& write : m_pendingWrites) {
+        if (write.binding == binding && write.index == index && !write.released) {
+            write.info = info;
+            write.bufferInfo = bufferInfo;
+            return write;
+        }
+    }
+    PendingWrite& write = m_pendingWrites.emplace_back();
+    write.binding = binding;
+    write.index = index;
+    write.info = info;
+    write.bufferInfo = bufferInfo;
+    return write;
+}
+
+void VK_BindlessManager::flushWrites(bool includeLive) {
+    std::vector<std::function<void()>> replaced;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_pendingWrites.empty() || !m_set) return;
+        includeLive = includeLive || !m_deferLiveWrites;
+
+        // 在用槽位仍被在途帧采样时不等待, 留到下一次 flushWrites; 已释放的只剩回调, 不必再等
+        auto deferred = [&](const PendingWrite& write) {
+            if (!write.live) return false;
+            return !includeLive || (!write.released && isSlotBusy(write.index));
+        };
+
+        // 有渲染器时新 view 先写入未用过的影子槽位, 之后的帧改为采样它, 原槽位的使用随在途帧完成而结束
+        std::vector<PendingWrite> shadowWrites;
+        if (includeLive && m_deferLiveWrites) {
+            for (const auto& write : m_pendingWrites) {
+                if (!deferred(write)) continue;
+                auto shadow = m_shadowSlots.find(write.index);
+                if (shadow != m_shadowSlots.end() && shadow->second.view == write.info.imageView) continue;
+                uint32_t index = 0;
+                // 表满时不建影子槽位, 只能等原槽位不再被采样
+                if (!m_textureSlots.allocate(index)) continue;
+                releaseShadow(write.index);
+                m_shadowSlots[write.index] = ShadowSlot{index, write.info.imageView};
+                PendingWrite& shadowWrite = shadowWrites.emplace_back();
+                shadowWrite.binding = 1;
+                shadowWrite.index = index;
+                shadowWrite.info = write.info;
+            }
+        }
+        m_pendingWrites.insert(m_pendingWrites.end(), std::make_move_iterator(shadowWrites.begin()), std::make_move_iterator(shadowWrites.end()));
+
+        std::vector<vk::WriteDescriptorSet> writes;
+        writes.reserve(m_pendingWrites.size());
+        auto flushed = std::stable_partition(m_pendingWrites.begin(), m_pendingWrites.end(), deferred);
+        for (auto it = flushed; it != m_pendingWrites.end(); ++it) {
+            for (auto& callback : it->onReplaced) replaced.push_back(std::move(callback));
+            if (it->released) continue;
+            // 原槽位改写后不再需要影子槽位
+            if (it->live) releaseShadow(it->index);
+            vk::WriteDescriptorSet& write = writes.emplace_back();
+            write.dstSet = m_set;
+            write.dstBinding = it->binding;
+            write.dstArrayElement = it->index;
+            write.descriptorCount = 1;
+            if (it->binding == 2) {
+                write.descriptorType = vk::DescriptorType::eStorageBuffer;
+                write.pBufferInfo = &it->bufferInfo;
+            } else {
+                write.descriptorType = it->binding == 0 ? vk::DescriptorType::eSampler : vk::DescriptorType::eSampledImage;
+                write.pImageInfo = &it->info;
+            }
+        }
+        if (!writes.empty()) m_device.updateDescriptorSets(static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+        m_lastFlushWrites = static_cast<uint32_t>(writes.size());
+        m_pendingWrites.erase(flushed, m_pendingWrites.end());
+    }
+    // 在锁外执行, 回调可以再次访问本管理器 (如经 retire 销毁图像)
+    for (auto& callback : replaced) callback();
+}
+
+void VK_BindlessManager::endFrame() {
+    flushWrites(false);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_frameIndex;
+    const uint64_t completed = getCompletedValue();
+    m_textureSlots.reclaim(completed, &m_textureLastUse);
+    m_samplerSlots.reclaim(completed);
+    m_storageBufferSlots.reclaim(completed);
+}
+
+VK_BindlessManager::Stats VK_BindlessManager::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats;
+    stats.texturesInUse = m_textureSlots.inUse();
+    stats.texturesPendingFree = static_cast<uint32_t>(m_textureSlots.retiring.size());
+    stats.textureHighWater = m_textureSlots.next;
+    stats.samplersInUse = m_samplerSlots.inUse();
+    stats.samplersPendingFree = static_cast<uint32_t>(m_samplerSlots.retiring.size());
+    stats.samplerHighWater = m_samplerSlots.next;
+    stats.storageBuffersInUse = m_storageBufferSlots.inUse();
+    stats.storageBuffersPendingFree = static_cast<uint32_t>(m_storageBufferSlots.retiring.size());
+    stats.lastFlushWrites = m_lastFlushWrites;
+    stats.frameIndex = m_frameIndex;
+    return stats;
+}
+
 } // namespace Nexus
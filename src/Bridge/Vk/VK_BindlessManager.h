@@ -3,16 +3,49 @@
 #include "Base.h"
 #include <vulkan/vulkan.hpp>
 #include <vector>
-#include <map>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <unordered_map>
 
 namespace Nexus {
 
+class VK_FrameTimeline;
+
 /**
  * @brief 全局 Bindless 资源管理器
+ *
+ * binding 0 为采样器, 1 为纹理, 2 为存储缓冲区 (着色器中按 RWByteAddressBuffer 访问).
+ * 槽位由空闲链表分配; 释放时记录帧时间线上已提交的值, 该值 (纹理槽位还有最近采样它的帧) 完成后才复用.
+ * 描述符写入先排队, 在 flushWrites (每帧 VK_Context::sync 与渲染器提交前) 中合并为一次 updateDescriptorSets;
+ * 各 binding 带 UpdateUnusedWhilePending, 写入时在途帧可以仍在执行, 但不得使用被写入的槽位:
+ * 新分配的槽位没有在途帧使用; 改写在用槽位 (updateTexture) 时不等待, 最近使用它的帧 (markTexturesUsed) 未完成则留在队列中,
+ * 下一次 flushWrites 重试. 有渲染器时, 其间新 view 先写入一个未用过的影子槽位, 渲染器经 getTextureSlotTable 改用影子槽位,
+ * 原槽位不再被新帧采样, 在途帧完成后即可改写; 改写后影子槽位随之释放.
  */
 class VK_BindlessManager {
 public:
-    VK_BindlessManager(vk::Device device);
+    /**
+     * @brief 槽位占用统计
+     */
+    struct Stats {
+        uint32_t texturesInUse = 0;
+        uint32_t texturesPendingFree = 0;
+        uint32_t textureHighWater = 0;
+        uint32_t samplersInUse = 0;
+        uint32_t samplersPendingFree = 0;
+        uint32_t samplerHighWater = 0;
+        uint32_t storageBuffersInUse = 0;
+        uint32_t storageBuffersPendingFree = 0;
+        uint32_t lastFlushWrites = 0; // 上一次 flushWrites 合并的写入数
+        uint64_t frameIndex = 0;
+    };
+
+    /**
+     * @param frameTimeline 判断在用槽位与释放的槽位是否仍被在途帧使用; 为空时视为没有在途帧 (调用方保证)
+     */
+    VK_BindlessManager(vk::Device device, const VK_FrameTimeline* frameTimeline = nullptr);
     ~VK_BindlessManager();
 
     Status initialize();
@@ -20,29 +53,141 @@ public:
 
     /**
      * @brief 注册纹理到全局描述符集
-     * @return 返回在全局数组中的索引
+     * @return 返回在全局数组中的索引; 表已满时返回 ResourceExhausted
+     */
+    StatusOr<uint32_t> registerTexture(vk::ImageView view);
+
+    /**
+     * @brief 将已分配的纹理槽位指向新的 view (异步上传完成, mip 替换, 换出时调用)
+     *
+     * 写入推迟到 flushWrites, 最近使用该槽位的帧在帧时间线上完成之前一直留在队列中.
+     * @param onReplaced 写入后调用: 此后提交的帧不再经该槽位访问旧 view, 可据此 (经帧时间线延迟) 销毁旧图像
+     */
+    void updateTexture(uint32_t index, vk::ImageView view, std::function<void()> onReplaced = {});
+
+    /**
+     * @brief 记录帧 frameValue (帧时间线的值) 采样了这些纹理槽位, 须在该帧提交前且在本帧的 flushWrites 之后调用
      */
-    uint32_t registerTexture(vk::ImageView view);
+    void markTexturesUsed(std::span<const uint32_t> indices, uint64_t frameValue);
+
+    /**
+     * @brief 有渲染器时由其在提交前 flushWrites 改写在用槽位 (并建立影子槽位), 同步点 (endFrame) 只写新分配的槽位,
+     *        保证写入与 markTexturesUsed, 帧提交在同一线程上有序
+     */
+    void setDeferLiveWrites(bool defer);
+
+    /**
+     * @brief 纹理槽位到本帧应采样的槽位的映射 (大小 MAX_TEXTURES): 改写尚在排队的槽位映射到其影子槽位, 其余为恒等
+     */
+    void getTextureSlotTable(std::vector<uint32_t>& table) const;
+
+    /**
+     * @brief 归还纹理槽位, 已提交的帧与最近采样它的帧完成后可被复用
+     */
+    void releaseTexture(uint32_t index);
 
     /**
      * @brief 注册采样器到全局描述符集
+     * @return 表已满时返回 ResourceExhausted
+     */
+    StatusOr<uint32_t> registerSampler(vk::Sampler sampler);
+
+    /**
+     * @brief 归还采样器槽位, 已提交的帧完成后可被复用
+     */
+    void releaseSampler(uint32_t index);
+
+    /**
+     * @brief 注册存储缓冲区 (整个缓冲区) 到全局描述符集
+     * @return 表已满时返回 ResourceExhausted
+     */
+    StatusOr<uint32_t> registerStorageBuffer(vk::Buffer buffer);
+
+    /**
+     * @brief 归还存储缓冲区槽位, 已提交的帧完成后可被复用
+     */
+    void releaseStorageBuffer(uint32_t index);
+
+    /**
+     * @brief 提交排队的描述符写入, 须在提交使用这些槽位的命令前调用; 不等待 GPU
+     * @param includeLive 同时改写在用槽位 (仍被在途帧使用的留到下一次)
      */
-    uint32_t registerSampler(vk::Sampler sampler);
+    void flushWrites(bool includeLive = true);
+
+    /**
+     * @brief 帧结束: 提交写入, 推进帧号并回收在途帧已不再使用的槽位
+     */
+    void endFrame();
+
+    Stats getStats() const;
 
     vk::DescriptorSetLayout getLayout() const { return m_layout; }
     vk::DescriptorSet getSet() const { return m_set; }
 
     static constexpr uint32_t MAX_TEXTURES = 1024;
     static constexpr uint32_t MAX_SAMPLERS = 64;
+    static constexpr uint32_t MAX_STORAGE_BUFFERS = 256;
 
 private:
+    /**
+     * @brief 固定容量的槽位分配器
+     */
+    struct SlotPool {
+        uint32_t capacity = 0;
+        uint32_t next = 0; // 从未分配过的最小槽位
+        std::vector<uint32_t> free;
+        std::deque<std::pair<uint32_t, uint64_t>> retiring; // (槽位, 释放时已提交的帧时间线值)
+
+        bool allocate(uint32_t& index);
+        void release(uint32_t index, uint64_t frameValue);
+        /**
+         * @param lastUse 非空时还须最近采样该槽位的帧完成
+         */
+        void reclaim(uint64_t completedValue, const std::vector<uint64_t>* lastUse = nullptr);
+        uint32_t inUse() const { return next - (uint32_t)free.size() - (uint32_t)retiring.size(); }
+    };
+
+    struct PendingWrite {
+        uint32_t binding = 0;
+        uint32_t index = 0;
+        vk::DescriptorImageInfo info;
+        vk::DescriptorBufferInfo bufferInfo; // 仅 binding 2
+        bool live = false;                   // 改写在用槽位, 使用它的帧完成后才写入
+        bool released = false;               // 写入前槽位已释放: 不再写入, 只执行回调
+        std::vector<std::function<void()>> onReplaced;
+    };
+
+    /**
+     * @brief 排队改写期间代替原槽位被采样的槽位
+     */
+    struct ShadowSlot {
+        uint32_t index = 0;
+        vk::ImageView view;
+    };
+
+    PendingWrite& queueWrite(uint32_t binding, uint32_t index, const vk::DescriptorImageInfo& info,
+                             const vk::DescriptorBufferInfo& bufferInfo = vk::DescriptorBufferInfo());
+    uint64_t getSubmittedValue() const;
+    uint64_t getCompletedValue() const;
+    bool isSlotBusy(uint32_t index) const;
+    void releaseShadow(uint32_t index);
+
     vk::Device m_device;
+    const VK_FrameTimeline* m_frameTimeline;
     vk::DescriptorPool m_pool;
     vk::DescriptorSetLayout m_layout;
     vk::DescriptorSet m_set;
 
-    uint32_t m_nextTextureIndex = 0;
-    uint32_t m_nextSamplerIndex = 0;
+    mutable std::mutex m_mutex;
+    SlotPool m_textureSlots;
+    SlotPool m_samplerSlots;
+    SlotPool m_storageBufferSlots;
+    std::vector<PendingWrite> m_pendingWrites;
+    std::vector<uint64_t> m_textureLastUse; // 纹理槽位 -> 最近采样它的帧
+    std::unordered_map<uint32_t, ShadowSlot> m_shadowSlots; // 改写排队中的原槽位 -> 影子槽位
+    bool m_deferLiveWrites = false;
+    uint32_t m_lastFlushWrites = 0;
+    uint64_t m_frameIndex = 0;
 };
 
 } // namespace Nexus
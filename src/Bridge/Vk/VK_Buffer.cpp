@@ -24,25 +24,19 @@ Status VK_Buffer::create(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::Me
     }
     m_buffer = result.value;
 
-    vk::MemoryRequirements memRequirements = device.getBufferMemoryRequirements(m_buffer);
-    vk::MemoryAllocateInfo allocInfo(memRequirements.size, m_context->findMemoryType(memRequirements.memoryTypeBits, properties));
-
-    auto allocResult = device.allocateMemory(allocInfo);
-    if (allocResult.result != vk::Result::eSuccess) {
-        return InternalError("Failed to allocate buffer memory");
-    }
-    m_memory = allocResult.value;
-
-    device.bindBufferMemory(m_buffer, m_memory, 0);
+    NX_ASSIGN_OR_RETURN(m_allocation, m_context->getMemoryAllocator()->allocateForBuffer(m_buffer, properties));
 
     return OkStatus();
 }
 
 /**
- * @brief 将数据上传至缓冲区
+ * @brief 将数据上传至缓冲区, device-local 缓冲区经上传上下文排队拷贝
  */
 Status VK_Buffer::uploadData(const void* data, uint64_t size, uint64_t offset) {
     if (offset + size > (uint64_t)m_size) return InvalidArgumentError("Data size + offset exceeds buffer size");
+    if (!m_allocation.mapped && m_context->getUploadContext()) {
+        return m_context->getUploadContext()->uploadBuffer(m_buffer, offset, data, size);
+    }
     void* mappedData = map();
     if (!mappedData) return InternalError("Failed to map buffer memory");
     memcpy((uint8_t*)mappedData + offset, data, (size_t)size);
@@ -50,22 +44,23 @@ Status VK_Buffer::uploadData(const void* data, uint64_t size, uint64_t offset) {
     return OkStatus();
 }
 void* VK_Buffer::map() {
-    void* data;
-    if (m_context->getDevice().mapMemory(m_memory, 0, m_size, {}, &data) != vk::Result::eSuccess) return nullptr;
-    return data;
+    return m_allocation.mapped;
 }
 void VK_Buffer::unmap() {
-    m_context->getDevice().unmapMemory(m_memory);
+    // 持久映射, 仅非 coherent 内存需要刷新
+    if (m_allocation) m_context->getMemoryAllocator()->flush(m_allocation);
 }
 void VK_Buffer::destroy() {
-    if (m_buffer) {
-        m_context->getDevice().destroyBuffer(m_buffer);
-        m_buffer = nullptr;
-    }
-    if (m_memory) {
-        m_context->getDevice().freeMemory(m_memory);
-        m_memory = nullptr;
-    }
+    if (!m_buffer && !m_allocation) return;
+    if (m_buffer && !m_allocation.mapped && m_context->getUploadContext()) m_context->getUploadContext()->discardPending(m_buffer);
+    // 在途帧或已提交的上传可能仍在访问, 经帧时间线延迟销毁
+    VK_Context* context = m_context;
+    context->retire([context, buffer = m_buffer, allocation = m_allocation]() mutable {
+        if (buffer) context->getDevice().destroyBuffer(buffer);
+        if (allocation && context->getMemoryAllocator()) context->getMemoryAllocator()->free(allocation);
+    });
+    m_buffer = nullptr;
+    m_allocation = VK_MemoryAllocator::Allocation{};
 }
 
 } // namespace Nexus
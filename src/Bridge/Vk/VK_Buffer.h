@@ -2,6 +2,7 @@
 
 #include "Base.h"
 #include "Interfaces.h"
+#include "VK_MemoryAllocator.h"
 #include <vulkan/vulkan.hpp>
 
 namespace Nexus {
@@ -10,6 +11,10 @@ class VK_Context;
 
 /**
  * @brief Vulkan 缓冲区薄抽象
+ *
+ * 内存来自 VK_MemoryAllocator 的子分配; host-visible 缓冲区持久映射, map/unmap 不再调用 vkMapMemory.
+ * device-local 缓冲区不可映射, uploadData 经 VK_UploadContext 排队, 在下一次 flush 时拷贝.
+ * destroy 经 VK_Context::retire 延迟到在途帧完成后才真正释放.
  */
 class VK_Buffer : public IBuffer {
 public:
@@ -23,11 +28,12 @@ public:
     Status uploadData(const void* data, uint64_t size, uint64_t offset = 0) override;
     void destroy();
     vk::Buffer getHandle() const { return m_buffer; }
-    vk::DeviceMemory getMemory() const { return m_memory; }
+    vk::DeviceMemory getMemory() const { return m_allocation.memory; }
+    vk::DeviceSize getMemoryOffset() const { return m_allocation.offset; }
 private:
     VK_Context* m_context;
     vk::Buffer m_buffer;
-    vk::DeviceMemory m_memory;
+    VK_MemoryAllocator::Allocation m_allocation;
     vk::DeviceSize m_size = 0;
 };
 
@@ -38,7 +38,7 @@ void VK_CommandBuffer::transitionImageLayout(ITexture* texture, ImageLayout oldL
     barrier.image = vkTexture->getImage();
     barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
     barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
     barrier.subresourceRange.baseArrayLayer = 0;
     barrier.subresourceRange.layerCount = 1;
 
@@ -4,6 +4,7 @@
 #include "VK_Texture.h"
 #include "Config.h"
 #include "Log.h"
+#include <algorithm>
 #include <iostream>
 #include <set>
 
@@ -14,7 +15,7 @@
 
 namespace Nexus {
 
-VK_Context::VK_Context(bool enableValidation) : m_instance(nullptr), m_surface(nullptr), m_debugMessenger(nullptr), m_physicalDevice(nullptr), m_device(nullptr), m_graphicsQueue(nullptr), m_enableValidationLayers(enableValidation) {
+VK_Context::VK_Context(bool enableValidation) : m_instance(nullptr), m_surface(nullptr), m_debugMessenger(nullptr), m_physicalDevice(nullptr), m_device(nullptr), m_graphicsQueue(nullptr), m_transferQueue(nullptr), m_enableValidationLayers(enableValidation) {
 #ifdef NDEBUG
     m_enableValidationLayers = false;
 #endif
@@ -35,16 +36,7 @@ Status VK_Context::initializeWindowSurface(void* windowNativeHandle) {
     NX_RETURN_IF_ERROR(createSurface(windowNativeHandle));
     NX_RETURN_IF_ERROR(selectPhysicalDevice());
     NX_RETURN_IF_ERROR(createLogicalDevice());
-
-    vk::CommandPoolCreateInfo poolInfo({}, m_graphicsQueueFamilyIndex);
-    auto poolResult = m_device.createCommandPool(poolInfo);
-    if (poolResult.result != vk::Result::eSuccess) return InternalError("Failed to create command pool");
-    m_commandPool = poolResult.value;
-
-    m_bindlessManager = std::make_unique<VK_BindlessManager>(m_device);
-    NX_RETURN_IF_ERROR(m_bindlessManager->initialize());
-
-    return OkStatus();
+    return createDeviceResources();
 }
 
 Status VK_Context::initializeHeadless() {
@@ -54,30 +46,82 @@ Status VK_Context::initializeHeadless() {
     }
     NX_RETURN_IF_ERROR(selectPhysicalDevice());
     NX_RETURN_IF_ERROR(createLogicalDevice());
+    NX_RETURN_IF_ERROR(createDeviceResources());
+    NX_CORE_INFO("Headless Context Initialized Successfully");
+    return OkStatus();
+}
+
+Status VK_Context::createDeviceResources() {
     NX_CORE_INFO("Creating Command Pool");
     vk::CommandPoolCreateInfo poolInfo({}, m_graphicsQueueFamilyIndex);
     auto poolResult = m_device.createCommandPool(poolInfo);
     if (poolResult.result != vk::Result::eSuccess) return InternalError("Failed to create command pool");
     m_commandPool = poolResult.value;
+    m_frameTimeline = std::make_unique<VK_FrameTimeline>(m_device);
+    NX_RETURN_IF_ERROR(m_frameTimeline->initialize());
+    m_memoryAllocator = std::make_unique<VK_MemoryAllocator>(m_physicalDevice, m_device, m_memoryBudgetSupported);
+    for (const auto& heap : m_memoryAllocator->getHeapBudgets()) {
+        if (heap.deviceLocal) {
+            NX_CORE_INFO("Device-local heap: {} MB, budget {} MB{}", heap.size >> 20, heap.budget >> 20,
+                         m_memoryBudgetSupported ? "" : " (estimated, VK_EXT_memory_budget unavailable)");
+        }
+    }
+    m_uploadContext = std::make_unique<VK_UploadContext>(this);
+    NX_RETURN_IF_ERROR(m_uploadContext->initialize());
     NX_CORE_INFO("Initializing Bindless Manager");
-    m_bindlessManager = std::make_unique<VK_BindlessManager>(m_device);
+    m_bindlessManager = std::make_unique<VK_BindlessManager>(m_device, m_frameTimeline.get());
     NX_RETURN_IF_ERROR(m_bindlessManager->initialize());
-    NX_CORE_INFO("Headless Context Initialized Successfully");
+    m_samplerCache = std::make_unique<VK_SamplerCache>(m_device, m_bindlessManager.get());
+    m_textureStreamer = std::make_unique<VK_TextureStreamer>(this);
+    NX_RETURN_IF_ERROR(m_textureStreamer->initialize());
+    // 管线缓存只影响创建速度, 不可用时以空句柄继续
+    auto pipelineCache = std::make_unique<VK_PipelineCache>(m_physicalDevice, m_device);
+    if (auto status = pipelineCache->initialize(PIPELINE_CACHE_PATH); status.ok()) {
+        m_pipelineCache = std::move(pipelineCache);
+    } else {
+        NX_CORE_WARN("Pipeline cache disabled: {}", status.message());
+    }
     return OkStatus();
 }
 
 void VK_Context::sync() {
     if (m_device) {
-        try {
-            (void)m_device.waitIdle();
-        } catch (...) {
-            // Ignore errors during sync/shutdown
-        }
+        // 不等待设备空闲: 销毁在途帧已不再引用的资源, 切换上传完成纹理的 bindless 槽位
+        // (被替换的图像经 retire 延迟销毁), 并提交本帧积累的上传
+        if (m_frameTimeline) m_frameTimeline->collect();
+        if (m_textureStreamer) m_textureStreamer->flush();
+        if (m_uploadContext) m_uploadContext->flush();
+        if (m_bindlessManager) m_bindlessManager->endFrame();
+    }
+}
+
+void VK_Context::retire(std::function<void()> destroy) {
+    if (!m_frameTimeline) {
+        destroy();
+        return;
     }
+    // 最近一帧之后还有未完成的上传时等下一帧: 图形队列上它的信号晚于此前提交的所有上传
+    uint64_t value = m_frameTimeline->getSubmittedValue();
+    if (m_uploadContext && !m_uploadContext->isComplete(m_uploadContext->getLastTicket())) ++value;
+    m_frameTimeline->retire(value, std::move(destroy));
 }
 
 void VK_Context::shutdown() {
     if (m_device) {
+        // 关闭时允许等待设备空闲, 之后执行全部延迟销毁, 此后的 retire 立即执行
+        (void)m_device.waitIdle();
+        m_frameTimeline.reset();
+        if (m_textureStreamer) {
+            m_textureStreamer.reset();
+        }
+        if (m_uploadContext) {
+            m_uploadContext.reset();
+        }
+        if (m_samplerCache) {
+            m_samplerCache.reset();
+        }
+        // 析构时写回磁盘
+        m_pipelineCache.reset();
         if (m_bindlessManager) {
             m_bindlessManager.reset();
         }
@@ -85,6 +129,8 @@ void VK_Context::shutdown() {
             m_device.destroyCommandPool(m_commandPool);
             m_commandPool = nullptr;
         }
+        // 所有子分配都来自这里, 须在上面的管理器释放完内存后销毁
+        m_memoryAllocator.reset();
         m_device.destroy();
         m_device = nullptr;
     }
@@ -245,8 +291,19 @@ Status VK_Context::createLogicalDevice() {
 
     if (graphicsFamily == -1) return InternalError("Graphics queue family not found");
 
+    // 只有 transfer 能力的队列族通常对应独立的 DMA 引擎, 优先于同时支持 compute 的族
+    int transferFamily = -1;
+    for (int i = 0; i < static_cast<int>(queueFamilies.size()); i++) {
+        const auto flags = queueFamilies[i].queueFlags;
+        if (!(flags & vk::QueueFlagBits::eTransfer) || (flags & vk::QueueFlagBits::eGraphics)) continue;
+        if (transferFamily == -1 || !(flags & vk::QueueFlagBits::eCompute)) transferFamily = i;
+        if (!(flags & vk::QueueFlagBits::eCompute)) break;
+    }
+
     float queuePriority = 1.0f;
-    vk::DeviceQueueCreateInfo queueCreateInfo({}, graphicsFamily, 1, &queuePriority);
+    std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
+    queueCreateInfos.emplace_back(vk::DeviceQueueCreateFlags{}, graphicsFamily, 1, &queuePriority);
+    if (transferFamily != -1) queueCreateInfos.emplace_back(vk::DeviceQueueCreateFlags{}, transferFamily, 1, &queuePriority);
 
     vk::PhysicalDeviceVulkan13Features features13{};
     features13.dynamicRendering = VK_TRUE;
@@ -263,6 +320,16 @@ Status VK_Context::createLogicalDevice() {
     features12.descriptorBindingVariableDescriptorCount = VK_TRUE;
 
     features12.descriptorBindingVariableDescriptorCount = VK_TRUE;
+    features12.timelineSemaphore = VK_TRUE;
+    // GPU 剔除后以 drawIndexedIndirectCount 读取可见数量, 不支持时剔除结果以 instanceCount = 0 表示
+    {
+        vk::PhysicalDeviceVulkan12Features supported12{};
+        vk::PhysicalDeviceFeatures2 supported;
+        supported.pNext = &supported12;
+        m_physicalDevice.getFeatures2(&supported);
+        m_drawIndirectCountSupported = supported12.drawIndirectCount == VK_TRUE;
+    }
+    features12.drawIndirectCount = m_drawIndirectCountSupported ? VK_TRUE : VK_FALSE;
 
     auto availableExtensionsResult = m_physicalDevice.enumerateDeviceExtensionProperties();
     std::set<std::string> availableExtSet;
@@ -277,6 +344,7 @@ Status VK_Context::createLogicalDevice() {
     bool hasFloatControls = availableExtSet.count(VK_KHR_SHADER_FLOAT_CONTROLS_EXTENSION_NAME);
 
     m_meshShaderSupported = hasMeshShader && hasSpirv14 && hasFloatControls;
+    m_memoryBudgetSupported = availableExtSet.count(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) > 0;
 
     vk::PhysicalDeviceMeshShaderFeaturesEXT meshFeatures{};
     if (m_meshShaderSupported) {
@@ -298,16 +366,30 @@ Status VK_Context::createLogicalDevice() {
     } else {
         NX_CORE_INFO("Mesh Shader Extensions Not Supported, falling back.");
     }
+    if (m_memoryBudgetSupported) deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
     if (m_surface) deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
     vk::PhysicalDeviceFeatures deviceFeatures{};
     deviceFeatures.drawIndirectFirstInstance = VK_TRUE;
     deviceFeatures.multiDrawIndirect = VK_TRUE;
-    deviceFeatures.samplerAnisotropy = VK_TRUE;
+    // lavapipe 等软件实现可能不支持各向异性, 按需开启
+    m_samplerAnisotropySupported = m_physicalDevice.getFeatures().samplerAnisotropy == VK_TRUE;
+    m_deviceMaxAnisotropy = m_physicalDevice.getProperties().limits.maxSamplerAnisotropy;
+    deviceFeatures.samplerAnisotropy = m_samplerAnisotropySupported ? VK_TRUE : VK_FALSE;
+    // BC 纹理在不支持的设备上由 VK_Texture 在 CPU 解压
+    m_textureCompressionBCSupported = m_physicalDevice.getFeatures().textureCompressionBC == VK_TRUE;
+    deviceFeatures.textureCompressionBC = m_textureCompressionBCSupported ? VK_TRUE : VK_FALSE;
+    // GPU 性能分析: 时间戳由队列族的 timestampValidBits 决定, 管线统计查询跨 executeCommands 需 inheritedQueries
+    m_pipelineStatisticsSupported = m_physicalDevice.getFeatures().pipelineStatisticsQuery == VK_TRUE;
+    m_inheritedQueriesSupported = m_physicalDevice.getFeatures().inheritedQueries == VK_TRUE;
+    deviceFeatures.pipelineStatisticsQuery = m_pipelineStatisticsSupported ? VK_TRUE : VK_FALSE;
+    deviceFeatures.inheritedQueries = m_inheritedQueriesSupported ? VK_TRUE : VK_FALSE;
+    m_timestampValidBits = queueFamilies[graphicsFamily].timestampValidBits;
+    m_timestampPeriod = m_physicalDevice.getProperties().limits.timestampPeriod;
 
     vk::DeviceCreateInfo createInfo;
     createInfo.pNext = m_meshShaderSupported ? &meshFeatures : (void*)&features12;
-    createInfo.queueCreateInfoCount = 1;
-    createInfo.pQueueCreateInfos = &queueCreateInfo;
+    createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
+    createInfo.pQueueCreateInfos = queueCreateInfos.data();
     createInfo.pEnabledFeatures = &deviceFeatures;
     createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
     createInfo.ppEnabledExtensionNames = deviceExtensions.data();
@@ -325,11 +407,33 @@ Status VK_Context::createLogicalDevice() {
     m_device = result.value;
     m_graphicsQueueFamilyIndex = static_cast<uint32_t>(graphicsFamily);
     m_graphicsQueue = m_device.getQueue(m_graphicsQueueFamilyIndex, 0);
+    m_transferQueueFamilyIndex = transferFamily != -1 ? static_cast<uint32_t>(transferFamily) : m_graphicsQueueFamilyIndex;
+    m_transferQueue = m_device.getQueue(m_transferQueueFamilyIndex, 0);
 
-    NX_CORE_INFO("Vulkan Logical Device created successfully (Graphics Family: {})", graphicsFamily);
+    NX_CORE_INFO("Vulkan Logical Device created successfully (Graphics Family: {}, Transfer Family: {})", graphicsFamily,
+                 m_transferQueueFamilyIndex);
     return OkStatus();
 }
 
+float VK_Context::getSamplerAnisotropy() const {
+    if (!m_samplerAnisotropySupported || m_requestedAnisotropy <= 1.0f) return 1.0f;
+    return std::min(m_requestedAnisotropy, m_deviceMaxAnisotropy);
+}
+
+bool VK_Context::supportsLinearBlit(vk::Format format) const {
+    vk::FormatProperties formatProps = m_physicalDevice.getFormatProperties(format);
+    const vk::FormatFeatureFlags blitFeatures = vk::FormatFeatureFlagBits::eBlitSrc | vk::FormatFeatureFlagBits::eBlitDst |
+                                                vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+    return (formatProps.optimalTilingFeatures & blitFeatures) == blitFeatures;
+}
+
+bool VK_Context::supportsCompressedFormat(vk::Format format) const {
+    if (!m_textureCompressionBCSupported) return false;
+    vk::FormatProperties formatProps = m_physicalDevice.getFormatProperties(format);
+    const vk::FormatFeatureFlags sampleFeatures = vk::FormatFeatureFlagBits::eSampledImage | vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+    return (formatProps.optimalTilingFeatures & sampleFeatures) == sampleFeatures;
+}
+
 uint32_t VK_Context::findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) {
     vk::PhysicalDeviceMemoryProperties memProperties = m_physicalDevice.getMemoryProperties();
     for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
@@ -355,26 +459,35 @@ std::unique_ptr<ITexture> VK_Context::createTexture(uint32_t width, uint32_t hei
     (void)tex->create(width, height, format, usage);
     return tex;
 }
-vk::CommandBuffer VK_Context::beginSingleTimeCommands() {
-    vk::CommandBufferAllocateInfo allocInfo(m_commandPool, vk::CommandBufferLevel::ePrimary, 1);
-    vk::CommandBuffer commandBuffer = m_device.allocateCommandBuffers(allocInfo).value[0];
-
-    vk::CommandBufferBeginInfo beginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
-    (void)commandBuffer.begin(beginInfo);
-    return commandBuffer;
+std::unique_ptr<ITexture> VK_Context::createTextureAsync(ITexture* placeholder) {
+    auto* vkPlaceholder = dynamic_cast<VK_Texture*>(placeholder);
+    if (!vkPlaceholder || !m_textureStreamer) return nullptr;
+    auto tex = std::make_unique<VK_Texture>(this);
+    if (!tex->createDeferred(vkPlaceholder).ok()) return nullptr;
+    return tex;
 }
 
-void VK_Context::endSingleTimeCommands(vk::CommandBuffer commandBuffer) {
-    (void)commandBuffer.end();
+void VK_Context::uploadTextureAsync(ITexture* texture, ImageData&& imageData) {
+    auto* vkTexture = static_cast<VK_Texture*>(texture);
+    if (m_textureStreamer && vkTexture) {
+        m_textureStreamer->enqueue(vkTexture, std::move(imageData));
+    }
+}
 
-    vk::SubmitInfo submitInfo;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
+void* VK_Context::mapTextureUpload(ITexture* texture, uint32_t width, uint32_t height) {
+    auto* vkTexture = static_cast<VK_Texture*>(texture);
+    if (!m_textureStreamer || !vkTexture || vkTexture->isResident()) return nullptr;
+    return m_textureStreamer->mapUpload(vkTexture, width, height);
+}
 
-    (void)m_graphicsQueue.submit(submitInfo, nullptr);
-    (void)m_graphicsQueue.waitIdle();
+void VK_Context::commitTextureUpload(ITexture* texture, bool success) {
+    if (m_textureStreamer) m_textureStreamer->commitUpload(static_cast<VK_Texture*>(texture), success);
+}
 
-    m_device.freeCommandBuffers(m_commandPool, 1, &commandBuffer);
+bool VK_Context::evictTexture(ITexture* texture, ITexture* placeholder) {
+    auto* vkTexture = static_cast<VK_Texture*>(texture);
+    if (!vkTexture || !placeholder) return false;
+    return vkTexture->evict(static_cast<VK_Texture*>(placeholder)).ok();
 }
 
 static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
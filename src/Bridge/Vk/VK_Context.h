@@ -1,7 +1,15 @@
 #pragma once
 #include "VK_BindlessManager.h"
+#include "VK_FrameTimeline.h"
+#include "VK_MemoryAllocator.h"
+#include "VK_PipelineCache.h"
+#include "VK_SamplerCache.h"
+#include "VK_TextureStreamer.h"
+#include "VK_UploadContext.h"
 #include "../Interfaces.h"
 #include <vulkan/vulkan.hpp>
+#include <functional>
+#include <mutex>
 #include <vector>
 #include <string>
 
@@ -31,7 +39,7 @@ public:
     virtual Status initializeHeadless() override;
 
     /**
-     * @brief 同步 RHI 线程与逻辑线程 (汇聚段)
+     * @brief 同步 RHI 线程与逻辑线程 (汇聚段), 不等待设备空闲
      */
     virtual void sync() override;
 
@@ -43,20 +51,98 @@ public:
     vk::Device getDevice() const { return m_device; }
     vk::PhysicalDevice getPhysicalDevice() const { return m_physicalDevice; }
     vk::Queue getGraphicsQueue() const { return m_graphicsQueue; }
+    vk::Queue getTransferQueue() const { return m_transferQueue; }
     vk::Instance getInstance() const { return m_instance; }
     vk::SurfaceKHR getSurface() const { return m_surface; }
     vk::CommandPool getCommandPool() const { return m_commandPool; }
     virtual uint32_t getGraphicsQueueFamilyIndex() const override { return m_graphicsQueueFamilyIndex; }
+    /**
+     * @brief 独立 transfer 队列族, 设备没有时等于图形队列族
+     */
+    uint32_t getTransferQueueFamilyIndex() const { return m_transferQueueFamilyIndex; }
+
+    /**
+     * @brief 图形队列被渲染线程与上传上下文共用, 提交/呈现时须持有
+     */
+    std::mutex& getGraphicsQueueMutex() { return m_graphicsQueueMutex; }
 
+    VK_MemoryAllocator* getMemoryAllocator() const { return m_memoryAllocator.get(); }
     VK_BindlessManager* getBindlessManager() const { return m_bindlessManager.get(); }
+    VK_TextureStreamer* getTextureStreamer() const { return m_textureStreamer.get(); }
+    VK_SamplerCache* getSamplerCache() const { return m_samplerCache.get(); }
+    VK_UploadContext* getUploadContext() const { return m_uploadContext.get(); }
+    VK_FrameTimeline* getFrameTimeline() const { return m_frameTimeline.get(); }
+
+    /**
+     * @brief 在途帧与已提交的上传都不再引用后执行 destroy (线程安全), 上下文关闭时执行剩余的全部
+     */
+    void retire(std::function<void()> destroy);
+
+    virtual uint64_t getSubmittedFrameValue() const override { return m_frameTimeline ? m_frameTimeline->getSubmittedValue() : 0; }
+    virtual uint64_t getCompletedFrameValue() const override { return m_frameTimeline ? m_frameTimeline->getCompletedValue() : 0; }
+
+    /**
+     * @brief 渲染器的在途帧数 (2 或 3), 需在创建渲染器前设置
+     */
+    void setFramesInFlight(uint32_t count) { m_framesInFlight = count; }
+    uint32_t getFramesInFlight() const { return m_framesInFlight; }
+
+    /**
+     * @brief 所有管线创建共用的持久化管线缓存, 创建失败时为空句柄
+     */
+    vk::PipelineCache getPipelineCache() const { return m_pipelineCache ? m_pipelineCache->getHandle() : vk::PipelineCache(); }
+    static constexpr const char* PIPELINE_CACHE_PATH = "Data/Cache/pipeline_cache.bin";
     virtual std::unique_ptr<IBuffer> createBuffer(uint64_t size, uint32_t usage, uint32_t properties) override;
 
     bool isMeshShaderSupported() const { return m_meshShaderSupported; }
+    bool isMemoryBudgetSupported() const { return m_memoryBudgetSupported; }
+    bool isDrawIndirectCountSupported() const { return m_drawIndirectCountSupported; }
+    bool isPipelineStatisticsSupported() const { return m_pipelineStatisticsSupported; }
+    bool isInheritedQueriesSupported() const { return m_inheritedQueriesSupported; }
+
+    /**
+     * @brief 图形队列能否写时间戳 (timestampValidBits 为 0 时不支持)
+     */
+    bool isTimestampSupported() const { return m_timestampValidBits > 0; }
+    uint32_t getTimestampValidBits() const { return m_timestampValidBits; }
+
+    /**
+     * @brief 时间戳每递增 1 经过的纳秒数
+     */
+    float getTimestampPeriod() const { return m_timestampPeriod; }
+
+    /**
+     * @brief 期望的采样器各向异性级别 (<= 1 关闭), 需在创建纹理前设置
+     */
+    void setMaxAnisotropy(float anisotropy) { m_requestedAnisotropy = anisotropy; }
+
+    /**
+     * @brief 实际使用的各向异性级别, 已按设备特性与 maxSamplerAnisotropy 限制
+     */
+    float getSamplerAnisotropy() const;
+
+    /**
+     * @brief 格式是否支持 optimal tiling 下的线性 blit (用于 GPU 生成 mip)
+     */
+    bool supportsLinearBlit(vk::Format format) const;
+
+    /**
+     * @brief 设备是否可直接采样该块压缩格式 (需开启 textureCompressionBC 特性)
+     */
+    bool supportsCompressedFormat(vk::Format format) const;
+
     virtual std::unique_ptr<ITexture> createTexture(const ImageData& imageData, TextureUsage usage) override;
     virtual std::unique_ptr<ITexture> createTexture(uint32_t width, uint32_t height, TextureFormat format, TextureUsage usage) override;
+    virtual std::unique_ptr<ITexture> createTextureAsync(ITexture* placeholder) override;
+    virtual void uploadTextureAsync(ITexture* texture, ImageData&& imageData) override;
+    virtual void* mapTextureUpload(ITexture* texture, uint32_t width, uint32_t height) override;
+    virtual void commitTextureUpload(ITexture* texture, bool success) override;
+    virtual bool evictTexture(ITexture* texture, ITexture* placeholder) override;
 
     void setGlobalVertexBuffer(IBuffer* buffer) { m_globalVertexBuffer = buffer; }
     void setGlobalIndexBuffer(IBuffer* buffer) { m_globalIndexBuffer = buffer; }
+    void setGlobalVertexFormat(VertexFormat format) { m_globalVertexFormat = format; }
+    VertexFormat getGlobalVertexFormat() const { return m_globalVertexFormat; }
     virtual IBuffer* getGlobalVertexBuffer() const override { return m_globalVertexBuffer; }
     virtual IBuffer* getGlobalIndexBuffer() const override { return m_globalIndexBuffer; }
 
@@ -65,16 +151,6 @@ public:
      */
     uint32_t findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties);
 
-    /**
-     * @brief 开始单次执行命令
-     */
-    vk::CommandBuffer beginSingleTimeCommands();
-
-    /**
-     * @brief 结束单次执行命令并提交
-     */
-    void endSingleTimeCommands(vk::CommandBuffer commandBuffer);
-
     /**
      * @brief 供渲染器调用
      */
@@ -82,6 +158,7 @@ public:
 
 private:
     Status createInstance();
+    Status createDeviceResources();
     Status createSurface(void* windowHandle);
     Status selectPhysicalDevice();
     Status createLogicalDevice();
@@ -94,11 +171,22 @@ private:
     vk::Device m_device;
     vk::Queue m_graphicsQueue;
     uint32_t m_graphicsQueueFamilyIndex = 0;
+    vk::Queue m_transferQueue;
+    uint32_t m_transferQueueFamilyIndex = 0;
+    std::mutex m_graphicsQueueMutex;
     vk::CommandPool m_commandPool;
+    std::unique_ptr<VK_MemoryAllocator> m_memoryAllocator;
+    std::unique_ptr<VK_UploadContext> m_uploadContext;
     std::unique_ptr<VK_BindlessManager> m_bindlessManager;
+    std::unique_ptr<VK_TextureStreamer> m_textureStreamer;
+    std::unique_ptr<VK_SamplerCache> m_samplerCache;
+    std::unique_ptr<VK_PipelineCache> m_pipelineCache;
+    std::unique_ptr<VK_FrameTimeline> m_frameTimeline;
+    uint32_t m_framesInFlight = 2;
 
     IBuffer* m_globalVertexBuffer = nullptr;
     IBuffer* m_globalIndexBuffer = nullptr;
+    VertexFormat m_globalVertexFormat = VertexFormat::Float32;
 
     const std::vector<const char*> m_validationLayers = {
         "VK_LAYER_KHRONOS_validation"
@@ -106,6 +194,16 @@ private:
 
     bool m_enableValidationLayers = true;
     bool m_meshShaderSupported = false;
+    bool m_memoryBudgetSupported = false;
+    bool m_drawIndirectCountSupported = false;
+    bool m_samplerAnisotropySupported = false;
+    float m_deviceMaxAnisotropy = 1.0f;
+    float m_requestedAnisotropy = 16.0f;
+    bool m_textureCompressionBCSupported = false;
+    bool m_pipelineStatisticsSupported = false;
+    bool m_inheritedQueriesSupported = false;
+    uint32_t m_timestampValidBits = 0;
+    float m_timestampPeriod = 1.0f;
 };
 
 } // namespace Nexus
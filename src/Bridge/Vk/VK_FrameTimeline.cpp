@@ -0,0 +1,95 @@
+#include "VK_FrameTimeline.h"
+#include "Log.h"
+#include <algorithm>
+
+namespace Nexus {
+
+VK_FrameTimeline::VK_FrameTimeline(vk::Device device) : m_device(device) {}
+
+VK_FrameTimeline::~VK_FrameTimeline() {
+    shutdown();
+}
+
+Status VK_FrameTimeline::initialize() {
+    vk::SemaphoreTypeCreateInfo typeInfo(vk::SemaphoreType::eTimeline, 0);
+    vk::SemaphoreCreateInfo createInfo;
+    createInfo.pNext = &typeInfo;
+    auto semaphore = m_device.createSemaphore(createInfo);
+    if (semaphore.result != vk::Result::eSuccess) return InternalError("Failed to create frame timeline semaphore");
+    m_semaphore = semaphore.value;
+    return OkStatus();
+}
+
+void VK_FrameTimeline::shutdown() {
+    if (!m_semaphore) return;
+    if (!wait(getSubmittedValue()).ok()) {
+        NX_CORE_WARN("VK_FrameTimeline: failed to wait for submitted frames, waiting for device idle");
+        (void)m_device.waitIdle();
+    }
+    std::vector<Retirement> retiring;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        retiring.swap(m_retiring);
+    }
+    for (auto& retirement : retiring) retirement.destroy();
+    m_device.destroySemaphore(m_semaphore);
+    m_semaphore = nullptr;
+}
+
+uint64_t VK_FrameTimeline::nextValue() {
+    return m_submitted.fetch_add(1, std::memory_order_acq_rel) + 1;
+}
+
+Status VK_FrameTimeline::signal(uint64_t value) {
+    // 主机信号直接把计数推进到 value, 之前的值须先真正完成
+    if (value > 1) NX_RETURN_IF_ERROR(wait(value - 1));
+    vk::SemaphoreSignalInfo signalInfo(m_semaphore, value);
+    if (m_device.signalSemaphore(signalInfo) != vk::Result::eSuccess) return InternalError("Failed to signal frame timeline");
+    return OkStatus();
+}
+
+uint64_t VK_FrameTimeline::getCompletedValue() const {
+    if (!m_semaphore) return getSubmittedValue();
+    auto value = m_device.getSemaphoreCounterValue(m_semaphore);
+    return value.result == vk::Result::eSuccess ? value.value : 0;
+}
+
+Status VK_FrameTimeline::wait(uint64_t value, uint64_t timeout) const {
+    if (value == 0 || !m_semaphore) return OkStatus();
+    vk::SemaphoreWaitInfo waitInfo({}, 1, &m_semaphore, &value);
+    const vk::Result result = m_device.waitSemaphores(waitInfo, timeout);
+    if (result == vk::Result::eTimeout) return DeadlineExceededError("Frame timeline wait timed out");
+    if (result != vk::Result::eSuccess) return InternalError("Failed to wait for frame timeline");
+    return OkStatus();
+}
+
+void VK_FrameTimeline::retire(uint64_t value, std::function<void()> destroy) {
+    if (isComplete(value)) {
+        destroy();
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_retiring.push_back({value, std::move(destroy)});
+}
+
+uint32_t VK_FrameTimeline::collect() {
+    std::vector<Retirement> done;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_retiring.empty()) return 0;
+        const uint64_t completed = getCompletedValue();
+        auto split = std::partition(m_retiring.begin(), m_retiring.end(), [completed](const Retirement& r) { return r.value > completed; });
+        done.assign(std::make_move_iterator(split), std::make_move_iterator(m_retiring.end()));
+        m_retiring.erase(split, m_retiring.end());
+    }
+    // 在锁外执行, 销毁回调可以再次 retire
+    for (auto& retirement : done) retirement.destroy();
+    return (uint32_t)done.size();
+}
+
+uint32_t VK_FrameTimeline::getRetiringCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return (uint32_t)m_retiring.size();
+}
+
+} // namespace Nexus
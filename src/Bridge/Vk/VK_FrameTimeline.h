@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Base.h"
+#include <vulkan/vulkan.hpp>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace Nexus {
+
+/**
+ * @brief 帧时间线: 一个 timeline semaphore, 第 n 次帧提交完成时信号值 n
+ *
+ * 在途帧的资源环 (命令缓冲区, 实例缓冲区等) 记录所属提交的值, 复用前等待该值即可, 不再每帧一个 fence.
+ * 可能仍被在途帧引用的资源经 retire 延迟到对应值完成后销毁, 由 collect (每个同步点) 执行,
+ * 取代同步点上的 waitIdle.
+ */
+class VK_FrameTimeline {
+public:
+    explicit VK_FrameTimeline(vk::Device device);
+    ~VK_FrameTimeline();
+
+    Status initialize();
+
+    /**
+     * @brief 等待全部已提交的帧并执行剩余的延迟销毁 (关闭时)
+     */
+    void shutdown();
+
+    vk::Semaphore getSemaphore() const { return m_semaphore; }
+
+    /**
+     * @brief 为下一次帧提交分配信号值, 分配后即计入 getSubmittedValue (只由提交线程调用)
+     */
+    uint64_t nextValue();
+
+    /**
+     * @brief 提交失败时由主机信号 value (先等待之前的值), 使等待它的一方不会永久阻塞
+     */
+    Status signal(uint64_t value);
+
+    uint64_t getSubmittedValue() const { return m_submitted.load(std::memory_order_acquire); }
+    uint64_t getCompletedValue() const;
+    bool isComplete(uint64_t value) const { return value == 0 || getCompletedValue() >= value; }
+    Status wait(uint64_t value, uint64_t timeout = UINT64_MAX) const;
+
+    /**
+     * @brief value 完成后执行 destroy, 已完成时立即执行 (线程安全)
+     */
+    void retire(uint64_t value, std::function<void()> destroy);
+
+    /**
+     * @brief 执行已完成帧的延迟销毁
+     * @return 执行的数量
+     */
+    uint32_t collect();
+
+    uint32_t getRetiringCount() const;
+
+private:
+    struct Retirement {
+        uint64_t value = 0;
+        std::function<void()> destroy;
+    };
+
+    vk::Device m_device;
+    vk::Semaphore m_semaphore;
+    std::atomic<uint64_t> m_submitted{0};
+
+    mutable std::mutex m_mutex;
+    std::vector<Retirement> m_retiring;
+};
+
+} // namespace Nexus
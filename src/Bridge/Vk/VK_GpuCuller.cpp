@@ -0,0 +1,430 @@
+#include "VK_GpuCuller.h"
+#include "VK_Context.h"
+#include "VK_BindlessManager.h"
+#include "VK_PipelineBuilder.h"
+#include "JobSystem.h"
+#include "ResourceLoader.h"
+#include "FrustumCuller.h"
+#include "Log.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Nexus {
+
+namespace {
+
+// 与 Cull.hlsl 的 viewBuffer / countBuffer 布局一致
+constexpr vk::DeviceSize VIEW_OCCLUSION_MATRIX = 96;
+constexpr vk::DeviceSize VIEW_DEPTH_SIZE = 160;
+constexpr vk::DeviceSize VIEW_PYRAMID_MIPS = 168;
+constexpr vk::DeviceSize VIEW_FLAGS = 172;
+constexpr vk::DeviceSize VIEW_SIZE = 176;
+constexpr vk::DeviceSize COUNT_SIZE = 4 * sizeof(uint32_t);
+
+constexpr uint32_t CULL_GROUP_SIZE = 64;
+constexpr uint32_t PYRAMID_GROUP_SIZE = 8;
+
+struct PyramidConstants {
+    uint32_t sourceSize[2];
+    uint32_t destinationSize[2];
+};
+
+StatusOr<VK_PipelineBuilder::PipelineFuture> buildComputePipeline(VK_PipelineBuilder& builder, vk::Device device, vk::PipelineCache cache,
+                                                                  const char* path, vk::PipelineLayout layout) {
+    std::string source;
+    NX_ASSIGN_OR_RETURN(source, ResourceLoader::loadTextFile(path));
+    auto shader = builder.compile(std::move(source), "CSMain", shaderc_compute_shader);
+    return builder.build({shader}, [device, cache, layout, path = std::string(path)](std::span<const vk::ShaderModule> modules) -> StatusOr<vk::Pipeline> {
+        vk::ComputePipelineCreateInfo pipelineInfo;
+        pipelineInfo.stage = vk::PipelineShaderStageCreateInfo({}, vk::ShaderStageFlagBits::eCompute, modules[0], "CSMain");
+        pipelineInfo.layout = layout;
+        auto result = device.createComputePipeline(cache, pipelineInfo);
+        if (result.result != vk::Result::eSuccess) return InternalError("Failed to create compute pipeline: " + path);
+        return result.value;
+    });
+}
+
+// 等待构建完成并取回管线, 构建失败时返回其错误
+Status waitPipeline(const StatusOr<VK_PipelineBuilder::PipelineFuture>& future, vk::Pipeline& pipeline) {
+    if (!future.ok()) return future.status();
+    const auto& result = future->get();
+    if (result.ok()) pipeline = *result;
+    return result.status();
+}
+
+bool hasStencil(vk::Format format) {
+    return format == vk::Format::eD32SfloatS8Uint || format == vk::Format::eD24UnormS8Uint || format == vk::Format::eD16UnormS8Uint;
+}
+
+} // namespace
+
+VK_GpuCuller::VK_GpuCuller(VK_Context* context) : m_context(context), m_device(context->getDevice()) {}
+
+VK_GpuCuller::~VK_GpuCuller() {
+    shutdown();
+}
+
+Status VK_GpuCuller::initialize(uint32_t framesInFlight) {
+    NX_RETURN_IF_ERROR(createPipelines());
+    m_frames.resize(framesInFlight);
+    for (auto& frame : m_frames) {
+        NX_RETURN_IF_ERROR(createFrameBuffers(frame, 1024));
+    }
+    NX_CORE_INFO("GPU culler initialized");
+    return OkStatus();
+}
+
+void VK_GpuCuller::shutdown() {
+    if (!m_cullLayout) return;
+
+    destroyPyramid();
+    for (auto& frame : m_frames) {
+        releaseFrameBuffers(frame);
+        auto* bindless = m_context->getBindlessManager();
+        if (frame.counts) bindless->releaseStorageBuffer(frame.countIndex);
+        if (frame.view) bindless->releaseStorageBuffer(frame.viewIndex);
+    }
+    m_frames.clear();
+
+    if (m_pyramidPipeline) m_device.destroyPipeline(m_pyramidPipeline);
+    if (m_pyramidLayout) m_device.destroyPipelineLayout(m_pyramidLayout);
+    if (m_pyramidSetLayout) m_device.destroyDescriptorSetLayout(m_pyramidSetLayout);
+    if (m_cullPipeline) m_device.destroyPipeline(m_cullPipeline);
+    m_device.destroyPipelineLayout(m_cullLayout);
+    m_pyramidPipeline = nullptr;
+    m_pyramidLayout = nullptr;
+    m_pyramidSetLayout = nullptr;
+    m_cullPipeline = nullptr;
+    m_cullLayout = nullptr;
+}
+
+Status VK_GpuCuller::createPipelines() {
+    // 剔除: 只使用 bindless 集 (存储缓冲区 + 金字塔纹理), 其余参数经 push constant
+    vk::DescriptorSetLayout bindlessLayout = m_context->getBindlessManager()->getLayout();
+    vk::PushConstantRange cullRange(vk::ShaderStageFlagBits::eCompute, 0, sizeof(CullConstants));
+    auto cullLayout = m_device.createPipelineLayout(vk::PipelineLayoutCreateInfo({}, 1, &bindlessLayout, 1, &cullRange));
+    if (cullLayout.result != vk::Result::eSuccess) return InternalError("Failed to create cull pipeline layout");
+    m_cullLayout = cullLayout.value;
+
+    std::array<vk::DescriptorSetLayoutBinding, 2> bindings = {
+        vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eSampledImage, 1, vk::ShaderStageFlagBits::eCompute),
+        vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eStorageImage, 1, vk::ShaderStageFlagBits::eCompute)
+    };
+    auto setLayout = m_device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo({}, (uint32_t)bindings.size(), bindings.data()));
+    if (setLayout.result != vk::Result::eSuccess) return InternalError("Failed to create depth pyramid set layout");
+    m_pyramidSetLayout = setLayout.value;
+
+    vk::PushConstantRange pyramidRange(vk::ShaderStageFlagBits::eCompute, 0, sizeof(PyramidConstants));
+    auto pyramidLayout = m_device.createPipelineLayout(vk::PipelineLayoutCreateInfo({}, 1, &m_pyramidSetLayout, 1, &pyramidRange));
+    if (pyramidLayout.result != vk::Result::eSuccess) return InternalError("Failed to create depth pyramid pipeline layout");
+    m_pyramidLayout = pyramidLayout.value;
+
+    // 两个计算着色器在工作线程上并行编译; 剔除器初始化需要二者, 在此等待
+    VK_PipelineBuilder builder(m_device, &JobSystem::get());
+    auto cull = buildComputePipeline(builder, m_device, m_context->getPipelineCache(), "Data/Shaders/Cull.hlsl", m_cullLayout);
+    auto pyramid = buildComputePipeline(builder, m_device, m_context->getPipelineCache(), "Data/Shaders/DepthPyramid.hlsl", m_pyramidLayout);
+    // 两者都取回后再报告错误, 已创建的管线由 shutdown 销毁
+    const Status cullStatus = waitPipeline(cull, m_cullPipeline);
+    const Status pyramidStatus = waitPipeline(pyramid, m_pyramidPipeline);
+    NX_RETURN_IF_ERROR(cullStatus);
+    return pyramidStatus;
+}
+
+Status VK_GpuCuller::registerBuffer(const std::unique_ptr<VK_Buffer>& buffer, uint32_t& index) {
+    NX_ASSIGN_OR_RETURN(index, m_context->getBindlessManager()->registerStorageBuffer(buffer->getHandle()));
+    return OkStatus();
+}
+
+Status VK_GpuCuller::createFrameBuffers(FrameResources& frame, uint32_t capacity) {
+    releaseFrameBuffers(frame);
+    const auto host = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+    const vk::DeviceSize commandBytes = (vk::DeviceSize)capacity * sizeof(DrawIndexedIndirectCommand);
+
+    frame.bounds = std::make_unique<VK_Buffer>(m_context);
+    NX_RETURN_IF_ERROR(frame.bounds->create((vk::DeviceSize)capacity * sizeof(InstanceBounds), vk::BufferUsageFlagBits::eStorageBuffer, host));
+    frame.inputCommands = std::make_unique<VK_Buffer>(m_context);
+    NX_RETURN_IF_ERROR(frame.inputCommands->create(commandBytes, vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferSrc, host));
+    frame.outputCommands = std::make_unique<VK_Buffer>(m_context);
+    NX_RETURN_IF_ERROR(frame.outputCommands->create(commandBytes, vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer |
+                                                                      vk::BufferUsageFlagBits::eTransferDst,
+                                                    vk::MemoryPropertyFlagBits::eDeviceLocal));
+    NX_RETURN_IF_ERROR(registerBuffer(frame.bounds, frame.boundsIndex));
+    NX_RETURN_IF_ERROR(registerBuffer(frame.inputCommands, frame.inputIndex));
+    NX_RETURN_IF_ERROR(registerBuffer(frame.outputCommands, frame.outputIndex));
+    frame.capacity = capacity;
+
+    // 计数, 回读与视锥缓冲区大小固定, 只创建一次
+    if (!frame.counts) {
+        frame.counts = std::make_unique<VK_Buffer>(m_context);
+        NX_RETURN_IF_ERROR(frame.counts->create(COUNT_SIZE, vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst |
+                                                            vk::BufferUsageFlagBits::eTransferSrc,
+                                                vk::MemoryPropertyFlagBits::eDeviceLocal));
+        frame.readback = std::make_unique<VK_Buffer>(m_context);
+        NX_RETURN_IF_ERROR(frame.readback->create(COUNT_SIZE, vk::BufferUsageFlagBits::eTransferDst, host));
+        std::memset(frame.readback->map(), 0, COUNT_SIZE);
+        frame.view = std::make_unique<VK_Buffer>(m_context);
+        NX_RETURN_IF_ERROR(frame.view->create(VIEW_SIZE, vk::BufferUsageFlagBits::eStorageBuffer, host));
+        NX_RETURN_IF_ERROR(registerBuffer(frame.counts, frame.countIndex));
+        NX_RETURN_IF_ERROR(registerBuffer(frame.view, frame.viewIndex));
+    }
+    return OkStatus();
+}
+
+void VK_GpuCuller::releaseFrameBuffers(FrameResources& frame) {
+    // 槽位延迟回收; 缓冲区经帧时间线延迟销毁
+    auto* bindless = m_context->getBindlessManager();
+    if (frame.bounds) bindless->releaseStorageBuffer(frame.boundsIndex);
+    if (frame.inputCommands) bindless->releaseStorageBuffer(frame.inputIndex);
+    if (frame.outputCommands) bindless->releaseStorageBuffer(frame.outputIndex);
+    frame.bounds.reset();
+    frame.inputCommands.reset();
+    frame.outputCommands.reset();
+    frame.capacity = 0;
+}
+
+Status VK_GpuCuller::setDepthSource(vk::Image image, vk::ImageView view, vk::Format format, uint32_t width, uint32_t height) {
+    destroyPyramid();
+    if (!image || width == 0 || height == 0) return OkStatus();
+
+    const auto depthFeatures = m_context->getPhysicalDevice().getFormatProperties(format).optimalTilingFeatures;
+    const auto pyramidFeatures = m_context->getPhysicalDevice().getFormatProperties(vk::Format::eR32Sfloat).optimalTilingFeatures;
+    if (!(depthFeatures & vk::FormatFeatureFlagBits::eSampledImage) || !(pyramidFeatures & vk::FormatFeatureFlagBits::eStorageImage)) {
+        NX_CORE_WARN("GPU culler: depth format {} cannot be sampled, occlusion culling disabled", vk::to_string(format));
+        return OkStatus();
+    }
+
+    m_depthImage = image;
+    m_depthView = view;
+    m_depthAspect = vk::ImageAspectFlagBits::eDepth;
+    if (hasStencil(format)) m_depthAspect |= vk::ImageAspectFlagBits::eStencil;
+    m_depthExtent = vk::Extent2D(width, height);
+
+    // 第 0 级为深度图的一半 (向上取整), 使第 L 级的一个纹素恰好覆盖 2^(L+1) 个深度像素
+    vk::Extent2D extent((width + 1) / 2, (height + 1) / 2);
+    while (m_pyramidExtents.size() < MAX_PYRAMID_MIPS) {
+        m_pyramidExtents.push_back(extent);
+        if (extent.width == 1 && extent.height == 1) break;
+        extent = vk::Extent2D((extent.width + 1) / 2, (extent.height + 1) / 2);
+    }
+    const uint32_t mips = (uint32_t)m_pyramidExtents.size();
+
+    vk::ImageCreateInfo imageInfo;
+    imageInfo.imageType = vk::ImageType::e2D;
+    imageInfo.format = vk::Format::eR32Sfloat;
+    imageInfo.extent = vk::Extent3D(m_pyramidExtents[0].width, m_pyramidExtents[0].height, 1);
+    imageInfo.mipLevels = mips;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = vk::SampleCountFlagBits::e1;
+    imageInfo.tiling = vk::ImageTiling::eOptimal;
+    imageInfo.usage = vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled;
+    imageInfo.sharingMode = vk::SharingMode::eExclusive;
+    imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+    auto imageResult = m_device.createImage(imageInfo);
+    if (imageResult.result != vk::Result::eSuccess) return InternalError("Failed to create depth pyramid image");
+    m_pyramidImage = imageResult.value;
+    NX_ASSIGN_OR_RETURN(m_pyramidAllocation,
+                        m_context->getMemoryAllocator()->allocateForImage(m_pyramidImage, vk::MemoryPropertyFlagBits::eDeviceLocal));
+
+    vk::ImageViewCreateInfo viewInfo({}, m_pyramidImage, vk::ImageViewType::e2D, vk::Format::eR32Sfloat, {},
+                                     vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, mips, 0, 1));
+    auto viewResult = m_device.createImageView(viewInfo);
+    if (viewResult.result != vk::Result::eSuccess) return InternalError("Failed to create depth pyramid view");
+    m_pyramidView = viewResult.value;
+    for (uint32_t mip = 0; mip < mips; ++mip) {
+        viewInfo.subresourceRange.baseMipLevel = mip;
+        viewInfo.subresourceRange.levelCount = 1;
+        auto mipView = m_device.createImageView(viewInfo);
+        if (mipView.result != vk::Result::eSuccess) return InternalError("Failed to create depth pyramid mip view");
+        m_pyramidMipViews.push_back(mipView.value);
+    }
+
+    std::array<vk::DescriptorPoolSize, 2> poolSizes = {
+        vk::DescriptorPoolSize(vk::DescriptorType::eSampledImage, mips),
+        vk::DescriptorPoolSize(vk::DescriptorType::eStorageImage, mips)
+    };
+    auto poolResult = m_device.createDescriptorPool(vk::DescriptorPoolCreateInfo({}, mips, (uint32_t)poolSizes.size(), poolSizes.data()));
+    if (poolResult.result != vk::Result::eSuccess) return InternalError("Failed to create depth pyramid descriptor pool");
+    m_pyramidPool = poolResult.value;
+
+    std::vector<vk::DescriptorSetLayout> layouts(mips, m_pyramidSetLayout);
+    auto setResult = m_device.allocateDescriptorSets(vk::DescriptorSetAllocateInfo(m_pyramidPool, mips, layouts.data()));
+    if (setResult.result != vk::Result::eSuccess) return InternalError("Failed to allocate depth pyramid descriptor sets");
+    m_pyramidSets = setResult.value;
+
+    std::vector<vk::DescriptorImageInfo> imageInfos;
+    imageInfos.reserve(mips * 2);
+    std::vector<vk::WriteDescriptorSet> writes;
+    for (uint32_t mip = 0; mip < mips; ++mip) {
+        imageInfos.emplace_back(nullptr, mip == 0 ? m_depthView : m_pyramidMipViews[mip - 1], vk::ImageLayout::eShaderReadOnlyOptimal);
+        writes.emplace_back(m_pyramidSets[mip], 0, 0, 1, vk::DescriptorType::eSampledImage, &imageInfos.back());
+        imageInfos.emplace_back(nullptr, m_pyramidMipViews[mip], vk::ImageLayout::eGeneral);
+        writes.emplace_back(m_pyramidSets[mip], 1, 0, 1, vk::DescriptorType::eStorageImage, &imageInfos.back());
+    }
+    m_device.updateDescriptorSets(writes, nullptr);
+
+    NX_ASSIGN_OR_RETURN(m_pyramidTexture, m_context->getBindlessManager()->registerTexture(m_pyramidView));
+    m_pyramidValid = false;
+    return OkStatus();
+}
+
+void VK_GpuCuller::destroyPyramid() {
+    if (m_pyramidTexture != INVALID_INDEX) m_context->getBindlessManager()->releaseTexture(m_pyramidTexture);
+    m_pyramidTexture = INVALID_INDEX;
+    for (auto mipView : m_pyramidMipViews) m_device.destroyImageView(mipView);
+    m_pyramidMipViews.clear();
+    m_pyramidExtents.clear();
+    m_pyramidSets.clear();
+    if (m_pyramidPool) m_device.destroyDescriptorPool(m_pyramidPool);
+    if (m_pyramidView) m_device.destroyImageView(m_pyramidView);
+    if (m_pyramidImage) m_device.destroyImage(m_pyramidImage);
+    if (m_pyramidAllocation) m_context->getMemoryAllocator()->free(m_pyramidAllocation);
+    m_pyramidPool = nullptr;
+    m_pyramidView = nullptr;
+    m_pyramidImage = nullptr;
+    m_depthImage = nullptr;
+    m_depthView = nullptr;
+    m_pyramidValid = false;
+}
+
+Status VK_GpuCuller::prepare(uint32_t frame, std::span<const InstanceBounds> bounds, std::span<const DrawIndexedIndirectCommand> commands,
+                             uint32_t instanceBuffer, uint32_t instanceStride, uint32_t instanceIndexBuffer,
+                             const std::array<float, 16>& viewProj) {
+    if (commands.size() > bounds.size()) return InvalidArgumentError("GPU culler: more commands than instances");
+    FrameResources& resources = m_frames[frame];
+    const uint32_t count = (uint32_t)bounds.size();
+    if (count > resources.capacity) {
+        NX_RETURN_IF_ERROR(createFrameBuffers(resources, std::max(count, resources.capacity * 2)));
+    }
+    std::memcpy(resources.bounds->map(), bounds.data(), bounds.size_bytes());
+    // 可见实例在剔除时逐个累加 instanceCount
+    auto* inputCommands = static_cast<DrawIndexedIndirectCommand*>(resources.inputCommands->map());
+    std::memcpy(inputCommands, commands.data(), commands.size_bytes());
+    for (size_t i = 0; i < commands.size(); ++i) inputCommands[i].instanceCount = 0;
+    resources.instanceCount = count;
+    resources.commandCount = (uint32_t)commands.size();
+    resources.instanceBuffer = instanceBuffer;
+    resources.instanceStride = instanceStride;
+    resources.instanceIndexBuffer = instanceIndexBuffer;
+
+    auto* view = static_cast<uint8_t*>(resources.view->map());
+    const auto planes = FrustumCuller::extractPlanes(viewProj);
+    std::memcpy(view, planes.data(), sizeof(planes));
+    std::memcpy(view + VIEW_OCCLUSION_MATRIX, m_pyramidViewProj.data(), sizeof(m_pyramidViewProj));
+    const float depthSize[2] = { (float)m_depthExtent.width, (float)m_depthExtent.height };
+    std::memcpy(view + VIEW_DEPTH_SIZE, depthSize, sizeof(depthSize));
+    const uint32_t mips = (uint32_t)m_pyramidExtents.size();
+    const uint32_t flags = (m_pyramidValid && m_pyramidTexture != INVALID_INDEX) ? 1u : 0u;
+    std::memcpy(view + VIEW_PYRAMID_MIPS, &mips, sizeof(mips));
+    std::memcpy(view + VIEW_FLAGS, &flags, sizeof(flags));
+    return OkStatus();
+}
+
+void VK_GpuCuller::recordCull(vk::CommandBuffer cmd, uint32_t frame) {
+    const FrameResources& resources = m_frames[frame];
+    if (resources.instanceCount == 0) return;
+
+    // 上一次使用同一输出缓冲区的间接绘制已随该帧在帧时间线上完成
+    cmd.fillBuffer(resources.counts->getHandle(), 0, COUNT_SIZE, 0);
+    if (resources.commandCount > 0) {
+        cmd.copyBuffer(resources.inputCommands->getHandle(), resources.outputCommands->getHandle(),
+                       vk::BufferCopy(0, 0, (vk::DeviceSize)resources.commandCount * sizeof(DrawIndexedIndirectCommand)));
+    }
+    vk::MemoryBarrier clearBarrier(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader, {}, 1, &clearBarrier, 0, nullptr, 0, nullptr);
+
+    CullConstants constants;
+    constants.instanceCount = resources.instanceCount;
+    constants.instanceStride = resources.instanceStride;
+    constants.boundsBuffer = resources.boundsIndex;
+    constants.instanceBuffer = resources.instanceBuffer;
+    constants.inputCommands = resources.inputIndex;
+    constants.outputCommands = resources.outputIndex;
+    constants.instanceIndices = resources.instanceIndexBuffer;
+    constants.countBuffer = resources.countIndex;
+    constants.viewBuffer = resources.viewIndex;
+    constants.pyramidTexture = m_pyramidTexture != INVALID_INDEX ? m_pyramidTexture : 0;
+
+    vk::DescriptorSet bindlessSet = m_context->getBindlessManager()->getSet();
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, m_cullPipeline);
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_cullLayout, 0, 1, &bindlessSet, 0, nullptr);
+    cmd.pushConstants<CullConstants>(m_cullLayout, vk::ShaderStageFlagBits::eCompute, 0, constants);
+    cmd.dispatch((resources.instanceCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+
+    vk::MemoryBarrier cullBarrier(vk::AccessFlagBits::eShaderWrite,
+                                  vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eTransferRead);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                        vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eTransfer,
+                        {}, 1, &cullBarrier, 0, nullptr, 0, nullptr);
+
+    cmd.copyBuffer(resources.counts->getHandle(), resources.readback->getHandle(), vk::BufferCopy(0, 0, COUNT_SIZE));
+    vk::MemoryBarrier readbackBarrier(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eHostRead);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost, {}, 1, &readbackBarrier, 0, nullptr, 0, nullptr);
+}
+
+void VK_GpuCuller::recordDepthPyramid(vk::CommandBuffer cmd, const std::array<float, 16>& viewProj, vk::ImageLayout depthLayout) {
+    if (!isOcclusionEnabled()) return;
+    const uint32_t mips = (uint32_t)m_pyramidExtents.size();
+
+    // 深度图转为可采样; 金字塔旧内容丢弃 (srcStage 覆盖上一帧剔除对它的读取)
+    std::array<vk::ImageMemoryBarrier, 2> barriers;
+    barriers[0].srcAccessMask = vk::AccessFlagBits::eDepthStencilAttachmentWrite | vk::AccessFlagBits::eTransferWrite;
+    barriers[0].dstAccessMask = vk::AccessFlagBits::eShaderRead;
+    barriers[0].oldLayout = depthLayout;
+    barriers[0].newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    barriers[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barriers[0].image = m_depthImage;
+    barriers[0].subresourceRange = vk::ImageSubresourceRange(m_depthAspect, 0, 1, 0, 1);
+    barriers[1].srcAccessMask = {};
+    barriers[1].dstAccessMask = vk::AccessFlagBits::eShaderWrite;
+    barriers[1].oldLayout = vk::ImageLayout::eUndefined;
+    barriers[1].newLayout = vk::ImageLayout::eGeneral;
+    barriers[1].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barriers[1].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barriers[1].image = m_pyramidImage;
+    barriers[1].subresourceRange = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, mips, 0, 1);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests |
+                        vk::PipelineStageFlagBits::eTransfer | vk::PipelineStageFlagBits::eComputeShader,
+                        vk::PipelineStageFlagBits::eComputeShader, {}, 0, nullptr, 0, nullptr, (uint32_t)barriers.size(), barriers.data());
+
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, m_pyramidPipeline);
+    vk::Extent2D sourceExtent = m_depthExtent;
+    for (uint32_t mip = 0; mip < mips; ++mip) {
+        const vk::Extent2D extent = m_pyramidExtents[mip];
+        PyramidConstants constants = { {sourceExtent.width, sourceExtent.height}, {extent.width, extent.height} };
+        cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_pyramidLayout, 0, 1, &m_pyramidSets[mip], 0, nullptr);
+        cmd.pushConstants<PyramidConstants>(m_pyramidLayout, vk::ShaderStageFlagBits::eCompute, 0, constants);
+        cmd.dispatch((extent.width + PYRAMID_GROUP_SIZE - 1) / PYRAMID_GROUP_SIZE, (extent.height + PYRAMID_GROUP_SIZE - 1) / PYRAMID_GROUP_SIZE, 1);
+
+        // 本级写完后转为只读, 供下一级构建与下一帧剔除采样
+        vk::ImageMemoryBarrier mipBarrier = barriers[1];
+        mipBarrier.srcAccessMask = vk::AccessFlagBits::eShaderWrite;
+        mipBarrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+        mipBarrier.oldLayout = vk::ImageLayout::eGeneral;
+        mipBarrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+        mipBarrier.subresourceRange = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, mip, 1, 0, 1);
+        cmd.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader, {}, 0, nullptr, 0, nullptr, 1, &mipBarrier);
+        sourceExtent = extent;
+    }
+
+    m_pyramidViewProj = viewProj;
+    m_pyramidValid = true;
+}
+
+vk::Buffer VK_GpuCuller::getOutputCommands(uint32_t frame) const {
+    return m_frames[frame].outputCommands->getHandle();
+}
+
+VK_GpuCuller::Stats VK_GpuCuller::getStats(uint32_t frame) const {
+    const FrameResources& resources = m_frames[frame];
+    uint32_t counts[4];
+    std::memcpy(counts, resources.readback->map(), sizeof(counts));
+    Stats stats;
+    stats.total = resources.instanceCount;
+    stats.visible = counts[0];
+    stats.frustumCulled = counts[2];
+    stats.occlusionCulled = counts[3];
+    return stats;
+}
+
+} // namespace Nexus
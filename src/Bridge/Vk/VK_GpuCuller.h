@@ -0,0 +1,160 @@
+#pragma once
+
+#include "Base.h"
+#include "CommonTypes.h"
+#include "VK_Buffer.h"
+#include "VK_MemoryAllocator.h"
+#include <vulkan/vulkan.hpp>
+#include <array>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace Nexus {
+
+class VK_Context;
+
+/**
+ * @brief GPU 实例剔除 (Data/Shaders/Cull.hlsl)
+ *
+ * 输入为实例化命令 (批次) 与逐实例包围盒; 计算着色器每线程一个实例, 读取实例缓冲区中的 world 矩阵,
+ * 先做视锥测试, 再对上一帧的深度金字塔做 Hi-Z 遮挡测试.
+ * 输出命令由输入命令拷贝并把 instanceCount 清零, 可见实例原子累加所属命令的 instanceCount,
+ * 并把自身实例下标写入实例索引缓冲区 [firstInstance, firstInstance + instanceCount), 顶点着色器经其间接寻址.
+ * 全部缓冲区经 VK_BindlessManager 的存储缓冲区数组访问; 计数在每帧末拷回 host 供统计.
+ * 深度金字塔 (R32 最远深度) 在主 pass 之后由 recordDepthPyramid 构建, 供下一帧剔除使用.
+ */
+class VK_GpuCuller {
+public:
+    /**
+     * @brief 实例局部包围盒 (与实例 world 矩阵作用的顶点空间一致), min > max 表示始终可见
+     */
+    struct InstanceBounds {
+        std::array<float, 3> min;
+        uint32_t batch = 0; // 所属命令的下标
+        std::array<float, 3> max;
+        float pad1 = 0.0f;
+    };
+    static_assert(sizeof(InstanceBounds) == 32, "InstanceBounds must match the shader layout");
+
+    /**
+     * @brief 某一帧的剔除结果, 在该帧的提交完成后有效
+     */
+    struct Stats {
+        uint32_t total = 0;
+        uint32_t visible = 0;
+        uint32_t frustumCulled = 0;
+        uint32_t occlusionCulled = 0;
+    };
+
+    static constexpr uint32_t MAX_PYRAMID_MIPS = 16;
+    static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+    explicit VK_GpuCuller(VK_Context* context);
+    ~VK_GpuCuller();
+
+    Status initialize(uint32_t framesInFlight);
+    void shutdown();
+
+    /**
+     * @brief 设置构建金字塔的深度图 (初始化与窗口改变大小时调用, 须先在帧时间线上等待全部已提交的帧)
+     * 深度格式不支持采样时关闭遮挡剔除, 仅做视锥剔除
+     */
+    Status setDepthSource(vk::Image image, vk::ImageView view, vk::Format format, uint32_t width, uint32_t height);
+
+    /**
+     * @brief 写入帧 frame 的包围盒, 输入命令与视锥 (该帧在帧时间线上已等待)
+     * @param bounds 逐实例, 与实例缓冲区同序
+     * @param commands 实例化命令, 其实例区间覆盖 bounds
+     * @param instanceBuffer 实例缓冲区的 bindless 存储缓冲区索引
+     * @param instanceIndexBuffer 可见实例索引 (uint) 的 bindless 存储缓冲区索引, 容量不小于实例数
+     */
+    Status prepare(uint32_t frame, std::span<const InstanceBounds> bounds, std::span<const DrawIndexedIndirectCommand> commands,
+                   uint32_t instanceBuffer, uint32_t instanceStride, uint32_t instanceIndexBuffer, const std::array<float, 16>& viewProj);
+
+    /**
+     * @brief 录制剔除 dispatch, 须在 beginRendering 之前; 结束后输出命令与实例索引可供间接绘制读取
+     */
+    void recordCull(vk::CommandBuffer cmd, uint32_t frame);
+
+    /**
+     * @brief 由深度图构建金字塔, 须在 endRendering 之后; 结束时深度图处于 ShaderReadOnlyOptimal
+     * @param depthLayout 深度图当前布局 (深度附件或传输目标)
+     */
+    void recordDepthPyramid(vk::CommandBuffer cmd, const std::array<float, 16>& viewProj,
+                            vk::ImageLayout depthLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal);
+
+    vk::Buffer getOutputCommands(uint32_t frame) const;
+    Stats getStats(uint32_t frame) const;
+
+    bool isOcclusionEnabled() const { return m_pyramidImage && m_depthView; }
+
+private:
+    struct FrameResources {
+        std::unique_ptr<VK_Buffer> bounds;         // host-visible
+        std::unique_ptr<VK_Buffer> inputCommands;  // host-visible, instanceCount 已清零
+        std::unique_ptr<VK_Buffer> outputCommands; // device-local, 间接绘制读取
+        std::unique_ptr<VK_Buffer> counts;         // device-local, uint[4]
+        std::unique_ptr<VK_Buffer> readback;       // host-visible, counts 的拷贝
+        std::unique_ptr<VK_Buffer> view;           // host-visible, 视锥平面与金字塔参数
+        uint32_t capacity = 0; // 实例数; 命令数不超过实例数, 共用同一容量
+        uint32_t instanceCount = 0;
+        uint32_t commandCount = 0;
+        uint32_t instanceBuffer = 0;
+        uint32_t instanceStride = 0;
+        uint32_t instanceIndexBuffer = 0;
+        uint32_t boundsIndex = 0;
+        uint32_t inputIndex = 0;
+        uint32_t outputIndex = 0;
+        uint32_t countIndex = 0;
+        uint32_t viewIndex = 0;
+    };
+
+    struct CullConstants {
+        uint32_t instanceCount;
+        uint32_t instanceStride;
+        uint32_t boundsBuffer;
+        uint32_t instanceBuffer;
+        uint32_t inputCommands;
+        uint32_t outputCommands;
+        uint32_t instanceIndices;
+        uint32_t countBuffer;
+        uint32_t viewBuffer;
+        uint32_t pyramidTexture;
+    };
+
+    Status createPipelines();
+    Status createFrameBuffers(FrameResources& frame, uint32_t capacity);
+    void releaseFrameBuffers(FrameResources& frame);
+    Status registerBuffer(const std::unique_ptr<VK_Buffer>& buffer, uint32_t& index);
+    void destroyPyramid();
+
+    VK_Context* m_context;
+    vk::Device m_device;
+
+    vk::PipelineLayout m_cullLayout;
+    vk::Pipeline m_cullPipeline;
+    vk::DescriptorSetLayout m_pyramidSetLayout;
+    vk::PipelineLayout m_pyramidLayout;
+    vk::Pipeline m_pyramidPipeline;
+
+    std::vector<FrameResources> m_frames;
+
+    // 深度金字塔
+    vk::Image m_depthImage;
+    vk::ImageView m_depthView;
+    vk::ImageAspectFlags m_depthAspect;
+    vk::Extent2D m_depthExtent;
+    vk::Image m_pyramidImage;
+    VK_MemoryAllocator::Allocation m_pyramidAllocation;
+    vk::ImageView m_pyramidView;                  // 全部 mip, 注册到 bindless
+    std::vector<vk::ImageView> m_pyramidMipViews; // 逐 mip, 构建时写入
+    std::vector<vk::Extent2D> m_pyramidExtents;
+    vk::DescriptorPool m_pyramidPool;
+    std::vector<vk::DescriptorSet> m_pyramidSets; // 第 i 级: 源 (深度图或第 i-1 级) + 目标
+    uint32_t m_pyramidTexture = INVALID_INDEX;
+    bool m_pyramidValid = false;
+    std::array<float, 16> m_pyramidViewProj{}; // 构建金字塔时的 viewProj, 用于投影遮挡测试
+};
+
+} // namespace Nexus
@@ -0,0 +1,151 @@
+#include "VK_GpuProfiler.h"
+#include "VK_Context.h"
+#include "Log.h"
+#include <algorithm>
+
+namespace Nexus {
+
+VK_GpuProfiler::VK_GpuProfiler(VK_Context* context) : m_context(context), m_device(context->getDevice()) {}
+
+VK_GpuProfiler::~VK_GpuProfiler() {
+    shutdown();
+}
+
+Status VK_GpuProfiler::initialize(uint32_t framesInFlight, bool pipelineStatistics) {
+    if (!m_context->isTimestampSupported()) return UnimplementedError("Graphics queue does not support timestamps");
+    const uint32_t validBits = m_context->getTimestampValidBits();
+    m_timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+    m_timestampPeriodMs = m_context->getTimestampPeriod() / 1e6;
+
+    if (pipelineStatistics && m_context->isPipelineStatisticsSupported()) {
+        m_statisticFlags = vk::QueryPipelineStatisticFlagBits::eInputAssemblyPrimitives | vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations |
+                           vk::QueryPipelineStatisticFlagBits::eClippingPrimitives | vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations |
+                           vk::QueryPipelineStatisticFlagBits::eComputeShaderInvocations;
+        m_statisticCount = 5;
+    }
+
+    for (uint32_t i = 0; i < framesInFlight; ++i) {
+        auto queries = std::make_unique<FrameQueries>();
+        vk::QueryPoolCreateInfo timestampInfo({}, vk::QueryType::eTimestamp, MAX_SCOPES * 2);
+        auto timestamps = m_device.createQueryPool(timestampInfo);
+        if (timestamps.result != vk::Result::eSuccess) return InternalError("Failed to create timestamp query pool");
+        queries->timestamps = timestamps.value;
+        if (m_statisticFlags) {
+            vk::QueryPoolCreateInfo statisticsInfo({}, vk::QueryType::ePipelineStatistics, MAX_SCOPES, m_statisticFlags);
+            auto statistics = m_device.createQueryPool(statisticsInfo);
+            if (statistics.result != vk::Result::eSuccess) return InternalError("Failed to create pipeline statistics query pool");
+            queries->statistics = statistics.value;
+        }
+        m_frames.push_back(std::move(queries));
+    }
+    NX_CORE_INFO("GPU profiler: {} timestamp bits, {:.3f} ns per tick, pipeline statistics {}", validBits, m_context->getTimestampPeriod(),
+                 m_statisticFlags ? "on" : "off");
+    return OkStatus();
+}
+
+void VK_GpuProfiler::shutdown() {
+    // 调用方已等待设备空闲
+    for (auto& queries : m_frames) {
+        if (queries->timestamps) m_device.destroyQueryPool(queries->timestamps);
+        if (queries->statistics) m_device.destroyQueryPool(queries->statistics);
+    }
+    m_frames.clear();
+    m_recording = nullptr;
+}
+
+bool VK_GpuProfiler::beginFrame(vk::CommandBuffer cmd, uint32_t frame) {
+    FrameQueries& queries = *m_frames[frame];
+    const bool resolved = queries.pending && resolve(queries);
+
+    queries.scopeCount.store(0, std::memory_order_relaxed);
+    queries.frameNumber = ++m_frameNumber;
+    queries.recordTime = std::chrono::steady_clock::now();
+    queries.pending = true;
+    cmd.resetQueryPool(queries.timestamps, 0, MAX_SCOPES * 2);
+    if (queries.statistics) cmd.resetQueryPool(queries.statistics, 0, MAX_SCOPES);
+    m_recording = &queries;
+    return resolved;
+}
+
+void VK_GpuProfiler::discardFrame(uint32_t frame) {
+    m_frames[frame]->pending = false;
+}
+
+uint32_t VK_GpuProfiler::beginScope(vk::CommandBuffer cmd, const char* name, bool statistics) {
+    if (!m_recording) return INVALID_SCOPE;
+    const uint32_t scope = m_recording->scopeCount.fetch_add(1, std::memory_order_relaxed);
+    if (scope >= MAX_SCOPES) return INVALID_SCOPE;
+
+    Scope& entry = m_recording->scopes[scope];
+    entry.name = name;
+    entry.statistics = statistics && m_recording->statistics;
+    cmd.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, m_recording->timestamps, scope * 2);
+    if (entry.statistics) cmd.beginQuery(m_recording->statistics, scope, {});
+    return scope;
+}
+
+void VK_GpuProfiler::endScope(vk::CommandBuffer cmd, uint32_t scope) {
+    if (!m_recording || scope == INVALID_SCOPE) return;
+    if (m_recording->scopes[scope].statistics) cmd.endQuery(m_recording->statistics, scope);
+    cmd.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, m_recording->timestamps, scope * 2 + 1);
+}
+
+bool VK_GpuProfiler::resolve(FrameQueries& queries) {
+    queries.pending = false;
+    const uint32_t count = std::min(queries.scopeCount.load(std::memory_order_relaxed), MAX_SCOPES);
+    if (count == 0) return false;
+
+    // 每个查询两个值: 结果与可用性; 未写入的区间 (如录制中途失败) 不可用, 跳过而不等待
+    const vk::QueryResultFlags flags = vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWithAvailability;
+    std::vector<uint64_t> timestamps(count * 4);
+    vk::Result result = m_device.getQueryPoolResults(queries.timestamps, 0, count * 2, timestamps.size() * sizeof(uint64_t), timestamps.data(),
+                                                     sizeof(uint64_t) * 2, flags);
+    if (result != vk::Result::eSuccess && result != vk::Result::eNotReady) return false;
+
+    auto available = [&](uint32_t scope) { return timestamps[scope * 4 + 1] != 0 && timestamps[scope * 4 + 3] != 0; };
+    uint64_t origin = UINT64_MAX;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (available(i)) origin = std::min(origin, timestamps[i * 4]);
+    }
+    if (origin == UINT64_MAX) return false;
+
+    FrameTimings timings;
+    timings.frameNumber = queries.frameNumber;
+    timings.recordTime = queries.recordTime;
+    std::vector<uint64_t> statistics(m_statisticCount + 1);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!available(i)) continue;
+        PassTiming& pass = timings.passes.emplace_back();
+        pass.name = queries.scopes[i].name;
+        // 时间戳只有 validBits 位有效, 按掩码取差值可容忍回绕
+        pass.startMs = ((timestamps[i * 4] - origin) & m_timestampMask) * m_timestampPeriodMs;
+        pass.durationMs = ((timestamps[i * 4 + 2] - timestamps[i * 4]) & m_timestampMask) * m_timestampPeriodMs;
+        timings.gpuMs = std::max(timings.gpuMs, pass.startMs + pass.durationMs);
+
+        if (!queries.scopes[i].statistics) continue;
+        result = m_device.getQueryPoolResults(queries.statistics, i, 1, statistics.size() * sizeof(uint64_t), statistics.data(),
+                                              statistics.size() * sizeof(uint64_t), flags);
+        if ((result != vk::Result::eSuccess && result != vk::Result::eNotReady) || statistics[m_statisticCount] == 0) continue;
+        pass.hasStatistics = true;
+        pass.statistics.inputAssemblyPrimitives = statistics[0];
+        pass.statistics.vertexShaderInvocations = statistics[1];
+        pass.statistics.clippingPrimitives = statistics[2];
+        pass.statistics.fragmentShaderInvocations = statistics[3];
+        pass.statistics.computeShaderInvocations = statistics[4];
+    }
+    if (timings.passes.empty()) return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_latest = std::move(timings);
+    m_hasLatest = true;
+    return true;
+}
+
+bool VK_GpuProfiler::getLatest(FrameTimings& out) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_hasLatest) return false;
+    out = m_latest;
+    return true;
+}
+
+} // namespace Nexus
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Base.h"
+#include <vulkan/vulkan.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Nexus {
+
+class VK_Context;
+
+/**
+ * @brief 按 pass 统计 GPU 耗时与管线统计
+ *
+ * 每个在途帧一个时间戳查询池 (每个区间两个查询) 与一个可选的管线统计查询池. beginFrame 在帧开始时
+ * 读回该帧槽位上一次的结果 (槽位已在帧时间线上等待, 不带 WAIT 标志, 不阻塞), 再在命令缓冲区中重置查询池;
+ * 因此结果比录制晚在途帧数个帧. 区间以 beginScope/endScope 包围, 可录制在主命令缓冲区或
+ * 渲染 pass 内的二级命令缓冲区中; 带管线统计的区间须在同一命令缓冲区内开始与结束,
+ * 跨 executeCommands 时还需 inheritedQueries (见 VK_SecondaryRecorder::setInheritedStatistics).
+ */
+class VK_GpuProfiler {
+public:
+    static constexpr uint32_t MAX_SCOPES = 32;
+    static constexpr uint32_t INVALID_SCOPE = UINT32_MAX;
+
+    /**
+     * @brief 与 getStatisticFlags 的位顺序一致 (查询结果按标志位从低到高排列)
+     */
+    struct PipelineStatistics {
+        uint64_t inputAssemblyPrimitives = 0;
+        uint64_t vertexShaderInvocations = 0;
+        uint64_t clippingPrimitives = 0;
+        uint64_t fragmentShaderInvocations = 0;
+        uint64_t computeShaderInvocations = 0;
+    };
+
+    struct PassTiming {
+        std::string name;
+        double startMs = 0.0;    // 相对本帧第一个区间的开始
+        double durationMs = 0.0;
+        bool hasStatistics = false;
+        PipelineStatistics statistics;
+    };
+
+    struct FrameTimings {
+        uint64_t frameNumber = 0;                         // 第几次 beginFrame
+        std::chrono::steady_clock::time_point recordTime; // 录制该帧的 CPU 时刻, 用于在 trace 中对齐 GPU 区间
+        double gpuMs = 0.0;                               // 第一个区间开始到最后一个区间结束
+        std::vector<PassTiming> passes;                   // 按 beginScope 顺序
+    };
+
+    explicit VK_GpuProfiler(VK_Context* context);
+    ~VK_GpuProfiler();
+
+    /**
+     * @brief 图形队列不支持时间戳时返回 Unimplemented; 设备不支持管线统计查询时只统计时间
+     */
+    Status initialize(uint32_t framesInFlight, bool pipelineStatistics);
+    void shutdown();
+
+    bool hasPipelineStatistics() const { return static_cast<bool>(m_statisticFlags); }
+    vk::QueryPipelineStatisticFlags getStatisticFlags() const { return m_statisticFlags; }
+
+    /**
+     * @brief 读回帧 frame 上一次的结果并重置其查询池 (须在渲染 pass 之外, 本帧任何区间之前)
+     * @return 是否得到了新的结果 (见 getLatest)
+     */
+    bool beginFrame(vk::CommandBuffer cmd, uint32_t frame);
+
+    /**
+     * @brief 提交失败时丢弃本帧的区间, 其查询未被重置也不会被写入
+     */
+    void discardFrame(uint32_t frame);
+
+    /**
+     * @brief 开始一个区间, name 须为静态字符串; 超过 MAX_SCOPES 时返回 INVALID_SCOPE
+     * @param statistics 同时开始管线统计查询 (不支持时忽略)
+     */
+    uint32_t beginScope(vk::CommandBuffer cmd, const char* name, bool statistics = false);
+    void endScope(vk::CommandBuffer cmd, uint32_t scope);
+
+    /**
+     * @brief 最近一次读回的结果 (线程安全)
+     * @return 尚无结果时为 false
+     */
+    bool getLatest(FrameTimings& out) const;
+
+private:
+    struct Scope {
+        const char* name = nullptr;
+        bool statistics = false;
+    };
+
+    struct FrameQueries {
+        vk::QueryPool timestamps;
+        vk::QueryPool statistics;
+        std::array<Scope, MAX_SCOPES> scopes;
+        std::atomic<uint32_t> scopeCount{0};
+        bool pending = false; // 已录制区间且查询池已在同一命令缓冲区中重置
+        uint64_t frameNumber = 0;
+        std::chrono::steady_clock::time_point recordTime;
+    };
+
+    bool resolve(FrameQueries& queries);
+
+    VK_Context* m_context;
+    vk::Device m_device;
+    std::vector<std::unique_ptr<FrameQueries>> m_frames;
+    FrameQueries* m_recording = nullptr; // beginFrame 与下一次 beginFrame 之间录制的帧
+    vk::QueryPipelineStatisticFlags m_statisticFlags;
+    uint32_t m_statisticCount = 0; // 每个统计查询的结果个数
+    uint64_t m_timestampMask = 0;
+    double m_timestampPeriodMs = 0.0;
+    uint64_t m_frameNumber = 0;
+
+    mutable std::mutex m_mutex;
+    FrameTimings m_latest;
+    bool m_hasLatest = false;
+};
+
+} // namespace Nexus
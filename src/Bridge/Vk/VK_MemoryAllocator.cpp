@@ -0,0 +1,315 @@
+#include "VK_MemoryAllocator.h"
+#include "TlsfAllocator.h"
+#include "Log.h"
+#include <algorithm>
+
+namespace Nexus {
+
+namespace {
+
+vk::DeviceSize alignUp(vk::DeviceSize value, vk::DeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+struct VK_MemoryAllocator::Block {
+    vk::DeviceMemory memory;
+    vk::DeviceSize size = 0;
+    uint8_t* mapped = nullptr;
+    uint32_t memoryType = 0;
+    Usage usage = Usage::Buffer;
+    std::unique_ptr<TlsfAllocator> tlsf; // Transient 块为空, 使用线性游标
+    vk::DeviceSize linearHead = 0;
+    uint32_t linearCount = 0;
+
+    uint32_t getAllocationCount() const { return tlsf ? tlsf->getAllocationCount() : linearCount; }
+    vk::DeviceSize getUsedBytes() const { return tlsf ? tlsf->getUsedBytes() : linearHead; }
+};
+
+VK_MemoryAllocator::VK_MemoryAllocator(vk::PhysicalDevice physicalDevice, vk::Device device, bool memoryBudgetSupported)
+    : m_physicalDevice(physicalDevice), m_device(device), m_memoryBudgetSupported(memoryBudgetSupported) {
+    m_memoryProperties = m_physicalDevice.getMemoryProperties();
+    m_nonCoherentAtomSize = std::max<vk::DeviceSize>(m_physicalDevice.getProperties().limits.nonCoherentAtomSize, 1);
+    m_heapAllocated.assign(m_memoryProperties.memoryHeapCount, 0);
+}
+
+VK_MemoryAllocator::~VK_MemoryAllocator() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint32_t live = m_dedicatedCount;
+    for (auto& block : m_blocks) {
+        live += block->getAllocationCount();
+        m_device.freeMemory(block->memory);
+    }
+    m_blocks.clear();
+    if (live > 0) NX_CORE_WARN("Device memory allocator destroyed with {} live allocations", live);
+}
+
+uint32_t VK_MemoryAllocator::findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const {
+    for (uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; i++) {
+        if ((typeFilter & (1u << i)) && (m_memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return i;
+        }
+    }
+    return UINT32_MAX;
+}
+
+bool VK_MemoryAllocator::isHostVisible(uint32_t memoryType) const {
+    return (bool)(m_memoryProperties.memoryTypes[memoryType].propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible);
+}
+
+vk::DeviceSize VK_MemoryAllocator::getBlockSize(uint32_t memoryType) const {
+    const uint32_t heapIndex = m_memoryProperties.memoryTypes[memoryType].heapIndex;
+    const vk::DeviceSize heapSize = m_memoryProperties.memoryHeaps[heapIndex].size;
+    return std::min(DEFAULT_BLOCK_SIZE, alignUp(heapSize / 8, 4096));
+}
+
+StatusOr<vk::DeviceMemory> VK_MemoryAllocator::allocateMemory(vk::DeviceSize size, uint32_t memoryType, const void* pNext) {
+    const uint32_t heapIndex = m_memoryProperties.memoryTypes[memoryType].heapIndex;
+    if (m_memoryBudgetSupported) {
+        vk::PhysicalDeviceMemoryBudgetPropertiesEXT budget;
+        vk::PhysicalDeviceMemoryProperties2 properties;
+        properties.pNext = &budget;
+        m_physicalDevice.getMemoryProperties2(&properties);
+        if (budget.heapUsage[heapIndex] + size > budget.heapBudget[heapIndex]) {
+            NX_CORE_WARN("Device memory heap {} over budget: usage {} + {} > budget {}", heapIndex,
+                         budget.heapUsage[heapIndex], size, budget.heapBudget[heapIndex]);
+        }
+    }
+
+    vk::MemoryAllocateInfo allocInfo(size, memoryType);
+    allocInfo.pNext = pNext;
+    auto result = m_device.allocateMemory(allocInfo);
+    if (result.result != vk::Result::eSuccess) {
+        return ResourceExhaustedError("Failed to allocate device memory: " + vk::to_string(result.result));
+    }
+    m_heapAllocated[heapIndex] += size;
+    ++m_deviceMemoryCount;
+    return result.value;
+}
+
+void VK_MemoryAllocator::freeMemory(vk::DeviceMemory memory, vk::DeviceSize size, uint32_t memoryType) {
+    m_device.freeMemory(memory);
+    m_heapAllocated[m_memoryProperties.memoryTypes[memoryType].heapIndex] -= size;
+    --m_deviceMemoryCount;
+}
+
+StatusOr<VK_MemoryAllocator::Allocation> VK_MemoryAllocator::allocate(const vk::MemoryRequirements& requirements,
+                                                                      vk::MemoryPropertyFlags properties, Usage usage) {
+    return allocateInternal(requirements, properties, usage, false, nullptr, nullptr);
+}
+
+StatusOr<VK_MemoryAllocator::Allocation> VK_MemoryAllocator::allocateForBuffer(vk::Buffer buffer, vk::MemoryPropertyFlags properties, Usage usage) {
+    vk::BufferMemoryRequirementsInfo2 info(buffer);
+    auto chain = m_device.getBufferMemoryRequirements2<vk::MemoryRequirements2, vk::MemoryDedicatedRequirements>(info);
+    const auto& dedicated = chain.get<vk::MemoryDedicatedRequirements>();
+    const bool preferDedicated = dedicated.prefersDedicatedAllocation || dedicated.requiresDedicatedAllocation;
+
+    NX_ASSIGN_OR_RETURN(Allocation allocation, allocateInternal(chain.get<vk::MemoryRequirements2>().memoryRequirements,
+                                                                properties, usage, preferDedicated, buffer, nullptr));
+    if (m_device.bindBufferMemory(buffer, allocation.memory, allocation.offset) != vk::Result::eSuccess) {
+        free(allocation);
+        return InternalError("Failed to bind buffer memory");
+    }
+    return allocation;
+}
+
+StatusOr<VK_MemoryAllocator::Allocation> VK_MemoryAllocator::allocateForImage(vk::Image image, vk::MemoryPropertyFlags properties) {
+    vk::ImageMemoryRequirementsInfo2 info(image);
+    auto chain = m_device.getImageMemoryRequirements2<vk::MemoryRequirements2, vk::MemoryDedicatedRequirements>(info);
+    const auto& dedicated = chain.get<vk::MemoryDedicatedRequirements>();
+    const bool preferDedicated = dedicated.prefersDedicatedAllocation || dedicated.requiresDedicatedAllocation;
+
+    NX_ASSIGN_OR_RETURN(Allocation allocation, allocateInternal(chain.get<vk::MemoryRequirements2>().memoryRequirements,
+                                                                properties, Usage::Image, preferDedicated, nullptr, image));
+    if (m_device.bindImageMemory(image, allocation.memory, allocation.offset) != vk::Result::eSuccess) {
+        free(allocation);
+        return InternalError("Failed to bind image memory");
+    }
+    return allocation;
+}
+
+StatusOr<VK_MemoryAllocator::Allocation> VK_MemoryAllocator::allocateInternal(const vk::MemoryRequirements& requirements,
+                                                                              vk::MemoryPropertyFlags properties, Usage usage,
+                                                                              bool preferDedicated, vk::Buffer dedicatedBuffer,
+                                                                              vk::Image dedicatedImage) {
+    if (requirements.size == 0) return InvalidArgumentError("Zero-sized device memory allocation");
+    const uint32_t memoryType = findMemoryType(requirements.memoryTypeBits, properties);
+    if (memoryType == UINT32_MAX) return InvalidArgumentError("No memory type matches the requested properties");
+
+    const vk::DeviceSize blockSize = getBlockSize(memoryType);
+    if (usage == Usage::Dedicated || preferDedicated || requirements.size > blockSize / 2) {
+        return allocateDedicated(requirements, memoryType, dedicatedBuffer, dedicatedImage);
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    Allocation allocation;
+    for (auto& block : m_blocks) {
+        if (block->memoryType == memoryType && block->usage == usage && allocateFromBlock(*block, requirements, allocation)) {
+            return allocation;
+        }
+    }
+
+    auto memory = allocateMemory(blockSize, memoryType, nullptr);
+    if (!memory.ok()) {
+        // 显存紧张时整块申请可能失败, 退化为恰好大小的独立分配
+        lock.unlock();
+        return allocateDedicated(requirements, memoryType, dedicatedBuffer, dedicatedImage);
+    }
+
+    auto block = std::make_unique<Block>();
+    block->memory = *memory;
+    block->size = blockSize;
+    block->memoryType = memoryType;
+    block->usage = usage;
+    if (usage != Usage::Transient) block->tlsf = std::make_unique<TlsfAllocator>(blockSize);
+    if (isHostVisible(memoryType)) {
+        auto mapResult = m_device.mapMemory(block->memory, 0, VK_WHOLE_SIZE);
+        if (mapResult.result != vk::Result::eSuccess) {
+            freeMemory(block->memory, blockSize, memoryType);
+            return InternalError("Failed to map device memory block");
+        }
+        block->mapped = static_cast<uint8_t*>(mapResult.value);
+    }
+    if (!allocateFromBlock(*block, requirements, allocation)) {
+        freeMemory(block->memory, blockSize, memoryType);
+        return InternalError("Allocation does not fit in a fresh memory block");
+    }
+    m_blocks.push_back(std::move(block));
+    return allocation;
+}
+
+StatusOr<VK_MemoryAllocator::Allocation> VK_MemoryAllocator::allocateDedicated(const vk::MemoryRequirements& requirements, uint32_t memoryType,
+                                                                               vk::Buffer dedicatedBuffer, vk::Image dedicatedImage) {
+    vk::MemoryDedicatedAllocateInfo dedicatedInfo(dedicatedImage, dedicatedBuffer);
+    const void* pNext = (dedicatedBuffer || dedicatedImage) ? &dedicatedInfo : nullptr;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    NX_ASSIGN_OR_RETURN(vk::DeviceMemory memory, allocateMemory(requirements.size, memoryType, pNext));
+
+    Allocation allocation;
+    allocation.memory = memory;
+    allocation.size = requirements.size;
+    allocation.memoryType = memoryType;
+    if (isHostVisible(memoryType)) {
+        auto mapResult = m_device.mapMemory(memory, 0, VK_WHOLE_SIZE);
+        if (mapResult.result != vk::Result::eSuccess) {
+            freeMemory(memory, requirements.size, memoryType);
+            return InternalError("Failed to map dedicated device memory");
+        }
+        allocation.mapped = static_cast<uint8_t*>(mapResult.value);
+    }
+    ++m_dedicatedCount;
+    m_dedicatedBytes += requirements.size;
+    return allocation;
+}
+
+bool VK_MemoryAllocator::allocateFromBlock(Block& block, const vk::MemoryRequirements& requirements, Allocation& outAllocation) {
+    const vk::DeviceSize alignment = std::max<vk::DeviceSize>(requirements.alignment, 1);
+    vk::DeviceSize offset = 0;
+    uint32_t handle = 0;
+    if (block.tlsf) {
+        handle = block.tlsf->allocate(requirements.size, alignment, offset);
+        if (handle == TlsfAllocator::INVALID_HANDLE) return false;
+    } else {
+        offset = alignUp(block.linearHead, alignment);
+        if (offset + requirements.size > block.size) return false;
+        block.linearHead = offset + requirements.size;
+        ++block.linearCount;
+    }
+
+    outAllocation.memory = block.memory;
+    outAllocation.offset = offset;
+    outAllocation.size = requirements.size;
+    outAllocation.mapped = block.mapped ? block.mapped + offset : nullptr;
+    outAllocation.memoryType = block.memoryType;
+    outAllocation.block = &block;
+    outAllocation.handle = handle;
+    return true;
+}
+
+void VK_MemoryAllocator::free(Allocation& allocation) {
+    if (!allocation) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!allocation.block) {
+        freeMemory(allocation.memory, allocation.size, allocation.memoryType);
+        --m_dedicatedCount;
+        m_dedicatedBytes -= allocation.size;
+        allocation = Allocation{};
+        return;
+    }
+
+    Block* block = static_cast<Block*>(allocation.block);
+    if (block->tlsf) {
+        block->tlsf->free(allocation.handle);
+    } else if (--block->linearCount == 0) {
+        block->linearHead = 0;
+    }
+    allocation = Allocation{};
+    if (block->getAllocationCount() > 0) return;
+
+    // 每种 (内存类型, 用途) 保留一个空块, 避免在阈值附近反复申请释放
+    const bool hasSpare = std::any_of(m_blocks.begin(), m_blocks.end(), [block](const auto& other) {
+        return other.get() != block && other->memoryType == block->memoryType && other->usage == block->usage &&
+               other->getAllocationCount() == 0;
+    });
+    if (!hasSpare) return;
+    freeMemory(block->memory, block->size, block->memoryType);
+    m_blocks.erase(std::find_if(m_blocks.begin(), m_blocks.end(), [block](const auto& b) { return b.get() == block; }));
+}
+
+void VK_MemoryAllocator::flush(const Allocation& allocation, vk::DeviceSize offset, vk::DeviceSize size) {
+    if (!allocation || !allocation.mapped) return;
+    if (m_memoryProperties.memoryTypes[allocation.memoryType].propertyFlags & vk::MemoryPropertyFlagBits::eHostCoherent) return;
+
+    // 刷新范围需按 nonCoherentAtomSize 对齐, 超出内存末尾时改用 VK_WHOLE_SIZE
+    const vk::DeviceSize memorySize = allocation.block ? static_cast<Block*>(allocation.block)->size : allocation.size;
+    const vk::DeviceSize begin = (allocation.offset + offset) / m_nonCoherentAtomSize * m_nonCoherentAtomSize;
+    const vk::DeviceSize end = alignUp(allocation.offset + (size == VK_WHOLE_SIZE ? allocation.size : offset + size), m_nonCoherentAtomSize);
+    vk::MappedMemoryRange range(allocation.memory, begin, end >= memorySize ? VK_WHOLE_SIZE : end - begin);
+    (void)m_device.flushMappedMemoryRanges(range);
+}
+
+std::vector<VK_MemoryAllocator::HeapBudget> VK_MemoryAllocator::getHeapBudgets() const {
+    vk::PhysicalDeviceMemoryBudgetPropertiesEXT budget;
+    if (m_memoryBudgetSupported) {
+        vk::PhysicalDeviceMemoryProperties2 properties;
+        properties.pNext = &budget;
+        m_physicalDevice.getMemoryProperties2(&properties);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<HeapBudget> heaps(m_memoryProperties.memoryHeapCount);
+    for (uint32_t i = 0; i < m_memoryProperties.memoryHeapCount; ++i) {
+        const auto& heap = m_memoryProperties.memoryHeaps[i];
+        heaps[i].size = heap.size;
+        heaps[i].deviceLocal = (bool)(heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal);
+        heaps[i].allocated = m_heapAllocated[i];
+        if (m_memoryBudgetSupported) {
+            heaps[i].budget = budget.heapBudget[i];
+            heaps[i].usage = budget.heapUsage[i];
+        } else {
+            heaps[i].budget = heap.size / 10 * 8;
+            heaps[i].usage = m_heapAllocated[i];
+        }
+    }
+    return heaps;
+}
+
+VK_MemoryAllocator::Stats VK_MemoryAllocator::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats;
+    stats.deviceMemoryCount = m_deviceMemoryCount;
+    stats.blockCount = (uint32_t)m_blocks.size();
+    stats.dedicatedCount = m_dedicatedCount;
+    stats.allocationCount = m_dedicatedCount;
+    stats.usedBytes = m_dedicatedBytes;
+    for (const auto& block : m_blocks) {
+        stats.allocationCount += block->getAllocationCount();
+        stats.blockBytes += block->size;
+        stats.usedBytes += block->getUsedBytes();
+    }
+    return stats;
+}
+
+} // namespace Nexus
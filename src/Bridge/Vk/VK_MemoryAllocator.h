@@ -0,0 +1,135 @@
+#pragma once
+
+#include "Base.h"
+#include <vulkan/vulkan.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Nexus {
+
+/**
+ * @brief 设备内存分配器
+ *
+ * 按内存类型申请大块 VkDeviceMemory 并在块内子分配, 代替每个资源一次 vkAllocateMemory:
+ * - 常规缓冲区与图像在 TLSF 块中分配, 两者分属不同的块, 不必处理 bufferImageGranularity;
+ * - Transient (短生命周期的 staging) 在线性块中顺序分配, 块内全部释放后整体复位;
+ * - 超过块一半大小的资源以及驱动要求/偏好独占内存的资源使用独立分配;
+ * - host-visible 的内存在分配时持久映射, 分配结果直接给出 CPU 地址.
+ * 线程安全.
+ */
+class VK_MemoryAllocator {
+public:
+    enum class Usage : uint8_t {
+        Buffer,    // 缓冲区 (线性资源)
+        Image,     // optimal tiling 图像
+        Transient, // 短生命周期缓冲区, 线性分配
+        Dedicated, // 强制独立分配
+    };
+
+    struct Allocation {
+        vk::DeviceMemory memory;
+        vk::DeviceSize offset = 0;
+        vk::DeviceSize size = 0;
+        uint8_t* mapped = nullptr; // 持久映射地址 (已加 offset), 非 host-visible 时为空
+        uint32_t memoryType = 0;
+        void* block = nullptr;     // 所属块, 独立分配时为空
+        uint32_t handle = 0;
+
+        explicit operator bool() const { return (bool)memory; }
+    };
+
+    struct HeapBudget {
+        vk::DeviceSize size = 0;
+        vk::DeviceSize budget = 0;    // 本进程可用的估计上限
+        vk::DeviceSize usage = 0;     // 本进程当前用量
+        vk::DeviceSize allocated = 0; // 其中由本分配器持有的字节数
+        bool deviceLocal = false;
+    };
+
+    struct Stats {
+        uint32_t deviceMemoryCount = 0; // 存活的 VkDeviceMemory 数
+        uint32_t blockCount = 0;
+        uint32_t dedicatedCount = 0;
+        uint32_t allocationCount = 0;   // 块内子分配 + 独立分配
+        vk::DeviceSize blockBytes = 0;
+        vk::DeviceSize usedBytes = 0;   // 块内已分配字节 + 独立分配字节
+    };
+
+    static constexpr vk::DeviceSize DEFAULT_BLOCK_SIZE = 64ull << 20;
+
+    /**
+     * @param memoryBudgetSupported 设备是否启用了 VK_EXT_memory_budget
+     */
+    VK_MemoryAllocator(vk::PhysicalDevice physicalDevice, vk::Device device, bool memoryBudgetSupported);
+    ~VK_MemoryAllocator();
+
+    VK_MemoryAllocator(const VK_MemoryAllocator&) = delete;
+    VK_MemoryAllocator& operator=(const VK_MemoryAllocator&) = delete;
+
+    /**
+     * @brief 按内存需求分配, 不绑定资源
+     */
+    StatusOr<Allocation> allocate(const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags properties, Usage usage);
+
+    /**
+     * @brief 查询缓冲区的内存需求, 分配并绑定
+     */
+    StatusOr<Allocation> allocateForBuffer(vk::Buffer buffer, vk::MemoryPropertyFlags properties, Usage usage = Usage::Buffer);
+
+    /**
+     * @brief 查询图像的内存需求 (含独占偏好), 分配并绑定
+     */
+    StatusOr<Allocation> allocateForImage(vk::Image image, vk::MemoryPropertyFlags properties);
+
+    /**
+     * @brief 释放并清空 allocation, 空分配为 no-op
+     */
+    void free(Allocation& allocation);
+
+    /**
+     * @brief 非 coherent 内存在 CPU 写入后刷新, coherent 内存为 no-op
+     */
+    void flush(const Allocation& allocation, vk::DeviceSize offset = 0, vk::DeviceSize size = VK_WHOLE_SIZE);
+
+    /**
+     * @brief 各内存堆的预算; 未启用 VK_EXT_memory_budget 时以堆大小的 80% 作为预算, 用量为本分配器的统计
+     */
+    std::vector<HeapBudget> getHeapBudgets() const;
+
+    Stats getStats() const;
+    bool isMemoryBudgetSupported() const { return m_memoryBudgetSupported; }
+
+    /**
+     * @brief 该内存类型的块大小 (小堆按堆大小的 1/8 缩小)
+     */
+    vk::DeviceSize getBlockSize(uint32_t memoryType) const;
+
+private:
+    struct Block;
+
+    uint32_t findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const;
+    StatusOr<Allocation> allocateInternal(const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags properties,
+                                          Usage usage, bool preferDedicated, vk::Buffer dedicatedBuffer, vk::Image dedicatedImage);
+    StatusOr<Allocation> allocateDedicated(const vk::MemoryRequirements& requirements, uint32_t memoryType,
+                                           vk::Buffer dedicatedBuffer, vk::Image dedicatedImage);
+    bool allocateFromBlock(Block& block, const vk::MemoryRequirements& requirements, Allocation& outAllocation);
+    StatusOr<vk::DeviceMemory> allocateMemory(vk::DeviceSize size, uint32_t memoryType, const void* pNext);
+    void freeMemory(vk::DeviceMemory memory, vk::DeviceSize size, uint32_t memoryType);
+    bool isHostVisible(uint32_t memoryType) const;
+
+    vk::PhysicalDevice m_physicalDevice;
+    vk::Device m_device;
+    bool m_memoryBudgetSupported = false;
+    vk::PhysicalDeviceMemoryProperties m_memoryProperties;
+    vk::DeviceSize m_nonCoherentAtomSize = 1;
+
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<Block>> m_blocks;
+    std::vector<vk::DeviceSize> m_heapAllocated;
+    uint32_t m_deviceMemoryCount = 0;
+    uint32_t m_dedicatedCount = 0;
+    vk::DeviceSize m_dedicatedBytes = 0;
+};
+
+} // namespace Nexus
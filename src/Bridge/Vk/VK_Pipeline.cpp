@@ -53,7 +53,7 @@ Status VK_Pipeline::createGraphics(vk::ShaderModule vertShader, vk::ShaderModule
     pipelineInfo.pDynamicState = &dynamicState;
     pipelineInfo.layout = layout;
 
-    auto result = device.createGraphicsPipeline(nullptr, pipelineInfo);
+    auto result = device.createGraphicsPipeline(m_context->getPipelineCache(), pipelineInfo);
     if (result.result != vk::Result::eSuccess) {
         return InternalError("Failed to create graphics pipeline");
     }
@@ -101,7 +101,7 @@ Status VK_Pipeline::createMesh(vk::ShaderModule taskShader, vk::ShaderModule mes
     pipelineInfo.pDynamicState = &dynamicState;
     pipelineInfo.layout = layout;
 
-    auto result = device.createGraphicsPipeline(nullptr, pipelineInfo);
+    auto result = device.createGraphicsPipeline(m_context->getPipelineCache(), pipelineInfo);
     if (result.result != vk::Result::eSuccess) {
         return InternalError("Failed to create mesh graphics pipeline");
     }
@@ -0,0 +1,40 @@
+#include "VK_PipelineBuilder.h"
+#include "VK_ShaderCompiler.h"
+#include "JobSystem.h"
+
+namespace Nexus {
+
+VK_PipelineBuilder::VK_PipelineBuilder(vk::Device device, JobSystem* jobs) : m_device(device), m_jobs(jobs) {}
+
+VK_PipelineBuilder::SpirvFuture VK_PipelineBuilder::compile(std::string source, std::string entryPoint, shaderc_shader_kind stage, Defines defines) {
+    return m_jobs->submitTask([source = std::move(source), entryPoint = std::move(entryPoint), stage, defines = std::move(defines)]() {
+        return VK_ShaderCompiler::compileSpirv(source, entryPoint, stage, defines);
+    }).share();
+}
+
+VK_PipelineBuilder::PipelineFuture VK_PipelineBuilder::build(std::vector<SpirvFuture> shaders, CreateFn create) {
+    return m_jobs->submitTask([device = m_device, shaders = std::move(shaders), create = std::move(create)]() -> StatusOr<vk::Pipeline> {
+        std::vector<vk::ShaderModule> modules;
+        auto destroyModules = [&]() {
+            for (auto module : modules) device.destroyShaderModule(module);
+        };
+        for (const auto& shader : shaders) {
+            const auto& spirv = shader.get();
+            if (!spirv.ok()) {
+                destroyModules();
+                return spirv.status();
+            }
+            auto module = device.createShaderModule(vk::ShaderModuleCreateInfo({}, spirv->size() * sizeof(uint32_t), spirv->data()));
+            if (module.result != vk::Result::eSuccess) {
+                destroyModules();
+                return InternalError("Failed to create shader module");
+            }
+            modules.push_back(module.value);
+        }
+        auto pipeline = create(modules);
+        destroyModules();
+        return pipeline;
+    }).share();
+}
+
+} // namespace Nexus
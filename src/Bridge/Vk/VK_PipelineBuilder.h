@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Base.h"
+#include <vulkan/vulkan.hpp>
+#include <shaderc/shaderc.hpp>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Nexus {
+
+class JobSystem;
+
+/**
+ * @brief 在工作线程上并行编译着色器与创建管线
+ *
+ * compile 把一个 HLSL 入口 (含宏排列) 的编译作为任务提交, build 提交一个等待所需 SPIR-V 后创建着色器模块与管线的任务,
+ * 两者都立即返回 future. 每个工作线程使用各自的 shaderc::Compiler (见 VK_ShaderCompiler).
+ * JobSystem 先进先出, 构建任务只等待先于它提交的编译任务, 后者不会阻塞, 因此不会占满工作线程而死锁.
+ */
+class VK_PipelineBuilder {
+public:
+    using Defines = std::vector<std::pair<std::string, std::string>>;
+    using SpirvFuture = std::shared_future<StatusOr<std::vector<uint32_t>>>;
+    using PipelineFuture = std::shared_future<StatusOr<vk::Pipeline>>;
+    /**
+     * @brief 以与 build 的 shaders 同序的着色器模块创建管线; 模块在其返回后销毁
+     */
+    using CreateFn = std::function<StatusOr<vk::Pipeline>(std::span<const vk::ShaderModule>)>;
+
+    VK_PipelineBuilder(vk::Device device, JobSystem* jobs);
+
+    SpirvFuture compile(std::string source, std::string entryPoint, shaderc_shader_kind stage, Defines defines = {});
+
+    /**
+     * @brief 任一着色器编译失败时 future 携带该错误
+     */
+    PipelineFuture build(std::vector<SpirvFuture> shaders, CreateFn create);
+
+    /**
+     * @brief 不阻塞地检查 future 是否已完成
+     */
+    template<typename T>
+    static bool isReady(const std::shared_future<T>& future) {
+        return future.valid() && future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+private:
+    vk::Device m_device;
+    JobSystem* m_jobs;
+};
+
+} // namespace Nexus
@@ -0,0 +1,99 @@
+#include "VK_PipelineCache.h"
+#include "Log.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace Nexus {
+
+namespace {
+
+constexpr size_t kHeaderSize = 16 + VK_UUID_SIZE;
+
+uint32_t readU32(const uint8_t* data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+VK_PipelineCache::VK_PipelineCache(vk::PhysicalDevice physicalDevice, vk::Device device)
+    : m_physicalDevice(physicalDevice), m_device(device) {}
+
+VK_PipelineCache::~VK_PipelineCache() {
+    shutdown();
+}
+
+bool VK_PipelineCache::isCompatible(std::span<const uint8_t> data, const vk::PhysicalDeviceProperties& properties) {
+    if (data.size() < kHeaderSize) return false;
+    const uint32_t headerSize = readU32(data.data());
+    if (headerSize < kHeaderSize || headerSize > data.size()) return false;
+    if (readU32(data.data() + 4) != (uint32_t)vk::PipelineCacheHeaderVersion::eOne) return false;
+    if (readU32(data.data() + 8) != properties.vendorID || readU32(data.data() + 12) != properties.deviceID) return false;
+    return std::memcmp(data.data() + 16, properties.pipelineCacheUUID.data(), VK_UUID_SIZE) == 0;
+}
+
+Status VK_PipelineCache::initialize(const std::string& path) {
+    m_path = path;
+    std::vector<uint8_t> data;
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (file.is_open()) {
+        data.resize((size_t)file.tellg());
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char*>(data.data()), (std::streamsize)data.size())) data.clear();
+    }
+    // 驱动或设备变化后旧数据无效, 交给驱动前先行拒绝 (部分驱动对不匹配的数据处理不当)
+    if (!data.empty() && !isCompatible(data, m_physicalDevice.getProperties())) {
+        NX_CORE_INFO("Pipeline cache {} was created by another device or driver, starting empty", path);
+        data.clear();
+    }
+
+    vk::PipelineCacheCreateInfo createInfo;
+    createInfo.initialDataSize = data.size();
+    createInfo.pInitialData = data.data();
+    auto result = m_device.createPipelineCache(createInfo);
+    if (result.result != vk::Result::eSuccess && !data.empty()) {
+        createInfo.initialDataSize = 0;
+        createInfo.pInitialData = nullptr;
+        data.clear();
+        result = m_device.createPipelineCache(createInfo);
+    }
+    if (result.result != vk::Result::eSuccess) return InternalError("Failed to create pipeline cache");
+    m_cache = result.value;
+    m_warm = !data.empty();
+    NX_CORE_INFO("Pipeline cache {}: {}", path, m_warm ? "loaded " + std::to_string(data.size()) + " bytes" : std::string("cold"));
+    return OkStatus();
+}
+
+Status VK_PipelineCache::save() const {
+    if (!m_cache || m_path.empty()) return OkStatus();
+    auto data = m_device.getPipelineCacheData(m_cache);
+    if (data.result != vk::Result::eSuccess) return InternalError("Failed to read pipeline cache data");
+
+    std::error_code ec;
+    const auto parent = std::filesystem::path(m_path).parent_path();
+    if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+    const std::string tempPath = m_path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return InternalError("Failed to open for writing: " + tempPath);
+        file.write(reinterpret_cast<const char*>(data.value.data()), (std::streamsize)data.value.size());
+        if (!file) return InternalError("Failed to write: " + tempPath);
+    }
+    std::filesystem::rename(tempPath, m_path, ec);
+    if (ec) return InternalError("Failed to rename " + tempPath + ": " + ec.message());
+    return OkStatus();
+}
+
+void VK_PipelineCache::shutdown() {
+    if (!m_cache) return;
+    if (auto status = save(); !status.ok()) {
+        NX_CORE_WARN("Failed to save pipeline cache: {}", status.message());
+    }
+    m_device.destroyPipelineCache(m_cache);
+    m_cache = nullptr;
+}
+
+} // namespace Nexus
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Base.h"
+#include <vulkan/vulkan.hpp>
+#include <span>
+#include <string>
+
+namespace Nexus {
+
+/**
+ * @brief 持久化的 vk::PipelineCache
+ *
+ * 启动时读取磁盘上的缓存数据, 其头部 (vendorID, deviceID, pipelineCacheUUID) 与当前设备不符时丢弃, 以空缓存开始;
+ * 关闭时把驱动累积的数据写回磁盘. 温启动时创建管线可直接命中驱动缓存, 跳过后端编译.
+ */
+class VK_PipelineCache {
+public:
+    VK_PipelineCache(vk::PhysicalDevice physicalDevice, vk::Device device);
+    ~VK_PipelineCache();
+
+    /**
+     * @brief 创建管线缓存, path 处有兼容的数据时作为初始数据
+     */
+    Status initialize(const std::string& path);
+
+    /**
+     * @brief 写回磁盘 (先写临时文件再重命名)
+     */
+    Status save() const;
+
+    /**
+     * @brief 保存并销毁缓存, 须在设备销毁之前调用
+     */
+    void shutdown();
+
+    vk::PipelineCache getHandle() const { return m_cache; }
+
+    /**
+     * @brief 初始化时是否载入了磁盘上的数据
+     */
+    bool isWarm() const { return m_warm; }
+
+    /**
+     * @brief 校验缓存数据头部 (VkPipelineCacheHeaderVersionOne) 是否来自同一设备与驱动
+     */
+    static bool isCompatible(std::span<const uint8_t> data, const vk::PhysicalDeviceProperties& properties);
+
+private:
+    vk::PhysicalDevice m_physicalDevice;
+    vk::Device m_device;
+    vk::PipelineCache m_cache;
+    std::string m_path;
+    bool m_warm = false;
+};
+
+} // namespace Nexus
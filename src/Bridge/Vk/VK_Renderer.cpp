@@ -3,12 +3,37 @@
 #include "ResourceLoader.h"
 #include "Log.h"
 #include "VK_UIBridge.h"
+#include "JobSystem.h"
+#include "TraceExporter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 // #include "../../Editor/EditorUIManager.h" // Removed to break circular dependency
 
 namespace Nexus {
 
 std::atomic<uint32_t> g_RenderStats_DrawCalls{0};
 std::atomic<uint32_t> g_RenderStats_Triangles{0};
+std::atomic<uint32_t> g_RenderStats_VisibleInstances{0};
+std::atomic<uint32_t> g_RenderStats_FrameWaitUs{0};    // beginFrame 等待帧时间线的 CPU 时间
+std::atomic<uint32_t> g_RenderStats_GpuQueuedFrames{0}; // 提交后已提交但 GPU 未完成的帧数
+std::atomic<uint32_t> g_RenderStats_CpuGpuOverlap{0};   // 帧间隔中 CPU 未阻塞于 GPU 的百分比
+// 按 pass 的 GPU 耗时 (微秒), 比当前帧晚在途帧数个帧
+std::atomic<uint32_t> g_RenderStats_GpuFrameUs{0};
+std::atomic<uint32_t> g_RenderStats_GpuCullUs{0};
+std::atomic<uint32_t> g_RenderStats_GpuMainPassUs{0};
+std::atomic<uint32_t> g_RenderStats_GpuUiUs{0};
+std::atomic<uint32_t> g_RenderStats_GpuDepthPyramidUs{0};
+
+namespace {
+
+// GPU 分析器的区间名, 同时作为 trace 中的事件名 ("UI" 由 VK_UIBridge::render 录制)
+constexpr const char* kPassGpuCull = "GpuCull";
+constexpr const char* kPassMain = "MainPass";
+constexpr const char* kPassUi = "UI";
+constexpr const char* kPassDepthPyramid = "DepthPyramid";
+
+} // namespace
 
 VK_Renderer::VK_Renderer(VK_Context* context, VK_Swapchain* swapchain) 
     : m_context(context), m_swapchain(swapchain), m_device(context->getDevice()) {
@@ -22,6 +47,9 @@ void VK_Renderer::shutdown() {
     if (!m_commandPool) return;
 
     deviceWaitIdle();
+    // 仍在构建的管线须先完成, 再与其余管线一并销毁
+    collectPipelines(true);
+    m_context->getBindlessManager()->setDeferLiveWrites(false);
 
     if (m_testTexture) {
         m_testTexture.reset();
@@ -33,12 +61,8 @@ void VK_Renderer::shutdown() {
     for (size_t i = 0; i < m_imageAvailableSemaphores.size(); i++) {
         if (m_imageAvailableSemaphores[i]) m_device.destroySemaphore(m_imageAvailableSemaphores[i]);
     }
-    for (size_t i = 0; i < m_inFlightFences.size(); i++) {
-        if (m_inFlightFences[i]) m_device.destroyFence(m_inFlightFences[i]);
-    }
     m_renderFinishedSemaphores.clear();
     m_imageAvailableSemaphores.clear();
-    m_inFlightFences.clear();
 
     if (m_commandPool) {
         m_device.destroyCommandPool(m_commandPool);
@@ -49,20 +73,81 @@ void VK_Renderer::shutdown() {
         m_device.destroyPipeline(m_graphicsPipeline);
         m_graphicsPipeline = nullptr;
     }
+    if (m_depthPrepassPipeline) {
+        m_device.destroyPipeline(m_depthPrepassPipeline);
+        m_depthPrepassPipeline = nullptr;
+    }
+    if (m_depthEqualPipeline) {
+        m_device.destroyPipeline(m_depthEqualPipeline);
+        m_depthEqualPipeline = nullptr;
+    }
 
     if (m_pipelineLayout) {
         m_device.destroyPipelineLayout(m_pipelineLayout);
         m_pipelineLayout = nullptr;
     }
+
+    m_gpuCuller.reset();
+    m_secondaryRecorder.reset();
+    m_gpuProfiler.reset();
+    for (auto& frame : m_frames) {
+        if (frame.instanceBufferIndex != VK_GpuCuller::INVALID_INDEX) {
+            m_context->getBindlessManager()->releaseStorageBuffer(frame.instanceBufferIndex);
+        }
+        if (frame.instanceIndexBufferIndex != VK_GpuCuller::INVALID_INDEX) {
+            m_context->getBindlessManager()->releaseStorageBuffer(frame.instanceIndexBufferIndex);
+        }
+    }
+    m_frames.clear();
+    if (m_instancePool) {
+        m_device.destroyDescriptorPool(m_instancePool);
+        m_instancePool = nullptr;
+    }
+    if (m_instanceSetLayout) {
+        m_device.destroyDescriptorSetLayout(m_instanceSetLayout);
+        m_instanceSetLayout = nullptr;
+    }
 }
 
 Status VK_Renderer::initialize() {
+    m_framesInFlight = std::clamp(m_context->getFramesInFlight(), MIN_FRAMES_IN_FLIGHT, MAX_FRAMES_IN_FLIGHT);
+    NX_CORE_INFO("Renderer: {} frames in flight", m_framesInFlight);
     if (auto status = createCommandPool(); !status.ok()) return status;
+    if (auto status = createInstanceResources(); !status.ok()) return status;
     if (auto status = createGraphicsPipeline(); !status.ok()) return status;
     if (auto status = createCommandBuffers(); !status.ok()) return status;
     if (auto status = createSyncObjects(); !status.ok()) return status;
     if (auto status = createSwapchainTextures(); !status.ok()) return status;
 
+    m_secondaryRecorder = std::make_unique<VK_SecondaryRecorder>(m_context);
+    NX_RETURN_IF_ERROR(m_secondaryRecorder->initialize(m_framesInFlight));
+
+    // 改写在用纹理槽位须在渲染线程上与本帧的使用记录, 提交有序 (见 endFrame)
+    m_textureUsed.assign(VK_BindlessManager::MAX_TEXTURES, 0);
+    m_context->getBindlessManager()->setDeferLiveWrites(true);
+
+    // 不支持时间戳 (timestampValidBits 为 0) 时不做 GPU 计时; 主 pass 的管线统计跨 executeCommands, 需二级命令缓冲区继承
+    auto profiler = std::make_unique<VK_GpuProfiler>(m_context);
+    if (auto profilerStatus = profiler->initialize(m_framesInFlight, true); profilerStatus.ok()) {
+        if (m_context->isInheritedQueriesSupported()) m_secondaryRecorder->setInheritedStatistics(profiler->getStatisticFlags());
+        m_gpuProfiler = std::move(profiler);
+    } else {
+        NX_CORE_WARN("GPU profiler disabled: {}", profilerStatus.message());
+    }
+
+    // GPU 剔除不可用 (如着色器编译失败) 时只做 CPU 视锥剔除
+    auto culler = std::make_unique<VK_GpuCuller>(m_context);
+    auto cullerStatus = culler->initialize(m_framesInFlight);
+    if (cullerStatus.ok()) {
+        cullerStatus = culler->setDepthSource(m_swapchain->getDepthImage(), m_swapchain->getDepthImageView(), m_swapchain->getDepthFormat(),
+                                              m_swapchain->getExtent().width, m_swapchain->getExtent().height);
+    }
+    if (cullerStatus.ok()) {
+        m_gpuCuller = std::move(culler);
+    } else {
+        NX_CORE_WARN("GPU culling disabled, falling back to CPU frustum culling: {}", cullerStatus.message());
+    }
+
     ImageData imageData;
     auto imageRes = ResourceLoader::loadImage("Data/Textures/test.png");
     if (imageRes.ok()) {
@@ -101,6 +186,7 @@ Status VK_Renderer::initialize() {
 #ifdef ENABLE_RMLUI
     m_uiBridge = std::make_unique<VK_UIBridge>(m_context, this);
     m_uiBridge->initialize(m_swapchain->getExtent().width, m_swapchain->getExtent().height);
+    m_uiBridge->setProfiler(m_gpuProfiler.get());
 #endif
 
     return OkStatus(); 
@@ -128,44 +214,97 @@ Status VK_Renderer::createGraphicsPipeline() {
     std::string vsCode;
     NX_ASSIGN_OR_RETURN(vsCode, ResourceLoader::loadTextFile("Data/Shaders/Triangle.hlsl"));
 
-    vk::ShaderModule vertShaderModule;
-    NX_ASSIGN_OR_RETURN(vertShaderModule, VK_ShaderCompiler::compileLayer(m_device, vsCode, "VSMain", shaderc_vertex_shader));
-    
-    vk::ShaderModule fragShaderModule;
-    NX_ASSIGN_OR_RETURN(fragShaderModule, VK_ShaderCompiler::compileLayer(m_device, vsCode, "PSMain", shaderc_fragment_shader));
+    const VertexFormat vertexFormat = m_context->getGlobalVertexFormat();
+    std::vector<std::pair<std::string, std::string>> defines;
+    if (vertexFormat == VertexFormat::Compact) {
+        defines.emplace_back("NX_COMPACT_VERTEX", "1");
+    }
+
+    // set 0: bindless 纹理/采样器, set 1: 当前帧的实例缓冲区
+    std::vector<vk::DescriptorSetLayout> setLayouts = {
+        m_context->getBindlessManager()->getLayout(),
+        m_instanceSetLayout
+    };
+
+    vk::PushConstantRange pushConstantRange;
+    pushConstantRange.stageFlags = vk::ShaderStageFlagBits::eVertex;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(FrameConstants);
+
+    vk::PipelineLayoutCreateInfo pipelineLayoutInfo;
+    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+    pipelineLayoutInfo.pSetLayouts = setLayouts.data();
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (m_device.createPipelineLayout(&pipelineLayoutInfo, nullptr, &m_pipelineLayout) != vk::Result::eSuccess) {
+        return InternalError("Failed to create pipeline layout");
+    }
 
+    vk::Format colorAttachmentFormat = m_swapchain->getImageFormat();
+    vk::Format depthAttachmentFormat = m_swapchain->getDepthFormat();
+    if (depthAttachmentFormat == vk::Format::eUndefined) {
+        depthAttachmentFormat = vk::Format::eD32Sfloat;
+    }
+
+    NX_CORE_INFO("Pipeline Rendering Formats: Color={}, Depth={}", vk::to_string(colorAttachmentFormat), vk::to_string(depthAttachmentFormat));
+
+    // VS/PS 在工作线程上并行编译, 随后三个管线变体并行创建; 初始化不等待, 录制时只使用已就绪的管线
+    m_pipelineBuilder = std::make_unique<VK_PipelineBuilder>(m_device, &JobSystem::get());
+    auto vertShader = m_pipelineBuilder->compile(vsCode, "VSMain", shaderc_vertex_shader, defines);
+    auto fragShader = m_pipelineBuilder->compile(std::move(vsCode), "PSMain", shaderc_fragment_shader, defines);
+    for (uint32_t i = 0; i < MESH_PIPELINE_COUNT; ++i) {
+        const auto variant = static_cast<MeshPipelineVariant>(i);
+        m_pendingPipelines[i] = m_pipelineBuilder->build({vertShader, fragShader},
+            [this, variant, vertexFormat, colorAttachmentFormat, depthAttachmentFormat](std::span<const vk::ShaderModule> modules) {
+                return createMeshPipeline(variant, modules, vertexFormat, colorAttachmentFormat, depthAttachmentFormat);
+            });
+    }
+    return OkStatus();
+}
+
+StatusOr<vk::Pipeline> VK_Renderer::createMeshPipeline(MeshPipelineVariant variant, std::span<const vk::ShaderModule> modules, VertexFormat vertexFormat,
+                                                       vk::Format colorFormat, vk::Format depthFormat) const {
     vk::PipelineShaderStageCreateInfo vertShaderStageInfo;
     vertShaderStageInfo.stage = vk::ShaderStageFlagBits::eVertex;
-    vertShaderStageInfo.module = vertShaderModule;
+    vertShaderStageInfo.module = modules[0];
     vertShaderStageInfo.pName = "VSMain";
 
     vk::PipelineShaderStageCreateInfo fragShaderStageInfo;
     fragShaderStageInfo.stage = vk::ShaderStageFlagBits::eFragment;
-    fragShaderStageInfo.module = fragShaderModule;
+    fragShaderStageInfo.module = modules[1];
     fragShaderStageInfo.pName = "PSMain";
 
     vk::PipelineShaderStageCreateInfo shaderStages[] = { vertShaderStageInfo, fragShaderStageInfo };
 
     vk::VertexInputBindingDescription bindingDescription;
     bindingDescription.binding = 0;
-    bindingDescription.stride = sizeof(float) * 8; // 3 pos, 2 uv, 3 normal
+    bindingDescription.stride = getVertexStride(vertexFormat);
     bindingDescription.inputRate = vk::VertexInputRate::eVertex;
 
     std::array<vk::VertexInputAttributeDescription, 3> attributeDescriptions;
-    attributeDescriptions[0].binding = 0;
-    attributeDescriptions[0].location = 0;
-    attributeDescriptions[0].format = vk::Format::eR32G32B32Sfloat;
-    attributeDescriptions[0].offset = 0;
-
-    attributeDescriptions[1].binding = 0;
-    attributeDescriptions[1].location = 1;
-    attributeDescriptions[1].format = vk::Format::eR32G32Sfloat;
-    attributeDescriptions[1].offset = sizeof(float) * 3;
+    for (uint32_t i = 0; i < attributeDescriptions.size(); ++i) {
+        attributeDescriptions[i].binding = 0;
+        attributeDescriptions[i].location = i;
+    }
 
-    attributeDescriptions[2].binding = 0;
-    attributeDescriptions[2].location = 2;
-    attributeDescriptions[2].format = vk::Format::eR32G32B32Sfloat;
-    attributeDescriptions[2].offset = sizeof(float) * 5;
+    if (vertexFormat == VertexFormat::Compact) {
+        // unorm16x4 pos (AABB 相对), half2 uv, snorm16x2 八面体法线
+        attributeDescriptions[0].format = vk::Format::eR16G16B16A16Unorm;
+        attributeDescriptions[0].offset = 0;
+        attributeDescriptions[1].format = vk::Format::eR16G16Sfloat;
+        attributeDescriptions[1].offset = 8;
+        attributeDescriptions[2].format = vk::Format::eR16G16Snorm;
+        attributeDescriptions[2].offset = 12;
+    } else {
+        // 3 pos, 2 uv, 3 normal
+        attributeDescriptions[0].format = vk::Format::eR32G32B32Sfloat;
+        attributeDescriptions[0].offset = 0;
+        attributeDescriptions[1].format = vk::Format::eR32G32Sfloat;
+        attributeDescriptions[1].offset = sizeof(float) * 3;
+        attributeDescriptions[2].format = vk::Format::eR32G32B32Sfloat;
+        attributeDescriptions[2].offset = sizeof(float) * 5;
+    }
 
     vk::PipelineVertexInputStateCreateInfo vertexInputInfo;
     vertexInputInfo.vertexBindingDescriptionCount = 1;
@@ -222,44 +361,25 @@ Status VK_Renderer::createGraphicsPipeline() {
     dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
     dynamicState.pDynamicStates = dynamicStates.data();
 
-    std::vector<vk::DescriptorSetLayout> setLayouts = {
-        m_context->getBindlessManager()->getLayout()
-    };
-
-    vk::PushConstantRange pushConstantRange;
-    pushConstantRange.stageFlags = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
-    pushConstantRange.offset = 0;
-    pushConstantRange.size = sizeof(BindlessConstants);
-
-    vk::PipelineLayoutCreateInfo pipelineLayoutInfo;
-    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
-    pipelineLayoutInfo.pSetLayouts = setLayouts.data();
-    pipelineLayoutInfo.pushConstantRangeCount = 1;
-    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
-
-    if (m_device.createPipelineLayout(&pipelineLayoutInfo, nullptr, &m_pipelineLayout) != vk::Result::eSuccess) {
-        return InternalError("Failed to create pipeline layout");
-    }
-
-    vk::Format colorAttachmentFormat = m_swapchain->getImageFormat();
-    vk::Format depthAttachmentFormat = m_swapchain->getDepthFormat();
-    if (depthAttachmentFormat == vk::Format::eUndefined) {
-        depthAttachmentFormat = vk::Format::eD32Sfloat;
+    // 深度预通道: 只有顶点着色器, 不写颜色; 配套的主通道变体以 LessOrEqual 测试且不写深度, 每个像素只着色一次
+    if (variant == MeshPipelineVariant::DepthPrepass) {
+        colorBlendAttachment.colorWriteMask = {};
+    } else if (variant == MeshPipelineVariant::DepthEqual) {
+        depthStencilState.depthWriteEnable = VK_FALSE;
+        depthStencilState.depthCompareOp = vk::CompareOp::eLessOrEqual;
     }
 
-    NX_CORE_INFO("Pipeline Rendering Formats: Color={}, Depth={}", vk::to_string(colorAttachmentFormat), vk::to_string(depthAttachmentFormat));
-
     // [Note: Pipeline Format Fix] Use Vulkan-HPP structure for consistency
     vk::PipelineRenderingCreateInfo renderingCreateInfo;
     renderingCreateInfo.colorAttachmentCount = 1;
-    renderingCreateInfo.pColorAttachmentFormats = &colorAttachmentFormat;
-    renderingCreateInfo.depthAttachmentFormat = depthAttachmentFormat;
+    renderingCreateInfo.pColorAttachmentFormats = &colorFormat;
+    renderingCreateInfo.depthAttachmentFormat = depthFormat;
     renderingCreateInfo.stencilAttachmentFormat = vk::Format::eUndefined;
     renderingCreateInfo.viewMask = 0;
 
     vk::GraphicsPipelineCreateInfo pipelineInfo;
     pipelineInfo.pNext = &renderingCreateInfo;
-    pipelineInfo.stageCount = 2;
+    pipelineInfo.stageCount = variant == MeshPipelineVariant::DepthPrepass ? 1 : 2;
     pipelineInfo.pStages = shaderStages;
     pipelineInfo.pVertexInputState = &vertexInputInfo;
     pipelineInfo.pInputAssemblyState = &inputAssembly;
@@ -273,18 +393,89 @@ Status VK_Renderer::createGraphicsPipeline() {
     pipelineInfo.renderPass = VK_NULL_HANDLE;
     pipelineInfo.subpass = 0;
 
-    auto result = m_device.createGraphicsPipeline(nullptr, pipelineInfo);
+    auto result = m_device.createGraphicsPipeline(m_context->getPipelineCache(), pipelineInfo);
     if (result.result != vk::Result::eSuccess) {
         return InternalError("Failed to create graphics pipeline");
     }
-    m_graphicsPipeline = result.value;
+    return result.value;
+}
 
-    m_device.destroyShaderModule(fragShaderModule);
-    m_device.destroyShaderModule(vertShaderModule);
+void VK_Renderer::collectPipelines(bool wait) {
+    vk::Pipeline* targets[MESH_PIPELINE_COUNT] = { &m_graphicsPipeline, &m_depthPrepassPipeline, &m_depthEqualPipeline };
+    for (uint32_t i = 0; i < MESH_PIPELINE_COUNT; ++i) {
+        auto& pending = m_pendingPipelines[i];
+        if (!pending.valid() || (!wait && !VK_PipelineBuilder::isReady(pending))) continue;
+        const auto& result = pending.get();
+        if (result.ok()) {
+            *targets[i] = *result;
+        } else {
+            NX_CORE_ERROR("Mesh pipeline variant {} failed to build: {}", i, result.status().message());
+        }
+        pending = {};
+    }
+}
 
-    // Note: In a full implementation, we wouldn't destroy the layout here if we want to reuse it,
-    // but the manager doesn't cache layouts yet.
-    
+Status VK_Renderer::createInstanceResources() {
+    // 0: 实例记录, 1: 实例索引
+    std::array<vk::DescriptorSetLayoutBinding, 2> bindings = {
+        vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment),
+        vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eVertex)
+    };
+    vk::DescriptorSetLayoutCreateInfo layoutInfo({}, (uint32_t)bindings.size(), bindings.data());
+    auto layoutResult = m_device.createDescriptorSetLayout(layoutInfo);
+    if (layoutResult.result != vk::Result::eSuccess) return InternalError("Failed to create instance set layout");
+    m_instanceSetLayout = layoutResult.value;
+
+    vk::DescriptorPoolSize poolSize(vk::DescriptorType::eStorageBuffer, m_framesInFlight * (uint32_t)bindings.size());
+    vk::DescriptorPoolCreateInfo poolInfo({}, m_framesInFlight, 1, &poolSize);
+    auto poolResult = m_device.createDescriptorPool(poolInfo);
+    if (poolResult.result != vk::Result::eSuccess) return InternalError("Failed to create instance descriptor pool");
+    m_instancePool = poolResult.value;
+
+    std::vector<vk::DescriptorSetLayout> layouts(m_framesInFlight, m_instanceSetLayout);
+    vk::DescriptorSetAllocateInfo allocInfo(m_instancePool, (uint32_t)layouts.size(), layouts.data());
+    auto setResult = m_device.allocateDescriptorSets(allocInfo);
+    if (setResult.result != vk::Result::eSuccess) return InternalError("Failed to allocate instance descriptor sets");
+
+    m_frames.resize(m_framesInFlight);
+    for (uint32_t i = 0; i < m_framesInFlight; ++i) {
+        m_frames[i].instanceSet = setResult.value[i];
+        m_frames[i].indirectBuffer = std::make_unique<VK_IndirectBuffer>(m_context);
+        NX_RETURN_IF_ERROR(reserveInstances(i, 1024));
+    }
+    m_maxDrawIndirectCount = std::max(1u, m_context->getPhysicalDevice().getProperties().limits.maxDrawIndirectCount);
+    return OkStatus();
+}
+
+Status VK_Renderer::reserveInstances(uint32_t frame, uint32_t count) {
+    FrameResources& resources = m_frames[frame];
+    if (count <= resources.instanceCapacity) return OkStatus();
+    const uint32_t capacity = std::max(count, resources.instanceCapacity * 2);
+
+    const auto host = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+    auto buffer = std::make_unique<VK_Buffer>(m_context);
+    NX_RETURN_IF_ERROR(buffer->create((vk::DeviceSize)capacity * sizeof(InstanceData), vk::BufferUsageFlagBits::eStorageBuffer, host));
+    auto indexBuffer = std::make_unique<VK_Buffer>(m_context);
+    NX_RETURN_IF_ERROR(indexBuffer->create((vk::DeviceSize)capacity * sizeof(uint32_t), vk::BufferUsageFlagBits::eStorageBuffer, host));
+    resources.instanceBuffer = std::move(buffer);
+    resources.instanceIndexBuffer = std::move(indexBuffer);
+    resources.instanceCapacity = capacity;
+
+    auto* bindless = m_context->getBindlessManager();
+    if (resources.instanceBufferIndex != VK_GpuCuller::INVALID_INDEX) bindless->releaseStorageBuffer(resources.instanceBufferIndex);
+    if (resources.instanceIndexBufferIndex != VK_GpuCuller::INVALID_INDEX) bindless->releaseStorageBuffer(resources.instanceIndexBufferIndex);
+    NX_ASSIGN_OR_RETURN(resources.instanceBufferIndex, bindless->registerStorageBuffer(resources.instanceBuffer->getHandle()));
+    NX_ASSIGN_OR_RETURN(resources.instanceIndexBufferIndex, bindless->registerStorageBuffer(resources.instanceIndexBuffer->getHandle()));
+
+    std::array<vk::DescriptorBufferInfo, 2> bufferInfos = {
+        vk::DescriptorBufferInfo(resources.instanceBuffer->getHandle(), 0, VK_WHOLE_SIZE),
+        vk::DescriptorBufferInfo(resources.instanceIndexBuffer->getHandle(), 0, VK_WHOLE_SIZE)
+    };
+    std::array<vk::WriteDescriptorSet, 2> writes = {
+        vk::WriteDescriptorSet(resources.instanceSet, 0, 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &bufferInfos[0]),
+        vk::WriteDescriptorSet(resources.instanceSet, 1, 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &bufferInfos[1])
+    };
+    m_device.updateDescriptorSets(writes, nullptr);
     return OkStatus();
 }
 
@@ -300,7 +491,7 @@ Status VK_Renderer::createCommandPool() {
 }
 
 Status VK_Renderer::createCommandBuffers() {
-    m_commandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+    m_commandBuffers.resize(m_framesInFlight);
 
     vk::CommandBufferAllocateInfo allocInfo;
     allocInfo.commandPool = m_commandPool;
@@ -319,27 +510,79 @@ Status VK_Renderer::createCommandBuffers() {
 }
 
 Status VK_Renderer::createSyncObjects() {
-    m_imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    m_renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    m_inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
-
+    // 帧槽位的复用由 VK_Context 的帧时间线同步, 这里只需获取/呈现用的二进制信号量
     vk::SemaphoreCreateInfo semaphoreInfo;
-    vk::FenceCreateInfo fenceInfo;
-    fenceInfo.flags = vk::FenceCreateFlagBits::eSignaled;
+    for (uint32_t i = 0; i < m_framesInFlight; i++) {
+        auto semaphore = m_device.createSemaphore(semaphoreInfo);
+        if (semaphore.result != vk::Result::eSuccess) return InternalError("Failed to create sync objects");
+        m_imageAvailableSemaphores.push_back(semaphore.value);
+    }
+    return createPresentSemaphores();
+}
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-        auto sem1 = m_device.createSemaphore(semaphoreInfo);
-        auto sem2 = m_device.createSemaphore(semaphoreInfo);
-        auto fence = m_device.createFence(fenceInfo);
+Status VK_Renderer::createPresentSemaphores() {
+    vk::SemaphoreCreateInfo semaphoreInfo;
+    while (m_renderFinishedSemaphores.size() < m_swapchain->getImages().size()) {
+        auto semaphore = m_device.createSemaphore(semaphoreInfo);
+        if (semaphore.result != vk::Result::eSuccess) return InternalError("Failed to create present semaphore");
+        m_renderFinishedSemaphores.push_back(semaphore.value);
+    }
+    return OkStatus();
+}
 
-        if (sem1.result != vk::Result::eSuccess || sem2.result != vk::Result::eSuccess || fence.result != vk::Result::eSuccess) {
-            return InternalError("Failed to create sync objects");
+/**
+ * @brief 网格的局部包围盒, 换算到实例 world 矩阵作用的 (量化) 顶点空间; 没有包围盒时返回 min > max (始终可见)
+ */
+static VK_GpuCuller::InstanceBounds computeInstanceBounds(Registry* registry, entt::entity entity, const MeshComponent& mesh) {
+    VK_GpuCuller::InstanceBounds bounds;
+    bounds.min = {1.0f, 1.0f, 1.0f};
+    bounds.max = {-1.0f, -1.0f, -1.0f};
+    if (!registry->has<BoundsComponent>(entity)) return bounds;
+
+    const auto& component = registry->get<BoundsComponent>(entity);
+    bounds.min = component.localMin;
+    bounds.max = component.localMax;
+    if (mesh.hasQuantizedPositions()) {
+        for (int i = 0; i < 3; ++i) {
+            if (mesh.positionScale[i] == 0.0f) continue;
+            bounds.min[i] = (component.localMin[i] - mesh.positionOffset[i]) / mesh.positionScale[i];
+            bounds.max[i] = (component.localMax[i] - mesh.positionOffset[i]) / mesh.positionScale[i];
+            if (bounds.min[i] > bounds.max[i]) std::swap(bounds.min[i], bounds.max[i]);
         }
-        m_imageAvailableSemaphores[i] = sem1.value;
-        m_renderFinishedSemaphores[i] = sem2.value;
-        m_inFlightFences[i] = fence.value;
     }
-    return OkStatus();
+    return bounds;
+}
+
+void VK_Renderer::recordMeshDraws(vk::CommandBuffer commandBuffer, const MeshDrawRange& range) const {
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, range.pipeline);
+
+    vk::DescriptorSet descriptorSets[] = { m_context->getBindlessManager()->getSet(), range.instanceSet };
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipelineLayout, 0, 2, descriptorSets, 0, nullptr);
+
+    vk::Viewport viewport;
+    viewport.x = 0.0f;
+    viewport.y = (float)range.extent.height;
+    viewport.width = (float)range.extent.width;
+    viewport.height = -(float)range.extent.height;
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    commandBuffer.setViewport(0, 1, &viewport);
+
+    vk::Rect2D scissor;
+    scissor.offset = vk::Offset2D(0, 0);
+    scissor.extent = range.extent;
+    commandBuffer.setScissor(0, 1, &scissor);
+
+    FrameConstants frameConstants{range.viewProj};
+    commandBuffer.pushConstants<FrameConstants>(m_pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, frameConstants);
+
+    vk::DeviceSize offset = 0;
+    commandBuffer.bindVertexBuffers(0, 1, &range.vertexBuffer, &offset);
+    commandBuffer.bindIndexBuffer(range.indexBuffer, 0, range.indexType);
+    for (uint32_t first = range.firstCommand; first < range.firstCommand + range.commandCount; first += m_maxDrawIndirectCount) {
+        const uint32_t count = std::min(m_maxDrawIndirectCount, range.firstCommand + range.commandCount - first);
+        commandBuffer.drawIndexedIndirect(range.indirectBuffer, first * sizeof(DrawIndexedIndirectCommand), count, sizeof(DrawIndexedIndirectCommand));
+    }
 }
 
 void VK_Renderer::recordCommandBuffer(vk::CommandBuffer commandBuffer, uint32_t imageIndex, Registry* registry) {
@@ -348,8 +591,13 @@ void VK_Renderer::recordCommandBuffer(vk::CommandBuffer commandBuffer, uint32_t
     if (commandBuffer.begin(&beginInfo) != vk::Result::eSuccess) {
         return;
     }
+    // 读回该帧槽位上一次的 GPU 计时 (帧时间线已等待, 不阻塞) 并重置查询池, 须在任何区间之前
+    if (m_gpuProfiler && m_gpuProfiler->beginFrame(commandBuffer, m_currentFrame)) {
+        publishGpuTimings();
+    }
 
     vk::Extent2D extent = m_swapchain->getExtent();
+    collectPipelines(false);
 
     if (!registry) {
         static bool registryWarned = false;
@@ -359,81 +607,26 @@ void VK_Renderer::recordCommandBuffer(vk::CommandBuffer commandBuffer, uint32_t
         }
     }
 
-    vk::ImageMemoryBarrier colorBarrier;
-    colorBarrier.srcAccessMask = {};
-    colorBarrier.dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
-    colorBarrier.oldLayout = vk::ImageLayout::eUndefined;
-    colorBarrier.newLayout = vk::ImageLayout::eColorAttachmentOptimal;
-    colorBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    colorBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    colorBarrier.image = m_swapchain->getImages()[imageIndex];
-    colorBarrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-    colorBarrier.subresourceRange.baseMipLevel = 0;
-    colorBarrier.subresourceRange.levelCount = 1;
-    colorBarrier.subresourceRange.baseArrayLayer = 0;
-    colorBarrier.subresourceRange.layerCount = 1;
-
-    vk::ImageMemoryBarrier depthBarrier = colorBarrier;
-    depthBarrier.dstAccessMask = vk::AccessFlagBits::eDepthStencilAttachmentWrite;
-    depthBarrier.newLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
-    depthBarrier.image = static_cast<VK_Swapchain*>(m_swapchain)->getDepthImage();
-    depthBarrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eDepth;
-
-    vk::ImageMemoryBarrier barriers[] = { colorBarrier, depthBarrier };
-    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, 
-                                  vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eEarlyFragmentTests, 
-                                  {}, 0, nullptr, 0, nullptr, 2, barriers);
-
-    vk::RenderingAttachmentInfo colorAttachment;
-    colorAttachment.imageView = m_swapchain->getImageViews()[imageIndex];
-    colorAttachment.imageLayout = vk::ImageLayout::eColorAttachmentOptimal;
-    colorAttachment.loadOp = vk::AttachmentLoadOp::eClear;
-    colorAttachment.storeOp = vk::AttachmentStoreOp::eStore;
-    colorAttachment.clearValue = vk::ClearValue(std::array<float, 4>{0.12f, 0.14f, 0.22f, 1.0f});
-
-    vk::RenderingAttachmentInfo depthAttachment;
-    depthAttachment.imageView = static_cast<VK_Swapchain*>(m_swapchain)->getDepthImageView();
-    depthAttachment.imageLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
-    depthAttachment.loadOp = vk::AttachmentLoadOp::eClear;
-    depthAttachment.storeOp = vk::AttachmentStoreOp::eStore;
-    depthAttachment.clearValue.depthStencil = vk::ClearDepthStencilValue(1.0f, 0);
-
-    vk::RenderingInfo renderingInfo;
-    renderingInfo.renderArea = vk::Rect2D({0, 0}, extent);
-    renderingInfo.layerCount = 1;
-    renderingInfo.colorAttachmentCount = 1;
-    renderingInfo.pColorAttachments = &colorAttachment;
-    renderingInfo.pDepthAttachment = &depthAttachment;
-
-    commandBuffer.beginRendering(&renderingInfo);
-
-    commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_graphicsPipeline);
-
-    vk::DescriptorSet bindlessSet = m_context->getBindlessManager()->getSet();
-    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipelineLayout, 0, 1, &bindlessSet, 0, nullptr);
-
-    vk::Viewport viewport;
-    viewport.x = 0.0f;
-    viewport.y = (float)extent.height;
-    viewport.width = (float)extent.width;
-    viewport.height = -(float)extent.height;
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-    commandBuffer.setViewport(0, 1, &viewport);
-
-    vk::Rect2D scissor;
-    scissor.offset = vk::Offset2D(0, 0);
-    scissor.extent = extent;
-    commandBuffer.setScissor(0, 1, &scissor);
+    // 实例数据与间接命令须在 beginRendering 之前准备好: GPU 剔除的 dispatch 不能录制在渲染 pass 内
+    std::array<float, 16> viewProj = {
+        1,0,0,0,
+        0,1,0,0,
+        0,0,1,0,
+        0,0,0,1
+    };
+    FrameResources& frame = m_frames[m_currentFrame];
+    IBuffer* vb = nullptr;
+    IBuffer* ib = nullptr;
+    uint32_t meshCount = 0;
+    uint32_t batchCount = 0;
+    uint32_t totalTriangles = 0;
+    size_t shortCount = 0;
+    bool drawReady = false;
+    bool gpuCulled = false;
+    static int logCounter = 0;
+    bool shouldLog = false;
 
     if (registry) {
-        std::array<float, 16> viewProj = {
-            1,0,0,0,
-            0,1,0,0,
-            0,0,1,0,
-            0,0,0,1
-        };
-
         auto cameraView = registry->view<CameraComponent, TransformComponent>();
         for (auto entity : cameraView) {
             auto& camera = cameraView.get<CameraComponent>(entity);
@@ -444,7 +637,8 @@ void VK_Renderer::recordCommandBuffer(vk::CommandBuffer commandBuffer, uint32_t
             
             auto proj = camera.computeProjectionMatrix();
             
-            float pos[3] = { transform.position[0], transform.position[1], transform.position[2] };
+            // 世界空间位置, 与 LodSystem, TextureResidencySystem 的视点一致
+            float pos[3] = { transform.worldMatrix[12], transform.worldMatrix[13], transform.worldMatrix[14] };
             float target[3] = { camera.target[0], camera.target[1], camera.target[2] };
             float upVector[3] = { camera.up[0], camera.up[1], camera.up[2] };
             
@@ -495,81 +689,110 @@ void VK_Renderer::recordCommandBuffer(vk::CommandBuffer commandBuffer, uint32_t
 
         auto meshView = registry->view<MeshComponent, TransformComponent>();
         
-        // bind buffers once (assuming MeshManager stores glob buffers; will fix if true offsets used)
-        IBuffer* vb = m_context->getGlobalVertexBuffer();
-        IBuffer* ib = m_context->getGlobalIndexBuffer();
+        vb = m_context->getGlobalVertexBuffer();
+        ib = m_context->getGlobalIndexBuffer();
         
         if (vb && ib) {
-            vk::Buffer vertexBuffers[] = { static_cast<VK_Buffer*>(vb)->getHandle() };
-            vk::DeviceSize offsets[] = { 0 };
-            commandBuffer.bindVertexBuffers(0, 1, vertexBuffers, offsets);
-            commandBuffer.bindIndexBuffer(static_cast<VK_Buffer*>(ib)->getHandle(), 0, vk::IndexType::eUint32);
-
-            static int logCounter = 0;
-            bool shouldLog = (logCounter++ % 600 == 0);
-
-            size_t meshCount = 0;
-            uint32_t totalTriangles = 0;
-            uint32_t selectedId = m_selectedEntityId.load(std::memory_order_relaxed);
+            shouldLog = (logCounter++ % 600 == 0);
+
+            // 每个网格一条实例记录; 共享同一网格区间的网格合并为一条实例化间接命令, 其实例记录连续排列.
+            // 16/32 位索引共用同一缓冲区但须分别绑定, 按索引类型分组后每组一次间接绘制
+            m_instances.clear();
+            m_instanceBounds.clear();
+            const uint32_t selectedId = m_selectedEntityId.load(std::memory_order_relaxed);
+            const uint32_t fallbackTexture = m_whiteTexture->getBindlessTextureIndex();
+            const uint32_t fallbackSampler = m_whiteTexture->getBindlessSamplerIndex();
+            m_context->getBindlessManager()->getTextureSlotTable(m_textureSlotTable);
+            // 先在 CPU 上做视锥剔除, 只为可见网格生成实例与命令; GPU 剔除在此基础上再做 Hi-Z 遮挡测试.
+            // 可见集合同时驱动纹理驻留 (TextureResidencySystem), 视锥外网格的纹理才能成为换出候选
+            m_visibleEntities.clear();
+            m_cullEntities.clear();
+            m_frustumCuller.clear();
             for (auto entity : meshView) {
-                auto& mesh = meshView.get<MeshComponent>(entity);
-                auto& transform = meshView.get<TransformComponent>(entity);
-                
-                std::array<float, 16> mvp = multiplyMat4(viewProj, transform.worldMatrix);
-                
-                if (shouldLog) {
-                    std::string eName = "Unknown";
-                    if (registry->has<TagComponent>(entity)) {
-                        eName = registry->get<TagComponent>(entity).name;
-                    }
-                    NX_CORE_INFO("Drawing Component: entityID={} (Name={}), indexCount={}, vOffset={}, worldPos=({},{},{})", 
-                                 (uint32_t)entity, eName, mesh.indexCount, mesh.vertexOffset,
-                                 transform.position[0], transform.position[1], transform.position[2]);
-                    NX_CORE_INFO("MVP Matrix (Col-Major):");
-                    NX_CORE_INFO("  [{}, {}, {}, {}]", mvp[0], mvp[4], mvp[8], mvp[12]);
-                    NX_CORE_INFO("  [{}, {}, {}, {}]", mvp[1], mvp[5], mvp[9], mvp[13]);
-                    NX_CORE_INFO("  [{}, {}, {}, {}]", mvp[2], mvp[6], mvp[10], mvp[14]);
-                    NX_CORE_INFO("  [{}, {}, {}, {}]", mvp[3], mvp[7], mvp[11], mvp[15]);
-                }
-
-                BindlessConstants constants = {};
-                if (mesh.albedoTexture < VK_BindlessManager::MAX_TEXTURES) {
-                    constants.textureIndex = mesh.albedoTexture;
+                m_cullEntities.push_back(entity);
+                if (registry->has<BoundsComponent>(entity)) {
+                    const auto& bounds = registry->get<BoundsComponent>(entity);
+                    m_frustumCuller.add(bounds.worldSphere, bounds.worldMin, bounds.worldMax);
                 } else {
-                    constants.textureIndex = m_whiteTexture->getBindlessTextureIndex();
+                    m_frustumCuller.addUnbounded();
                 }
+            }
+            for (uint32_t index : m_frustumCuller.cull(viewProj, &JobSystem::get())) {
+                m_visibleEntities.push_back(m_cullEntities[index]);
+            }
 
-                if (mesh.samplerIndex < VK_BindlessManager::MAX_SAMPLERS) {
-                    constants.samplerIndex = mesh.samplerIndex;
-                } else {
-                    constants.samplerIndex = m_whiteTexture->getBindlessSamplerIndex();
+            // 排序键: 索引类型分组, 网格区间, 视深度 (裁剪空间 w), 材质 (当前只有一条主管线)
+            m_drawBatcher.clear();
+            m_drawBatcher.reserve((uint32_t)m_visibleEntities.size());
+            for (uint32_t i = 0; i < m_visibleEntities.size(); ++i) {
+                const auto entity = m_visibleEntities[i];
+                const auto& mesh = meshView.get<MeshComponent>(entity);
+                const auto& world = meshView.get<TransformComponent>(entity).worldMatrix;
+                std::array<float, 3> center = { world[12], world[13], world[14] };
+                if (registry->has<BoundsComponent>(entity)) {
+                    const auto& sphere = registry->get<BoundsComponent>(entity).worldSphere;
+                    center = { sphere[0], sphere[1], sphere[2] };
                 }
+                const float depth = viewProj[3] * center[0] + viewProj[7] * center[1] + viewProj[11] * center[2] + viewProj[15];
+                m_drawBatcher.add({mesh.indexType == IndexType::Uint16 ? 0u : 1u, mesh.getDrawIndexOffset(), mesh.getDrawIndexCount(),
+                                   static_cast<int32_t>(mesh.vertexOffset), mesh.albedoTexture, depth, i});
+            }
+            m_drawBatcher.build(&JobSystem::get());
+
+            const auto& order = m_drawBatcher.getOrder();
+            const auto& commands = m_drawBatcher.getCommands();
+            for (uint32_t batch = 0; batch < commands.size(); ++batch) {
+                const auto& command = commands[batch];
+                for (uint32_t i = command.firstInstance; i < command.firstInstance + command.instanceCount; ++i) {
+                    const auto entity = m_visibleEntities[order[i]];
+                    auto& mesh = meshView.get<MeshComponent>(entity);
+                    auto& transform = meshView.get<TransformComponent>(entity);
+
+                    InstanceData& instance = m_instances.emplace_back();
+                    instance.world = mesh.hasQuantizedPositions() ? multiplyMat4(transform.worldMatrix, mesh.computeDequantizeMatrix())
+                                                                  : transform.worldMatrix;
+                    instance.albedoFactor = mesh.albedoFactor;
+                    instance.highlightColor = ((uint32_t)entity == selectedId) ? std::array<float, 4>{1.0f, 0.6f, 0.1f, 0.35f}
+                                                                               : std::array<float, 4>{0.0f, 0.0f, 0.0f, 0.0f};
+                    instance.textureIndex = m_textureSlotTable[mesh.albedoTexture < VK_BindlessManager::MAX_TEXTURES ? mesh.albedoTexture : fallbackTexture];
+                    if (!m_textureUsed[instance.textureIndex]) {
+                        m_textureUsed[instance.textureIndex] = 1;
+                        m_usedTextures.push_back(instance.textureIndex);
+                    }
+                    instance.samplerIndex = mesh.samplerIndex < VK_BindlessManager::MAX_SAMPLERS ? mesh.samplerIndex : fallbackSampler;
+                    instance.metallicFactor = mesh.metallicFactor;
+                    instance.roughnessFactor = mesh.roughnessFactor;
 
-                constants.albedoFactor = mesh.albedoFactor;
-                constants.metallicFactor = mesh.metallicFactor;
-                constants.roughnessFactor = mesh.roughnessFactor;
-
-                constants.mvp = mvp;
-
-                bool isSelected = ((uint32_t)entity == selectedId);
-                if (isSelected) {
-                    constants.highlightColor = {1.0f, 0.6f, 0.1f, 0.35f};
-                } else {
-                    constants.highlightColor = {0.0f, 0.0f, 0.0f, 0.0f};
+                    auto& bounds = m_instanceBounds.emplace_back(computeInstanceBounds(registry, entity, mesh));
+                    bounds.batch = batch;
                 }
-
-                commandBuffer.pushConstants<BindlessConstants>(m_pipelineLayout, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0, constants);
-                
-                commandBuffer.drawIndexed(mesh.indexCount, 1, mesh.indexOffset, mesh.vertexOffset, 0);
-                meshCount++;
-                totalTriangles += mesh.indexCount / 3;
+                totalTriangles += command.indexCount / 3 * command.instanceCount;
             }
-            
-            g_RenderStats_DrawCalls.store((uint32_t)meshCount, std::memory_order_relaxed);
-            g_RenderStats_Triangles.store(totalTriangles, std::memory_order_relaxed);
 
-            if (shouldLog) {
-                NX_CORE_INFO("Recorded {} mesh draw calls ({} triangles) in this command buffer.", meshCount, totalTriangles);
+            meshCount = (uint32_t)m_instances.size();
+            batchCount = (uint32_t)commands.size();
+            shortCount = m_drawBatcher.getGroupBegin(1);
+            if (meshCount > 0 && reserveInstances(m_currentFrame, meshCount).ok()) {
+                std::memcpy(frame.instanceBuffer->map(), m_instances.data(), m_instances.size() * sizeof(InstanceData));
+
+                if (m_gpuCuller) {
+                    // 读回该帧槽位上一次提交 (帧时间线已等待) 的剔除计数
+                    const auto cullStats = m_gpuCuller->getStats(m_currentFrame);
+                    g_RenderStats_VisibleInstances.store(cullStats.visible, std::memory_order_relaxed);
+                    gpuCulled = m_gpuCuller->prepare(m_currentFrame, m_instanceBounds, commands, frame.instanceBufferIndex, sizeof(InstanceData),
+                                                     frame.instanceIndexBufferIndex, viewProj).ok();
+                    if (gpuCulled) {
+                        const uint32_t scope = m_gpuProfiler ? m_gpuProfiler->beginScope(commandBuffer, kPassGpuCull, true) : VK_GpuProfiler::INVALID_SCOPE;
+                        m_gpuCuller->recordCull(commandBuffer, m_currentFrame);
+                        if (m_gpuProfiler) m_gpuProfiler->endScope(commandBuffer, scope);
+                    }
+                }
+                if (!gpuCulled) {
+                    // 未经 GPU 剔除时实例按命令顺序连续排列, 索引为恒等映射
+                    auto* indices = static_cast<uint32_t*>(frame.instanceIndexBuffer->map());
+                    for (uint32_t i = 0; i < meshCount; ++i) indices[i] = i;
+                }
+                drawReady = gpuCulled || frame.indirectBuffer->uploadDrawIndexedCommands(commands).ok();
             }
         } else {
             static bool bufferWarned = false;
@@ -578,17 +801,160 @@ void VK_Renderer::recordCommandBuffer(vk::CommandBuffer commandBuffer, uint32_t
                 bufferWarned = true;
             }
         }
-    } else {
-        // Fallback for empty registry, but Triangle expects buffer now, doing nothing.
+    }
+
+    vk::ImageMemoryBarrier colorBarrier;
+    colorBarrier.srcAccessMask = {};
+    colorBarrier.dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
+    colorBarrier.oldLayout = vk::ImageLayout::eUndefined;
+    colorBarrier.newLayout = vk::ImageLayout::eColorAttachmentOptimal;
+    colorBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    colorBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    colorBarrier.image = m_swapchain->getImages()[imageIndex];
+    colorBarrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    colorBarrier.subresourceRange.baseMipLevel = 0;
+    colorBarrier.subresourceRange.levelCount = 1;
+    colorBarrier.subresourceRange.baseArrayLayer = 0;
+    colorBarrier.subresourceRange.layerCount = 1;
+
+    vk::ImageMemoryBarrier depthBarrier = colorBarrier;
+    depthBarrier.dstAccessMask = vk::AccessFlagBits::eDepthStencilAttachmentWrite;
+    depthBarrier.newLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+    depthBarrier.image = static_cast<VK_Swapchain*>(m_swapchain)->getDepthImage();
+    depthBarrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eDepth;
+
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eColorAttachmentOutput,
+                                  {}, 0, nullptr, 0, nullptr, 1, &colorBarrier);
+    // 上一帧的深度金字塔构建 (计算着色器) 仍可能在读取深度图
+    depthBarrier.srcAccessMask = vk::AccessFlagBits::eDepthStencilAttachmentWrite;
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eLateFragmentTests | vk::PipelineStageFlagBits::eComputeShader,
+                                  vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests,
+                                  {}, 0, nullptr, 0, nullptr, 1, &depthBarrier);
+
+    vk::RenderingAttachmentInfo colorAttachment;
+    colorAttachment.imageView = m_swapchain->getImageViews()[imageIndex];
+    colorAttachment.imageLayout = vk::ImageLayout::eColorAttachmentOptimal;
+    colorAttachment.loadOp = vk::AttachmentLoadOp::eClear;
+    colorAttachment.storeOp = vk::AttachmentStoreOp::eStore;
+    colorAttachment.clearValue = vk::ClearValue(std::array<float, 4>{0.12f, 0.14f, 0.22f, 1.0f});
+
+    vk::RenderingAttachmentInfo depthAttachment;
+    depthAttachment.imageView = static_cast<VK_Swapchain*>(m_swapchain)->getDepthImageView();
+    depthAttachment.imageLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+    depthAttachment.loadOp = vk::AttachmentLoadOp::eClear;
+    depthAttachment.storeOp = vk::AttachmentStoreOp::eStore;
+    depthAttachment.clearValue.depthStencil = vk::ClearDepthStencilValue(1.0f, 0);
+
+    vk::RenderingInfo renderingInfo;
+    renderingInfo.renderArea = vk::Rect2D({0, 0}, extent);
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachments = &colorAttachment;
+    renderingInfo.pDepthAttachment = &depthAttachment;
+
+    // 渲染 pass 的内容全部来自二级命令缓冲区: 网格绘制按命令区间切分到工作线程并行录制, UI 最后在当前线程录制
+    renderingInfo.flags = vk::RenderingFlagBits::eContentsSecondaryCommandBuffers;
+    m_recordTasks.clear();
+    uint32_t indirectDraws = 0;
+    // 主管线仍在后台构建时跳过网格绘制, 不阻塞本帧
+    if (drawReady && !m_graphicsPipeline) {
+        static bool pipelineWarned = false;
+        if (!pipelineWarned) {
+            NX_CORE_INFO("Mesh pipelines are still building, skipping mesh draws");
+            pipelineWarned = true;
+        }
+    }
+    if (drawReady && m_graphicsPipeline) {
+        MeshDrawRange range{};
+        range.instanceSet = frame.instanceSet;
+        range.viewProj = viewProj;
+        range.vertexBuffer = static_cast<VK_Buffer*>(vb)->getHandle();
+        range.indexBuffer = static_cast<VK_Buffer*>(ib)->getHandle();
+        // GPU 剔除后命令原位写出, instanceCount 为批次内的可见实例数 (全部剔除时为 0)
+        range.indirectBuffer = gpuCulled ? m_gpuCuller->getOutputCommands(m_currentFrame) : frame.indirectBuffer->getHandle();
+        range.extent = extent;
+
+        const std::pair<uint32_t, uint32_t> groups[] = { {0, (uint32_t)shortCount}, {(uint32_t)shortCount, batchCount} };
+        const vk::IndexType indexTypes[] = { vk::IndexType::eUint16, vk::IndexType::eUint32 };
+        const uint32_t taskBudget = JobSystem::get().getWorkerCount() + 1;
+        const uint32_t commandsPerTask = std::max(MIN_COMMANDS_PER_TASK, (batchCount + taskBudget - 1) / taskBudget);
+        auto addMeshTasks = [&](vk::Pipeline pipeline) {
+            range.pipeline = pipeline;
+            for (int g = 0; g < 2; ++g) {
+                range.indexType = indexTypes[g];
+                for (uint32_t first = groups[g].first; first < groups[g].second; first += commandsPerTask) {
+                    range.firstCommand = first;
+                    range.commandCount = std::min(commandsPerTask, groups[g].second - first);
+                    indirectDraws += (range.commandCount + m_maxDrawIndirectCount - 1) / m_maxDrawIndirectCount;
+                    m_recordTasks.push_back({[this, range](vk::CommandBuffer cmd) { recordMeshDraws(cmd, range); }});
+                }
+            }
+        };
+
+        // 命令已按由近到远排序; 开启深度预通道时先只写深度, 再以 LessOrEqual 着色
+        if (m_depthPrepass.load(std::memory_order_relaxed) && m_depthPrepassPipeline && m_depthEqualPipeline) {
+            addMeshTasks(m_depthPrepassPipeline);
+            addMeshTasks(m_depthEqualPipeline);
+        } else {
+            addMeshTasks(m_graphicsPipeline);
+        }
     }
 
 #ifdef ENABLE_RMLUI
     if (m_uiBridge) {
-        m_uiBridge->render();
+        // RmlUi 非线程安全, 在当前线程录制; 录制期间 getCurrentCommandBuffer 指向该二级命令缓冲区
+        m_recordTasks.push_back({[this](vk::CommandBuffer cmd) {
+            m_uiCommandBuffer = std::make_unique<VK_CommandBuffer>(cmd);
+            m_uiBridge->render();
+            m_uiCommandBuffer.reset();
+        }, false});
     }
 #endif
 
+    vk::Format depthFormat = m_swapchain->getDepthFormat();
+    if (depthFormat == vk::Format::eUndefined) depthFormat = vk::Format::eD32Sfloat;
+    const VK_SecondaryRecorder::Formats formats{m_swapchain->getImageFormat(), depthFormat};
+    const auto recordStart = std::chrono::steady_clock::now();
+    const auto recordStatus = m_secondaryRecorder->record(m_currentFrame, m_recordTasks, formats, &JobSystem::get(), m_secondaryBuffers);
+    const double recordMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - recordStart).count();
+    if (!recordStatus.ok()) {
+        static bool recordWarned = false;
+        if (!recordWarned) {
+            NX_CORE_ERROR("Renderer: failed to record secondary command buffers: {}", recordStatus.message());
+            recordWarned = true;
+        }
+        m_secondaryBuffers.clear();
+    }
+
+    if (vb && ib) {
+        g_RenderStats_DrawCalls.store(batchCount, std::memory_order_relaxed);
+        g_RenderStats_Triangles.store(totalTriangles, std::memory_order_relaxed);
+        if (!gpuCulled) g_RenderStats_VisibleInstances.store(meshCount, std::memory_order_relaxed);
+
+        if (shouldLog) {
+            NX_CORE_INFO("Recorded {} meshes ({} triangles) as {} instanced batches in {} indirect draw calls, {} visible after {} culling.",
+                         meshCount, totalTriangles, batchCount, indirectDraws, g_RenderStats_VisibleInstances.load(std::memory_order_relaxed),
+                         gpuCulled ? "GPU" : "CPU");
+            NX_CORE_INFO("Recorded {} secondary command buffers in {:.3f} ms.", m_secondaryBuffers.size(), recordMs);
+        }
+    }
+
+    // 主 pass 区间包含 UI; 管线统计查询须跨 executeCommands 保持活动, 没有 inheritedQueries 时只计时间
+    const uint32_t mainScope = m_gpuProfiler ? m_gpuProfiler->beginScope(commandBuffer, kPassMain, m_context->isInheritedQueriesSupported())
+                                             : VK_GpuProfiler::INVALID_SCOPE;
+    commandBuffer.beginRendering(&renderingInfo);
+    if (!m_secondaryBuffers.empty()) {
+        commandBuffer.executeCommands((uint32_t)m_secondaryBuffers.size(), m_secondaryBuffers.data());
+    }
     commandBuffer.endRendering();
+    if (m_gpuProfiler) m_gpuProfiler->endScope(commandBuffer, mainScope);
+
+    // 本帧深度构建 Hi-Z 金字塔, 供下一帧剔除
+    if (m_gpuCuller) {
+        const uint32_t scope = m_gpuProfiler ? m_gpuProfiler->beginScope(commandBuffer, kPassDepthPyramid, true) : VK_GpuProfiler::INVALID_SCOPE;
+        m_gpuCuller->recordDepthPyramid(commandBuffer, viewProj);
+        if (m_gpuProfiler) m_gpuProfiler->endScope(commandBuffer, scope);
+    }
 
     colorBarrier.srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
     colorBarrier.dstAccessMask = {};
@@ -608,11 +974,18 @@ Status VK_Renderer::onResize(uint32_t width, uint32_t height) {
     
     NX_CORE_INFO("VK_Renderer: Window resized to {}x{}", width, height);
     
-    NX_CORE_INFO("VK_Renderer: Waiting for device idle...");
-    deviceWaitIdle();
+    // 只等本渲染器提交的帧 (交换链图像与深度缓冲区的最后使用者), 其余队列上的上传不受影响
+    NX_CORE_INFO("VK_Renderer: Waiting for submitted frames...");
+    auto* timeline = m_context->getFrameTimeline();
+    NX_RETURN_IF_ERROR(timeline->wait(timeline->getSubmittedValue()));
     
     NX_CORE_INFO("VK_Renderer: Recreating swapchain...");
     NX_RETURN_IF_ERROR(m_swapchain->recreate(width, height));
+    NX_RETURN_IF_ERROR(createPresentSemaphores());
+    if (m_gpuCuller) {
+        NX_RETURN_IF_ERROR(m_gpuCuller->setDepthSource(m_swapchain->getDepthImage(), m_swapchain->getDepthImageView(),
+                                                       m_swapchain->getDepthFormat(), width, height));
+    }
     
     NX_CORE_INFO("VK_Renderer: Updating UI bridge dimensions...");
     if (m_uiBridge) {
@@ -638,7 +1011,12 @@ Status VK_Renderer::renderFrame(Registry* registry) {
 #endif
     uint32_t imageIndex;
     NX_RETURN_IF_ERROR(beginFrame(imageIndex));
+    const auto recordStart = std::chrono::steady_clock::now();
     recordCommandBuffer(m_commandBuffers[m_currentFrame], imageIndex, registry);
+    if (auto& trace = TraceExporter::get(); trace.isOpen()) {
+        const double startUs = trace.toTraceUs(recordStart);
+        trace.addEvent("RecordCommandBuffer", "cpu", TraceExporter::TRACK_CPU, startUs, trace.nowUs() - startUs);
+    }
     endFrame(imageIndex);
     return OkStatus();
 }
@@ -653,55 +1031,123 @@ void VK_Renderer::processEvent(const void* event) {
 }
 
 Status VK_Renderer::beginFrame(uint32_t& imageIndex) {
-    if (m_device.waitForFences(1, &m_inFlightFences[m_currentFrame], VK_TRUE, UINT64_MAX) != vk::Result::eSuccess) {
-        return InternalError("Wait for fences failed");
+    // 只等本帧槽位上一次的提交, 之后提交的帧继续在 GPU 上执行, 与本帧的录制重叠
+    auto* timeline = m_context->getFrameTimeline();
+    const auto waitStart = std::chrono::steady_clock::now();
+    NX_RETURN_IF_ERROR(timeline->wait(m_frames[m_currentFrame].timelineValue));
+    const auto waitEnd = std::chrono::steady_clock::now();
+
+    const double waitUs = std::chrono::duration<double, std::micro>(waitEnd - waitStart).count();
+    g_RenderStats_FrameWaitUs.store((uint32_t)waitUs, std::memory_order_relaxed);
+    if (m_lastFrameBegin.time_since_epoch().count() != 0) {
+        const double intervalUs = std::chrono::duration<double, std::micro>(waitEnd - m_lastFrameBegin).count();
+        const double overlap = intervalUs > 0.0 ? 100.0 * (1.0 - waitUs / intervalUs) : 100.0;
+        g_RenderStats_CpuGpuOverlap.store((uint32_t)std::clamp(overlap, 0.0, 100.0), std::memory_order_relaxed);
     }
+    m_lastFrameBegin = waitEnd;
+
+    // 获取失败时不必像 fence 那样回滚: 帧时间线的值只在提交时分配
     vk::Result acquireResult = m_device.acquireNextImageKHR(m_swapchain->getHandle(), UINT64_MAX, m_imageAvailableSemaphores[m_currentFrame], vk::Fence(), &imageIndex);
     if (acquireResult == vk::Result::eErrorOutOfDateKHR) return Status(absl::StatusCode::kUnavailable, "Swapchain out of date");
     if (acquireResult != vk::Result::eSuccess && acquireResult != vk::Result::eSuboptimalKHR) return InternalError("Failed to acquire swap chain image");
-    if (m_device.resetFences(1, &m_inFlightFences[m_currentFrame]) != vk::Result::eSuccess) return InternalError("Failed to reset fences");
     m_commandBuffers[m_currentFrame].reset();
     return OkStatus();
 }
+
 void VK_Renderer::endFrame(uint32_t imageIndex) {
-    vk::SubmitInfo submitInfo;
-    vk::Semaphore waitSemaphores[] = { m_imageAvailableSemaphores[m_currentFrame] };
-    vk::PipelineStageFlags waitStages[] = { vk::PipelineStageFlagBits::eColorAttachmentOutput };
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = waitSemaphores;
-    submitInfo.pWaitDstStageMask = waitStages;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &m_commandBuffers[m_currentFrame];
-    vk::Semaphore signalSemaphores[] = { m_renderFinishedSemaphores[m_currentFrame] };
-    submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = signalSemaphores;
-    (void)m_context->getGraphicsQueue().submit(1, &submitInfo, m_inFlightFences[m_currentFrame]);
-    vk::PresentInfoKHR presentInfo;
-    presentInfo.waitSemaphoreCount = 1;
-    presentInfo.pWaitSemaphores = signalSemaphores;
-    vk::SwapchainKHR swapchains[] = { m_swapchain->getHandle() };
-    presentInfo.swapchainCount = 1;
-    presentInfo.pSwapchains = swapchains;
-    presentInfo.pImageIndices = &imageIndex;
-    (void)m_context->getGraphicsQueue().presentKHR(&presentInfo);
-    m_currentFrame = (m_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    // 录制期间 (如 RmlUi 生成纹理) 新注册的槽位须在提交前写入, update-after-bind 允许此时更新;
+    // 改写在用槽位 (mip 替换, 换出) 不等待: 仍被在途帧采样的留到之后的帧, 其间新 view 经影子槽位供下一帧采样
+    auto* bindless = m_context->getBindlessManager();
+    bindless->flushWrites();
+    // 录制期间排队的缓冲区上传先于本帧命令提交到图形队列
+    m_context->getUploadContext()->flush();
+
+    auto* timeline = m_context->getFrameTimeline();
+    FrameResources& frame = m_frames[m_currentFrame];
+    std::lock_guard<std::mutex> queueLock(m_context->getGraphicsQueueMutex());
+    frame.timelineValue = timeline->nextValue();
+    bindless->markTexturesUsed(m_usedTextures, frame.timelineValue);
+    for (uint32_t index : m_usedTextures) m_textureUsed[index] = 0;
+    m_usedTextures.clear();
+
+    // 二进制信号量供呈现等待; 帧时间线的值标记本帧资源环, 也覆盖此前提交到图形队列的上传
+    const vk::Semaphore waitSemaphore = m_imageAvailableSemaphores[m_currentFrame];
+    const vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+    const std::array<vk::Semaphore, 2> signalSemaphores = {m_renderFinishedSemaphores[imageIndex], timeline->getSemaphore()};
+    const std::array<uint64_t, 2> signalValues = {0, frame.timelineValue};
+    vk::TimelineSemaphoreSubmitInfo timelineInfo(0, nullptr, (uint32_t)signalValues.size(), signalValues.data());
+    vk::SubmitInfo submitInfo(1, &waitSemaphore, &waitStage, 1, &m_commandBuffers[m_currentFrame], (uint32_t)signalSemaphores.size(),
+                              signalSemaphores.data());
+    submitInfo.pNext = &timelineInfo;
+
+    const vk::Result submitResult = m_context->getGraphicsQueue().submit(1, &submitInfo, nullptr);
+    if (submitResult == vk::Result::eSuccess) {
+        vk::PresentInfoKHR presentInfo;
+        presentInfo.waitSemaphoreCount = 1;
+        presentInfo.pWaitSemaphores = &signalSemaphores[0];
+        vk::SwapchainKHR swapchain = m_swapchain->getHandle();
+        presentInfo.swapchainCount = 1;
+        presentInfo.pSwapchains = &swapchain;
+        presentInfo.pImageIndices = &imageIndex;
+        (void)m_context->getGraphicsQueue().presentKHR(&presentInfo);
+    } else {
+        // 没有 GPU 工作会信号该值, 由主机补上, 否则下次复用本帧槽位时永久等待
+        NX_CORE_ERROR("Renderer: frame submission failed ({})", vk::to_string(submitResult));
+        if (m_gpuProfiler) m_gpuProfiler->discardFrame(m_currentFrame);
+        if (auto status = timeline->signal(frame.timelineValue); !status.ok()) NX_CORE_ERROR("Renderer: {}", status.message());
+    }
+
+    g_RenderStats_GpuQueuedFrames.store((uint32_t)(timeline->getSubmittedValue() - timeline->getCompletedValue()), std::memory_order_relaxed);
+    m_currentFrame = (m_currentFrame + 1) % m_framesInFlight;
+}
+
+void VK_Renderer::publishGpuTimings() {
+    VK_GpuProfiler::FrameTimings timings;
+    if (!m_gpuProfiler->getLatest(timings)) return;
+
+    uint32_t cullUs = 0, mainUs = 0, uiUs = 0, pyramidUs = 0;
+    for (const auto& pass : timings.passes) {
+        const uint32_t us = (uint32_t)(pass.durationMs * 1000.0);
+        if (pass.name == kPassGpuCull) cullUs = us;
+        else if (pass.name == kPassMain) mainUs = us;
+        else if (pass.name == kPassUi) uiUs = us;
+        else if (pass.name == kPassDepthPyramid) pyramidUs = us;
+    }
+    g_RenderStats_GpuFrameUs.store((uint32_t)(timings.gpuMs * 1000.0), std::memory_order_relaxed);
+    g_RenderStats_GpuCullUs.store(cullUs, std::memory_order_relaxed);
+    g_RenderStats_GpuMainPassUs.store(mainUs, std::memory_order_relaxed);
+    g_RenderStats_GpuUiUs.store(uiUs, std::memory_order_relaxed);
+    g_RenderStats_GpuDepthPyramidUs.store(pyramidUs, std::memory_order_relaxed);
+
+    auto& trace = TraceExporter::get();
+    if (!trace.isOpen()) return;
+    // GPU 时钟与 CPU 时钟没有校准, 以录制该帧的 CPU 时刻为 GPU 区间的起点, 只保证同一帧内的相对位置
+    const double originUs = trace.toTraceUs(timings.recordTime);
+    for (const auto& pass : timings.passes) {
+        if (!pass.hasStatistics) {
+            trace.addEvent(pass.name, "gpu", TraceExporter::TRACK_GPU, originUs + pass.startMs * 1000.0, pass.durationMs * 1000.0);
+            continue;
+        }
+        const TraceExporter::Arg args[] = {
+            {"ia_primitives", (double)pass.statistics.inputAssemblyPrimitives},
+            {"vs_invocations", (double)pass.statistics.vertexShaderInvocations},
+            {"clipping_primitives", (double)pass.statistics.clippingPrimitives},
+            {"fs_invocations", (double)pass.statistics.fragmentShaderInvocations},
+            {"cs_invocations", (double)pass.statistics.computeShaderInvocations},
+        };
+        trace.addEvent(pass.name, "gpu", TraceExporter::TRACK_GPU, originUs + pass.startMs * 1000.0, pass.durationMs * 1000.0, args);
+    }
 }
+
 uint32_t VK_Renderer::acquireNextImage() {
-    uint32_t imageIndex;
-    (void)m_device.acquireNextImageKHR(m_swapchain->getHandle(), UINT64_MAX, m_imageAvailableSemaphores[m_currentFrame], nullptr, &imageIndex);
+    uint32_t imageIndex = 0;
+    if (!beginFrame(imageIndex).ok()) return UINT32_MAX;
     return imageIndex;
 }
+
 void VK_Renderer::present(uint32_t imageIndex) {
-    vk::PresentInfoKHR presentInfo;
-    presentInfo.waitSemaphoreCount = 1;
-    vk::Semaphore signalSemaphores[] = { m_renderFinishedSemaphores[m_currentFrame] };
-    presentInfo.pWaitSemaphores = signalSemaphores;
-    vk::SwapchainKHR swapchains[] = { m_swapchain->getHandle() };
-    presentInfo.swapchainCount = 1;
-    presentInfo.pSwapchains = swapchains;
-    presentInfo.pImageIndices = &imageIndex;
-    (void)m_context->getGraphicsQueue().presentKHR(&presentInfo);
-    m_currentFrame = (m_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    endFrame(imageIndex);
 }
+
 void VK_Renderer::deviceWaitIdle() { (void)m_device.waitIdle(); }
 } // namespace Nexus
@@ -1,15 +1,23 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include "Base.h"
 #include "VK_Context.h"
 #include "VK_Swapchain.h"
 #include "Material.h"
 #include "VK_Texture.h"
 #include "Interfaces.h"
+#include <span>
 #include <vector>
 #include "VK_CommandBuffer.h"
 #include "VK_IndirectBuffer.h"
+#include "VK_GpuCuller.h"
+#include "VK_SecondaryRecorder.h"
+#include "VK_GpuProfiler.h"
+#include "VK_PipelineBuilder.h"
+#include "FrustumCuller.h"
+#include "DrawBatcher.h"
 #include "VK_UIBridge.h"
 #include "../ECS.h"
 #include "../../Core/Components.h"
@@ -41,13 +49,29 @@ public:
     void processEvent(const void* event) override;
 
     /**
-     * @brief 开始帧记录
+     * @brief 开始帧记录: 等待本帧资源环上一次的提交在帧时间线上完成, 再获取交换链图像
      */
     Status beginFrame(uint32_t& imageIndex);
+
+    /**
+     * @brief 提交本帧命令 (信号帧时间线) 并呈现
+     */
     void endFrame(uint32_t imageIndex);
 
-    ICommandBuffer* getCurrentCommandBuffer() override { return m_wrapperCommandBuffers[m_currentFrame].get(); }
+    /**
+     * @brief 当前录制目标: 录制 UI 二级命令缓冲区期间为其包装, 否则为本帧主命令缓冲区
+     */
+    ICommandBuffer* getCurrentCommandBuffer() override {
+        return m_uiCommandBuffer ? m_uiCommandBuffer.get() : m_wrapperCommandBuffers[m_currentFrame].get();
+    }
+    /**
+     * @brief 同 beginFrame, 失败时返回 UINT32_MAX
+     */
     uint32_t acquireNextImage() override;
+
+    /**
+     * @brief 同 endFrame
+     */
     void present(uint32_t imageIndex) override;
     ITexture* getSwapchainTexture(uint32_t index) override;
 
@@ -63,7 +87,28 @@ public:
     VK_UIBridge* getUIBridge() { return m_uiBridge.get(); }
 
     /**
-     * @brief 等待设备空闲
+     * @brief 开关深度预通道 (下一帧生效), 适合重叠绘制较多的场景
+     */
+    void setDepthPrepass(bool enabled) { m_depthPrepass.store(enabled, std::memory_order_relaxed); }
+    bool isDepthPrepassEnabled() const { return m_depthPrepass.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 在途帧数 (2 或 3), 由 VK_Context::setFramesInFlight 在初始化前指定
+     */
+    uint32_t getFramesInFlight() const { return m_framesInFlight; }
+
+    /**
+     * @brief 按 pass 的 GPU 计时, 设备不支持时间戳时为空
+     */
+    VK_GpuProfiler* getGpuProfiler() const { return m_gpuProfiler.get(); }
+
+    /**
+     * @brief 最近一帧通过视锥剔除的网格实体, 渲染线程停在同步点时才可读取
+     */
+    const std::vector<entt::entity>& getVisibleEntities() const { return m_visibleEntities; }
+
+    /**
+     * @brief 等待设备空闲 (仅关闭时)
      */
     void deviceWaitIdle();
 
@@ -75,10 +120,63 @@ public:
 private:
     Status createCommandPool();
     Status createGraphicsPipeline();
+
+    /**
+     * @brief 主 pass 的管线变体, 与 m_pendingPipelines 下标一致
+     */
+    enum class MeshPipelineVariant : uint32_t {
+        Main,         // 深度 Less, 写深度
+        DepthPrepass, // 只写深度
+        DepthEqual,   // 预通道之后着色: LessOrEqual, 不写深度
+    };
+    static constexpr uint32_t MESH_PIPELINE_COUNT = 3;
+
+    /**
+     * @brief 在工作线程上创建一个管线变体 (modules: VS, PS)
+     */
+    StatusOr<vk::Pipeline> createMeshPipeline(MeshPipelineVariant variant, std::span<const vk::ShaderModule> modules, VertexFormat vertexFormat,
+                                              vk::Format colorFormat, vk::Format depthFormat) const;
+
+    /**
+     * @brief 取回已构建完成的管线; wait 为 true 时等待全部完成 (关闭时)
+     */
+    void collectPipelines(bool wait);
     Status createCommandBuffers();
     Status createSyncObjects();
+    /**
+     * @brief 按交换链图像数补足呈现信号量 (交换链重建后图像数可能变化)
+     */
+    Status createPresentSemaphores();
+    Status createInstanceResources();
     void recordCommandBuffer(vk::CommandBuffer commandBuffer, uint32_t imageIndex, Registry* registry);
 
+    /**
+     * @brief 二级命令缓冲区中一段网格绘制的全部状态 (二级命令缓冲区不继承主命令缓冲区的绑定)
+     */
+    struct MeshDrawRange {
+        vk::Pipeline pipeline;
+        vk::DescriptorSet instanceSet;
+        std::array<float, 16> viewProj;
+        vk::Buffer vertexBuffer;
+        vk::Buffer indexBuffer;
+        vk::IndexType indexType;
+        vk::Buffer indirectBuffer;
+        uint32_t firstCommand;
+        uint32_t commandCount;
+        vk::Extent2D extent;
+    };
+    void recordMeshDraws(vk::CommandBuffer commandBuffer, const MeshDrawRange& range) const;
+
+    /**
+     * @brief 把 GPU 分析器最新读回的 pass 耗时写入编辑器统计, trace 开启时一并导出
+     */
+    void publishGpuTimings();
+
+    /**
+     * @brief 按实例数扩容当前帧的实例缓冲区, 扩容后重写其描述符与 bindless 槽位 (该帧在帧时间线上已等待)
+     */
+    Status reserveInstances(uint32_t frame, uint32_t count);
+
     VK_Context* m_context;
     VK_Swapchain* m_swapchain;
     vk::Device m_device;
@@ -87,13 +185,17 @@ private:
     // TODO: We will move these into Material class
     vk::PipelineLayout m_pipelineLayout;
     vk::Pipeline m_graphicsPipeline;
+    vk::Pipeline m_depthPrepassPipeline;
+    vk::Pipeline m_depthEqualPipeline;
+    std::atomic<bool> m_depthPrepass{false};
+    std::unique_ptr<VK_PipelineBuilder> m_pipelineBuilder;
+    std::array<VK_PipelineBuilder::PipelineFuture, MESH_PIPELINE_COUNT> m_pendingPipelines; // 构建中的变体, 完成后移入上面的句柄
     
     std::vector<vk::CommandBuffer> m_commandBuffers;
     std::vector<std::unique_ptr<VK_CommandBuffer>> m_wrapperCommandBuffers;
 
-    std::vector<vk::Semaphore> m_imageAvailableSemaphores;
-    std::vector<vk::Semaphore> m_renderFinishedSemaphores;
-    std::vector<vk::Fence> m_inFlightFences;
+    std::vector<vk::Semaphore> m_imageAvailableSemaphores; // 按帧槽位
+    std::vector<vk::Semaphore> m_renderFinishedSemaphores; // 按交换链图像: 图像再次获取时上一次呈现的等待已完成
     std::vector<std::unique_ptr<VK_Texture>> m_swapchainTextures;
     Status createSwapchainTextures();
     std::unique_ptr<VK_Texture> m_whiteTexture;
@@ -105,26 +207,67 @@ private:
     SPSCQueue<SDL_Event, 256> m_eventQueue;
 #endif
 
-    struct BindlessConstants {
-    uint32_t textureIndex; // Albedo
-    uint32_t normalIndex;
-    uint32_t metallicRoughnessIndex;
-    uint32_t occlusionIndex;
-    uint32_t emissiveIndex;
-    uint32_t samplerIndex;
-    uint32_t _pad0[2];
-
-    std::array<float, 4> albedoFactor;
-    float metallicFactor;
-    float roughnessFactor;
-    float _pad1[2];
-
-    std::array<float, 16> mvp;
-    std::array<float, 4> highlightColor; // (r,g,b,a) a>0 = highlighted
-};
+    /**
+     * @brief 主 pass 的逐实例数据, 与 Triangle.hlsl 的 InstanceData 布局一致 (std430)
+     */
+    struct InstanceData {
+        std::array<float, 16> world; // 已并入网格反量化
+        std::array<float, 4> albedoFactor;
+        std::array<float, 4> highlightColor; // (r,g,b,a) a>0 = highlighted
+        uint32_t textureIndex;
+        uint32_t samplerIndex;
+        float metallicFactor;
+        float roughnessFactor;
+    };
+    static_assert(sizeof(InstanceData) == 112, "InstanceData must match the shader layout");
+
+    struct FrameConstants {
+        std::array<float, 16> viewProj;
+    };
+
+    /**
+     * @brief 每个在途帧独立的实例/间接命令缓冲区 (host-visible, 录制时直接写入)
+     *
+     * 以 timelineValue 标记最近一次使用它们的提交, beginFrame 等到该值完成后才复用.
+     */
+    struct FrameResources {
+        uint64_t timelineValue = 0;
+        std::unique_ptr<VK_Buffer> instanceBuffer;
+        std::unique_ptr<VK_Buffer> instanceIndexBuffer; // 实例化命令的实例 -> 实例记录, GPU 剔除写入可见实例
+        std::unique_ptr<VK_IndirectBuffer> indirectBuffer;
+        uint32_t instanceCapacity = 0;
+        vk::DescriptorSet instanceSet;
+        uint32_t instanceBufferIndex = VK_GpuCuller::INVALID_INDEX; // bindless 存储缓冲区槽位, 供 GPU 剔除读取 world 矩阵
+        uint32_t instanceIndexBufferIndex = VK_GpuCuller::INVALID_INDEX;
+    };
+
+    vk::DescriptorSetLayout m_instanceSetLayout;
+    vk::DescriptorPool m_instancePool;
+    std::vector<FrameResources> m_frames;
+    std::vector<InstanceData> m_instances;                       // 录制期间的暂存, 跨帧复用容量
+    DrawBatcher m_drawBatcher;                                    // 按索引类型 (Uint16, Uint32) 分组并合并为实例化命令
+    std::vector<VK_GpuCuller::InstanceBounds> m_instanceBounds;   // 与 m_instances 同序
+    std::vector<uint32_t> m_usedTextures;                         // 本帧采样的纹理槽位, 提交前交给 markTexturesUsed
+    std::vector<uint8_t> m_textureUsed;                           // 纹理槽位 -> 本帧是否已记入 m_usedTextures
+    std::vector<uint32_t> m_textureSlotTable;                     // 纹理槽位 -> 本帧采样的槽位 (改写排队中的映射到影子槽位)
+    std::unique_ptr<VK_GpuCuller> m_gpuCuller;                    // 初始化失败时为空, 只做 CPU 视锥剔除
+    FrustumCuller m_frustumCuller;
+    std::vector<entt::entity> m_cullEntities;                     // FrustumCuller 对象索引 -> 实体
+    std::vector<entt::entity> m_visibleEntities;                  // 本帧视锥内的实体, 同步点供 TextureResidencySystem 读取
+    uint32_t m_maxDrawIndirectCount = 1;
+
+    std::unique_ptr<VK_SecondaryRecorder> m_secondaryRecorder;
+    std::vector<VK_SecondaryRecorder::Task> m_recordTasks;
+    std::vector<vk::CommandBuffer> m_secondaryBuffers;
+    std::unique_ptr<VK_CommandBuffer> m_uiCommandBuffer;         // 仅在录制 UI 二级命令缓冲区期间有效
+    std::unique_ptr<VK_GpuProfiler> m_gpuProfiler;                // 图形队列不支持时间戳时为空
+    static constexpr uint32_t MIN_COMMANDS_PER_TASK = 64;         // 命令太少时分发到工作线程得不偿失
 
     uint32_t m_currentFrame = 0;
-    static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
+    uint32_t m_framesInFlight = 2;
+    static constexpr uint32_t MIN_FRAMES_IN_FLIGHT = 2;
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+    std::chrono::steady_clock::time_point m_lastFrameBegin; // 上一次 beginFrame 等待结束的时刻, 两次之间为一个帧间隔
 public:
     std::atomic<uint32_t> m_selectedEntityId{0xFFFFFFFF};
 };
@@ -122,7 +122,7 @@ Status VK_RmlUi_Renderer::createPipeline(uint32_t width, uint32_t height) {
     vk::GraphicsPipelineCreateInfo pipelineInfo({}, 2, shaderStages, &vertexInputInfo, &inputAssembly, nullptr, &viewportState, &rasterizer, &multisampling, nullptr, &colorBlending, &dynamicState, m_pipelineLayout);
     pipelineInfo.pNext = &pipelineRenderingCreateInfo;
 
-    auto pipelineResult = device.createGraphicsPipeline(nullptr, pipelineInfo);
+    auto pipelineResult = device.createGraphicsPipeline(vkCtx->getPipelineCache(), pipelineInfo);
     if (pipelineResult.result != vk::Result::eSuccess) return InternalError("Failed to create RmlUi graphics pipeline");
     m_pipeline = pipelineResult.value;
 
@@ -137,16 +137,16 @@ Rml::CompiledGeometryHandle VK_RmlUi_Renderer::CompileGeometry(Rml::Span<const R
     geometry->indexCount = (uint32_t)indices.size();
 
     uint64_t vertexSize = vertices.size() * sizeof(Rml::Vertex);
-    // VK_BUFFER_USAGE_VERTEX_BUFFER_BIT = 0x00000080
-    // HOST_VISIBLE | HOST_COHERENT = 0x00000006
-    geometry->vertexBuffer = m_context->createBuffer(vertexSize, 0x00000080, 0x00000006);
+    // VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | TRANSFER_DST = 0x00000082
+    // DEVICE_LOCAL = 0x00000001, 数据在本帧提交前经上传上下文拷贝
+    geometry->vertexBuffer = m_context->createBuffer(vertexSize, 0x00000082, 0x00000001);
     if(geometry->vertexBuffer) {
         (void)geometry->vertexBuffer->uploadData(vertices.data(), vertexSize);
     }
 
     uint64_t indexSize = indices.size() * sizeof(int);
-    // VK_BUFFER_USAGE_INDEX_BUFFER_BIT = 0x00000040
-    geometry->indexBuffer = m_context->createBuffer(indexSize, 0x00000040, 0x00000006);
+    // VK_BUFFER_USAGE_INDEX_BUFFER_BIT | TRANSFER_DST = 0x00000042
+    geometry->indexBuffer = m_context->createBuffer(indexSize, 0x00000042, 0x00000001);
     if(geometry->indexBuffer) {
         (void)geometry->indexBuffer->uploadData(indices.data(), indexSize);
     }
@@ -0,0 +1,114 @@
+#include "VK_SamplerCache.h"
+#include "VK_BindlessManager.h"
+#include "Log.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Nexus {
+
+size_t SamplerDescHash::operator()(const SamplerDesc& desc) const {
+    auto bitsOf = [](float value) {
+        uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    };
+    size_t seed = 0;
+    auto combine = [&seed](size_t value) { seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2); };
+    combine((size_t)desc.magFilter);
+    combine((size_t)desc.minFilter);
+    combine((size_t)desc.mipmapMode);
+    combine((size_t)desc.addressModeU);
+    combine((size_t)desc.addressModeV);
+    combine((size_t)desc.addressModeW);
+    combine(bitsOf(desc.maxAnisotropy));
+    combine(bitsOf(desc.minLod));
+    combine(bitsOf(desc.maxLod));
+    return seed;
+}
+
+VK_SamplerCache::VK_SamplerCache(vk::Device device, VK_BindlessManager* bindlessManager)
+    : m_device(device), m_bindlessManager(bindlessManager) {}
+
+VK_SamplerCache::~VK_SamplerCache() {
+    shutdown();
+}
+
+StatusOr<VK_SamplerCache::Handle> VK_SamplerCache::acquire(const SamplerDesc& desc) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(desc);
+    if (it != m_entries.end()) {
+        ++it->second.refCount;
+        return Handle{it->second.sampler, it->second.bindlessIndex};
+    }
+
+    vk::SamplerCreateInfo samplerInfo;
+    samplerInfo.magFilter = desc.magFilter;
+    samplerInfo.minFilter = desc.minFilter;
+    samplerInfo.mipmapMode = desc.mipmapMode;
+    samplerInfo.addressModeU = desc.addressModeU;
+    samplerInfo.addressModeV = desc.addressModeV;
+    samplerInfo.addressModeW = desc.addressModeW;
+    samplerInfo.anisotropyEnable = desc.maxAnisotropy > 1.0f ? VK_TRUE : VK_FALSE;
+    samplerInfo.maxAnisotropy = std::max(desc.maxAnisotropy, 1.0f);
+    samplerInfo.borderColor = vk::BorderColor::eIntOpaqueBlack;
+    samplerInfo.unnormalizedCoordinates = VK_FALSE;
+    samplerInfo.compareEnable = VK_FALSE;
+    samplerInfo.compareOp = vk::CompareOp::eAlways;
+    samplerInfo.minLod = desc.minLod;
+    samplerInfo.maxLod = desc.maxLod;
+
+    auto samplerResult = m_device.createSampler(samplerInfo);
+    if (samplerResult.result != vk::Result::eSuccess) return InternalError("Failed to create sampler");
+
+    Entry entry;
+    entry.sampler = samplerResult.value;
+    entry.refCount = 1;
+    auto index = m_bindlessManager->registerSampler(entry.sampler);
+    if (!index.ok()) {
+        m_device.destroySampler(entry.sampler);
+        return index.status();
+    }
+    entry.bindlessIndex = *index;
+    m_entries.emplace(desc, entry);
+    m_descBySampler.emplace(static_cast<VkSampler>(entry.sampler), desc);
+    return Handle{entry.sampler, entry.bindlessIndex};
+}
+
+void VK_SamplerCache::release(vk::Sampler sampler) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto descIt = m_descBySampler.find(static_cast<VkSampler>(sampler));
+    if (descIt == m_descBySampler.end()) return;
+    auto it = m_entries.find(descIt->second);
+    if (--it->second.refCount > 0) return;
+
+    m_device.destroySampler(it->second.sampler);
+    m_bindlessManager->releaseSampler(it->second.bindlessIndex);
+    m_entries.erase(it);
+    m_descBySampler.erase(descIt);
+}
+
+void VK_SamplerCache::shutdown() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_entries.empty()) {
+        NX_CORE_WARN("[SamplerCache] {} samplers still referenced at shutdown", m_entries.size());
+    }
+    for (auto& [desc, entry] : m_entries) {
+        m_device.destroySampler(entry.sampler);
+    }
+    m_entries.clear();
+    m_descBySampler.clear();
+}
+
+uint32_t VK_SamplerCache::getSamplerCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<uint32_t>(m_entries.size());
+}
+
+uint32_t VK_SamplerCache::getRefCount(vk::Sampler sampler) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto descIt = m_descBySampler.find(static_cast<VkSampler>(sampler));
+    if (descIt == m_descBySampler.end()) return 0;
+    return m_entries.at(descIt->second).refCount;
+}
+
+} // namespace Nexus
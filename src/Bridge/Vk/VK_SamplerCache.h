@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Base.h"
+#include <vulkan/vulkan.hpp>
+#include <mutex>
+#include <unordered_map>
+
+namespace Nexus {
+
+class VK_BindlessManager;
+
+/**
+ * @brief 采样器状态, 作为缓存键
+ */
+struct SamplerDesc {
+    vk::Filter magFilter = vk::Filter::eLinear;
+    vk::Filter minFilter = vk::Filter::eLinear;
+    vk::SamplerMipmapMode mipmapMode = vk::SamplerMipmapMode::eLinear;
+    vk::SamplerAddressMode addressModeU = vk::SamplerAddressMode::eRepeat;
+    vk::SamplerAddressMode addressModeV = vk::SamplerAddressMode::eRepeat;
+    vk::SamplerAddressMode addressModeW = vk::SamplerAddressMode::eRepeat;
+    float maxAnisotropy = 1.0f; // <= 1 关闭各向异性
+    float minLod = 0.0f;
+    float maxLod = VK_LOD_CLAMP_NONE;
+
+    bool operator==(const SamplerDesc& other) const = default;
+};
+
+struct SamplerDescHash {
+    size_t operator()(const SamplerDesc& desc) const;
+};
+
+/**
+ * @brief 按状态去重的采样器缓存
+ *
+ * 相同状态的纹理共享同一个 vk::Sampler 及其 bindless 槽位 (MDI.hlsl 中 samplers[64]).
+ * 引用计数归零时销毁采样器并归还 bindless 槽位.
+ */
+class VK_SamplerCache {
+public:
+    struct Handle {
+        vk::Sampler sampler;
+        uint32_t bindlessIndex = 0;
+    };
+
+    VK_SamplerCache(vk::Device device, VK_BindlessManager* bindlessManager);
+    ~VK_SamplerCache();
+
+    /**
+     * @brief 获取 (必要时创建并注册) 采样器, 引用计数 +1
+     * @return bindless 采样器表已满时返回 ResourceExhausted
+     */
+    StatusOr<Handle> acquire(const SamplerDesc& desc);
+
+    /**
+     * @brief 引用计数 -1, 归零时销毁
+     */
+    void release(vk::Sampler sampler);
+
+    void shutdown();
+
+    uint32_t getSamplerCount() const;
+    uint32_t getRefCount(vk::Sampler sampler) const;
+
+private:
+    struct Entry {
+        vk::Sampler sampler;
+        uint32_t bindlessIndex = 0;
+        uint32_t refCount = 0;
+    };
+
+    vk::Device m_device;
+    VK_BindlessManager* m_bindlessManager;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<SamplerDesc, Entry, SamplerDescHash> m_entries;
+    std::unordered_map<VkSampler, SamplerDesc> m_descBySampler;
+};
+
+} // namespace Nexus
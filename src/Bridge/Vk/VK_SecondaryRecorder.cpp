@@ -0,0 +1,98 @@
+#include "VK_SecondaryRecorder.h"
+#include "VK_Context.h"
+#include "JobSystem.h"
+
+namespace Nexus {
+
+VK_SecondaryRecorder::VK_SecondaryRecorder(VK_Context* context) : m_context(context), m_device(context->getDevice()) {}
+
+VK_SecondaryRecorder::~VK_SecondaryRecorder() {
+    shutdown();
+}
+
+Status VK_SecondaryRecorder::initialize(uint32_t framesInFlight) {
+    m_frames.resize(framesInFlight);
+    return OkStatus();
+}
+
+void VK_SecondaryRecorder::shutdown() {
+    for (auto& slots : m_frames) {
+        // 销毁命令池会一并释放其命令缓冲区
+        for (auto& slot : slots) m_device.destroyCommandPool(slot.pool);
+    }
+    m_frames.clear();
+}
+
+Status VK_SecondaryRecorder::reserveSlots(uint32_t frame, uint32_t count) {
+    auto& slots = m_frames[frame];
+    while (slots.size() < count) {
+        vk::CommandPoolCreateInfo poolInfo(vk::CommandPoolCreateFlagBits::eTransient, m_context->getGraphicsQueueFamilyIndex());
+        auto pool = m_device.createCommandPool(poolInfo);
+        if (pool.result != vk::Result::eSuccess) return InternalError("Failed to create secondary command pool");
+
+        vk::CommandBufferAllocateInfo allocInfo(pool.value, vk::CommandBufferLevel::eSecondary, 1);
+        auto buffers = m_device.allocateCommandBuffers(allocInfo);
+        if (buffers.result != vk::Result::eSuccess) {
+            m_device.destroyCommandPool(pool.value);
+            return InternalError("Failed to allocate secondary command buffer");
+        }
+        slots.push_back({pool.value, buffers.value[0]});
+    }
+    return OkStatus();
+}
+
+Status VK_SecondaryRecorder::record(uint32_t frame, std::span<const Task> tasks, const Formats& formats, JobSystem* jobs,
+                                    std::vector<vk::CommandBuffer>& out) {
+    out.clear();
+    if (tasks.empty()) return OkStatus();
+    NX_RETURN_IF_ERROR(reserveSlots(frame, (uint32_t)tasks.size()));
+    const auto& slots = m_frames[frame];
+    for (uint32_t i = 0; i < tasks.size(); ++i) {
+        if (m_device.resetCommandPool(slots[i].pool) != vk::Result::eSuccess) return InternalError("Failed to reset secondary command pool");
+    }
+
+    vk::CommandBufferInheritanceRenderingInfo renderingInfo;
+    renderingInfo.colorAttachmentCount = formats.color != vk::Format::eUndefined ? 1 : 0;
+    renderingInfo.pColorAttachmentFormats = &formats.color;
+    renderingInfo.depthAttachmentFormat = formats.depth;
+    renderingInfo.rasterizationSamples = vk::SampleCountFlagBits::e1;
+    vk::CommandBufferInheritanceInfo inheritance;
+    inheritance.pNext = &renderingInfo;
+    inheritance.pipelineStatistics = m_inheritedStatistics;
+    const vk::CommandBufferBeginInfo beginInfo(vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+                                               &inheritance);
+
+    // 每个任务只写自己的槽位与结果
+    std::vector<uint8_t> recorded(tasks.size(), 0);
+    auto recordTask = [&](uint32_t i) {
+        const vk::CommandBuffer cmd = slots[i].buffer;
+        if (cmd.begin(beginInfo) != vk::Result::eSuccess) return;
+        tasks[i].record(cmd);
+        recorded[i] = cmd.end() == vk::Result::eSuccess;
+    };
+
+    // 不可并行的任务在调用线程录制, 之后调用线程与工作线程一起领取可并行的任务;
+    // 线程池中排在前面的后台任务 (纹理解码, 管线构建) 不会让录制空等
+    std::vector<uint32_t> parallelTasks;
+    for (uint32_t i = 0; i < tasks.size(); ++i) {
+        if (jobs && tasks[i].parallel) parallelTasks.push_back(i);
+    }
+    auto recordSerial = [&]() {
+        for (uint32_t i = 0; i < tasks.size(); ++i) {
+            if (!jobs || !tasks[i].parallel) recordTask(i);
+        }
+    };
+    if (jobs) {
+        jobs->dispatch((uint32_t)parallelTasks.size(), [&](uint32_t i) { recordTask(parallelTasks[i]); }, recordSerial);
+    } else {
+        recordSerial();
+    }
+
+    for (uint32_t i = 0; i < tasks.size(); ++i) {
+        if (!recorded[i]) return InternalError("Failed to record secondary command buffer");
+        out.push_back(slots[i].buffer);
+    }
+    return OkStatus();
+}
+
+} // namespace Nexus
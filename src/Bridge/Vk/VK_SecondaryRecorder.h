@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Base.h"
+#include <vulkan/vulkan.hpp>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace Nexus {
+
+class VK_Context;
+class JobSystem;
+
+/**
+ * @brief 并行录制动态渲染 pass 内的二级命令缓冲区
+ *
+ * 每个在途帧的每个录制槽位各有一个命令池 (命令池须外部同步, 槽位之间互不争用), 第 i 个任务使用第 i 个槽位.
+ * 可并行的任务经 JobSystem::dispatch 由调用线程与工作线程共同领取, 不可并行的任务在调用线程录制;
+ * 全部完成后按任务顺序返回二级命令缓冲区, 由主命令缓冲区在以 eContentsSecondaryCommandBuffers
+ * 开始的渲染 pass 内 executeCommands 拼接. 二级命令缓冲区不继承任何状态, 任务须自行绑定管线, 视口等.
+ */
+class VK_SecondaryRecorder {
+public:
+    struct Task {
+        std::function<void(vk::CommandBuffer)> record;
+        bool parallel = true; // false: 在调用线程录制 (如非线程安全的 RmlUi)
+    };
+
+    /**
+     * @brief 渲染 pass 的附件格式, 写入二级命令缓冲区的继承信息
+     */
+    struct Formats {
+        vk::Format color = vk::Format::eUndefined;
+        vk::Format depth = vk::Format::eUndefined;
+    };
+
+    explicit VK_SecondaryRecorder(VK_Context* context);
+    ~VK_SecondaryRecorder();
+
+    Status initialize(uint32_t framesInFlight);
+    void shutdown();
+
+    /**
+     * @brief 录制帧 frame 的全部任务 (该帧在帧时间线上已等待; 每帧调用一次, 会重置该帧用到的命令池)
+     * @param jobs 为空时全部在调用线程录制
+     * @param out 与 tasks 同序的二级命令缓冲区
+     */
+    Status record(uint32_t frame, std::span<const Task> tasks, const Formats& formats, JobSystem* jobs,
+                  std::vector<vk::CommandBuffer>& out);
+
+    uint32_t getSlotCount(uint32_t frame) const { return (uint32_t)m_frames[frame].size(); }
+
+    /**
+     * @brief 主命令缓冲区在 executeCommands 期间可能有活动的管线统计查询时, 二级命令缓冲区须继承其统计位 (需 inheritedQueries)
+     */
+    void setInheritedStatistics(vk::QueryPipelineStatisticFlags flags) { m_inheritedStatistics = flags; }
+
+private:
+    struct Slot {
+        vk::CommandPool pool;
+        vk::CommandBuffer buffer;
+    };
+
+    Status reserveSlots(uint32_t frame, uint32_t count);
+
+    VK_Context* m_context;
+    vk::Device m_device;
+    std::vector<std::vector<Slot>> m_frames;
+    vk::QueryPipelineStatisticFlags m_inheritedStatistics;
+};
+
+} // namespace Nexus
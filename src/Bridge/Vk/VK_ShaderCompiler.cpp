@@ -1,19 +1,136 @@
 #include "VK_ShaderCompiler.h"
+#include "ShaderCache.h"
+#include "ResourceLoader.h"
 #include "Log.h"
-#include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
 #include <fstream>
+#include <sstream>
 
 namespace Nexus {
 
-static bool g_dumpSpirv = true;
+static std::string g_cacheDirectory = VK_ShaderCompiler::DEFAULT_CACHE_DIRECTORY;
 
-StatusOr<vk::ShaderModule> VK_ShaderCompiler::compileLayer(vk::Device device, const std::string& source, const std::string& entryPoint, shaderc_shader_kind stage) {
-    shaderc::Compiler compiler;
+namespace {
+
+/**
+ * @brief 解析 #include 并记录每个被包含文件的路径与内容, 供缓存键使用
+ *
+ * 引号形式相对包含者所在目录, 尖括号形式与顶层源码的包含相对着色器目录.
+ */
+class RecordingIncluder : public shaderc::CompileOptions::IncluderInterface {
+public:
+    explicit RecordingIncluder(std::filesystem::path shaderDirectory) : m_shaderDirectory(std::move(shaderDirectory)) {}
+
+    shaderc_include_result* GetInclude(const char* requestedSource, shaderc_include_type type, const char* requestingSource, size_t) override {
+        std::filesystem::path base = m_shaderDirectory;
+        if (type == shaderc_include_type_relative && m_includes.end() != findInclude(requestingSource)) {
+            base = std::filesystem::path(requestingSource).parent_path();
+        }
+        Entry& entry = m_entries.emplace_back();
+        const std::string path = (base / requestedSource).lexically_normal().generic_string();
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            // source_name 为空表示解析失败, content 为错误信息
+            entry.content = "Cannot open include file: " + path;
+        } else {
+            std::stringstream content;
+            content << file.rdbuf();
+            entry.name = path;
+            entry.content = content.str();
+            if (findInclude(path) == m_includes.end()) m_includes.push_back({path, entry.content});
+        }
+        entry.result = {entry.name.c_str(), entry.name.size(), entry.content.c_str(), entry.content.size(), nullptr};
+        return &entry.result;
+    }
+
+    // 结果在 includer 析构时统一释放
+    void ReleaseInclude(shaderc_include_result*) override {}
+
+    const std::vector<ShaderCache::Include>& getIncludes() const { return m_includes; }
+
+private:
+    struct Entry {
+        std::string name;
+        std::string content;
+        shaderc_include_result result{};
+    };
+
+    std::vector<ShaderCache::Include>::const_iterator findInclude(std::string_view path) const {
+        return std::find_if(m_includes.begin(), m_includes.end(), [&](const ShaderCache::Include& include) { return include.path == path; });
+    }
+
+    std::filesystem::path m_shaderDirectory;
+    std::deque<Entry> m_entries; // deque 扩容不移动元素, 返回给 shaderc 的指针保持有效
+    std::vector<ShaderCache::Include> m_includes;
+};
+
+/**
+ * @brief 编译器指纹: shaderc 目标 SPIR-V 版本与一个固定探针着色器的输出哈希
+ *
+ * shaderc 不导出自身版本号; 升级 shaderc/glslang/SPIRV-Tools 会改变 SPIR-V 头中的生成器字或优化结果,
+ * 从而改变探针输出. 每个进程只编译一次探针.
+ */
+const std::string& getCompilerFingerprint() {
+    static const std::string fingerprint = []() {
+        unsigned int version = 0;
+        unsigned int revision = 0;
+        shaderc_get_spv_version(&version, &revision);
+        std::string result = "spv" + std::to_string(version) + "." + std::to_string(revision);
+
+        constexpr const char* probe = "float4 main(float4 position : POSITION) : SV_Position { return position * 2.0; }";
+        shaderc::Compiler compiler;
+        shaderc::CompileOptions options;
+        options.SetSourceLanguage(shaderc_source_language_hlsl);
+        options.SetOptimizationLevel(shaderc_optimization_level_performance);
+        options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_3);
+        shaderc::SpvCompilationResult module = compiler.CompileGlslToSpv(probe, shaderc_vertex_shader, "probe", "main", options);
+        const std::vector<uint32_t> spirv(module.cbegin(), module.cend());
+        const std::string_view bytes(reinterpret_cast<const char*>(spirv.data()), spirv.size() * sizeof(uint32_t));
+        char hash[24];
+        std::snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)ShaderCache::computeKey(bytes, "main", shaderc_vertex_shader, ""));
+        return result + ";probe=" + hash;
+    }();
+    return fingerprint;
+}
+
+} // namespace
+
+void VK_ShaderCompiler::setCacheDirectory(std::string directory) {
+    g_cacheDirectory = std::move(directory);
+}
+
+StatusOr<std::vector<uint32_t>> VK_ShaderCompiler::compileSpirv(const std::string& source, const std::string& entryPoint, shaderc_shader_kind stage,
+                                                                const std::vector<std::pair<std::string, std::string>>& defines) {
+    // 选项串须覆盖下面所有影响输出的编译设置
+    std::string optionKey = "hlsl;performance;vulkan1.3;" + getCompilerFingerprint();
+    for (const auto& [name, value] : defines) {
+        optionKey += ";" + name + "=" + value;
+    }
+    const ShaderCache cache(g_cacheDirectory);
+    const uint64_t sourceKey = ShaderCache::computeKey(source, entryPoint, (uint32_t)stage, optionKey);
+    if (!g_cacheDirectory.empty()) {
+        // 上次编译记录的包含文件须仍然存在, 其当前内容并入最终键
+        if (auto includes = cache.loadIncludes(sourceKey); includes.ok()) {
+            if (auto cached = cache.load(ShaderCache::computeIncludeKey(sourceKey, *includes)); cached.ok()) return cached;
+        }
+    }
+
+    // shaderc::Compiler 创建代价不小且不能跨线程并发使用, 每个线程复用自己的实例
+    thread_local shaderc::Compiler compiler;
     shaderc::CompileOptions options;
     
     options.SetSourceLanguage(shaderc_source_language_hlsl);
     options.SetOptimizationLevel(shaderc_optimization_level_performance);
     options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_3);
+    for (const auto& [name, value] : defines) {
+        options.AddMacroDefinition(name, value);
+    }
+    auto includer = std::make_unique<RecordingIncluder>(std::filesystem::path(ResourceLoader::getBasePath()) / SHADER_DIRECTORY);
+    const RecordingIncluder& recorded = *includer;
+    options.SetIncluder(std::move(includer));
 
     shaderc::SpvCompilationResult module = compiler.CompileGlslToSpv(source, stage, "shader", entryPoint.c_str(), options);
 
@@ -23,16 +140,21 @@ StatusOr<vk::ShaderModule> VK_ShaderCompiler::compileLayer(vk::Device device, co
     }
 
     std::vector<uint32_t> spirv(module.cbegin(), module.cend());
-
-    if (g_dumpSpirv) {
-        std::string filename = "Data/Shaders/dump_" + entryPoint + ".spv";
-        std::ofstream file(filename, std::ios::binary);
-        if (file.is_open()) {
-            file.write(reinterpret_cast<const char*>(spirv.data()), spirv.size() * sizeof(uint32_t));
-            file.close();
-            NX_CORE_INFO("Dumped SPIR-V: {} ({} bytes)", filename, spirv.size() * sizeof(uint32_t));
+    if (!g_cacheDirectory.empty()) {
+        // 先写 SPIR-V 再写包含列表, 列表可见时对应条目已就绪; 缓存写入失败只影响下次启动
+        const uint64_t key = ShaderCache::computeIncludeKey(sourceKey, recorded.getIncludes());
+        Status status = cache.store(key, spirv);
+        if (status.ok()) status = cache.storeIncludes(sourceKey, recorded.getIncludes());
+        if (!status.ok()) {
+            NX_CORE_WARN("Failed to cache SPIR-V for {}: {}", entryPoint, status.message());
         }
     }
+    return spirv;
+}
+
+StatusOr<vk::ShaderModule> VK_ShaderCompiler::compileLayer(vk::Device device, const std::string& source, const std::string& entryPoint, shaderc_shader_kind stage,
+                                                           const std::vector<std::pair<std::string, std::string>>& defines) {
+    NX_ASSIGN_OR_RETURN(std::vector<uint32_t> spirv, compileSpirv(source, entryPoint, stage, defines));
 
     vk::ShaderModuleCreateInfo createInfo;
     createInfo.codeSize = spirv.size() * sizeof(uint32_t);
@@ -11,13 +11,33 @@ namespace Nexus {
 
 /**
  * @brief Vulkan 着色器编译器
+ *
+ * 编译结果按源码, 入口, 阶段, 选项, 编译器指纹与所有 #include 文件的内容存入内容寻址的 SPIR-V 缓存 (ShaderCache),
+ * 温启动时跳过 shaderc. #include 相对包含者所在目录或 basePath 下的 SHADER_DIRECTORY 解析.
+ * 可在多个线程上同时调用, 每个线程使用各自的 shaderc::Compiler.
  */
 class VK_ShaderCompiler {
 public:
+    static constexpr const char* DEFAULT_CACHE_DIRECTORY = "Data/Cache/Shaders";
+    static constexpr const char* SHADER_DIRECTORY = "Data/Shaders";
+
     /**
      * @brief 编译HLSL到着色器模块
+     * @param defines 预处理宏 (名称, 值), 用于着色器变体
+     */
+    static StatusOr<vk::ShaderModule> compileLayer(vk::Device device, const std::string& source, const std::string& entryPoint, shaderc_shader_kind stage,
+                                                   const std::vector<std::pair<std::string, std::string>>& defines = {});
+
+    /**
+     * @brief 编译 HLSL 到 SPIR-V, 优先读取缓存
+     */
+    static StatusOr<std::vector<uint32_t>> compileSpirv(const std::string& source, const std::string& entryPoint, shaderc_shader_kind stage,
+                                                        const std::vector<std::pair<std::string, std::string>>& defines = {});
+
+    /**
+     * @brief 设置 SPIR-V 缓存目录, 为空时关闭缓存 (须在编译任何着色器之前调用)
      */
-    static StatusOr<vk::ShaderModule> compileLayer(vk::Device device, const std::string& source, const std::string& entryPoint, shaderc_shader_kind stage);
+    static void setCacheDirectory(std::string directory);
 };
 
 } // namespace Nexus
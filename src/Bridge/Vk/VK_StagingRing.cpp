@@ -0,0 +1,96 @@
+#include "VK_StagingRing.h"
+#include "VK_Context.h"
+#include <algorithm>
+
+namespace Nexus {
+
+VK_StagingRing::VK_StagingRing(VK_Context* context) : m_context(context), m_buffer(nullptr) {}
+
+VK_StagingRing::~VK_StagingRing() {
+    shutdown();
+}
+
+Status VK_StagingRing::initialize(vk::DeviceSize capacity) {
+    auto device = m_context->getDevice();
+    vk::BufferCreateInfo bufferInfo({}, capacity, vk::BufferUsageFlagBits::eTransferSrc, vk::SharingMode::eExclusive);
+    auto bufferResult = device.createBuffer(bufferInfo);
+    if (bufferResult.result != vk::Result::eSuccess) return InternalError("Failed to create staging ring buffer");
+    m_buffer = bufferResult.value;
+
+    auto allocation = m_context->getMemoryAllocator()->allocateForBuffer(
+        m_buffer, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        VK_MemoryAllocator::Usage::Dedicated);
+    if (!allocation.ok()) {
+        shutdown();
+        return allocation.status();
+    }
+    m_allocation = *allocation;
+    m_mapped = m_allocation.mapped;
+    m_capacity = capacity;
+    return OkStatus();
+}
+
+void VK_StagingRing::shutdown() {
+    auto device = m_context->getDevice();
+    if (m_buffer) device.destroyBuffer(m_buffer);
+    if (m_allocation) m_context->getMemoryAllocator()->free(m_allocation);
+    m_mapped = nullptr;
+    m_buffer = nullptr;
+    m_capacity = 0;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_allocations.clear();
+}
+
+VK_StagingRing::Slice VK_StagingRing::allocate(vk::DeviceSize size, vk::DeviceSize alignment) {
+    if (!m_mapped || size == 0 || size > m_capacity) return {};
+    auto alignUp = [alignment](vk::DeviceSize v) { return (v + alignment - 1) / alignment * alignment; };
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    vk::DeviceSize begin = 0;
+    if (!m_allocations.empty()) {
+        const vk::DeviceSize tail = m_allocations.front().begin;
+        const vk::DeviceSize head = alignUp(m_allocations.back().end);
+        const bool wrapped = m_allocations.back().begin < tail;
+        if (!wrapped && head + size <= m_capacity) {
+            begin = head;
+        } else if (!wrapped && size <= tail) {
+            begin = 0;
+        } else if (wrapped && head + size <= tail) {
+            begin = head;
+        } else {
+            return {};
+        }
+    }
+
+    Allocation allocation{m_nextId++, begin, begin + size, false};
+    m_allocations.push_back(allocation);
+    return Slice{m_buffer, begin, size, m_mapped + begin, allocation.id};
+}
+
+void VK_StagingRing::release(const Slice& slice) {
+    if (!slice) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = std::find_if(m_allocations.begin(), m_allocations.end(),
+                           [&slice](const Allocation& a) { return a.id == slice.id; });
+    if (it == m_allocations.end()) return;
+    it->released = true;
+    while (!m_allocations.empty() && m_allocations.front().released) {
+        m_allocations.pop_front();
+    }
+}
+
+vk::DeviceSize VK_StagingRing::getUsedBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_allocations.empty()) return 0;
+    const vk::DeviceSize tail = m_allocations.front().begin;
+    const vk::DeviceSize head = m_allocations.back().end;
+    return head >= tail ? head - tail : m_capacity - tail + head;
+}
+
+uint32_t VK_StagingRing::getLiveSliceCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<uint32_t>(std::count_if(m_allocations.begin(), m_allocations.end(),
+                                               [](const Allocation& a) { return !a.released; }));
+}
+
+} // namespace Nexus
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Base.h"
+#include "VK_MemoryAllocator.h"
+#include <vulkan/vulkan.hpp>
+#include <deque>
+#include <mutex>
+
+namespace Nexus {
+
+class VK_Context;
+
+/**
+ * @brief 持久映射的 staging 环形缓冲区
+ *
+ * 整个生命周期只从 VK_MemoryAllocator 独立分配一次 host-visible 内存 (持久映射). 调用方 (可为工作线程) 申请一段切片后直接写入
+ * mapped 指针, 录制 copy 命令时以 buffer + offset 作为源; GPU 使用完毕后 release.
+ * 切片按申请顺序回收, 较早的切片未释放时其后已释放的空间暂不可复用.
+ */
+class VK_StagingRing {
+public:
+    struct Slice {
+        vk::Buffer buffer;
+        vk::DeviceSize offset = 0;
+        vk::DeviceSize size = 0;
+        uint8_t* mapped = nullptr;
+        uint64_t id = 0;
+
+        explicit operator bool() const { return mapped != nullptr; }
+    };
+
+    explicit VK_StagingRing(VK_Context* context);
+    ~VK_StagingRing();
+
+    Status initialize(vk::DeviceSize capacity);
+    void shutdown();
+
+    /**
+     * @brief 申请切片 (线程安全)
+     * @return 空间不足时返回空切片, 调用方应退化为独立 staging 缓冲区
+     */
+    Slice allocate(vk::DeviceSize size, vk::DeviceSize alignment = 16);
+
+    /**
+     * @brief 归还切片, 须保证 GPU 已不再读取 (线程安全)
+     */
+    void release(const Slice& slice);
+
+    vk::DeviceSize getCapacity() const { return m_capacity; }
+    vk::DeviceSize getUsedBytes() const;
+    uint32_t getLiveSliceCount() const;
+
+private:
+    struct Allocation {
+        uint64_t id = 0;
+        vk::DeviceSize begin = 0;
+        vk::DeviceSize end = 0;
+        bool released = false;
+    };
+
+    VK_Context* m_context;
+    vk::Buffer m_buffer;
+    VK_MemoryAllocator::Allocation m_allocation;
+    uint8_t* m_mapped = nullptr;
+    vk::DeviceSize m_capacity = 0;
+
+    mutable std::mutex m_mutex;
+    std::deque<Allocation> m_allocations; // 按申请顺序
+    uint64_t m_nextId = 1;
+};
+
+} // namespace Nexus
@@ -4,8 +4,9 @@
 
 namespace Nexus {
 
-VK_Swapchain::VK_Swapchain(vk::Instance instance, vk::PhysicalDevice physicalDevice, vk::Device device, vk::SurfaceKHR surface)
-    : m_instance(instance), m_physicalDevice(physicalDevice), m_device(device), m_surface(surface), m_swapchain(nullptr) {
+VK_Swapchain::VK_Swapchain(vk::Instance instance, vk::PhysicalDevice physicalDevice, vk::Device device, vk::SurfaceKHR surface,
+                           VK_MemoryAllocator* allocator)
+    : m_instance(instance), m_physicalDevice(physicalDevice), m_device(device), m_surface(surface), m_allocator(allocator), m_swapchain(nullptr) {
 }
 
 VK_Swapchain::~VK_Swapchain() {
@@ -32,10 +33,9 @@ void VK_Swapchain::shutdown() {
 
     if (m_depthImageView) m_device.destroyImageView(m_depthImageView);
     if (m_depthImage) m_device.destroyImage(m_depthImage);
-    if (m_depthImageMemory) m_device.freeMemory(m_depthImageMemory);
+    if (m_depthAllocation) m_allocator->free(m_depthAllocation);
     m_depthImageView = nullptr;
     m_depthImage = nullptr;
-    m_depthImageMemory = nullptr;
 
     if (m_swapchain) {
         m_device.destroySwapchainKHR(m_swapchain);
@@ -150,6 +150,10 @@ Status VK_Swapchain::createDepthResources() {
     imageInfo.tiling = vk::ImageTiling::eOptimal;
     imageInfo.initialLayout = vk::ImageLayout::eUndefined;
     imageInfo.usage = vk::ImageUsageFlagBits::eDepthStencilAttachment;
+    // 主 pass 之后采样深度构建 Hi-Z 金字塔 (VK_GpuCuller)
+    if (m_physicalDevice.getFormatProperties(m_depthFormat).optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImage) {
+        imageInfo.usage |= vk::ImageUsageFlagBits::eSampled;
+    }
     imageInfo.samples = vk::SampleCountFlagBits::e1;
     imageInfo.sharingMode = vk::SharingMode::eExclusive;
 
@@ -157,16 +161,7 @@ Status VK_Swapchain::createDepthResources() {
     if (imgResult.result != vk::Result::eSuccess) return InternalError("Failed to create depth image");
     m_depthImage = imgResult.value;
 
-    vk::MemoryRequirements memRequirements = m_device.getImageMemoryRequirements(m_depthImage);
-    vk::MemoryAllocateInfo allocInfo;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
-
-    auto memResult = m_device.allocateMemory(allocInfo);
-    if (memResult.result != vk::Result::eSuccess) return InternalError("Failed to allocate depth image memory");
-    m_depthImageMemory = memResult.value;
-
-    m_device.bindImageMemory(m_depthImage, m_depthImageMemory, 0);
+    NX_ASSIGN_OR_RETURN(m_depthAllocation, m_allocator->allocateForImage(m_depthImage, vk::MemoryPropertyFlagBits::eDeviceLocal));
 
     vk::ImageViewCreateInfo viewInfo;
     viewInfo.image = m_depthImage;
@@ -196,14 +191,4 @@ vk::Format VK_Swapchain::findDepthFormat() {
     return vk::Format::eD32Sfloat;
 }
 
-uint32_t VK_Swapchain::findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) {
-    vk::PhysicalDeviceMemoryProperties memProperties = m_physicalDevice.getMemoryProperties();
-    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-        if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
-            return i;
-        }
-    }
-    return 0;
-}
-
 } // namespace Nexus
@@ -2,6 +2,7 @@
 
 #pragma once
 #include "Base.h"
+#include "VK_MemoryAllocator.h"
 #include <vulkan/vulkan.hpp>
 #include <vector>
 
@@ -12,7 +13,8 @@ namespace Nexus {
  */
 class VK_Swapchain {
 public:
-    VK_Swapchain(vk::Instance instance, vk::PhysicalDevice physicalDevice, vk::Device device, vk::SurfaceKHR surface);
+    VK_Swapchain(vk::Instance instance, vk::PhysicalDevice physicalDevice, vk::Device device, vk::SurfaceKHR surface,
+                 VK_MemoryAllocator* allocator);
     ~VK_Swapchain();
 
     /**
@@ -44,12 +46,12 @@ private:
     Status createImageViews();
     Status createDepthResources();
     vk::Format findDepthFormat();
-    uint32_t findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties);
 
     vk::Instance m_instance;
     vk::PhysicalDevice m_physicalDevice;
     vk::Device m_device;
     vk::SurfaceKHR m_surface;
+    VK_MemoryAllocator* m_allocator;
 
     vk::SwapchainKHR m_swapchain;
     vk::Format m_imageFormat;
@@ -58,7 +60,7 @@ private:
     std::vector<vk::ImageView> m_imageViews;
 
     vk::Image m_depthImage;
-    vk::DeviceMemory m_depthImageMemory;
+    VK_MemoryAllocator::Allocation m_depthAllocation;
     vk::ImageView m_depthImageView;
     vk::Format m_depthFormat;
 };
@@ -1,91 +1,302 @@
 #include "VK_Texture.h"
+#include "ImageMips.h"
+#include "BlockCompression.h"
 #include "Log.h"
+#include <algorithm>
 
 namespace Nexus {
 
-VK_Texture::VK_Texture(VK_Context* context) : m_context(context), m_image(nullptr), m_memory(nullptr), m_view(nullptr), m_sampler(nullptr), m_ownsResources(false) {}
+namespace {
+vk::Format toVkFormat(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::BC1_RGBA_UNORM_BLOCK: return vk::Format::eBc1RgbaUnormBlock;
+        case TextureFormat::BC3_UNORM_BLOCK: return vk::Format::eBc3UnormBlock;
+        case TextureFormat::BC5_UNORM_BLOCK: return vk::Format::eBc5UnormBlock;
+        case TextureFormat::BC7_UNORM_BLOCK: return vk::Format::eBc7UnormBlock;
+        default: return vk::Format::eR8G8B8A8Unorm;
+    }
+}
+}
+
+VK_Texture::VK_Texture(VK_Context* context) : m_context(context), m_image(nullptr), m_view(nullptr), m_sampler(nullptr), m_ownsResources(false) {}
 
 VK_Texture::~VK_Texture() {
-    auto device = m_context->getDevice();
-    if (m_sampler) device.destroySampler(m_sampler);
-    if (m_ownsResources) {
-        if (m_view) device.destroyImageView(m_view);
-        if (m_image) device.destroyImage(m_image);
-        if (m_memory) device.freeMemory(m_memory);
+    // 可能仍有异步上传或 mip 替换在排队, 先从上传队列中撤下 (必要时等待 GPU 拷贝结束)
+    if (m_ownsResources && m_context->getTextureStreamer()) {
+        m_context->getTextureStreamer()->cancel(this);
     }
+    destroyPrevious();
+    if (m_sampler && m_context->getSamplerCache()) m_context->getSamplerCache()->release(m_sampler);
+    if (m_ownsBindlessSlot && m_context->getBindlessManager()) m_context->getBindlessManager()->releaseTexture(m_bindlessTextureIndex);
+    if (m_ownsResources) retireImage(m_context, m_image, m_view, m_allocation);
+}
+
+void VK_Texture::retireImage(VK_Context* context, vk::Image image, vk::ImageView view, VK_MemoryAllocator::Allocation allocation) {
+    // 在途帧可能仍在采样, 帧时间线越过它们后再销毁
+    context->retire([context, image, view, allocation]() mutable {
+        auto device = context->getDevice();
+        if (view) device.destroyImageView(view);
+        if (image) device.destroyImage(image);
+        if (allocation && context->getMemoryAllocator()) context->getMemoryAllocator()->free(allocation);
+    });
 }
 
 Status VK_Texture::create(const ImageData& imageData, TextureUsage usage) {
+    auto device = m_context->getDevice();
+
+    UploadPlan plan;
+    NX_RETURN_IF_ERROR(prepareUpload(imageData, plan));
+
+    // 优先使用持久映射的 staging 环, 省去每张纹理的缓冲区创建与映射.
+    // 布局转换, 拷贝与 mip 生成录制在同一个命令缓冲区中, 只等待该次提交的 ticket, 不清空整个队列
+    VK_UploadContext* upload = m_context->getUploadContext();
+    VK_StagingRing* ring = upload->getStagingRing();
+    VK_StagingRing::Slice slice = ring ? ring->allocate(plan.size) : VK_StagingRing::Slice{};
+    if (slice) {
+        memcpy(slice.mapped, plan.data().pixels.data(), plan.size);
+        auto ticket = upload->submitGraphics([&](vk::CommandBuffer commandBuffer) {
+            recordUpload(commandBuffer, slice.buffer, slice.offset, plan);
+        });
+        if (ticket.ok()) (void)upload->wait(*ticket);
+        ring->release(slice);
+        if (!ticket.ok()) return ticket.status();
+    } else {
+        vk::BufferCreateInfo stagingBufferInfo({}, plan.size, vk::BufferUsageFlagBits::eTransferSrc, vk::SharingMode::eExclusive);
+        auto stagingResult = device.createBuffer(stagingBufferInfo);
+        if (stagingResult.result != vk::Result::eSuccess) return InternalError("Failed to create staging buffer");
+        vk::Buffer stagingBuffer = stagingResult.value;
+
+        auto staging = m_context->getMemoryAllocator()->allocateForBuffer(
+            stagingBuffer, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+            VK_MemoryAllocator::Usage::Transient);
+        if (!staging.ok()) {
+            device.destroyBuffer(stagingBuffer);
+            return staging.status();
+        }
+        memcpy(staging->mapped, plan.data().pixels.data(), plan.size);
+
+        auto ticket = upload->submitGraphics([&](vk::CommandBuffer commandBuffer) {
+            recordUpload(commandBuffer, stagingBuffer, 0, plan);
+        });
+        if (ticket.ok()) (void)upload->wait(*ticket);
+
+        device.destroyBuffer(stagingBuffer);
+        m_context->getMemoryAllocator()->free(*staging);
+        if (!ticket.ok()) return ticket.status();
+    }
+
+    NX_ASSIGN_OR_RETURN(m_bindlessTextureIndex, m_context->getBindlessManager()->registerTexture(m_view));
+    m_ownsBindlessSlot = true;
+    return createSampler();
+}
+
+Status VK_Texture::createDeferred(VK_Texture* placeholder) {
+    if (!placeholder || !placeholder->getView()) return InvalidArgumentError("Deferred texture requires a resident placeholder");
     m_ownsResources = true;
+    m_resident = false;
+    m_width = placeholder->getWidth();
+    m_height = placeholder->getHeight();
+    // 独占一个 bindless 槽位, 上传完成前指向占位纹理
+    NX_ASSIGN_OR_RETURN(m_bindlessTextureIndex, m_context->getBindlessManager()->registerTexture(placeholder->getView()));
+    m_ownsBindlessSlot = true;
+    return createSampler();
+}
+
+Status VK_Texture::prepareUpload(const ImageData& imageData, UploadPlan& plan) {
+    if (imageData.width == 0 || imageData.height == 0) return InvalidArgumentError("Texture has zero extent");
+    const bool replacing = m_image && m_resident;
+    if (m_image && !replacing) return InternalError("Texture image already created");
+    if (m_previous.image) return InternalError("Texture mip update already in flight");
+    if (replacing && (imageData.width != m_width || imageData.height != m_height)) {
+        return InvalidArgumentError("Mip update must keep the texture extent");
+    }
     auto device = m_context->getDevice();
-    m_width = imageData.width;
-    m_height = imageData.height;
 
+    const uint32_t fullMipLevels = computeMipLevelCount(imageData.width, imageData.height);
+    const uint32_t baseMip = imageData.baseMip;
+    if (baseMip >= fullMipLevels) return InvalidArgumentError("Texture base mip out of range");
+    TextureFormat format = TextureFormat::R8G8B8A8_UNORM;
+    uint32_t endLevel = fullMipLevels;
+    plan.input = &imageData;
+    if (imageData.mipLevels == 0) {
+        // 只保留更粗的级别: 全部从旧图像拷贝
+        if (!replacing) return InvalidArgumentError("Texture upload has no mip levels");
+        format = m_format;
+        endLevel = m_baseMip + m_mipLevels;
+    } else if (isBlockCompressed(imageData.format)) {
+        // 烘焙好的 mip 链原样上传; 设备不支持该格式时在 CPU 解压为 RGBA8
+        if (m_context->supportsCompressedFormat(toVkFormat(imageData.format))) {
+            format = imageData.format;
+        } else {
+            NX_ASSIGN_OR_RETURN(plan.generated, decompressImage(imageData));
+        }
+        endLevel = std::min(baseMip + imageData.mipLevels, fullMipLevels);
+    } else {
+        const uint32_t stagedEnd = baseMip + std::min(imageData.mipLevels, fullMipLevels - baseMip);
+        const bool tailFromPrevious = replacing && m_format == format && m_baseMip <= stagedEnd && m_baseMip + m_mipLevels >= fullMipLevels;
+        if (stagedEnd < fullMipLevels && !tailFromPrevious) {
+            // 完整 mip 链: 格式支持线性 blit 时由 GPU 逐级生成, 否则在 CPU 上盒式滤波后整体上传
+            plan.gpuBlit = m_context->supportsLinearBlit(toVkFormat(format));
+            if (plan.prestaged && !plan.gpuBlit) return InvalidArgumentError("Prestaged texture requires GPU mip generation");
+            if (!plan.gpuBlit) {
+                if (baseMip != 0) return InvalidArgumentError("Partial mip chain requires GPU mip generation");
+                plan.generated.width = imageData.width;
+                plan.generated.height = imageData.height;
+                plan.generated.channels = imageData.channels;
+                plan.generated.pixels.assign(imageData.pixels.begin(), imageData.pixels.begin() + (size_t)imageData.width * imageData.height * 4);
+                NX_RETURN_IF_ERROR(generateMipChain(plan.generated));
+            }
+        }
+    }
+    if (replacing) {
+        if (format != m_format) return InvalidArgumentError("Mip update must keep the texture format");
+        endLevel = std::max(endLevel, m_baseMip + m_mipLevels);
+    }
+
+    plan.levels = std::min(plan.data().mipLevels, endLevel - baseMip);
+    plan.size = imageLevelOffset(plan.data(), baseMip + plan.levels);
+    if (!plan.prestaged && plan.data().pixels.size() < plan.size) return InvalidArgumentError("Texture pixel data smaller than declared mip chain");
+    if (!plan.gpuBlit && baseMip + plan.levels < endLevel) {
+        // pixels 中没有的更粗级别由旧图像提供
+        if (!replacing || m_baseMip > baseMip + plan.levels) return InvalidArgumentError("Texture mip chain has missing levels");
+        plan.copyFirstLevel = baseMip + plan.levels;
+        plan.copyLevels = endLevel - plan.copyFirstLevel;
+    }
+
+    const vk::Format vkFormat = toVkFormat(format);
+    const uint32_t mipLevels = endLevel - baseMip;
     vk::ImageCreateInfo imageInfo;
     imageInfo.imageType = vk::ImageType::e2D;
-    imageInfo.extent = vk::Extent3D(m_width, m_height, 1);
-    imageInfo.mipLevels = 1;
+    imageInfo.extent = vk::Extent3D(mipExtent(imageData.width, baseMip), mipExtent(imageData.height, baseMip), 1);
+    imageInfo.mipLevels = mipLevels;
     imageInfo.arrayLayers = 1;
-    imageInfo.format = vk::Format::eR8G8B8A8Unorm;
+    imageInfo.format = vkFormat;
     imageInfo.tiling = vk::ImageTiling::eOptimal;
     imageInfo.initialLayout = vk::ImageLayout::eUndefined;
-    imageInfo.usage = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled;
+    // TransferSrc: blit 生成 mip, 以及之后的 mip 替换从本图像拷贝
+    imageInfo.usage = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eSampled;
     imageInfo.sharingMode = vk::SharingMode::eExclusive;
     imageInfo.samples = vk::SampleCountFlagBits::e1;
 
     auto imgResult = device.createImage(imageInfo);
     if (imgResult.result != vk::Result::eSuccess) return InternalError("Failed to create texture image");
-    m_image = imgResult.value;
+    vk::Image image = imgResult.value;
 
-    vk::MemoryRequirements memRequirements = device.getImageMemoryRequirements(m_image);
-    vk::MemoryAllocateInfo allocInfo(memRequirements.size, m_context->findMemoryType(memRequirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal));
-    auto memResult = device.allocateMemory(allocInfo);
-    if (memResult.result != vk::Result::eSuccess) return InternalError("Failed to allocate texture memory");
-    m_memory = memResult.value;
-    (void)device.bindImageMemory(m_image, m_memory, 0);
-
-    vk::BufferCreateInfo stagingBufferInfo({}, imageData.pixels.size(), vk::BufferUsageFlagBits::eTransferSrc, vk::SharingMode::eExclusive);
-    auto stagingResult = device.createBuffer(stagingBufferInfo);
-    if (stagingResult.result != vk::Result::eSuccess) return InternalError("Failed to create staging buffer");
-    vk::Buffer stagingBuffer = stagingResult.value;
-
-    vk::MemoryRequirements stagingMemReq = device.getBufferMemoryRequirements(stagingBuffer);
-    vk::MemoryAllocateInfo stagingAllocInfo(stagingMemReq.size, m_context->findMemoryType(stagingMemReq.memoryTypeBits, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent));
-    auto stageMemResult = device.allocateMemory(stagingAllocInfo);
-    if (stageMemResult.result != vk::Result::eSuccess) return InternalError("Failed to allocate staging memory");
-    vk::DeviceMemory stagingMemory = stageMemResult.value;
-    (void)device.bindBufferMemory(stagingBuffer, stagingMemory, 0);
-
-    auto mapResult = device.mapMemory(stagingMemory, 0, imageData.pixels.size());
-    if (mapResult.result != vk::Result::eSuccess) return InternalError("Failed to map staging memory");
-    void* data = mapResult.value;
-    memcpy(data, imageData.pixels.data(), imageData.pixels.size());
-    device.unmapMemory(stagingMemory);
-
-    transitionImageLayout(m_image, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal);
-    copyBufferToImage(stagingBuffer, m_image, m_width, m_height);
-    transitionImageLayout(m_image, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
-
-    device.destroyBuffer(stagingBuffer);
-    device.freeMemory(stagingMemory);
+    auto allocation = m_context->getMemoryAllocator()->allocateForImage(image, vk::MemoryPropertyFlagBits::eDeviceLocal);
+    if (!allocation.ok()) {
+        device.destroyImage(image);
+        return allocation.status();
+    }
 
     vk::ImageViewCreateInfo viewInfo;
-    viewInfo.image = m_image;
+    viewInfo.image = image;
     viewInfo.viewType = vk::ImageViewType::e2D;
-    viewInfo.format = vk::Format::eR8G8B8A8Unorm;
+    viewInfo.format = vkFormat;
     viewInfo.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
     viewInfo.subresourceRange.baseMipLevel = 0;
-    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.levelCount = mipLevels;
     viewInfo.subresourceRange.baseArrayLayer = 0;
     viewInfo.subresourceRange.layerCount = 1;
 
     auto viewResult = device.createImageView(viewInfo);
-    if (viewResult.result != vk::Result::eSuccess) return InternalError("Failed to create texture view");
+    if (viewResult.result != vk::Result::eSuccess) {
+        device.destroyImage(image);
+        m_context->getMemoryAllocator()->free(*allocation);
+        return InternalError("Failed to create texture view");
+    }
+
+    // 旧图像保留到 markResident, 在此之前槽位仍指向它
+    if (replacing) m_previous = {m_image, m_allocation, m_view, m_baseMip, m_mipLevels};
+    m_ownsResources = true;
+    m_image = image;
+    m_allocation = *allocation;
     m_view = viewResult.value;
+    m_memorySize = m_allocation.size;
+    m_width = imageData.width;
+    m_height = imageData.height;
+    m_format = format;
+    m_baseMip = baseMip;
+    m_mipLevels = mipLevels;
+    return OkStatus();
+}
 
-    m_bindlessTextureIndex = m_context->getBindlessManager()->registerTexture(m_view);
-    return createSampler();
+void VK_Texture::recordUpload(vk::CommandBuffer commandBuffer, vk::Buffer stagingBuffer, vk::DeviceSize stagingOffset, const UploadPlan& plan) {
+    recordLayoutTransition(commandBuffer, m_image, 0, m_mipLevels, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal);
+    std::vector<vk::BufferImageCopy> regions;
+    for (uint32_t i = 0; i < plan.levels; ++i) {
+        const uint32_t level = m_baseMip + i;
+        vk::BufferImageCopy region;
+        region.bufferOffset = stagingOffset + imageLevelOffset(plan.data(), level);
+        region.imageSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, i, 0, 1);
+        region.imageExtent = vk::Extent3D{mipExtent(m_width, level), mipExtent(m_height, level), 1};
+        regions.push_back(region);
+    }
+    if (!regions.empty()) {
+        commandBuffer.copyBufferToImage(stagingBuffer, m_image, vk::ImageLayout::eTransferDstOptimal, regions);
+    }
+    if (plan.copyLevels > 0) recordCopyFromPrevious(commandBuffer, plan);
+    if (plan.gpuBlit) {
+        recordMipBlits(commandBuffer, plan.levels);
+    } else {
+        recordLayoutTransition(commandBuffer, m_image, 0, m_mipLevels, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
+    }
+}
+
+void VK_Texture::recordCopyFromPrevious(vk::CommandBuffer commandBuffer, const UploadPlan& plan) {
+    // 旧图像此时仍可能被之前提交的绘制采样, 拷贝后立即转回 ShaderReadOnly
+    const uint32_t srcFirst = plan.copyFirstLevel - m_previous.baseMip;
+    recordLayoutTransition(commandBuffer, m_previous.image, srcFirst, plan.copyLevels,
+                           vk::ImageLayout::eShaderReadOnlyOptimal, vk::ImageLayout::eTransferSrcOptimal);
+    std::vector<vk::ImageCopy> regions;
+    for (uint32_t i = 0; i < plan.copyLevels; ++i) {
+        const uint32_t level = plan.copyFirstLevel + i;
+        vk::ImageCopy region;
+        region.srcSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, srcFirst + i, 0, 1);
+        region.dstSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level - m_baseMip, 0, 1);
+        region.extent = vk::Extent3D{mipExtent(m_width, level), mipExtent(m_height, level), 1};
+        regions.push_back(region);
+    }
+    commandBuffer.copyImage(m_previous.image, vk::ImageLayout::eTransferSrcOptimal, m_image, vk::ImageLayout::eTransferDstOptimal, regions);
+    recordLayoutTransition(commandBuffer, m_previous.image, srcFirst, plan.copyLevels,
+                           vk::ImageLayout::eTransferSrcOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
+}
+
+void VK_Texture::markResident() {
+    // 流式替换完成: 槽位在采样它的在途帧完成后才改写, 旧图像在改写之后销毁 (回调可能晚于本纹理析构)
+    std::function<void()> onReplaced;
+    if (m_previous.image) {
+        onReplaced = [context = m_context, previous = m_previous]() { retireImage(context, previous.image, previous.view, previous.allocation); };
+        m_previous = PreviousImage{};
+    }
+    m_context->getBindlessManager()->updateTexture(m_bindlessTextureIndex, m_view, std::move(onReplaced));
+    m_resident = true;
 }
+
+void VK_Texture::destroyPrevious() {
+    if (!m_previous.image) return;
+    retireImage(m_context, m_previous.image, m_previous.view, m_previous.allocation);
+    m_previous = PreviousImage{};
+}
+
+Status VK_Texture::evict(VK_Texture* placeholder) {
+    if (!m_resident || !m_ownsResources || !m_ownsBindlessSlot || !m_image) return InvalidArgumentError("Texture cannot be evicted");
+    if (m_previous.image) return InvalidArgumentError("Texture has a mip update in flight");
+    if (!placeholder || !placeholder->getView()) return InvalidArgumentError("Eviction requires a resident placeholder");
+    // 槽位改写前在途帧仍可能采样本图像, 改写之后再销毁
+    m_context->getBindlessManager()->updateTexture(m_bindlessTextureIndex, placeholder->getView(),
+                                                   [context = m_context, image = m_image, view = m_view, allocation = m_allocation]() {
+                                                       retireImage(context, image, view, allocation);
+                                                   });
+    m_allocation = VK_MemoryAllocator::Allocation{};
+    m_view = nullptr;
+    m_image = nullptr;
+    m_memorySize = 0;
+    m_mipLevels = 1;
+    m_baseMip = 0;
+    m_resident = false;
+    return OkStatus();
+}
+
 Status VK_Texture::create(uint32_t width, uint32_t height, TextureFormat format, TextureUsage usage) {
     m_ownsResources = true;
     auto device = m_context->getDevice();
@@ -98,86 +309,80 @@ Status VK_Texture::create(uint32_t width, uint32_t height, TextureFormat format,
     auto imgResult = device.createImage(imageInfo);
     if (imgResult.result != vk::Result::eSuccess) return InternalError("Failed to create attachment image");
     m_image = imgResult.value;
-    vk::MemoryRequirements memReq = device.getImageMemoryRequirements(m_image);
-    auto memResult = device.allocateMemory({memReq.size, m_context->findMemoryType(memReq.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal)});
-    if (memResult.result != vk::Result::eSuccess) return InternalError("Failed to allocate attachment memory");
-    m_memory = memResult.value;
-    (void)device.bindImageMemory(m_image, m_memory, 0);
+    NX_ASSIGN_OR_RETURN(m_allocation, m_context->getMemoryAllocator()->allocateForImage(m_image, vk::MemoryPropertyFlagBits::eDeviceLocal));
+    m_memorySize = m_allocation.size;
     vk::ImageViewCreateInfo viewInfo({}, m_image, vk::ImageViewType::e2D, vkFormat, {}, {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1});
     auto viewResult = device.createImageView(viewInfo);
     if (viewResult.result != vk::Result::eSuccess) return InternalError("Failed to create attachment view");
     m_view = viewResult.value;
-    if (m_context->getBindlessManager()) m_bindlessTextureIndex = m_context->getBindlessManager()->registerTexture(m_view);
+    if (m_context->getBindlessManager()) {
+        NX_ASSIGN_OR_RETURN(m_bindlessTextureIndex, m_context->getBindlessManager()->registerTexture(m_view));
+        m_ownsBindlessSlot = true;
+    }
     return createSampler();
 }
 
 Status VK_Texture::createSampler() {
-    vk::SamplerCreateInfo samplerInfo;
-    samplerInfo.magFilter = vk::Filter::eLinear;
-    samplerInfo.minFilter = vk::Filter::eLinear;
-    samplerInfo.addressModeU = vk::SamplerAddressMode::eRepeat;
-    samplerInfo.addressModeV = vk::SamplerAddressMode::eRepeat;
-    samplerInfo.addressModeW = vk::SamplerAddressMode::eRepeat;
-    samplerInfo.anisotropyEnable = VK_FALSE;
-    samplerInfo.maxAnisotropy = 1.0f;
-    samplerInfo.borderColor = vk::BorderColor::eIntOpaqueBlack;
-    samplerInfo.unnormalizedCoordinates = VK_FALSE;
-    samplerInfo.compareEnable = VK_FALSE;
-    samplerInfo.compareOp = vk::CompareOp::eAlways;
-    samplerInfo.mipmapMode = vk::SamplerMipmapMode::eLinear;
-
-    auto samplerResult = m_context->getDevice().createSampler(samplerInfo);
-    if (samplerResult.result != vk::Result::eSuccess) return InternalError("Failed to create sampler");
-    m_sampler = samplerResult.value;
-    
-    m_bindlessSamplerIndex = m_context->getBindlessManager()->registerSampler(m_sampler);
-
+    SamplerDesc desc;
+    desc.maxAnisotropy = m_context->getSamplerAnisotropy();
+    NX_ASSIGN_OR_RETURN(VK_SamplerCache::Handle handle, m_context->getSamplerCache()->acquire(desc));
+    m_sampler = handle.sampler;
+    m_bindlessSamplerIndex = handle.bindlessIndex;
     return OkStatus();
 }
 
-void VK_Texture::transitionImageLayout(vk::Image image, vk::ImageLayout oldLayout, vk::ImageLayout newLayout) {
-    vk::CommandBuffer commandBuffer = m_context->beginSingleTimeCommands();
+void VK_Texture::recordLayoutTransition(vk::CommandBuffer commandBuffer, vk::Image image, uint32_t baseMip, uint32_t mipCount,
+                                        vk::ImageLayout oldLayout, vk::ImageLayout newLayout) {
     vk::ImageMemoryBarrier barrier;
     barrier.oldLayout = oldLayout;
     barrier.newLayout = newLayout;
     barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.image = image;
-    barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-    vk::PipelineStageFlags sourceStage;
-    vk::PipelineStageFlags destinationStage;
+    barrier.subresourceRange = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, baseMip, mipCount, 0, 1);
+    vk::PipelineStageFlags sourceStage = vk::PipelineStageFlagBits::eTopOfPipe;
+    vk::PipelineStageFlags destinationStage = vk::PipelineStageFlagBits::eTransfer;
     if (oldLayout == vk::ImageLayout::eUndefined && newLayout == vk::ImageLayout::eTransferDstOptimal) {
         barrier.srcAccessMask = {};
         barrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
-        sourceStage = vk::PipelineStageFlagBits::eTopOfPipe;
-        destinationStage = vk::PipelineStageFlagBits::eTransfer;
-    } else if (oldLayout == vk::ImageLayout::eTransferDstOptimal && newLayout == vk::ImageLayout::eShaderReadOnlyOptimal) {
+    } else if (oldLayout == vk::ImageLayout::eTransferDstOptimal && newLayout == vk::ImageLayout::eTransferSrcOptimal) {
         barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+        barrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
+        sourceStage = vk::PipelineStageFlagBits::eTransfer;
+    } else if (oldLayout == vk::ImageLayout::eShaderReadOnlyOptimal && newLayout == vk::ImageLayout::eTransferSrcOptimal) {
+        // 之前的采样只读, 仅需执行依赖
+        barrier.srcAccessMask = {};
+        barrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
+        sourceStage = vk::PipelineStageFlagBits::eFragmentShader;
+    } else if (newLayout == vk::ImageLayout::eShaderReadOnlyOptimal) {
+        barrier.srcAccessMask = oldLayout == vk::ImageLayout::eTransferSrcOptimal ? vk::AccessFlagBits::eTransferRead : vk::AccessFlagBits::eTransferWrite;
         barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
         sourceStage = vk::PipelineStageFlagBits::eTransfer;
         destinationStage = vk::PipelineStageFlagBits::eFragmentShader;
     }
     commandBuffer.pipelineBarrier(sourceStage, destinationStage, {}, nullptr, nullptr, barrier);
-    m_context->endSingleTimeCommands(commandBuffer);
-}
-void VK_Texture::copyBufferToImage(vk::Buffer buffer, vk::Image image, uint32_t width, uint32_t height) {
-    vk::CommandBuffer commandBuffer = m_context->beginSingleTimeCommands();
-    vk::BufferImageCopy region;
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-    region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-    region.imageOffset = vk::Offset3D{0, 0, 0};
-    region.imageExtent = vk::Extent3D{width, height, 1};
-    commandBuffer.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal, region);
-    m_context->endSingleTimeCommands(commandBuffer);
+}
+
+void VK_Texture::recordMipBlits(vk::CommandBuffer commandBuffer, uint32_t firstGeneratedLevel) {
+    // 已上传的级别中最后一级作为第一次 blit 的源
+    for (uint32_t level = firstGeneratedLevel; level < m_mipLevels; ++level) {
+        recordLayoutTransition(commandBuffer, m_image, level - 1, 1, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eTransferSrcOptimal);
+
+        vk::ImageBlit blit;
+        blit.srcSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level - 1, 0, 1);
+        blit.srcOffsets[1] = vk::Offset3D{(int32_t)mipExtent(m_width, m_baseMip + level - 1), (int32_t)mipExtent(m_height, m_baseMip + level - 1), 1};
+        blit.dstSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level, 0, 1);
+        blit.dstOffsets[1] = vk::Offset3D{(int32_t)mipExtent(m_width, m_baseMip + level), (int32_t)mipExtent(m_height, m_baseMip + level), 1};
+        commandBuffer.blitImage(m_image, vk::ImageLayout::eTransferSrcOptimal, m_image, vk::ImageLayout::eTransferDstOptimal,
+                                blit, vk::Filter::eLinear);
+
+        recordLayoutTransition(commandBuffer, m_image, level - 1, 1, vk::ImageLayout::eTransferSrcOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
+    }
+    // 上传但未参与 blit 的级别, 以及最后一级
+    if (firstGeneratedLevel > 1) {
+        recordLayoutTransition(commandBuffer, m_image, 0, firstGeneratedLevel - 1, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
+    }
+    recordLayoutTransition(commandBuffer, m_image, m_mipLevels - 1, 1, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
 }
 void VK_Texture::initializeFromExisting(vk::Image image, vk::ImageView view, vk::Format format, uint32_t width, uint32_t height) {
     m_ownsResources = false;
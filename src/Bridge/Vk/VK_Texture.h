@@ -2,6 +2,7 @@
 
 #include "Interfaces.h"
 #include "VK_Context.h"
+#include "VK_TextureStreamer.h"
 #include <vulkan/vulkan.hpp>
 
 namespace Nexus {
@@ -11,6 +12,22 @@ namespace Nexus {
  */
 class VK_Texture : public ITexture {
 public:
+    /**
+     * @brief 一次上传的数据来源与 mip 安排
+     */
+    struct UploadPlan {
+        const ImageData* input = nullptr;
+        ImageData generated;        // CPU 生成的 mip 链 (仅在不支持 blit 时使用)
+        uint32_t levels = 1;        // 从 staging 拷贝的级数
+        uint32_t copyFirstLevel = 0; // 替换上传时从旧图像拷贝的第一级 (完整链中的级别)
+        uint32_t copyLevels = 0;
+        vk::DeviceSize size = 0;    // staging 字节数
+        bool gpuBlit = false;       // 其余级别由 blit 生成
+        bool prestaged = false;     // mip0 已由调用方写入 staging, input 仅提供尺寸
+
+        const ImageData& data() const { return generated.pixels.empty() ? *input : generated; }
+    };
+
     VK_Texture(VK_Context* context);
     virtual ~VK_Texture() override;
 
@@ -23,6 +40,45 @@ public:
     Status create(uint32_t width, uint32_t height, TextureFormat format, TextureUsage usage);
     void initializeFromExisting(vk::Image image, vk::ImageView view, vk::Format format, uint32_t width, uint32_t height);
 
+    /**
+     * @brief 创建延迟上传的纹理: 立即分配 bindless 槽位并指向 placeholder, 数据由 VK_TextureStreamer 上传
+     */
+    Status createDeferred(VK_Texture* placeholder);
+
+    /**
+     * @brief 创建图像资源并确定上传方式 (plan 引用 imageData, 需在录制前保持有效)
+     *
+     * 已驻留的纹理再次上传时为 mip 替换: 新图像覆盖 [imageData.baseMip, 末级], pixels 中没有的更粗级别
+     * 从旧图像拷贝 (mipLevels 为 0 时全部拷贝, 即换出更精细的级别); 旧图像在 markResident 前继续被采样.
+     */
+    Status prepareUpload(const ImageData& imageData, UploadPlan& plan);
+
+    /**
+     * @brief 录制 staging -> image 拷贝与 mip 生成, 结束时为 ShaderReadOnly
+     */
+    void recordUpload(vk::CommandBuffer commandBuffer, vk::Buffer stagingBuffer, vk::DeviceSize stagingOffset, const UploadPlan& plan);
+
+    /**
+     * @brief 上传完成后将 bindless 槽位切换到真实图像 (在同步点调用)
+     *
+     * 槽位改写推迟到采样它的在途帧完成后的 VK_BindlessManager::flushWrites (不等待); 替换前的旧图像在改写之后销毁.
+     */
+    void markResident();
+    virtual bool isResident() const override { return m_resident; }
+    virtual uint64_t getMemorySize() const override { return m_resident ? m_memorySize : 0; }
+
+    /**
+     * @brief 换出: 槽位指回 placeholder 并销毁图像与显存, 保留槽位和采样器以便重新上传
+     *
+     * 在途帧可以仍在采样该图像: 槽位在它们完成后改写, 图像在改写之后经帧时间线销毁.
+     */
+    Status evict(VK_Texture* placeholder);
+
+    /**
+     * @brief 图像第 0 级对应完整 mip 链中的级别
+     */
+    virtual uint32_t getResidentMip() const override { return m_baseMip; }
+
     /**
      * @brief 获取宽度
      */
@@ -38,6 +94,11 @@ public:
      */
     virtual TextureFormat getFormat() const override { return m_format; }
 
+    /**
+     * @brief 图像中的 mip 级数 (采样纹理为从 getResidentMip 起的完整 mip 链)
+     */
+    uint32_t getMipLevels() const { return m_mipLevels; }
+
     uint32_t getBindlessTextureIndex() const { return m_bindlessTextureIndex; }
     uint32_t getBindlessSamplerIndex() const { return m_bindlessSamplerIndex; }
 
@@ -47,21 +108,49 @@ public:
 
 private:
     Status createSampler();
-    void transitionImageLayout(vk::Image image, vk::ImageLayout oldLayout, vk::ImageLayout newLayout);
-    void copyBufferToImage(vk::Buffer buffer, vk::Image image, uint32_t width, uint32_t height);
+    void recordLayoutTransition(vk::CommandBuffer commandBuffer, vk::Image image, uint32_t baseMip, uint32_t mipCount,
+                                vk::ImageLayout oldLayout, vk::ImageLayout newLayout);
+    /**
+     * @brief 替换上传时把 plan 指定的级别从旧图像拷贝到新图像 (新图像需为 TransferDst)
+     */
+    void recordCopyFromPrevious(vk::CommandBuffer commandBuffer, const UploadPlan& plan);
+    void destroyPrevious();
+    /**
+     * @brief 经 VK_Context::retire 延迟销毁图像及其显存
+     */
+    static void retireImage(VK_Context* context, vk::Image image, vk::ImageView view, VK_MemoryAllocator::Allocation allocation);
+    /**
+     * @brief 从 firstGeneratedLevel - 1 开始逐级 blit 生成剩余 mip, 结束时全部级别为 ShaderReadOnly
+     */
+    void recordMipBlits(vk::CommandBuffer commandBuffer, uint32_t firstGeneratedLevel);
 
     VK_Context* m_context;
     uint32_t m_width = 0;
     uint32_t m_height = 0;
+    uint32_t m_mipLevels = 1;
+    uint32_t m_baseMip = 0;
     TextureFormat m_format = TextureFormat::R8G8B8A8_UNORM;
 
     vk::Image m_image;
-    vk::DeviceMemory m_memory;
+    VK_MemoryAllocator::Allocation m_allocation;
     vk::ImageView m_view;
     vk::Sampler m_sampler;
     bool m_ownsResources = false;
+    bool m_resident = true;
+
+    // 替换上传期间保留的旧图像, bindless 槽位切换后销毁
+    struct PreviousImage {
+        vk::Image image;
+        VK_MemoryAllocator::Allocation allocation;
+        vk::ImageView view;
+        uint32_t baseMip = 0;
+        uint32_t mipLevels = 0;
+    };
+    PreviousImage m_previous;
 
     uint32_t m_bindlessTextureIndex = 0;
+    bool m_ownsBindlessSlot = false;
+    vk::DeviceSize m_memorySize = 0;
     uint32_t m_bindlessSamplerIndex = 0;
 };
 
@@ -0,0 +1,250 @@
+#include "VK_TextureStreamer.h"
+#include "VK_Context.h"
+#include "VK_Texture.h"
+#include "Log.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Nexus {
+
+namespace {
+// copyBufferToImage 要求偏移为纹素大小的倍数, 统一按 16 字节对齐
+constexpr vk::DeviceSize kStagingAlignment = 16;
+}
+
+VK_TextureStreamer::VK_TextureStreamer(VK_Context* context) : m_context(context) {}
+
+VK_TextureStreamer::~VK_TextureStreamer() {
+    shutdown();
+}
+
+Status VK_TextureStreamer::initialize() {
+    m_upload = m_context->getUploadContext();
+    if (!m_upload) return InternalError("Texture streamer requires an upload context");
+    // 没有环时所有上传都使用独立 staging 缓冲区
+    m_stagingRing = m_upload->getStagingRing();
+    return OkStatus();
+}
+
+void VK_TextureStreamer::shutdown() {
+    if (!m_upload) return;
+    waitIdle();
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        for (auto& request : m_pending) {
+            if (request.staged) m_stagingRing->release(request.staged);
+        }
+        for (auto& [texture, request] : m_mapped) m_stagingRing->release(request.staged);
+        m_pending.clear();
+        m_mapped.clear();
+    }
+    m_stagingRing = nullptr;
+    m_upload = nullptr;
+}
+
+void VK_TextureStreamer::enqueue(VK_Texture* texture, ImageData&& imageData) {
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    m_pending.push_back({texture, std::move(imageData), {}});
+}
+
+uint8_t* VK_TextureStreamer::mapUpload(VK_Texture* texture, uint32_t width, uint32_t height) {
+    // 切片只容纳 mip0, 其余级别须由 GPU blit 生成
+    if (!m_stagingRing || !texture || !m_context->supportsLinearBlit(vk::Format::eR8G8B8A8Unorm)) return nullptr;
+    auto slice = m_stagingRing->allocate((vk::DeviceSize)width * height * 4, kStagingAlignment);
+    if (!slice) return nullptr;
+
+    Request request;
+    request.texture = texture;
+    request.imageData.width = width;
+    request.imageData.height = height;
+    request.imageData.channels = 4;
+    request.staged = slice;
+
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    m_mapped[texture] = std::move(request);
+    return slice.mapped;
+}
+
+void VK_TextureStreamer::commitUpload(VK_Texture* texture, bool success) {
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    auto it = m_mapped.find(texture);
+    if (it == m_mapped.end()) return;
+    if (success) {
+        m_pending.push_back(std::move(it->second));
+    } else {
+        m_stagingRing->release(it->second.staged);
+    }
+    m_mapped.erase(it);
+}
+
+void VK_TextureStreamer::flush() {
+    if (!m_upload) return;
+    std::lock_guard<std::mutex> flushLock(m_flushMutex);
+    retireBatches(false);
+
+    std::vector<Request> requests;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        requests.swap(m_pending);
+    }
+    if (requests.empty()) return;
+
+    if (auto status = submitBatch(requests); !status.ok()) {
+        NX_CORE_ERROR("VK_TextureStreamer: failed to submit upload batch: {}", status.message());
+    }
+}
+
+Status VK_TextureStreamer::submitBatch(std::vector<Request>& requests) {
+    Batch batch;
+
+    std::vector<VK_Texture::UploadPlan> plans(requests.size());
+    std::vector<vk::DeviceSize> offsets(requests.size(), 0);
+    vk::DeviceSize heapSize = 0;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        Request& request = requests[i];
+        plans[i].prestaged = static_cast<bool>(request.staged);
+        auto status = request.texture->prepareUpload(request.imageData, plans[i]);
+        if (!status.ok()) {
+            NX_CORE_WARN("VK_TextureStreamer: skipping texture upload: {}", status.message());
+            if (request.staged) m_stagingRing->release(request.staged);
+            request.texture = nullptr;
+            continue;
+        }
+        if (request.staged) {
+            offsets[i] = request.staged.offset;
+            batch.slices.push_back(request.staged);
+            continue;
+        }
+        offsets[i] = heapSize;
+        heapSize = (heapSize + plans[i].size + kStagingAlignment - 1) & ~(kStagingAlignment - 1);
+    }
+    // 换出精细级别的替换上传没有 staging 数据, 但仍需录制图像间拷贝
+    if (std::none_of(requests.begin(), requests.end(), [](const Request& r) { return r.texture != nullptr; })) return OkStatus();
+
+    // 仍以 ImageData 提交的纹理合并拷贝到一个环切片, 环放不下时退化为独立缓冲区
+    vk::Buffer heapBuffer;
+    if (heapSize > 0) {
+        uint8_t* mapped = nullptr;
+        vk::DeviceSize base = 0;
+        VK_StagingRing::Slice slice = m_stagingRing ? m_stagingRing->allocate(heapSize, kStagingAlignment) : VK_StagingRing::Slice{};
+        if (slice) {
+            batch.slices.push_back(slice);
+            heapBuffer = slice.buffer;
+            mapped = slice.mapped;
+            base = slice.offset;
+        } else if (auto status = createDedicatedStaging(batch, heapSize, mapped); !status.ok()) {
+            destroyBatch(batch);
+            return status;
+        } else {
+            heapBuffer = batch.stagingBuffer;
+        }
+        for (size_t i = 0; i < requests.size(); ++i) {
+            if (!requests[i].texture || requests[i].staged || plans[i].size == 0) continue;
+            std::memcpy(mapped + offsets[i], plans[i].data().pixels.data(), plans[i].size);
+            offsets[i] += base;
+        }
+    }
+
+    // 布局转换与 mip blit 只能在图形队列执行
+    auto ticket = m_upload->submitGraphics([&](vk::CommandBuffer commandBuffer) {
+        for (size_t i = 0; i < requests.size(); ++i) {
+            if (!requests[i].texture) continue;
+            vk::Buffer source = requests[i].staged ? requests[i].staged.buffer : heapBuffer;
+            requests[i].texture->recordUpload(commandBuffer, source, offsets[i], plans[i]);
+            batch.textures.push_back(requests[i].texture);
+        }
+    });
+    if (!ticket.ok()) {
+        destroyBatch(batch);
+        return ticket.status();
+    }
+    batch.ticket = *ticket;
+
+    std::lock_guard<std::mutex> lock(m_inFlightMutex);
+    m_inFlight.push_back(std::move(batch));
+    return OkStatus();
+}
+
+Status VK_TextureStreamer::createDedicatedStaging(Batch& batch, vk::DeviceSize size, uint8_t*& mapped) {
+    auto device = m_context->getDevice();
+    vk::BufferCreateInfo bufferInfo({}, size, vk::BufferUsageFlagBits::eTransferSrc, vk::SharingMode::eExclusive);
+    auto bufferResult = device.createBuffer(bufferInfo);
+    if (bufferResult.result != vk::Result::eSuccess) return InternalError("Failed to create batch staging buffer");
+    batch.stagingBuffer = bufferResult.value;
+
+    // 环放不下的批次多为一次性的大图, 从线性块分配, 批次退役后整块复位
+    NX_ASSIGN_OR_RETURN(batch.stagingAllocation, m_context->getMemoryAllocator()->allocateForBuffer(
+        batch.stagingBuffer, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        VK_MemoryAllocator::Usage::Transient));
+    mapped = batch.stagingAllocation.mapped;
+    return OkStatus();
+}
+
+void VK_TextureStreamer::retireBatches(bool wait) {
+    std::lock_guard<std::mutex> lock(m_inFlightMutex);
+    for (auto it = m_inFlight.begin(); it != m_inFlight.end();) {
+        if (wait) {
+            (void)m_upload->wait(it->ticket);
+        }
+        if (!m_upload->isComplete(it->ticket)) {
+            ++it;
+            continue;
+        }
+        for (auto* texture : it->textures) {
+            if (texture) texture->markResident();
+        }
+        destroyBatch(*it);
+        it = m_inFlight.erase(it);
+    }
+}
+
+void VK_TextureStreamer::destroyBatch(Batch& batch) {
+    if (batch.stagingBuffer) m_context->getDevice().destroyBuffer(batch.stagingBuffer);
+    if (batch.stagingAllocation) m_context->getMemoryAllocator()->free(batch.stagingAllocation);
+    for (const auto& slice : batch.slices) m_stagingRing->release(slice);
+    batch = Batch{};
+}
+
+void VK_TextureStreamer::waitIdle() {
+    std::lock_guard<std::mutex> flushLock(m_flushMutex);
+    retireBatches(true);
+}
+
+void VK_TextureStreamer::cancel(VK_Texture* texture) {
+    // 与 flush 互斥, 避免纹理在 prepareUpload/recordUpload 期间被销毁
+    std::lock_guard<std::mutex> flushLock(m_flushMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        auto removed = std::remove_if(m_pending.begin(), m_pending.end(),
+                                      [texture](const Request& r) { return r.texture == texture; });
+        for (auto it = removed; it != m_pending.end(); ++it) {
+            if (it->staged) m_stagingRing->release(it->staged);
+        }
+        m_pending.erase(removed, m_pending.end());
+        // 调用方须保证没有工作线程仍在写入该纹理的切片
+        if (auto it = m_mapped.find(texture); it != m_mapped.end()) {
+            m_stagingRing->release(it->second.staged);
+            m_mapped.erase(it);
+        }
+    }
+    std::lock_guard<std::mutex> lock(m_inFlightMutex);
+    for (auto& batch : m_inFlight) {
+        auto it = std::find(batch.textures.begin(), batch.textures.end(), texture);
+        if (it == batch.textures.end()) continue;
+        // 图像即将销毁, 必须等待 GPU 拷贝结束
+        (void)m_upload->wait(batch.ticket);
+        *it = nullptr;
+    }
+}
+
+uint32_t VK_TextureStreamer::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    return static_cast<uint32_t>(m_pending.size());
+}
+
+uint32_t VK_TextureStreamer::getInFlightBatchCount() const {
+    std::lock_guard<std::mutex> lock(m_inFlightMutex);
+    return static_cast<uint32_t>(m_inFlight.size());
+}
+
+} // namespace Nexus
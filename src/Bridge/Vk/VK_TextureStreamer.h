@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Base.h"
+#include "CommonTypes.h"
+#include "VK_StagingRing.h"
+#include "VK_MemoryAllocator.h"
+#include "VK_UploadContext.h"
+#include <vulkan/vulkan.hpp>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Nexus {
+
+class VK_Context;
+class VK_Texture;
+
+/**
+ * @brief 异步纹理上传队列
+ *
+ * 工作线程解码后通过 enqueue 提交像素数据; RHI 线程每帧调用 flush,
+ * 将本帧积累的全部纹理合并为一次图形队列提交 (VK_UploadContext::submitGraphics), 以 ticket 跟踪完成,
+ * 完成后把各纹理的 bindless 槽位从占位纹理切换到真实图像.
+ * staging 数据来自上传上下文持久映射的 VK_StagingRing; 工作线程可经 mapUpload 直接解码到环中, 省去中间拷贝.
+ * 已驻留纹理的请求为 mip 替换 (见 VK_Texture::prepareUpload), 同样在批次完成时切换槽位.
+ */
+class VK_TextureStreamer {
+public:
+    explicit VK_TextureStreamer(VK_Context* context);
+    ~VK_TextureStreamer();
+
+    Status initialize();
+    void shutdown();
+
+    /**
+     * @brief 提交待上传的纹理数据或已驻留纹理的 mip 替换 (线程安全)
+     */
+    void enqueue(VK_Texture* texture, ImageData&& imageData);
+
+    /**
+     * @brief 为 width x height 的 RGBA8 纹理申请 staging 环切片 (线程安全)
+     * @return 可写入 mip0 像素的映射指针; 环已满或设备不支持 blit 生成 mip 时返回 nullptr
+     */
+    uint8_t* mapUpload(VK_Texture* texture, uint32_t width, uint32_t height);
+
+    /**
+     * @brief 写入完成后提交 mapUpload 的切片; success 为 false 时归还切片
+     */
+    void commitUpload(VK_Texture* texture, bool success);
+
+    /**
+     * @brief 回收已完成的批次并提交新批次, 不阻塞 (需在拥有图形队列的线程调用)
+     */
+    void flush();
+
+    /**
+     * @brief 等待所有在途批次完成
+     */
+    void waitIdle();
+
+    /**
+     * @brief 纹理销毁前撤下其上传请求
+     */
+    void cancel(VK_Texture* texture);
+
+    uint32_t getPendingCount() const;
+    uint32_t getInFlightBatchCount() const;
+    VK_StagingRing* getStagingRing() const { return m_stagingRing; }
+
+private:
+    struct Request {
+        VK_Texture* texture = nullptr;
+        ImageData imageData;          // 经 mapUpload 提交时仅含尺寸
+        VK_StagingRing::Slice staged; // 已写好像素的环切片
+    };
+
+    struct Batch {
+        VK_UploadContext::Ticket ticket = 0;
+        vk::Buffer stagingBuffer;     // 环空间不足时的独立 staging 缓冲区
+        VK_MemoryAllocator::Allocation stagingAllocation;
+        std::vector<VK_StagingRing::Slice> slices;
+        std::vector<VK_Texture*> textures;
+    };
+
+    Status submitBatch(std::vector<Request>& requests);
+    Status createDedicatedStaging(Batch& batch, vk::DeviceSize size, uint8_t*& mapped);
+    void retireBatches(bool wait);
+    void destroyBatch(Batch& batch);
+
+    VK_Context* m_context;
+    VK_UploadContext* m_upload = nullptr;
+    VK_StagingRing* m_stagingRing = nullptr; // 由上传上下文持有
+
+    std::mutex m_flushMutex;
+
+    mutable std::mutex m_pendingMutex;
+    std::vector<Request> m_pending;
+    std::unordered_map<VK_Texture*, Request> m_mapped; // 工作线程正在写入的切片
+
+    mutable std::mutex m_inFlightMutex;
+    std::vector<Batch> m_inFlight;
+};
+
+} // namespace Nexus
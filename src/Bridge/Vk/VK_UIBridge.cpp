@@ -1,6 +1,8 @@
 #include "VK_UIBridge.h"
 #include "../Log.h"
 #include "../ResourceLoader.h"
+#include "VK_CommandBuffer.h"
+#include "VK_GpuProfiler.h"
 #include <RmlUi/Debugger.h>
 
 #ifdef ENABLE_RMLUI
@@ -71,9 +73,13 @@ void VK_UIBridge::update() {
 }
 
 void VK_UIBridge::render() {
-    if (m_rmlContext) {
-        m_rmlContext->Render();
-    }
+    if (!m_rmlContext) return;
+    // 当前录制目标可能是渲染 pass 内的二级命令缓冲区, 只计时间戳
+    ICommandBuffer* cmd = m_renderer->getCurrentCommandBuffer();
+    const vk::CommandBuffer vkCmd = cmd ? static_cast<VK_CommandBuffer*>(cmd)->getHandle() : vk::CommandBuffer();
+    const uint32_t scope = m_profiler && vkCmd ? m_profiler->beginScope(vkCmd, "UI") : VK_GpuProfiler::INVALID_SCOPE;
+    m_rmlContext->Render();
+    if (scope != VK_GpuProfiler::INVALID_SCOPE) m_profiler->endScope(vkCmd, scope);
 }
 
 Rml::ElementDocument* VK_UIBridge::loadDocument(const std::string& documentPath) {
@@ -13,6 +13,7 @@ namespace Nexus {
 
 class IContext;
 class IRenderer;
+class VK_GpuProfiler;
 
 /**
  * @brief RmlUi 桥接管理器，负责初始化、生命周期与上下文管理
@@ -38,10 +39,12 @@ public:
     void update();
     
     /**
-     * @brief 渲染 UI 几何体
+     * @brief 渲染 UI 几何体, 设置了 profiler 时以 "UI" 区间计时
      */
     void render();
 
+    void setProfiler(VK_GpuProfiler* profiler) { m_profiler = profiler; }
+
     /**
      * @brief 加载 UI 文档
      */
@@ -67,6 +70,7 @@ private:
     std::unique_ptr<VK_RmlUi_Renderer> m_renderInterface;
 
     Rml::Context* m_rmlContext = nullptr;
+    VK_GpuProfiler* m_profiler = nullptr;
 };
 
 } // namespace Nexus
@@ -0,0 +1,310 @@
+#include "VK_UploadContext.h"
+#include "VK_Context.h"
+#include "Log.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Nexus {
+
+namespace {
+constexpr vk::DeviceSize kStagingAlignment = 16;
+
+// 上传后的数据可能作为顶点/索引/间接参数/着色器资源被读取
+constexpr vk::AccessFlags kUploadReadAccess = vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead |
+                                              vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eShaderRead |
+                                              vk::AccessFlagBits::eUniformRead | vk::AccessFlagBits::eTransferRead;
+}
+
+VK_UploadContext::VK_UploadContext(VK_Context* context)
+    : m_context(context), m_device(context->getDevice()), m_transferQueue(nullptr), m_graphicsPool(nullptr),
+      m_transferPool(nullptr), m_timeline(nullptr), m_transferTimeline(nullptr) {}
+
+VK_UploadContext::~VK_UploadContext() {
+    shutdown();
+}
+
+Status VK_UploadContext::initialize(vk::DeviceSize stagingCapacity) {
+    m_graphicsFamily = m_context->getGraphicsQueueFamilyIndex();
+    m_transferFamily = m_context->getTransferQueueFamilyIndex();
+    m_transferQueue = m_context->getTransferQueue();
+    m_dedicatedTransfer = m_transferFamily != m_graphicsFamily;
+
+    auto poolResult = m_device.createCommandPool({vk::CommandPoolCreateFlagBits::eTransient, m_graphicsFamily});
+    if (poolResult.result != vk::Result::eSuccess) return InternalError("Failed to create upload command pool");
+    m_graphicsPool = poolResult.value;
+    if (m_dedicatedTransfer) {
+        auto transferPoolResult = m_device.createCommandPool({vk::CommandPoolCreateFlagBits::eTransient, m_transferFamily});
+        if (transferPoolResult.result != vk::Result::eSuccess) return InternalError("Failed to create transfer command pool");
+        m_transferPool = transferPoolResult.value;
+    }
+
+    vk::SemaphoreTypeCreateInfo typeInfo(vk::SemaphoreType::eTimeline, 0);
+    vk::SemaphoreCreateInfo semaphoreInfo;
+    semaphoreInfo.pNext = &typeInfo;
+    auto timelineResult = m_device.createSemaphore(semaphoreInfo);
+    if (timelineResult.result != vk::Result::eSuccess) return InternalError("Failed to create upload timeline semaphore");
+    m_timeline = timelineResult.value;
+    if (m_dedicatedTransfer) {
+        auto transferTimelineResult = m_device.createSemaphore(semaphoreInfo);
+        if (transferTimelineResult.result != vk::Result::eSuccess) return InternalError("Failed to create transfer timeline semaphore");
+        m_transferTimeline = transferTimelineResult.value;
+    }
+
+    m_stagingRing = std::make_unique<VK_StagingRing>(m_context);
+    if (auto status = m_stagingRing->initialize(stagingCapacity); !status.ok()) {
+        // 没有环时所有上传都使用独立 staging 缓冲区
+        NX_CORE_WARN("VK_UploadContext: staging ring unavailable: {}", status.message());
+        m_stagingRing.reset();
+    }
+    NX_CORE_INFO("Upload context using {} queue family {}", m_dedicatedTransfer ? "dedicated transfer" : "graphics", m_transferFamily);
+    return OkStatus();
+}
+
+void VK_UploadContext::shutdown() {
+    if (!m_graphicsPool) return;
+    waitIdle();
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pendingCopies.clear();
+        destroySubmission(m_pending);
+    }
+    m_stagingRing.reset();
+    if (m_timeline) m_device.destroySemaphore(m_timeline);
+    if (m_transferTimeline) m_device.destroySemaphore(m_transferTimeline);
+    if (m_transferPool) m_device.destroyCommandPool(m_transferPool);
+    m_device.destroyCommandPool(m_graphicsPool);
+    m_timeline = nullptr;
+    m_transferTimeline = nullptr;
+    m_transferPool = nullptr;
+    m_graphicsPool = nullptr;
+}
+
+Status VK_UploadContext::uploadBuffer(vk::Buffer destination, vk::DeviceSize destinationOffset, const void* data, vk::DeviceSize size) {
+    if (size == 0) return OkStatus();
+    if (!destination || !data) return InvalidArgumentError("Upload requires a destination buffer and data");
+
+    VK_StagingRing::Slice slice = m_stagingRing ? m_stagingRing->allocate(size, kStagingAlignment) : VK_StagingRing::Slice{};
+    if (slice) {
+        std::memcpy(slice.mapped, data, (size_t)size);
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pendingCopies.push_back({slice.buffer, slice.offset, destination, destinationOffset, size});
+        m_pending.slices.push_back(slice);
+        return OkStatus();
+    }
+
+    // 环已满或单次数据超过环容量: 线性块中的独立 staging, 提交完成后释放
+    StagingBuffer staging;
+    vk::BufferCreateInfo bufferInfo({}, size, vk::BufferUsageFlagBits::eTransferSrc, vk::SharingMode::eExclusive);
+    auto bufferResult = m_device.createBuffer(bufferInfo);
+    if (bufferResult.result != vk::Result::eSuccess) return InternalError("Failed to create upload staging buffer");
+    staging.buffer = bufferResult.value;
+    auto allocation = m_context->getMemoryAllocator()->allocateForBuffer(
+        staging.buffer, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        VK_MemoryAllocator::Usage::Transient);
+    if (!allocation.ok()) {
+        m_device.destroyBuffer(staging.buffer);
+        return allocation.status();
+    }
+    staging.allocation = *allocation;
+    std::memcpy(staging.allocation.mapped, data, (size_t)size);
+
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    m_pendingCopies.push_back({staging.buffer, 0, destination, destinationOffset, size});
+    m_pending.stagingBuffers.push_back(staging);
+    return OkStatus();
+}
+
+void VK_UploadContext::discardPending(vk::Buffer destination) {
+    // staging 随 m_pending 在下一次提交完成后回收, 这里只去掉拷贝
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    m_pendingCopies.erase(std::remove_if(m_pendingCopies.begin(), m_pendingCopies.end(),
+                                         [destination](const PendingCopy& copy) { return copy.destination == destination; }),
+                          m_pendingCopies.end());
+}
+
+StatusOr<vk::CommandBuffer> VK_UploadContext::beginCommands(vk::CommandPool pool) {
+    vk::CommandBufferAllocateInfo allocInfo(pool, vk::CommandBufferLevel::ePrimary, 1);
+    auto result = m_device.allocateCommandBuffers(allocInfo);
+    if (result.result != vk::Result::eSuccess) return InternalError("Failed to allocate upload command buffer");
+    vk::CommandBuffer commands = result.value[0];
+    (void)commands.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    return commands;
+}
+
+Status VK_UploadContext::submit(vk::Queue queue, vk::CommandBuffer commands, vk::Semaphore signal, Ticket signalValue,
+                                vk::Semaphore wait, Ticket waitValue) {
+    const vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eAllCommands;
+    vk::TimelineSemaphoreSubmitInfo timelineInfo;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &signalValue;
+    vk::SubmitInfo submitInfo;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commands;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &signal;
+    if (wait) {
+        timelineInfo.waitSemaphoreValueCount = 1;
+        timelineInfo.pWaitSemaphoreValues = &waitValue;
+        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.pWaitSemaphores = &wait;
+        submitInfo.pWaitDstStageMask = &waitStage;
+    }
+
+    // 图形队列同时被渲染线程使用, 提交须互斥
+    std::unique_lock<std::mutex> queueLock(m_context->getGraphicsQueueMutex(), std::defer_lock);
+    if (queue == m_context->getGraphicsQueue()) queueLock.lock();
+    if (queue.submit(submitInfo, nullptr) != vk::Result::eSuccess) return InternalError("Failed to submit upload commands");
+    return OkStatus();
+}
+
+Status VK_UploadContext::submitCopies(Submission& submission, const std::vector<PendingCopy>& copies) {
+    vk::CommandPool copyPool = m_dedicatedTransfer ? m_transferPool : m_graphicsPool;
+    NX_ASSIGN_OR_RETURN(vk::CommandBuffer copyCommands, beginCommands(copyPool));
+    if (m_dedicatedTransfer) {
+        submission.transferCommands = copyCommands;
+    } else {
+        submission.graphicsCommands = copyCommands;
+    }
+
+    if (!m_dedicatedTransfer) {
+        // 同一队列上先前提交的读取须在覆盖前完成 (WAR, 仅需执行依赖)
+        copyCommands.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, {}, nullptr, nullptr, nullptr);
+    }
+    for (const auto& copy : copies) {
+        copyCommands.copyBuffer(copy.source, copy.destination, vk::BufferCopy(copy.sourceOffset, copy.destinationOffset, copy.size));
+    }
+
+    if (!m_dedicatedTransfer) {
+        vk::MemoryBarrier barrier(vk::AccessFlagBits::eTransferWrite, kUploadReadAccess);
+        copyCommands.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, barrier, nullptr, nullptr);
+        (void)copyCommands.end();
+        return submit(m_context->getGraphicsQueue(), copyCommands, m_timeline, submission.ticket, nullptr, 0);
+    }
+
+    // 独立 transfer 队列: 拷贝后释放目标区间的所有权, 图形队列等待拷贝完成后获取
+    std::vector<vk::BufferMemoryBarrier> release;
+    std::vector<vk::BufferMemoryBarrier> acquire;
+    release.reserve(copies.size());
+    acquire.reserve(copies.size());
+    for (const auto& copy : copies) {
+        release.emplace_back(vk::AccessFlagBits::eTransferWrite, vk::AccessFlags{}, m_transferFamily, m_graphicsFamily,
+                             copy.destination, copy.destinationOffset, copy.size);
+        acquire.emplace_back(vk::AccessFlags{}, kUploadReadAccess, m_transferFamily, m_graphicsFamily,
+                             copy.destination, copy.destinationOffset, copy.size);
+    }
+    copyCommands.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe, {}, nullptr, release, nullptr);
+    (void)copyCommands.end();
+    NX_RETURN_IF_ERROR(submit(m_transferQueue, copyCommands, m_transferTimeline, submission.ticket, nullptr, 0));
+
+    NX_ASSIGN_OR_RETURN(submission.graphicsCommands, beginCommands(m_graphicsPool));
+    submission.graphicsCommands.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eAllCommands, {}, nullptr, acquire, nullptr);
+    (void)submission.graphicsCommands.end();
+    return submit(m_context->getGraphicsQueue(), submission.graphicsCommands, m_timeline, submission.ticket,
+                  m_transferTimeline, submission.ticket);
+}
+
+VK_UploadContext::Ticket VK_UploadContext::flush() {
+    std::lock_guard<std::mutex> submitLock(m_submitMutex);
+    if (!m_graphicsPool) return m_lastTicket;
+    retireLocked(false);
+
+    std::vector<PendingCopy> copies;
+    Submission submission;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        copies.swap(m_pendingCopies);
+        std::swap(submission, m_pending);
+    }
+    if (copies.empty()) {
+        // 拷贝全部被丢弃时 staging 从未提交, 可直接回收
+        destroySubmission(submission);
+        return m_lastTicket;
+    }
+
+    submission.ticket = m_lastTicket + 1;
+    if (auto status = submitCopies(submission, copies); !status.ok()) {
+        NX_CORE_ERROR("VK_UploadContext: failed to submit buffer uploads: {}", status.message());
+        destroySubmission(submission);
+        return m_lastTicket;
+    }
+    m_lastTicket = submission.ticket;
+    m_inFlight.push_back(std::move(submission));
+    return m_lastTicket;
+}
+
+StatusOr<VK_UploadContext::Ticket> VK_UploadContext::submitGraphics(const std::function<void(vk::CommandBuffer)>& record) {
+    std::lock_guard<std::mutex> submitLock(m_submitMutex);
+    if (!m_graphicsPool) return InternalError("Upload context is not initialized");
+    retireLocked(false);
+
+    Submission submission;
+    NX_ASSIGN_OR_RETURN(submission.graphicsCommands, beginCommands(m_graphicsPool));
+    record(submission.graphicsCommands);
+    (void)submission.graphicsCommands.end();
+
+    submission.ticket = m_lastTicket + 1;
+    if (auto status = submit(m_context->getGraphicsQueue(), submission.graphicsCommands, m_timeline, submission.ticket, nullptr, 0);
+        !status.ok()) {
+        destroySubmission(submission);
+        return status;
+    }
+    m_lastTicket = submission.ticket;
+    m_inFlight.push_back(std::move(submission));
+    return m_lastTicket;
+}
+
+bool VK_UploadContext::isComplete(Ticket ticket) const {
+    if (ticket == 0 || !m_timeline) return true;
+    auto value = m_device.getSemaphoreCounterValue(m_timeline);
+    return value.result == vk::Result::eSuccess && value.value >= ticket;
+}
+
+Status VK_UploadContext::wait(Ticket ticket) const {
+    if (ticket == 0 || !m_timeline) return OkStatus();
+    vk::SemaphoreWaitInfo waitInfo({}, 1, &m_timeline, &ticket);
+    if (m_device.waitSemaphores(waitInfo, UINT64_MAX) != vk::Result::eSuccess) return InternalError("Failed to wait for upload");
+    return OkStatus();
+}
+
+VK_UploadContext::Ticket VK_UploadContext::getLastTicket() const {
+    std::lock_guard<std::mutex> submitLock(m_submitMutex);
+    return m_lastTicket;
+}
+
+void VK_UploadContext::waitIdle() {
+    std::lock_guard<std::mutex> submitLock(m_submitMutex);
+    retireLocked(true);
+}
+
+void VK_UploadContext::retireLocked(bool waitAll) {
+    if (waitAll) (void)wait(m_lastTicket);
+    auto value = m_device.getSemaphoreCounterValue(m_timeline);
+    const Ticket completed = value.result == vk::Result::eSuccess ? value.value : 0;
+    auto done = std::partition(m_inFlight.begin(), m_inFlight.end(), [completed](const Submission& s) { return s.ticket > completed; });
+    for (auto it = done; it != m_inFlight.end(); ++it) destroySubmission(*it);
+    m_inFlight.erase(done, m_inFlight.end());
+}
+
+void VK_UploadContext::destroySubmission(Submission& submission) {
+    if (submission.transferCommands) m_device.freeCommandBuffers(m_transferPool, 1, &submission.transferCommands);
+    if (submission.graphicsCommands) m_device.freeCommandBuffers(m_graphicsPool, 1, &submission.graphicsCommands);
+    for (const auto& slice : submission.slices) m_stagingRing->release(slice);
+    for (auto& staging : submission.stagingBuffers) {
+        m_device.destroyBuffer(staging.buffer);
+        m_context->getMemoryAllocator()->free(staging.allocation);
+    }
+    submission = Submission{};
+}
+
+uint32_t VK_UploadContext::getInFlightCount() const {
+    std::lock_guard<std::mutex> lock(m_submitMutex);
+    return static_cast<uint32_t>(m_inFlight.size());
+}
+
+uint32_t VK_UploadContext::getPendingCopyCount() const {
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    return static_cast<uint32_t>(m_pendingCopies.size());
+}
+
+} // namespace Nexus
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "Base.h"
+#include "VK_MemoryAllocator.h"
+#include "VK_StagingRing.h"
+#include <vulkan/vulkan.hpp>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Nexus {
+
+class VK_Context;
+
+/**
+ * @brief CPU -> GPU 上传上下文
+ *
+ * - staging 来自持久映射的 VK_StagingRing, 环放不下时退化为 Transient 独立缓冲区;
+ * - 缓冲区上传 (uploadBuffer) 先排队, flush 时合并为一次提交. 设备有独立 transfer 队列族时
+ *   在 transfer 队列拷贝, 以 release/acquire 屏障把目标区间的所有权转移给图形队列;
+ *   否则直接在图形队列拷贝;
+ * - 图像上传需要 blit 生成 mip 与布局转换, 经 submitGraphics 在图形队列录制提交;
+ * - 每次提交在 timeline semaphore 上信号一个递增的 ticket, 完成查询与等待都基于 ticket,
+ *   不再使用 queue.waitIdle.
+ * uploadBuffer 的目标区间不能正被在途的 GPU 工作读取 (新分配的区间, 或读取它的帧已在帧时间线上完成).
+ */
+class VK_UploadContext {
+public:
+    using Ticket = uint64_t;
+
+    static constexpr vk::DeviceSize STAGING_RING_SIZE = 64ull * 1024 * 1024;
+
+    explicit VK_UploadContext(VK_Context* context);
+    ~VK_UploadContext();
+
+    Status initialize(vk::DeviceSize stagingCapacity = STAGING_RING_SIZE);
+    void shutdown();
+
+    /**
+     * @brief 把 data 拷入 staging 并排队到下一次 flush (线程安全)
+     */
+    Status uploadBuffer(vk::Buffer destination, vk::DeviceSize destinationOffset, const void* data, vk::DeviceSize size);
+
+    /**
+     * @brief 丢弃排队中以 destination 为目标的拷贝, 缓冲区销毁前调用 (线程安全)
+     */
+    void discardPending(vk::Buffer destination);
+
+    /**
+     * @brief 回收已完成的提交, 并提交排队中的缓冲区拷贝
+     * @return 覆盖本次提交的 ticket; 没有排队内容时返回最近一次提交的 ticket
+     */
+    Ticket flush();
+
+    /**
+     * @brief 在图形队列上录制并提交一次性命令, 命令缓冲区在 ticket 完成后回收 (线程安全)
+     */
+    StatusOr<Ticket> submitGraphics(const std::function<void(vk::CommandBuffer)>& record);
+
+    bool isComplete(Ticket ticket) const;
+    Status wait(Ticket ticket) const;
+
+    /**
+     * @brief 最近一次提交的 ticket, 没有提交过时为 0
+     */
+    Ticket getLastTicket() const;
+
+    /**
+     * @brief 等待所有已提交的工作并回收
+     */
+    void waitIdle();
+
+    VK_StagingRing* getStagingRing() const { return m_stagingRing.get(); }
+    bool hasDedicatedTransferQueue() const { return m_dedicatedTransfer; }
+    uint32_t getInFlightCount() const;
+    uint32_t getPendingCopyCount() const;
+
+private:
+    struct PendingCopy {
+        vk::Buffer source;
+        vk::DeviceSize sourceOffset = 0;
+        vk::Buffer destination;
+        vk::DeviceSize destinationOffset = 0;
+        vk::DeviceSize size = 0;
+    };
+
+    struct StagingBuffer {
+        vk::Buffer buffer;
+        VK_MemoryAllocator::Allocation allocation;
+    };
+
+    struct Submission {
+        Ticket ticket = 0;
+        vk::CommandBuffer transferCommands; // 仅独立 transfer 队列
+        vk::CommandBuffer graphicsCommands;
+        std::vector<VK_StagingRing::Slice> slices;
+        std::vector<StagingBuffer> stagingBuffers;
+    };
+
+    StatusOr<vk::CommandBuffer> beginCommands(vk::CommandPool pool);
+    Status submit(vk::Queue queue, vk::CommandBuffer commands, vk::Semaphore signal, Ticket signalValue,
+                  vk::Semaphore wait, Ticket waitValue);
+    Status submitCopies(Submission& submission, const std::vector<PendingCopy>& copies);
+    void retireLocked(bool waitAll);
+    void destroySubmission(Submission& submission);
+
+    VK_Context* m_context;
+    vk::Device m_device;
+    bool m_dedicatedTransfer = false;
+    uint32_t m_transferFamily = 0;
+    uint32_t m_graphicsFamily = 0;
+    vk::Queue m_transferQueue;
+    vk::CommandPool m_graphicsPool;
+    vk::CommandPool m_transferPool;   // 独立 transfer 队列族的命令池
+    vk::Semaphore m_timeline;         // 图形队列上的完成 ticket
+    vk::Semaphore m_transferTimeline; // transfer 队列拷贝完成, 供图形队列 acquire 等待
+    std::unique_ptr<VK_StagingRing> m_stagingRing;
+
+    mutable std::mutex m_pendingMutex;
+    std::vector<PendingCopy> m_pendingCopies;
+    Submission m_pending; // 排队中的 staging 资源
+
+    // 串行化命令池, ticket 分配与队列提交
+    mutable std::mutex m_submitMutex;
+    std::vector<Submission> m_inFlight;
+    Ticket m_lastTicket = 0;
+};
+
+} // namespace Nexus
@@ -0,0 +1,92 @@
+#include "BoundsSystem.h"
+#include "Components.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NX_BOUNDS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace Nexus {
+
+#if NX_BOUNDS_SSE2
+
+void BoundsSystem::transformBounds(const std::array<float, 16>& m, BoundsComponent& bounds) {
+    // 每列一个寄存器 (x, y, z, w), 一次处理三个轴
+    const __m128 col0 = _mm_loadu_ps(&m[0]);
+    const __m128 col1 = _mm_loadu_ps(&m[4]);
+    const __m128 col2 = _mm_loadu_ps(&m[8]);
+    const __m128 col3 = _mm_loadu_ps(&m[12]);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+    const auto& lmin = bounds.localMin;
+    const auto& lmax = bounds.localMax;
+    const float cx = (lmin[0] + lmax[0]) * 0.5f, cy = (lmin[1] + lmax[1]) * 0.5f, cz = (lmin[2] + lmax[2]) * 0.5f;
+    const float ex = (lmax[0] - lmin[0]) * 0.5f, ey = (lmax[1] - lmin[1]) * 0.5f, ez = (lmax[2] - lmin[2]) * 0.5f;
+
+    __m128 center = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(col0, _mm_set1_ps(cx)), _mm_mul_ps(col1, _mm_set1_ps(cy))),
+        _mm_add_ps(_mm_mul_ps(col2, _mm_set1_ps(cz)), col3));
+    __m128 extent = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(_mm_and_ps(col0, absMask), _mm_set1_ps(ex)), _mm_mul_ps(_mm_and_ps(col1, absMask), _mm_set1_ps(ey))),
+        _mm_mul_ps(_mm_and_ps(col2, absMask), _mm_set1_ps(ez)));
+
+    alignas(16) float minOut[4], maxOut[4];
+    _mm_store_ps(minOut, _mm_sub_ps(center, extent));
+    _mm_store_ps(maxOut, _mm_add_ps(center, extent));
+    bounds.worldMin = {minOut[0], minOut[1], minOut[2]};
+    bounds.worldMax = {maxOut[0], maxOut[1], maxOut[2]};
+
+    const auto& ls = bounds.localSphere;
+    __m128 sphereCenter = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(col0, _mm_set1_ps(ls[0])), _mm_mul_ps(col1, _mm_set1_ps(ls[1]))),
+        _mm_add_ps(_mm_mul_ps(col2, _mm_set1_ps(ls[2])), col3));
+
+    // 各列长度平方 -> 最大轴缩放
+    __m128 sq0 = _mm_mul_ps(col0, col0), sq1 = _mm_mul_ps(col1, col1), sq2 = _mm_mul_ps(col2, col2);
+    __m128 w0 = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(sq0, sq1, sq2, w0);
+    __m128 lengthsSq = _mm_add_ps(_mm_add_ps(sq0, sq1), sq2); // (|c0|^2, |c1|^2, |c2|^2, 0)
+    __m128 maxSq = _mm_max_ps(lengthsSq, _mm_shuffle_ps(lengthsSq, lengthsSq, _MM_SHUFFLE(1, 0, 3, 2)));
+    maxSq = _mm_max_ps(maxSq, _mm_shuffle_ps(maxSq, maxSq, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    alignas(16) float sphereOut[4];
+    _mm_store_ps(sphereOut, sphereCenter);
+    bounds.worldSphere = {sphereOut[0], sphereOut[1], sphereOut[2], ls[3] * std::sqrt(_mm_cvtss_f32(maxSq))};
+}
+
+#else
+
+void BoundsSystem::transformBounds(const std::array<float, 16>& m, BoundsComponent& bounds) {
+    const auto& lmin = bounds.localMin;
+    const auto& lmax = bounds.localMax;
+    const auto& ls = bounds.localSphere;
+    float maxScaleSq = 0.0f;
+    for (int col = 0; col < 3; ++col) {
+        maxScaleSq = std::max(maxScaleSq, m[col * 4 + 0] * m[col * 4 + 0] + m[col * 4 + 1] * m[col * 4 + 1] + m[col * 4 + 2] * m[col * 4 + 2]);
+    }
+    for (int a = 0; a < 3; ++a) {
+        float center = m[12 + a], extent = 0.0f, sphereCenter = m[12 + a];
+        for (int col = 0; col < 3; ++col) {
+            center += m[col * 4 + a] * (lmin[col] + lmax[col]) * 0.5f;
+            extent += std::fabs(m[col * 4 + a]) * (lmax[col] - lmin[col]) * 0.5f;
+            sphereCenter += m[col * 4 + a] * ls[col];
+        }
+        bounds.worldMin[a] = center - extent;
+        bounds.worldMax[a] = center + extent;
+        bounds.worldSphere[a] = sphereCenter;
+    }
+    bounds.worldSphere[3] = ls[3] * std::sqrt(maxScaleSq);
+}
+
+#endif
+
+void BoundsSystem::update(Registry& registry) {
+    auto view = registry.view<TransformComponent, BoundsComponent>();
+    for (auto entity : view) {
+        transformBounds(view.get<TransformComponent>(entity).worldMatrix, view.get<BoundsComponent>(entity));
+    }
+}
+
+} // namespace Nexus
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "../Bridge/ECS.h"
+#include <array>
+
+namespace Nexus {
+
+struct BoundsComponent;
+
+/**
+ * @brief 包围体系统
+ * 在世界矩阵更新之后批量将 BoundsComponent 的局部包围体变换到世界空间
+ */
+class BoundsSystem {
+public:
+    /**
+     * @brief 更新所有 (TransformComponent, BoundsComponent) 实体的世界包围体
+     * 需在 HierarchySystem / RoboticsDynamicsSystem 写完 worldMatrix 之后调用
+     */
+    static void update(Registry& registry);
+
+    /**
+     * @brief 按世界矩阵 (列主序) 变换单个包围体
+     * AABB 使用 |M| * extent 求保守包围盒, 包围球半径按最大轴缩放放大
+     */
+    static void transformBounds(const std::array<float, 16>& worldMatrix, BoundsComponent& bounds);
+};
+
+} // namespace Nexus
@@ -8,6 +8,8 @@
 #include <cereal/types/string.hpp>
 #include <cereal/types/vector.hpp>
 #include <cereal/types/array.hpp>
+#include <cereal/types/common.hpp>
+#include "CommonTypes.h"
 
 namespace Nexus {
 
@@ -64,6 +66,13 @@ struct TransformComponent {
         };
     }
 
+    /**
+     * @brief 世界空间位置 (worldMatrix 的平移部分, 父级变换已计入)
+     */
+    std::array<float, 3> getWorldPosition() const {
+        return {worldMatrix[12], worldMatrix[13], worldMatrix[14]};
+    }
+
     template<class Archive>
     void serialize(Archive& ar) {
         ar(position, rotation, scale);
@@ -130,6 +139,11 @@ struct CameraComponent {
     }
 };
 
+template<class Archive>
+void serialize(Archive& ar, MeshLod& lod, const std::uint32_t /*version*/) {
+    ar(lod.indexOffset, lod.indexCount, lod.error);
+}
+
 /**
  * @brief 静态网格组件
  */
@@ -139,6 +153,17 @@ struct MeshComponent {
     uint32_t vertexOffset = 0;
     uint32_t indexOffset = 0;
     uint32_t indexCount = 0;
+    IndexType indexType = IndexType::Uint32; // indexOffset 以此为单位
+    uint32_t meshId = 0; // MeshManager 注册表句柄 (运行时, 不序列化)
+
+    // 顶点位置反量化 (VertexFormat::Compact), position = offset + unorm * scale
+    std::array<float, 3> positionOffset = {0.0f, 0.0f, 0.0f};
+    std::array<float, 3> positionScale = {1.0f, 1.0f, 1.0f};
+
+    // LOD 表 (lodCount == 0 表示仅有 indexOffset/indexCount 描述的单级网格)
+    std::array<MeshLod, MAX_MESH_LODS> lods = {};
+    uint32_t lodCount = 0;
+    uint32_t activeLod = 0; // 由 LodSystem 每帧选择 (运行时, 不序列化)
     
     // Bindless texture indices
     uint32_t albedoTexture = 0; 
@@ -147,20 +172,85 @@ struct MeshComponent {
     uint32_t occlusionTexture = 0;
     uint32_t emissiveTexture = 0;
     uint32_t samplerIndex = 0;
+    // 平均纹理坐标密度 (UV 长度 / 模型单位), 用于 mip 流式加载 (运行时, 不序列化)
+    float uvDensity = 0.0f;
 
     // PBR Factors
     std::array<float, 4> albedoFactor = {1.0f, 1.0f, 1.0f, 1.0f};
     float metallicFactor = 1.0f;
     float roughnessFactor = 1.0f;
 
+    bool hasQuantizedPositions() const {
+        return positionOffset != std::array<float, 3>{0.0f, 0.0f, 0.0f} ||
+               positionScale != std::array<float, 3>{1.0f, 1.0f, 1.0f};
+    }
+
+    /**
+     * @brief 反量化矩阵 (列主序), 需右乘到世界矩阵
+     */
+    std::array<float, 16> computeDequantizeMatrix() const {
+        return {
+            positionScale[0], 0.0f, 0.0f, 0.0f,
+            0.0f, positionScale[1], 0.0f, 0.0f,
+            0.0f, 0.0f, positionScale[2], 0.0f,
+            positionOffset[0], positionOffset[1], positionOffset[2], 1.0f
+        };
+    }
+
+    uint32_t getDrawIndexOffset() const {
+        return activeLod < lodCount ? lods[activeLod].indexOffset : indexOffset;
+    }
+
+    uint32_t getDrawIndexCount() const {
+        return activeLod < lodCount ? lods[activeLod].indexCount : indexCount;
+    }
+
     template<class Archive>
-    void serialize(Archive& ar) {
+    void serialize(Archive& ar, const std::uint32_t version) {
+        serializeFields(ar, version);
+    }
+
+    /**
+     * @brief 版本 0: 仅有偏移, 索引数, 纹理与 PBR 因子 (32 位索引, 无反量化与 LOD 表); 版本 1 起为当前布局
+     * @note 没有类版本号的旧场景文件由 SceneSerializer 以版本 0 直接调用
+     */
+    template<class Archive>
+    void serializeFields(Archive& ar, std::uint32_t version) {
         ar(vertexOffset, indexOffset, indexCount);
+        if (version >= 1) {
+            ar(indexType);
+            ar(positionOffset, positionScale);
+            ar(lods, lodCount);
+        }
         ar(albedoTexture, normalTexture, metallicRoughnessTexture, occlusionTexture, emissiveTexture, samplerIndex);
         ar(albedoFactor, metallicFactor, roughnessFactor);
     }
 };
 
+/**
+ * @brief 包围体组件
+ *
+ * local* 为网格空间包围体 (导入时计算并序列化), world* 由 BoundsSystem 每帧根据 worldMatrix 更新
+ */
+struct BoundsComponent {
+    std::array<float, 3> localMin = {0.0f, 0.0f, 0.0f};
+    std::array<float, 3> localMax = {0.0f, 0.0f, 0.0f};
+    std::array<float, 4> localSphere = {0.0f, 0.0f, 0.0f, 0.0f}; // center, radius
+
+    std::array<float, 3> worldMin = {0.0f, 0.0f, 0.0f};
+    std::array<float, 3> worldMax = {0.0f, 0.0f, 0.0f};
+    std::array<float, 4> worldSphere = {0.0f, 0.0f, 0.0f, 0.0f};
+
+    BoundsComponent() = default;
+    BoundsComponent(const std::array<float, 3>& min, const std::array<float, 3>& max, const std::array<float, 4>& sphere)
+        : localMin(min), localMax(max), localSphere(sphere), worldMin(min), worldMax(max), worldSphere(sphere) {}
+
+    template<class Archive>
+    void serialize(Archive& ar) {
+        ar(localMin, localMax, localSphere);
+    }
+};
+
 /**
  * @brief 刚体组件，用于与物理引擎（如 MuJoCo）进行状态同步
  */
@@ -174,3 +264,6 @@ struct RigidBodyComponent {
 };
 
 } // namespace Nexus
+
+CEREAL_CLASS_VERSION(Nexus::MeshLod, 0);
+CEREAL_CLASS_VERSION(Nexus::MeshComponent, 1);
@@ -13,8 +13,8 @@ Status DrawCommandGenerator::initialize(uint32_t maxCount) {
     NX_ASSERT(m_context, "Context must be valid");
     size_t bufferSize = maxCount * sizeof(DrawIndexedIndirectCommand);
     // Buffer usage: IndirectBuffer (0x00000100) | TransferDst (0x00000002)
-    // Memory properties: HostVisible (0x00000002) | HostCoherent (0x00000004)
-    m_indirectBuffer = m_context->createBuffer(bufferSize, 0x0102, 0x0006);
+    // Memory properties: DeviceLocal (0x00000001), 更新经上传上下文拷贝
+    m_indirectBuffer = m_context->createBuffer(bufferSize, 0x0102, 0x0001);
     return (m_indirectBuffer != nullptr) ? OkStatus() : InternalError("Failed to create indirect buffer");
 }
 
@@ -0,0 +1,60 @@
+#include "LodSystem.h"
+#include "Components.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Nexus {
+
+namespace {
+float lodThreshold(const LodSystem::Settings& settings, uint32_t lod) {
+    size_t i = std::min<size_t>(lod, settings.thresholds.size() - 1);
+    return settings.thresholds[i] * settings.lodBias;
+}
+}
+
+uint32_t LodSystem::selectLod(float coverage, uint32_t currentLod, uint32_t lodCount, const Settings& settings) {
+    if (lodCount <= 1) return 0;
+    uint32_t lod = std::min(currentLod, lodCount - 1);
+    while (lod + 1 < lodCount && coverage < lodThreshold(settings, lod) * (1.0f - settings.hysteresis)) {
+        ++lod;
+    }
+    while (lod > 0 && coverage > lodThreshold(settings, lod - 1) * (1.0f + settings.hysteresis)) {
+        --lod;
+    }
+    return lod;
+}
+
+void LodSystem::update(Registry& registry) {
+    update(registry, Settings{});
+}
+
+void LodSystem::update(Registry& registry, const Settings& settings) {
+    auto cameraView = registry.view<CameraComponent, TransformComponent>();
+    auto cameraIt = cameraView.begin();
+    if (cameraIt == cameraView.end()) return;
+
+    const auto& camera = cameraView.get<CameraComponent>(*cameraIt);
+    const auto& cameraTransform = cameraView.get<TransformComponent>(*cameraIt);
+    const auto eye = cameraTransform.getWorldPosition();
+    const float tanHalfFov = std::tan(camera.fov * 0.5f * (3.1415926535f / 180.0f));
+
+    auto meshView = registry.view<MeshComponent, BoundsComponent>();
+    for (auto entity : meshView) {
+        auto& mesh = meshView.get<MeshComponent>(entity);
+        if (mesh.lodCount <= 1) {
+            mesh.activeLod = 0;
+            continue;
+        }
+        const auto& sphere = meshView.get<BoundsComponent>(entity).worldSphere;
+        const float radius = sphere[3];
+
+        float dx = sphere[0] - eye[0], dy = sphere[1] - eye[1], dz = sphere[2] - eye[2];
+        float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+        // 相机位于包围球内时始终使用最高精度
+        float coverage = distance > radius ? radius / (distance * tanHalfFov) : 1e6f;
+
+        mesh.activeLod = selectLod(coverage, mesh.activeLod, mesh.lodCount, settings);
+    }
+}
+
+} // namespace Nexus
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../Bridge/ECS.h"
+#include <array>
+#include <cstdint>
+
+namespace Nexus {
+
+/**
+ * @brief LOD 选择系统
+ * 按世界包围球在屏幕上的投影大小为每个 MeshComponent 选择 activeLod, 带滞回避免在阈值附近来回切换
+ */
+class LodSystem {
+public:
+    struct Settings {
+        // 屏幕覆盖率 (投影半径 / 半屏高) 低于 thresholds[i] 时切换到 LOD i+1
+        std::array<float, 3> thresholds = {0.30f, 0.15f, 0.07f};
+        // 滞回带宽: 变粗需低于 t*(1-h), 变细需高于 t*(1+h)
+        float hysteresis = 0.1f;
+        // > 1 时更早切换到低精度级别
+        float lodBias = 1.0f;
+    };
+
+    /**
+     * @brief 使用第一个相机更新所有网格的 activeLod (需在 BoundsSystem 之后调用)
+     */
+    static void update(Registry& registry);
+    static void update(Registry& registry, const Settings& settings);
+
+    /**
+     * @brief 根据覆盖率与当前级别选择新级别
+     */
+    static uint32_t selectLod(float coverage, uint32_t currentLod, uint32_t lodCount, const Settings& settings);
+};
+
+} // namespace Nexus
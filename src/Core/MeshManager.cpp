@@ -1,8 +1,79 @@
 #include "MeshManager.h"
+#include "VertexPacking.h"
+#include "Components.h"
+#include "Log.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 namespace Nexus {
 namespace Core {
 
+namespace {
+constexpr uint64_t kGlobalBufferSize = 128ull * 1024 * 1024;
+constexpr uint32_t kFloatsPerVertex = 8;
+// 索引缓冲区按 4 字节为单位分配, 16 位索引两个占一个单位
+constexpr uint32_t kMaxIndexWords = (uint32_t)(kGlobalBufferSize / sizeof(uint32_t));
+
+uint32_t indexWordCount(IndexType type, uint32_t indexCount) {
+    return type == IndexType::Uint16 ? (indexCount + 1) / 2 : indexCount;
+}
+
+/**
+ * @brief 局部 AABB 与以其中心为球心的包围球
+ */
+void computeBounds(const std::vector<float>& vertices, MeshRange& range) {
+    const size_t vertexCount = vertices.size() / kFloatsPerVertex;
+    if (vertexCount == 0) {
+        range.aabbMin = range.aabbMax = {0.0f, 0.0f, 0.0f};
+        range.boundingSphere = {0.0f, 0.0f, 0.0f, 0.0f};
+        return;
+    }
+
+    std::array<float, 3> minPos = {vertices[0], vertices[1], vertices[2]};
+    std::array<float, 3> maxPos = minPos;
+    for (size_t i = 1; i < vertexCount; ++i) {
+        for (int a = 0; a < 3; ++a) {
+            minPos[a] = std::min(minPos[a], vertices[i * kFloatsPerVertex + a]);
+            maxPos[a] = std::max(maxPos[a], vertices[i * kFloatsPerVertex + a]);
+        }
+    }
+    std::array<float, 4> sphere = {
+        (minPos[0] + maxPos[0]) * 0.5f, (minPos[1] + maxPos[1]) * 0.5f, (minPos[2] + maxPos[2]) * 0.5f, 0.0f
+    };
+    float radiusSq = 0.0f;
+    for (size_t i = 0; i < vertexCount; ++i) {
+        float dx = vertices[i * kFloatsPerVertex + 0] - sphere[0];
+        float dy = vertices[i * kFloatsPerVertex + 1] - sphere[1];
+        float dz = vertices[i * kFloatsPerVertex + 2] - sphere[2];
+        radiusSq = std::max(radiusSq, dx * dx + dy * dy + dz * dz);
+    }
+    sphere[3] = std::sqrt(radiusSq);
+
+    range.aabbMin = minPos;
+    range.aabbMax = maxPos;
+    range.boundingSphere = sphere;
+}
+
+/**
+ * @brief 平均纹理坐标密度: sqrt(UV 面积之和 / 模型空间面积之和), 即每模型单位跨越的 UV 长度
+ */
+float computeUvDensity(const std::vector<float>& vertices, const std::vector<uint32_t>& indices) {
+    double uvArea = 0.0, positionArea = 0.0;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        const float* a = &vertices[(size_t)indices[i] * kFloatsPerVertex];
+        const float* b = &vertices[(size_t)indices[i + 1] * kFloatsPerVertex];
+        const float* c = &vertices[(size_t)indices[i + 2] * kFloatsPerVertex];
+        const float e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+        const float e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+        const float cross[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+        positionArea += 0.5 * std::sqrt((double)cross[0] * cross[0] + (double)cross[1] * cross[1] + (double)cross[2] * cross[2]);
+        uvArea += 0.5 * std::fabs((double)(b[3] - a[3]) * (c[4] - a[4]) - (double)(c[3] - a[3]) * (b[4] - a[4]));
+    }
+    return positionArea > 0.0 ? (float)std::sqrt(uvArea / positionArea) : 0.0f;
+}
+}
+
 MeshManager::MeshManager(IContext* context) : m_context(context) {
 }
 
@@ -12,17 +83,148 @@ MeshManager::~MeshManager() {
 /**
  * @brief 初始化全局网格缓冲区
  */
-Status MeshManager::initialize() {
+Status MeshManager::initialize(VertexFormat vertexFormat) {
     NX_ASSERT(m_context, "Context must be valid");
-    // VertexBuffer (0x00000080) | TransferDst (0x00000002)
-    // IndexBuffer (0x00000040) | TransferDst (0x00000002)
-    // VertexBuffer (0x00000080) | TransferDst (0x00000002) 
-    // HostVisible (0x00000002) | HostCoherent (0x00000004) -> 6
-    m_vertexBuffer = m_context->createBuffer(128 * 1024 * 1024, 0x0082, 0x0006);
+    m_vertexFormat = vertexFormat;
+    m_maxVertices = (uint32_t)(kGlobalBufferSize / getVertexStride(vertexFormat));
+
+    // 全局缓冲区放在 device-local 内存, registerMesh 的写入经 staging 拷贝
+    // VertexBuffer (0x00000080) | TransferDst (0x00000002) -> 0x0082
+    // DeviceLocal (0x00000001)
+    m_vertexBuffer = m_context->createBuffer(kGlobalBufferSize, 0x0082, 0x0001);
 
     // IndexBuffer (0x00000040) | TransferDst (0x00000002) -> 0x0042
-    // HostVisible (0x00000002) | HostCoherent (0x00000004) -> 0x0006
-    m_indexBuffer = m_context->createBuffer(128 * 1024 * 1024, 0x0042, 0x0006);
+    m_indexBuffer = m_context->createBuffer(kGlobalBufferSize, 0x0042, 0x0001);
+    return OkStatus();
+}
+
+bool MeshManager::allocateRange(std::vector<FreeRange>& freeList, uint32_t& current, uint32_t count, uint32_t capacity, uint32_t& outOffset) {
+    for (auto it = freeList.begin(); it != freeList.end(); ++it) {
+        if (it->count >= count) {
+            outOffset = it->offset;
+            it->offset += count;
+            it->count -= count;
+            if (it->count == 0) freeList.erase(it);
+            return true;
+        }
+    }
+    // 容量固定: 渲染器的在途帧与 VK_Context 持有全局缓冲区句柄, 不做扩容, 放不下时由调用方报告 ResourceExhausted
+    if ((uint64_t)current + count > capacity) return false;
+    outOffset = current;
+    current += count;
+    return true;
+}
+
+void MeshManager::freeRange(std::vector<FreeRange>& freeList, uint32_t offset, uint32_t count) {
+    if (count == 0) return;
+    auto it = std::lower_bound(freeList.begin(), freeList.end(), offset,
+        [](const FreeRange& r, uint32_t o) { return r.offset < o; });
+    it = freeList.insert(it, FreeRange{offset, count});
+
+    // 与后一个区间合并
+    auto next = it + 1;
+    if (next != freeList.end() && it->offset + it->count == next->offset) {
+        it->count += next->count;
+        freeList.erase(next);
+    }
+    // 与前一个区间合并
+    if (it != freeList.begin()) {
+        auto prev = it - 1;
+        if (prev->offset + prev->count == it->offset) {
+            prev->count += it->count;
+            freeList.erase(it);
+        }
+    }
+}
+
+void MeshManager::reclaimRetiredRanges() {
+    if (m_retiringRanges.empty()) return;
+    const uint64_t completed = m_context->getCompletedFrameValue();
+    auto done = std::partition(m_retiringRanges.begin(), m_retiringRanges.end(),
+                               [completed](const RetiringRange& r) { return r.frameValue > completed; });
+    for (auto it = done; it != m_retiringRanges.end(); ++it) {
+        freeRange(m_freeVertexRanges, it->vertices.offset, it->vertices.count);
+        freeRange(m_freeIndexRanges, it->indexWords.offset, it->indexWords.count);
+    }
+    m_retiringRanges.erase(done, m_retiringRanges.end());
+}
+
+bool MeshManager::canUseShortIndices(uint32_t vertexCount) {
+    return vertexCount <= 0x10000u;
+}
+
+Status MeshManager::uploadMesh(const std::vector<float>& vertices, const std::vector<uint32_t>& indices, const std::vector<MeshLodData>& lods,
+                               bool allowShortIndices, MeshRange& outRange, uint32_t& outIndexWordOffset, uint32_t& outIndexWordCount) {
+    uint32_t vertexCount = (uint32_t)(vertices.size() / kFloatsPerVertex);
+    IndexType indexType = (allowShortIndices && canUseShortIndices(vertexCount)) ? IndexType::Uint16 : IndexType::Uint32;
+
+    // 基础索引与各级 LOD 索引连续存放
+    uint32_t lodCount = std::min<uint32_t>((uint32_t)lods.size() + 1, MAX_MESH_LODS);
+    std::vector<uint32_t> allIndices(indices);
+    outRange.lods[0] = MeshLod{0, (uint32_t)indices.size(), 0.0f};
+    for (uint32_t lod = 1; lod < lodCount; ++lod) {
+        const auto& data = lods[lod - 1];
+        outRange.lods[lod] = MeshLod{(uint32_t)allIndices.size(), (uint32_t)data.indices.size(), data.error};
+        allIndices.insert(allIndices.end(), data.indices.begin(), data.indices.end());
+    }
+    uint32_t wordCount = indexWordCount(indexType, (uint32_t)allIndices.size());
+
+    uint32_t vOffset = 0, wordOffset = 0;
+    reclaimRetiredRanges();
+    if (!allocateRange(m_freeVertexRanges, m_currentVertexOffset, vertexCount, m_maxVertices, vOffset)) {
+        return ResourceExhaustedError("MeshManager: global vertex buffer exhausted (" + std::to_string(vertexCount) + " vertices requested, " +
+                                      std::to_string(m_currentVertexOffset) + " of " + std::to_string(m_maxVertices) + " in use or fragmented)");
+    }
+    if (!allocateRange(m_freeIndexRanges, m_currentIndexOffset, wordCount, kMaxIndexWords, wordOffset)) {
+        freeRange(m_freeVertexRanges, vOffset, vertexCount);
+        return ResourceExhaustedError("MeshManager: global index buffer exhausted (" + std::to_string(wordCount) + " words requested, " +
+                                      std::to_string(m_currentIndexOffset) + " of " + std::to_string(kMaxIndexWords) + " in use or fragmented)");
+    }
+
+    // 上传失败时归还两个区间, 否则全局缓冲区会永久泄漏这部分空间
+    uint32_t firstIndex = 0;
+    auto upload = [&]() -> Status {
+        const uint64_t stride = getVertexStride(m_vertexFormat);
+        if (m_vertexFormat == VertexFormat::Compact) {
+            std::vector<PackedVertex> packed;
+            packVertices(vertices, packed, outRange.positionOffset, outRange.positionScale);
+            NX_RETURN_IF_ERROR(m_vertexBuffer->uploadData(packed.data(), packed.size() * sizeof(PackedVertex), (uint64_t)vOffset * stride));
+        } else {
+            outRange.positionOffset = {0.0f, 0.0f, 0.0f};
+            outRange.positionScale = {1.0f, 1.0f, 1.0f};
+            NX_RETURN_IF_ERROR(m_vertexBuffer->uploadData(vertices.data(), vertices.size() * sizeof(float), (uint64_t)vOffset * stride));
+        }
+
+        const uint64_t indexByteOffset = (uint64_t)wordOffset * sizeof(uint32_t);
+        if (indexType == IndexType::Uint16) {
+            std::vector<uint16_t> shortIndices(allIndices.begin(), allIndices.end());
+            NX_RETURN_IF_ERROR(m_indexBuffer->uploadData(shortIndices.data(), shortIndices.size() * sizeof(uint16_t), indexByteOffset));
+            firstIndex = wordOffset * 2;
+        } else {
+            NX_RETURN_IF_ERROR(m_indexBuffer->uploadData(allIndices.data(), allIndices.size() * sizeof(uint32_t), indexByteOffset));
+            firstIndex = wordOffset;
+        }
+        return OkStatus();
+    };
+    if (Status status = upload(); !status.ok()) {
+        freeRange(m_freeVertexRanges, vOffset, vertexCount);
+        freeRange(m_freeIndexRanges, wordOffset, wordCount);
+        return status;
+    }
+    for (uint32_t lod = 0; lod < lodCount; ++lod) {
+        outRange.lods[lod].indexOffset += firstIndex;
+    }
+
+    outRange.vertexOffset = vOffset;
+    outRange.vertexCount = vertexCount;
+    outRange.indexOffset = firstIndex;
+    outRange.indexCount = (uint32_t)indices.size();
+    outRange.indexType = indexType;
+    outRange.lodCount = lodCount;
+    computeBounds(vertices, outRange);
+    outRange.uvDensity = computeUvDensity(vertices, indices);
+    outIndexWordOffset = wordOffset;
+    outIndexWordCount = wordCount;
     return OkStatus();
 }
 
@@ -30,21 +232,154 @@ Status MeshManager::initialize() {
  * @brief 向全局缓冲区添加网格数据
  */
 Status MeshManager::addMesh(const std::vector<float>& vertices, const std::vector<uint32_t>& indices, uint32_t& outVertexOffset, uint32_t& outIndexOffset) {
-    size_t vSize = vertices.size() * sizeof(float);
-    size_t iSize = indices.size() * sizeof(uint32_t);
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    MeshRange range;
+    uint32_t wordOffset = 0, wordCount = 0;
+    NX_RETURN_IF_ERROR(uploadMesh(vertices, indices, {}, false, range, wordOffset, wordCount));
+    outVertexOffset = range.vertexOffset;
+    outIndexOffset = range.indexOffset;
+    return OkStatus();
+}
+
+std::string MeshManager::makeMeshKey(const std::string& resolvedPath, uint32_t importFlags, uint32_t subMeshIndex) {
+    return resolvedPath + "|" + std::to_string(importFlags) + "#" + std::to_string(subMeshIndex);
+}
 
-    // TODO: 检查溢出并动态扩容
-    
-    NX_RETURN_IF_ERROR(m_vertexBuffer->uploadData(vertices.data(), vSize, m_currentVertexOffset * sizeof(float) * 8));
-    NX_RETURN_IF_ERROR(m_indexBuffer->uploadData(indices.data(), iSize, m_currentIndexOffset * sizeof(uint32_t)));
+MeshManager::ContentHash MeshManager::hashMeshData(const std::vector<float>& vertices, const std::vector<uint32_t>& indices) {
+    ContentHash hash{14695981039346656037ull, 0x9E3779B97F4A7C15ull};
+    auto mix = [&hash](const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash.low ^= bytes[i];
+            hash.low *= 1099511628211ull;
+        }
+        // 高半: 每 8 字节一块, 乘法-旋转混合 (尾部不足 8 字节补零)
+        for (size_t i = 0; i < size; i += 8) {
+            uint64_t block = 0;
+            std::memcpy(&block, bytes + i, std::min<size_t>(8, size - i));
+            block *= 0x87C37B91114253D5ull;
+            block = (block << 31) | (block >> 33);
+            block *= 0x4CF5AD432745937Full;
+            hash.high ^= block;
+            hash.high = ((hash.high << 27) | (hash.high >> 37)) * 5 + 0x52DCE729;
+        }
+    };
+    uint64_t counts[2] = { vertices.size(), indices.size() };
+    mix(counts, sizeof(counts));
+    mix(vertices.data(), vertices.size() * sizeof(float));
+    mix(indices.data(), indices.size() * sizeof(uint32_t));
+    // 末尾再做一次雪崩, 使高半的每一位依赖全部输入
+    hash.high ^= hash.high >> 33;
+    hash.high *= 0xFF51AFD7ED558CCDull;
+    hash.high ^= hash.high >> 33;
+    return hash;
+}
+
+bool MeshManager::acquireMesh(const std::string& key, MeshRange& outRange) {
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    auto it = m_keyToMesh.find(key);
+    if (it == m_keyToMesh.end()) return false;
 
-    outVertexOffset = m_currentVertexOffset;
-    outIndexOffset = m_currentIndexOffset;
+    auto& record = m_meshes.at(it->second);
+    record.refCount++;
+    outRange = record.range;
+    return true;
+}
 
-    m_currentVertexOffset += (uint32_t)(vertices.size() / 8);
-    m_currentIndexOffset += (uint32_t)indices.size();
+StatusOr<MeshRange> MeshManager::registerMesh(const std::string& key, const std::vector<float>& vertices, const std::vector<uint32_t>& indices,
+                                              const std::vector<MeshLodData>& lods) {
+    std::lock_guard<std::mutex> lock(m_registryMutex);
 
-    return OkStatus();
+    if (!key.empty()) {
+        auto keyIt = m_keyToMesh.find(key);
+        if (keyIt != m_keyToMesh.end()) {
+            auto& record = m_meshes.at(keyIt->second);
+            record.refCount++;
+            return record.range;
+        }
+    }
+
+    // 键未命中: 不同路径/导入标志可能产出相同数据, 按内容去重
+    // 按字节哈希 (浮点 == 会把 -0 与 0 视为相同); 128 位全部一致才视为相同内容
+    const ContentHash contentHash = hashMeshData(vertices, indices);
+    auto [hashBegin, hashEnd] = m_hashToMesh.equal_range(contentHash.low);
+    for (auto hashIt = hashBegin; hashIt != hashEnd; ++hashIt) {
+        auto& record = m_meshes.at(hashIt->second);
+        if (record.contentHash == contentHash) {
+            record.refCount++;
+            if (!key.empty()) {
+                m_keyToMesh[key] = record.range.meshId;
+                record.keys.push_back(key);
+            }
+            return record.range;
+        }
+    }
+
+    MeshRecord record;
+    NX_RETURN_IF_ERROR(uploadMesh(vertices, indices, lods, true, record.range, record.indexWordOffset, record.indexWordCount));
+    record.range.meshId = m_nextMeshId++;
+    record.contentHash = contentHash;
+    record.refCount = 1;
+    if (!key.empty()) {
+        record.keys.push_back(key);
+        m_keyToMesh[key] = record.range.meshId;
+    }
+    m_hashToMesh.emplace(contentHash.low, record.range.meshId);
+
+    MeshRange range = record.range;
+    m_meshes.emplace(range.meshId, std::move(record));
+    return range;
+}
+
+void MeshManager::releaseMesh(uint32_t meshId) {
+    if (meshId == 0) return;
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    auto it = m_meshes.find(meshId);
+    if (it == m_meshes.end()) {
+        NX_CORE_WARN("MeshManager: releaseMesh 未知 meshId {}", meshId);
+        return;
+    }
+
+    auto& record = it->second;
+    if (--record.refCount > 0) return;
+
+    for (const auto& key : record.keys) {
+        m_keyToMesh.erase(key);
+    }
+    auto [hashBegin, hashEnd] = m_hashToMesh.equal_range(record.contentHash.low);
+    for (auto hashIt = hashBegin; hashIt != hashEnd; ++hashIt) {
+        if (hashIt->second == meshId) {
+            m_hashToMesh.erase(hashIt);
+            break;
+        }
+    }
+    // 已提交的帧仍可能读取该区间, 上传新数据前须等它们完成
+    m_retiringRanges.push_back({{record.range.vertexOffset, record.range.vertexCount}, {record.indexWordOffset, record.indexWordCount},
+                                m_context->getSubmittedFrameValue()});
+    m_meshes.erase(it);
+}
+
+void MeshManager::attachRegistry(Registry& registry) {
+    registry.getInternal().on_destroy<MeshComponent>().connect<&MeshManager::onMeshComponentDestroyed>(*this);
+}
+
+void MeshManager::detachRegistry(Registry& registry) {
+    registry.getInternal().on_destroy<MeshComponent>().disconnect<&MeshManager::onMeshComponentDestroyed>(*this);
+}
+
+void MeshManager::onMeshComponentDestroyed(entt::registry& registry, entt::entity entity) {
+    releaseMesh(registry.get<MeshComponent>(entity).meshId);
+}
+
+uint32_t MeshManager::getRefCount(uint32_t meshId) const {
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    auto it = m_meshes.find(meshId);
+    return it != m_meshes.end() ? it->second.refCount : 0;
+}
+
+size_t MeshManager::getRegisteredMeshCount() const {
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    return m_meshes.size();
 }
 
 } // namespace Core
@@ -3,41 +3,188 @@
 #include "Base.h"
 #include <memory>
 #include <vector>
+#include <string>
+#include <mutex>
+#include <unordered_map>
+#include <array>
 
 #include "Interfaces.h"
+#include "../Bridge/ECS.h"
 
 namespace Nexus {
 namespace Core {
 
+/**
+ * @brief 网格在全局缓冲区中的区间
+ */
+struct MeshRange {
+    uint32_t meshId = 0;        // 0 表示未经注册表管理
+    uint32_t vertexOffset = 0;
+    uint32_t vertexCount = 0;
+    uint32_t indexOffset = 0;   // 以 indexType 为单位
+    uint32_t indexCount = 0;
+    IndexType indexType = IndexType::Uint32;
+
+    // 反量化参数 (VertexFormat::Compact), position = offset + unorm * scale
+    std::array<float, 3> positionOffset = {0.0f, 0.0f, 0.0f};
+    std::array<float, 3> positionScale = {1.0f, 1.0f, 1.0f};
+
+    // LOD 表, lods[0] 为基础网格
+    std::array<MeshLod, MAX_MESH_LODS> lods = {};
+    uint32_t lodCount = 1;
+
+    // 局部空间包围体 (导入时计算, 见 BoundsComponent)
+    std::array<float, 3> aabbMin = {0.0f, 0.0f, 0.0f};
+    std::array<float, 3> aabbMax = {0.0f, 0.0f, 0.0f};
+    std::array<float, 4> boundingSphere = {0.0f, 0.0f, 0.0f, 0.0f}; // center, radius
+
+    // 平均纹理坐标密度 (UV 长度 / 模型单位), 0 表示没有有效 UV
+    float uvDensity = 0.0f;
+};
+
+/**
+ * @brief 额外 LOD 级别的索引数据 (引用基础网格的顶点)
+ */
+struct MeshLodData {
+    std::vector<uint32_t> indices;
+    float error = 0.0f;
+};
+
 /**
  * @brief 网格管理器,负责管理全局顶点与索引缓冲区
+ *
+ * 内置网格注册表: 以 "解析后路径 + 导入标志 + 子网格序号" 为键,
+ * 128 位内容哈希 (含顶点与索引数) 作为兜底, 相同网格只上传一次并做引用计数; 不保留源数据副本.
  */
 class MeshManager {
 public:
+    /**
+     * @brief 网格内容的 128 位哈希, 两半由不同算法独立计算
+     */
+    struct ContentHash {
+        uint64_t low = 0;
+        uint64_t high = 0;
+        bool operator==(const ContentHash& other) const = default;
+    };
+
     MeshManager(IContext* context);
     ~MeshManager();
 
     /**
      * @brief 初始化全局缓冲区
+     * @param vertexFormat 顶点存储格式, 输入始终为 Pos(3) UV(2) Normal(3) 浮点
      * @return 状态码
      */
-    Status initialize();
+    Status initialize(VertexFormat vertexFormat = VertexFormat::Float32);
 
     /**
-     * @brief 分配网格空间 (简化版, 仅追加)
+     * @brief 分配网格空间 (不经过注册表, 始终使用 32 位索引)
+     * @note Compact 格式下反量化参数需通过 registerMesh 获取
      */
     Status addMesh(const std::vector<float>& vertices, const std::vector<uint32_t>& indices, uint32_t& outVertexOffset, uint32_t& outIndexOffset);
 
+    /**
+     * @brief 按缓存键查找已注册网格, 命中时引用计数 +1
+     * @return 是否命中
+     */
+    bool acquireMesh(const std::string& key, MeshRange& outRange);
+
+    /**
+     * @brief 注册网格: 先按键查找, 再按内容哈希查找, 均未命中才上传
+     * @param key 缓存键, 可为空 (仅按内容去重)
+     * @param lods 由粗到细之外的额外 LOD (LOD1..), 与基础索引一起连续存放
+     * @note 顶点数不超过 65536 时自动以 16 位索引存储, 见 MeshRange::indexType
+     * @return 全局缓冲区 (容量固定) 放不下时返回 ResourceExhausted
+     */
+    StatusOr<MeshRange> registerMesh(const std::string& key, const std::vector<float>& vertices, const std::vector<uint32_t>& indices,
+                                     const std::vector<MeshLodData>& lods = {});
+
+    /**
+     * @brief 释放一次引用, 归零时回收缓冲区区间 (在途帧完成后才可被新网格复用)
+     */
+    void releaseMesh(uint32_t meshId);
+
+    /**
+     * @brief 监听注册表中 MeshComponent 的销毁 (实体销毁, 组件移除, 场景清空), 释放其 meshId 的引用
+     * @note 注册表须先于本管理器销毁或调用 detachRegistry
+     */
+    void attachRegistry(Registry& registry);
+    void detachRegistry(Registry& registry);
+
+    uint32_t getRefCount(uint32_t meshId) const;
+    size_t getRegisteredMeshCount() const;
+
+    /**
+     * @brief 顶点数是否可用 16 位索引寻址
+     */
+    static bool canUseShortIndices(uint32_t vertexCount);
+
+    /**
+     * @brief 生成缓存键
+     */
+    static std::string makeMeshKey(const std::string& resolvedPath, uint32_t importFlags, uint32_t subMeshIndex);
+
+    /**
+     * @brief 顶点与索引数据的 128 位哈希: 低 64 位为 FNV-1a, 高 64 位为按 8 字节分块的乘法-旋转哈希, 均覆盖元素个数
+     */
+    static ContentHash hashMeshData(const std::vector<float>& vertices, const std::vector<uint32_t>& indices);
+
     IBuffer* getVertexBuffer() const { return m_vertexBuffer.get(); }
     IBuffer* getIndexBuffer() const { return m_indexBuffer.get(); }
+    VertexFormat getVertexFormat() const { return m_vertexFormat; }
 
 private:
+    struct FreeRange {
+        uint32_t offset;
+        uint32_t count;
+    };
+
+    /**
+     * @brief 已释放但可能仍被在途帧读取的区间, 帧时间线完成 frameValue 后并入空闲链表
+     */
+    struct RetiringRange {
+        FreeRange vertices;
+        FreeRange indexWords;
+        uint64_t frameValue = 0;
+    };
+
+    struct MeshRecord {
+        MeshRange range;
+        ContentHash contentHash;
+        uint32_t refCount = 0;
+        uint32_t indexWordOffset = 0;
+        uint32_t indexWordCount = 0;
+        std::vector<std::string> keys;
+    };
+
+    /**
+     * @brief 从空闲链表首次适配分配, 否则追加到末尾
+     */
+    static bool allocateRange(std::vector<FreeRange>& freeList, uint32_t& current, uint32_t count, uint32_t capacity, uint32_t& outOffset);
+    static void freeRange(std::vector<FreeRange>& freeList, uint32_t offset, uint32_t count);
+    void reclaimRetiredRanges();
+    void onMeshComponentDestroyed(entt::registry& registry, entt::entity entity);
+
+    Status uploadMesh(const std::vector<float>& vertices, const std::vector<uint32_t>& indices, const std::vector<MeshLodData>& lods,
+                      bool allowShortIndices, MeshRange& outRange, uint32_t& outIndexWordOffset, uint32_t& outIndexWordCount);
+
     IContext* m_context;
     std::unique_ptr<IBuffer> m_vertexBuffer;
     std::unique_ptr<IBuffer> m_indexBuffer;
+    VertexFormat m_vertexFormat = VertexFormat::Float32;
+    uint32_t m_maxVertices = 0;
 
     uint32_t m_currentVertexOffset = 0;
-    uint32_t m_currentIndexOffset = 0;
+    uint32_t m_currentIndexOffset = 0; // 以 4 字节为单位
+    std::vector<FreeRange> m_freeVertexRanges;
+    std::vector<FreeRange> m_freeIndexRanges;
+    std::vector<RetiringRange> m_retiringRanges;
+
+    mutable std::mutex m_registryMutex;
+    std::unordered_map<uint32_t, MeshRecord> m_meshes;
+    std::unordered_map<std::string, uint32_t> m_keyToMesh;
+    std::unordered_multimap<uint64_t, uint32_t> m_hashToMesh; // 以 ContentHash::low 为键, 命中后再比较 high
+    uint32_t m_nextMeshId = 1;
 };
 
 } // namespace Core
@@ -0,0 +1,121 @@
+#include "MeshOptimizer.h"
+#include "MeshManager.h"
+#include <meshoptimizer.h>
+
+namespace Nexus {
+namespace Core {
+
+namespace {
+constexpr size_t kFloatsPerVertex = 8;
+constexpr size_t kVertexSize = sizeof(float) * kFloatsPerVertex;
+// 近似现代 GPU 的后变换缓存参数 (meshoptimizer 推荐值)
+constexpr unsigned int kCacheSize = 16;
+constexpr unsigned int kWarpSize = 0;
+constexpr unsigned int kPrimGroupSize = 0;
+// LOD 简化参数
+constexpr float kLodTargetError = 0.02f;    // 相对网格尺寸的误差上限
+constexpr float kLodMinReduction = 0.9f;    // 简化后仍超过上一级 90% 则停止
+constexpr size_t kLodMinIndexCount = 36;    // 少于 12 个三角形不再简化
+
+uint64_t storageBytes(size_t vertexCount, size_t indexCount, VertexFormat format, bool allowShortIndices) {
+    size_t indexSize = (allowShortIndices && MeshManager::canUseShortIndices((uint32_t)vertexCount)) ? sizeof(uint16_t) : sizeof(uint32_t);
+    return (uint64_t)vertexCount * getVertexStride(format) + (uint64_t)indexCount * indexSize;
+}
+}
+
+MeshOptimizeReport MeshOptimizer::optimize(std::vector<float>& vertices, std::vector<uint32_t>& indices,
+                                           VertexFormat vertexFormat, const Options& options) {
+    MeshOptimizeReport report;
+    size_t vertexCount = vertices.size() / kFloatsPerVertex;
+    const size_t indexCount = indices.size();
+
+    report.vertexCountBefore = (uint32_t)vertexCount;
+    report.indexCount = (uint32_t)indexCount;
+    report.bytesBefore = storageBytes(vertexCount, indexCount, vertexFormat, false);
+    if (vertexCount == 0 || indexCount == 0) {
+        report.vertexCountAfter = report.vertexCountBefore;
+        report.bytesAfter = report.bytesBefore;
+        return report;
+    }
+
+    report.acmrBefore = meshopt_analyzeVertexCache(indices.data(), indexCount, vertexCount, kCacheSize, kWarpSize, kPrimGroupSize).acmr;
+    report.overfetchBefore = meshopt_analyzeVertexFetch(indices.data(), indexCount, vertexCount, kVertexSize).overfetch;
+
+    if (options.weldVertices) {
+        // 按位完全相同的顶点合并 (Assimp 按面展开后大量重复)
+        std::vector<unsigned int> remap(vertexCount);
+        size_t uniqueCount = meshopt_generateVertexRemap(remap.data(), indices.data(), indexCount,
+                                                         vertices.data(), vertexCount, kVertexSize);
+        if (uniqueCount < vertexCount) {
+            std::vector<float> welded(uniqueCount * kFloatsPerVertex);
+            meshopt_remapVertexBuffer(welded.data(), vertices.data(), vertexCount, kVertexSize, remap.data());
+            meshopt_remapIndexBuffer(indices.data(), indices.data(), indexCount, remap.data());
+            vertices.swap(welded);
+            vertexCount = uniqueCount;
+        }
+    }
+
+    std::vector<uint32_t> scratch(indexCount);
+    if (options.optimizeVertexCache) {
+        meshopt_optimizeVertexCache(scratch.data(), indices.data(), indexCount, vertexCount);
+        indices.swap(scratch);
+    }
+
+    if (options.optimizeOverdraw) {
+        meshopt_optimizeOverdraw(scratch.data(), indices.data(), indexCount, vertices.data(), vertexCount,
+                                 kVertexSize, options.overdrawThreshold);
+        indices.swap(scratch);
+    }
+
+    if (options.optimizeVertexFetch) {
+        std::vector<float> fetchOrdered(vertexCount * kFloatsPerVertex);
+        size_t usedCount = meshopt_optimizeVertexFetch(fetchOrdered.data(), indices.data(), indexCount,
+                                                       vertices.data(), vertexCount, kVertexSize);
+        // 未被引用的顶点会被丢弃
+        fetchOrdered.resize(usedCount * kFloatsPerVertex);
+        vertices.swap(fetchOrdered);
+        vertexCount = usedCount;
+    }
+
+    report.vertexCountAfter = (uint32_t)vertexCount;
+    report.acmrAfter = meshopt_analyzeVertexCache(indices.data(), indexCount, vertexCount, kCacheSize, kWarpSize, kPrimGroupSize).acmr;
+    report.overfetchAfter = meshopt_analyzeVertexFetch(indices.data(), indexCount, vertexCount, kVertexSize).overfetch;
+    report.bytesAfter = storageBytes(vertexCount, indexCount, vertexFormat, true);
+    return report;
+}
+
+std::vector<MeshLodData> MeshOptimizer::generateLods(const std::vector<float>& vertices, const std::vector<uint32_t>& indices,
+                                                     uint32_t maxLods) {
+    std::vector<MeshLodData> lods;
+    const size_t vertexCount = vertices.size() / kFloatsPerVertex;
+    if (vertexCount == 0 || indices.size() < kLodMinIndexCount * 2 || maxLods < 2) return lods;
+
+    const float errorScale = meshopt_simplifyScale(vertices.data(), vertexCount, kVertexSize);
+    const std::vector<uint32_t>* source = &indices;
+
+    for (uint32_t lod = 1; lod < maxLods; ++lod) {
+        const size_t sourceCount = source->size();
+        size_t targetCount = (sourceCount / 2) / 3 * 3;
+        if (targetCount < kLodMinIndexCount) break;
+
+        MeshLodData data;
+        data.indices.resize(sourceCount);
+        float resultError = 0.0f;
+        size_t resultCount = meshopt_simplify(data.indices.data(), source->data(), sourceCount, vertices.data(), vertexCount,
+                                              kVertexSize, targetCount, kLodTargetError, 0, &resultError);
+        if (resultCount == 0 || (float)resultCount > kLodMinReduction * (float)sourceCount) break;
+
+        data.indices.resize(resultCount);
+        meshopt_optimizeVertexCache(data.indices.data(), data.indices.data(), resultCount, vertexCount);
+        // 误差累加: 每级都基于上一级简化
+        data.error = resultError * errorScale + (lods.empty() ? 0.0f : lods.back().error);
+        lods.push_back(std::move(data));
+        source = &lods.back().indices;
+
+        if (resultCount < kLodMinIndexCount * 2) break;
+    }
+    return lods;
+}
+
+} // namespace Core
+} // namespace Nexus
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Base.h"
+#include "CommonTypes.h"
+#include "MeshManager.h"
+#include <vector>
+
+namespace Nexus {
+namespace Core {
+
+/**
+ * @brief 单个网格的优化报告
+ */
+struct MeshOptimizeReport {
+    uint32_t vertexCountBefore = 0;
+    uint32_t vertexCountAfter = 0;
+    uint32_t indexCount = 0;
+
+    float acmrBefore = 0.0f;     // 每三角形平均变换顶点数 (越低越好, 理想 ~0.5)
+    float acmrAfter = 0.0f;
+    float overfetchBefore = 0.0f; // 顶点读取字节 / 顶点缓冲区字节
+    float overfetchAfter = 0.0f;
+
+    uint64_t bytesBefore = 0;     // 顶点 + 索引 (32 位) 字节数
+    uint64_t bytesAfter = 0;      // 去重后顶点 + 自动选择宽度的索引字节数
+};
+
+/**
+ * @brief 导入期网格优化 (基于 meshoptimizer)
+ *
+ * 依次执行: 顶点去重 -> 顶点缓存排序 -> 考虑 overdraw 的三角形排序 -> 顶点读取顺序重排.
+ * 顶点格式为 Pos(3) UV(2) Normal(3) 浮点.
+ */
+class MeshOptimizer {
+public:
+    struct Options {
+        bool weldVertices = true;
+        bool optimizeVertexCache = true;
+        bool optimizeOverdraw = true;
+        bool optimizeVertexFetch = true;
+        // 允许为降低 overdraw 牺牲的 ACMR 比例
+        float overdrawThreshold = 1.05f;
+    };
+
+    /**
+     * @brief 原地优化顶点与索引
+     * @param vertexFormat 存储格式, 仅用于字节统计
+     */
+    static MeshOptimizeReport optimize(std::vector<float>& vertices, std::vector<uint32_t>& indices,
+                                       VertexFormat vertexFormat, const Options& options);
+    static MeshOptimizeReport optimize(std::vector<float>& vertices, std::vector<uint32_t>& indices,
+                                       VertexFormat vertexFormat = VertexFormat::Float32) {
+        return optimize(vertices, indices, vertexFormat, Options{});
+    }
+
+    /**
+     * @brief 生成 LOD 链 (LOD1.. 每级约为上一级三角形数的一半)
+     * @param maxLods 包含基础网格在内的最大级数
+     * @note 简化结果不再明显减少三角形时提前终止; error 为模型空间的绝对误差
+     */
+    static std::vector<MeshLodData> generateLods(const std::vector<float>& vertices, const std::vector<uint32_t>& indices,
+                                                 uint32_t maxLods = MAX_MESH_LODS);
+};
+
+} // namespace Core
+} // namespace Nexus
@@ -1,5 +1,6 @@
 #include "ModelLoader.h"
 #include "MeshManager.h"
+#include "MeshOptimizer.h"
 #include "Scene.h"
 #include "Components.h"
 #include "../Bridge/ResourceLoader.h"
@@ -8,6 +9,8 @@
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 #include <vector>
+#include <memory>
+#include <unordered_map>
 #include "TextureManager.h"
 #include "URDFLoader.h"
 #include "../Bridge/thirdparty.h"
@@ -15,7 +18,52 @@
 namespace Nexus {
 namespace Core {
 
-static void processNode(TextureManager* textureManager, aiNode* node, const aiScene* aScene, Scene* engineScene, MeshManager* meshManager, Entity parentEntity, const std::string& directory) {
+static constexpr unsigned int kImportFlags = aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenNormals;
+
+/**
+ * @brief 将 aiMesh 展开为引擎顶点格式 Pos(3), UV(2), Normal(3)
+ */
+static void buildMeshData(const aiMesh* mesh, std::vector<float>& vertices, std::vector<uint32_t>& indices) {
+    vertices.reserve((size_t)mesh->mNumVertices * 8);
+    indices.reserve((size_t)mesh->mNumFaces * 3);
+
+    for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
+        vertices.push_back(mesh->mVertices[i].x);
+        vertices.push_back(mesh->mVertices[i].y);
+        vertices.push_back(mesh->mVertices[i].z);
+
+        if (mesh->mTextureCoords[0]) {
+            vertices.push_back(mesh->mTextureCoords[0][i].x);
+            vertices.push_back(mesh->mTextureCoords[0][i].y);
+        } else {
+            vertices.push_back(0.0f);
+            vertices.push_back(0.0f);
+        }
+
+        if (mesh->mNormals) {
+            vertices.push_back(mesh->mNormals[i].x);
+            vertices.push_back(mesh->mNormals[i].y);
+            vertices.push_back(mesh->mNormals[i].z);
+        } else {
+            vertices.push_back(0.0f);
+            vertices.push_back(1.0f);
+            vertices.push_back(0.0f);
+        }
+    }
+
+    for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
+        const aiFace& face = mesh->mFaces[i];
+        for (unsigned int j = 0; j < face.mNumIndices; j++) {
+            indices.push_back(face.mIndices[j]);
+        }
+    }
+}
+
+/**
+ * @brief 递归处理节点
+ * @param meshSource 网格缓存键的来源 (解析后的文件路径), 为空时仅按内容去重
+ */
+static void processNode(TextureManager* textureManager, aiNode* node, const aiScene* aScene, Scene* engineScene, MeshManager* meshManager, Entity parentEntity, const std::string& directory, const std::string& meshSource) {
     // 跳过 Blender 导出的 Camera / Light 空节点（无 mesh 且名称匹配）
     std::string nodeName = node->mName.C_Str();
     if (node->mNumMeshes == 0 && node->mNumChildren == 0 &&
@@ -64,40 +112,6 @@ static void processNode(TextureManager* textureManager, aiNode* node, const aiSc
                 engineScene->setParent(subMeshEntity, nodeEntity);
             }
 
-            std::vector<float> vertices;
-            std::vector<uint32_t> indices;
-            
-            for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
-                vertices.push_back(mesh->mVertices[i].x);
-                vertices.push_back(mesh->mVertices[i].y);
-                vertices.push_back(mesh->mVertices[i].z);
-
-                if (mesh->mTextureCoords[0]) {
-                    vertices.push_back(mesh->mTextureCoords[0][i].x);
-                    vertices.push_back(mesh->mTextureCoords[0][i].y);
-                } else {
-                    vertices.push_back(0.0f);
-                    vertices.push_back(0.0f);
-                }
-
-                if (mesh->mNormals) {
-                    vertices.push_back(mesh->mNormals[i].x);
-                    vertices.push_back(mesh->mNormals[i].y);
-                    vertices.push_back(mesh->mNormals[i].z);
-                } else {
-                    vertices.push_back(0.0f);
-                    vertices.push_back(1.0f);
-                    vertices.push_back(0.0f);
-                }
-            }
-            
-            for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
-                aiFace face = mesh->mFaces[i];
-                for (unsigned int j = 0; j < face.mNumIndices; j++) {
-                    indices.push_back(face.mIndices[j]);
-                }
-            }
-            
             uint32_t albedoIndex = 0; // Default to White fallback at index 0
             uint32_t samplerIndex = 0; // Default to Linear sampler at index 0
             
@@ -127,10 +141,9 @@ static void processNode(TextureManager* textureManager, aiNode* node, const aiSc
                              if (embeddedTexture) {
                                  std::string key = directory + "#embedded#" + std::string(texPath.C_Str());
                                  if (embeddedTexture->mHeight == 0) {
-                                     auto texRes = ResourceLoader::loadImageFromMemory(reinterpret_cast<const uint8_t*>(embeddedTexture->pcData), embeddedTexture->mWidth);
-                                     if (texRes.ok()) {
-                                         tex = textureManager->createTextureFromMemory(key, texRes.value());
-                                     }
+                                     // 压缩数据拷贝后交给工作线程解码, 先使用默认纹理
+                                     const uint8_t* encoded = reinterpret_cast<const uint8_t*>(embeddedTexture->pcData);
+                                     tex = textureManager->createTextureFromMemoryAsync(key, std::vector<uint8_t>(encoded, encoded + embeddedTexture->mWidth));
                                  }
                              } else {
                                  std::string rawPath = texPath.C_Str();
@@ -140,7 +153,7 @@ static void processNode(TextureManager* textureManager, aiNode* node, const aiSc
                                  } else {
                                      fullTexPath = directory + "/" + rawPath;
                                  }
-                                 tex = textureManager->getOrCreateTexture(fullTexPath);
+                                 tex = textureManager->getOrCreateTextureAsync(fullTexPath);
                              }
 
                              if (tex) {
@@ -166,13 +179,46 @@ static void processNode(TextureManager* textureManager, aiNode* node, const aiSc
                 }
             }
 
-            uint32_t vOffset, iOffset;
-            auto addMeshStatus = meshManager->addMesh(vertices, indices, vOffset, iOffset);
+            // 相同文件 + 导入标志 + 子网格序号直接复用已上传的区间, 无需重新展开顶点
+            std::string meshKey = meshSource.empty() ? std::string() : MeshManager::makeMeshKey(meshSource, kImportFlags, node->mMeshes[m]);
+            MeshRange range;
+            Status addMeshStatus = OkStatus();
+            if (meshKey.empty() || !meshManager->acquireMesh(meshKey, range)) {
+                std::vector<float> vertices;
+                std::vector<uint32_t> indices;
+                buildMeshData(mesh, vertices, indices);
+
+                MeshOptimizeReport report = MeshOptimizer::optimize(vertices, indices, meshManager->getVertexFormat());
+                NX_CORE_INFO("[MeshOpt] {}: verts {} -> {}, ACMR {:.3f} -> {:.3f}, overfetch {:.2f} -> {:.2f}, bytes {} -> {} (saved {})",
+                             mesh->mName.C_Str(), report.vertexCountBefore, report.vertexCountAfter,
+                             report.acmrBefore, report.acmrAfter, report.overfetchBefore, report.overfetchAfter,
+                             report.bytesBefore, report.bytesAfter,
+                             report.bytesBefore > report.bytesAfter ? report.bytesBefore - report.bytesAfter : 0);
+                std::vector<MeshLodData> lods = MeshOptimizer::generateLods(vertices, indices);
+                for (size_t lod = 0; lod < lods.size(); ++lod) {
+                    NX_CORE_INFO("[MeshLod] {}: LOD{} {} tris (error {:.4f})", mesh->mName.C_Str(), lod + 1,
+                                 lods[lod].indices.size() / 3, lods[lod].error);
+                }
+                auto rangeRes = meshManager->registerMesh(meshKey, vertices, indices, lods);
+                if (rangeRes.ok()) {
+                    range = rangeRes.value();
+                } else {
+                    addMeshStatus = rangeRes.status();
+                }
+            }
+
             if (addMeshStatus.ok()) {
                 auto& meshComp = subMeshEntity.addComponent<MeshComponent>();
-                meshComp.vertexOffset = vOffset;
-                meshComp.indexOffset = iOffset;
-                meshComp.indexCount = (uint32_t)indices.size();
+                meshComp.meshId = range.meshId;
+                meshComp.vertexOffset = range.vertexOffset;
+                meshComp.indexOffset = range.indexOffset;
+                meshComp.indexCount = range.indexCount;
+                meshComp.indexType = range.indexType;
+                meshComp.positionOffset = range.positionOffset;
+                meshComp.positionScale = range.positionScale;
+                meshComp.lods = range.lods;
+                meshComp.lodCount = range.lodCount;
+                meshComp.uvDensity = range.uvDensity;
                 meshComp.albedoTexture = albedoIndex;
                 meshComp.samplerIndex = samplerIndex;
                 
@@ -185,15 +231,17 @@ static void processNode(TextureManager* textureManager, aiNode* node, const aiSc
                     }
                 }
 
+                subMeshEntity.addComponent<BoundsComponent>(range.aabbMin, range.aabbMax, range.boundingSphere);
+
                 NX_CORE_INFO("[TextureDebug] Submesh entity assigned: Albedo={}, Sampler={}", albedoIndex, samplerIndex);
             } else {
-                NX_CORE_ERROR("MeshManager::addMesh Failed: {}", addMeshStatus.message());
+                NX_CORE_ERROR("MeshManager::registerMesh Failed: {}", addMeshStatus.message());
             }
         }
     }
 
     for (unsigned int i = 0; i < node->mNumChildren; i++) {
-        processNode(textureManager, node->mChildren[i], aScene, engineScene, meshManager, nodeEntity, directory);
+        processNode(textureManager, node->mChildren[i], aScene, engineScene, meshManager, nodeEntity, directory, meshSource);
     }
 }
 
@@ -202,7 +250,7 @@ Entity ModelLoader::loadModel(TextureManager* textureManager, Scene* scene, Mesh
     std::string fullPath = ResourceLoader::getBasePath() + path;
     
     // We import with flags to triangulate, generate normals and flip UVs for standard graphics API consistency
-    const aiScene* aScene = importer.ReadFile(fullPath, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenNormals);
+    const aiScene* aScene = importer.ReadFile(fullPath, kImportFlags);
     
     if (!aScene || aScene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !aScene->mRootNode) {
         NX_CORE_ERROR("Assimp Error loading model: {} ({})", fullPath, importer.GetErrorString());
@@ -213,7 +261,7 @@ Entity ModelLoader::loadModel(TextureManager* textureManager, Scene* scene, Mesh
 
     Entity rootEntity = scene->createEntity(path + " Root");
     
-    processNode(textureManager, aScene->mRootNode, aScene, scene, meshManager, rootEntity, directory);
+    processNode(textureManager, aScene->mRootNode, aScene, scene, meshManager, rootEntity, directory, fullPath);
     
     // 计算模型 AABB
     aiVector3D bboxMin(1e10f, 1e10f, 1e10f), bboxMax(-1e10f, -1e10f, -1e10f);
@@ -270,6 +318,7 @@ Entity ModelLoader::loadURDF(TextureManager* textureManager, Scene* scene, MeshM
     rootTr.rotation = {-0.7071068f, 0.0f, 0.0f, 0.7071068f};
 
     std::unordered_map<std::string, Entity> linkEntities;
+    std::unordered_map<std::string, std::unique_ptr<Assimp::Importer>> importers;
     for (const auto& link : model.links) {
         Entity linkEntity = scene->createEntity(link.name);
         // 每个 URDF link 对应 MuJoCo 中同名的刚体
@@ -328,15 +377,20 @@ Entity ModelLoader::loadURDF(TextureManager* textureManager, Scene* scene, MeshM
             std::string meshPath = NxURDF::resolveMeshPath(visual.geometry.meshFilename, urdfDir);
             std::string fullMeshPath = ResourceLoader::getBasePath() + meshPath;
 
-            Assimp::Importer importer;
-            importer.SetPropertyInteger(AI_CONFIG_IMPORT_COLLADA_IGNORE_UP_DIRECTION, 1);
-            const aiScene* aScene = importer.ReadFile(fullMeshPath,
-                aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenNormals);
-
-            if (!aScene || aScene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) {
-                NX_CORE_WARN("NxURDF: 无法加载网格 {}: {}", fullMeshPath, importer.GetErrorString());
-                continue;
+            // 同一 URDF 内多个 link 引用同一网格文件时只解析一次
+            auto importerIt = importers.find(fullMeshPath);
+            if (importerIt == importers.end()) {
+                auto importer = std::make_unique<Assimp::Importer>();
+                importer->SetPropertyInteger(AI_CONFIG_IMPORT_COLLADA_IGNORE_UP_DIRECTION, 1);
+                const aiScene* imported = importer->ReadFile(fullMeshPath, kImportFlags);
+                if (!imported || imported->mFlags & AI_SCENE_FLAGS_INCOMPLETE) {
+                    NX_CORE_WARN("NxURDF: 无法加载网格 {}: {}", fullMeshPath, importer->GetErrorString());
+                    importer.reset();
+                }
+                importerIt = importers.emplace(fullMeshPath, std::move(importer)).first;
             }
+            if (!importerIt->second) continue;
+            const aiScene* aScene = importerIt->second->GetScene();
 
             auto linkIt = linkEntities.find(link.name);
             if (linkIt == linkEntities.end()) continue;
@@ -353,7 +407,8 @@ Entity ModelLoader::loadURDF(TextureManager* textureManager, Scene* scene, MeshM
             scene->setParent(visualEntity, linkIt->second);
 
             NX_CORE_INFO("NxURDF: processing visual Mesh for Link={}", link.name);
-            processNode(textureManager, aScene->mRootNode, aScene, scene, meshManager, visualEntity, "");
+            // Collada up-axis 配置会改变导入结果, 需计入缓存键
+            processNode(textureManager, aScene->mRootNode, aScene, scene, meshManager, visualEntity, "", fullMeshPath + "|collada_ignore_up");
         }
     }
 
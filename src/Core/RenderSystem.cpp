@@ -10,8 +10,8 @@
 namespace Nexus {
 namespace Core {
 
-RenderSystem::RenderSystem(VK_Context* context, VK_Swapchain* swapchain)
-    : m_context(context), m_swapchain(swapchain) {
+RenderSystem::RenderSystem(VK_Context* context, VK_Swapchain* swapchain, VertexFormat vertexFormat)
+    : m_context(context), m_swapchain(swapchain), m_vertexFormat(vertexFormat) {
 }
 
 RenderSystem::~RenderSystem() {
@@ -25,7 +25,7 @@ Status RenderSystem::initialize() {
     NX_CORE_INFO("Initializing Core RenderSystem...");
     m_meshManager = std::make_unique<MeshManager>(m_context);
     NX_ASSERT(m_meshManager, "MeshManager creation failed");
-    NX_RETURN_IF_ERROR(m_meshManager->initialize());
+    NX_RETURN_IF_ERROR(m_meshManager->initialize(m_vertexFormat));
     m_commandGenerator = std::make_unique<DrawCommandGenerator>(m_context);
     NX_ASSERT(m_commandGenerator, "DrawCommandGenerator creation failed");
     NX_RETURN_IF_ERROR(m_commandGenerator->initialize(1024));
@@ -71,15 +71,25 @@ Status RenderSystem::initialize() {
        20, 21, 22, 22, 23, 20   // Left
     };
 
-    NX_RETURN_IF_ERROR(m_meshManager->addMesh(vertices, indices, m_cubeVertexOffset, m_cubeIndexOffset));
+    MeshRange cubeRange;
+    NX_ASSIGN_OR_RETURN(cubeRange, m_meshManager->registerMesh("builtin:cube", vertices, indices));
+    m_cubeMesh.vertexOffset = cubeRange.vertexOffset;
+    m_cubeMesh.indexOffset = cubeRange.indexOffset;
+    m_cubeMesh.indexCount = cubeRange.indexCount;
+    m_cubeMesh.indexType = cubeRange.indexType;
+    m_cubeMesh.positionOffset = cubeRange.positionOffset;
+    m_cubeMesh.positionScale = cubeRange.positionScale;
+    m_cubeMesh.uvDensity = cubeRange.uvDensity;
+    m_cubeBounds = BoundsComponent(cubeRange.aabbMin, cubeRange.aabbMax, cubeRange.boundingSphere);
 
     auto* vkContext = dynamic_cast<VK_Context*>(m_context);
     if (vkContext) {
         vkContext->setGlobalVertexBuffer(m_meshManager->getVertexBuffer());
         vkContext->setGlobalIndexBuffer(m_meshManager->getIndexBuffer());
+        vkContext->setGlobalVertexFormat(m_meshManager->getVertexFormat());
     }
 
-    std::vector<DrawIndexedIndirectCommand> commands = { { 36, 1, m_cubeIndexOffset, static_cast<int32_t>(m_cubeVertexOffset), 0 } };
+    std::vector<DrawIndexedIndirectCommand> commands = { { 36, 1, m_cubeMesh.indexOffset, static_cast<int32_t>(m_cubeMesh.vertexOffset), 0 } };
     NX_RETURN_IF_ERROR(m_commandGenerator->updateCommands(commands));
     m_bridgeRenderer = std::make_unique<VK_Renderer>(m_context, m_swapchain);
     NX_ASSERT(m_bridgeRenderer, "VK_Renderer creation failed");
@@ -88,11 +98,11 @@ Status RenderSystem::initialize() {
 }
 
 Nexus::MeshComponent RenderSystem::getCubeMeshComponent() const {
-    Nexus::MeshComponent mesh;
-    mesh.vertexOffset = this->m_cubeVertexOffset;
-    mesh.indexOffset = this->m_cubeIndexOffset;
-    mesh.indexCount = 36;
-    return mesh;
+    return m_cubeMesh;
+}
+
+Nexus::BoundsComponent RenderSystem::getCubeBoundsComponent() const {
+    return m_cubeBounds;
 }
 
 Status RenderSystem::renderFrame(Registry* registry) {
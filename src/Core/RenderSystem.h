@@ -20,7 +20,7 @@ class VK_ShaderCompiler;
  */
 class RenderSystem : public IRenderer {
 public:
-    RenderSystem(VK_Context* context, VK_Swapchain* swapchain);
+    RenderSystem(VK_Context* context, VK_Swapchain* swapchain, VertexFormat vertexFormat = VertexFormat::Float32);
     ~RenderSystem();
 
     /**
@@ -58,6 +58,7 @@ public:
      * @brief 获取默认立方体的网格组件数据
      */
     MeshComponent getCubeMeshComponent() const;
+    BoundsComponent getCubeBoundsComponent() const;
     
     MeshManager* getMeshManager() const { return m_meshManager.get(); }
     
@@ -71,8 +72,9 @@ private:
     // 我们暂时保留 VK_Renderer 作为 Bridge 层的原始实现
     std::unique_ptr<VK_Renderer> m_bridgeRenderer;
 
-    uint32_t m_cubeVertexOffset = 0;
-    uint32_t m_cubeIndexOffset = 0;
+    VertexFormat m_vertexFormat;
+    MeshComponent m_cubeMesh;
+    BoundsComponent m_cubeBounds;
 };
 
 } // namespace Core
@@ -36,6 +36,10 @@ void Scene::destroyEntity(Entity entity) {
     }
 }
 
+void Scene::clear() {
+    m_registry.getInternal().clear();
+}
+
 void Scene::setParent(Entity child, Entity parent) {
     if (!child.isValid() || !parent.isValid()) return;
     if (child.getHandle() == parent.getHandle()) return;
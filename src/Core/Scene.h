@@ -30,6 +30,11 @@ public:
      */
     void destroyEntity(Entity entity);
 
+    /**
+     * @brief 销毁全部实体 (组件的销毁回调照常触发, 如 MeshManager 释放网格引用)
+     */
+    void clear();
+
     /**
      * @brief 设置父子关系
      */
@@ -101,6 +101,7 @@ Status SceneLoader::createEntities(
         ft.position = {0.0f, 0.0f, 0.0f};
         ft.scale = {config.groundSize[0], 0.01f, config.groundSize[1]};
         floor.addComponent<MeshComponent>(renderer->getCubeMeshComponent());
+        floor.addComponent<BoundsComponent>(renderer->getCubeBoundsComponent());
     }
 
     // 静态物体
@@ -110,8 +111,10 @@ Status SceneLoader::createEntities(
         auto& tr = entity.getComponent<TransformComponent>();
         tr.position = obj.position;
         tr.scale = obj.size;
-        if (renderer)
+        if (renderer) {
             entity.addComponent<MeshComponent>(renderer->getCubeMeshComponent());
+            entity.addComponent<BoundsComponent>(renderer->getCubeBoundsComponent());
+        }
     }
 
     return OkStatus();
@@ -11,6 +11,9 @@
 
 namespace Nexus {
 
+// 带类版本号的场景文件以此开头; 更早的文件直接以实体数量开头
+constexpr uint32_t kSceneFileMagic = 0x4353584E; // "NXSC"
+
 struct SerializedEntity {
     uint32_t id;
     bool hasTag = false;
@@ -32,12 +35,31 @@ struct SerializedEntity {
     bool hasRigidBody = false;
     RigidBodyComponent rigidBody;
 
+    bool hasBounds = false;
+    BoundsComponent bounds;
+
+    /**
+     * @brief 版本 0: 没有包围体, 网格为版本 0 布局且不带类版本号; 版本 1 起为当前布局
+     */
     template<class Archive>
-    void serialize(Archive& ar) {
-        ar(id, hasTag, tag, hasTransform, transform, hasHierarchy, parent, children, hasCamera, camera, hasMesh, mesh, hasRigidBody, rigidBody);
+    void serialize(Archive& ar, const std::uint32_t version) {
+        ar(id, hasTag, tag, hasTransform, transform, hasHierarchy, parent, children, hasCamera, camera, hasMesh);
+        if (version == 0) {
+            mesh.serializeFields(ar, 0);
+        } else {
+            ar(mesh);
+        }
+        ar(hasRigidBody, rigidBody);
+        if (version >= 1) ar(hasBounds, bounds);
     }
 };
 
+} // namespace Nexus
+
+CEREAL_CLASS_VERSION(Nexus::SerializedEntity, 1);
+
+namespace Nexus {
+
 SceneSerializer::SceneSerializer(Scene& scene) : m_scene(scene) {}
 
 bool SceneSerializer::serialize(const std::string& filePath) {
@@ -86,12 +108,16 @@ bool SceneSerializer::serialize(const std::string& filePath) {
                 se.hasRigidBody = true;
                 se.rigidBody = reg.get<RigidBodyComponent>(entityHandle);
             }
+            if (reg.all_of<BoundsComponent>(entityHandle)) {
+                se.hasBounds = true;
+                se.bounds = reg.get<BoundsComponent>(entityHandle);
+            }
             entities.push_back(se);
         }
 
-        // 写入实体数量
+        // 写入文件标记与实体数量
         uint32_t count = static_cast<uint32_t>(entities.size());
-        archive(count);
+        archive(kSceneFileMagic, count);
         for (auto& se : entities) {
             archive(se);
         }
@@ -116,14 +142,21 @@ bool SceneSerializer::deserialize(const std::string& filePath) {
         cereal::BinaryInputArchive archive(is);
         uint32_t count = 0;
         archive(count);
+        // 没有文件标记的旧文件不含类版本号, 按版本 0 布局逐个读取
+        const bool versioned = count == kSceneFileMagic;
+        if (versioned) archive(count);
 
         std::vector<SerializedEntity> entities(count);
         for (uint32_t i = 0; i < count; ++i) {
-            archive(entities[i]);
+            if (versioned) {
+                archive(entities[i]);
+            } else {
+                entities[i].serialize(archive, 0);
+            }
         }
 
         // 清空当前场景
-        m_scene.getRegistry().getInternal().clear();
+        m_scene.clear();
 
         // 映射旧 ID -> 新 handle
         std::unordered_map<uint32_t, entt::entity> idMap;
@@ -151,6 +184,10 @@ bool SceneSerializer::deserialize(const std::string& filePath) {
             if (se.hasRigidBody) {
                 reg.emplace<RigidBodyComponent>(handle, se.rigidBody);
             }
+            if (se.hasBounds) {
+                // 世界包围体在下一次 BoundsSystem::update 前与局部相同
+                reg.emplace<BoundsComponent>(handle, se.bounds.localMin, se.bounds.localMax, se.bounds.localSphere);
+            }
         }
 
         // 第二遍：建立 Hierarchy 关系
@@ -0,0 +1,59 @@
+#include "TextureCooker.h"
+#include "BlockCompression.h"
+#include "ImageMips.h"
+#include <filesystem>
+
+namespace Nexus {
+namespace Core {
+
+namespace {
+
+bool hasTranslucentAlpha(const ImageData& image) {
+    const size_t texels = (size_t)image.width * image.height;
+    for (size_t i = 0; i < texels; ++i) {
+        const uint8_t alpha = image.pixels[i * 4 + 3];
+        if (alpha != 0 && alpha != 255) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+StatusOr<ImageData> TextureCooker::cook(const ImageData& source, TextureRole role, const Options& options) {
+    if (isBlockCompressed(source.format)) return source;
+    if (source.width == 0 || source.height == 0) return InvalidArgumentError("TextureCooker: empty image");
+    if (source.pixels.size() < (size_t)source.width * source.height * 4) return InvalidArgumentError("TextureCooker: expects RGBA8 pixels");
+
+    TextureFormat format = (role == TextureRole::Normal) ? options.normalFormat : options.colorFormat;
+    if (!isBlockCompressed(format)) return InvalidArgumentError("TextureCooker: target format is not block-compressed");
+    if (format == TextureFormat::BC1_RGBA_UNORM_BLOCK && hasTranslucentAlpha(source)) {
+        format = TextureFormat::BC3_UNORM_BLOCK;
+    }
+
+    if (!options.generateMips || source.mipLevels >= computeMipLevelCount(source.width, source.height)) {
+        return compressImage(source, format);
+    }
+    ImageData image;
+    image.width = source.width;
+    image.height = source.height;
+    image.channels = source.channels;
+    image.pixels.assign(source.pixels.begin(), source.pixels.begin() + (size_t)source.width * source.height * 4);
+    NX_RETURN_IF_ERROR(generateMipChain(image));
+    return compressImage(image, format);
+}
+
+std::string TextureCooker::getCookedPath(const std::string& sourcePath) {
+    return sourcePath + ".ktx2";
+}
+
+bool TextureCooker::isCookedUpToDate(const std::string& sourcePath, const std::string& cookedPath) {
+    std::error_code ec;
+    const auto cookedTime = std::filesystem::last_write_time(cookedPath, ec);
+    if (ec) return false;
+    const auto sourceTime = std::filesystem::last_write_time(sourcePath, ec);
+    // 源文件缺失时仍可使用烘焙结果
+    return ec || cookedTime >= sourceTime;
+}
+
+} // namespace Core
+} // namespace Nexus
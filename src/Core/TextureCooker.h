@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Base.h"
+#include "CommonTypes.h"
+#include <string>
+
+namespace Nexus {
+namespace Core {
+
+/**
+ * @brief 纹理用途, 决定压缩格式
+ */
+enum class TextureRole {
+    Color,  // 反照率等颜色贴图
+    Normal  // 切线空间法线贴图 (仅 R/G 有效)
+};
+
+/**
+ * @brief 导入期纹理烘焙: 生成 mip 链并压缩为 GPU 块压缩格式
+ *
+ * 烘焙结果以 KTX2 保存在源文件旁 (<源文件>.ktx2), 源文件未修改时后续加载直接读取.
+ */
+class TextureCooker {
+public:
+    struct Options {
+        TextureFormat colorFormat = TextureFormat::BC7_UNORM_BLOCK;
+        TextureFormat normalFormat = TextureFormat::BC5_UNORM_BLOCK;
+        bool generateMips = true;
+    };
+
+    /**
+     * @brief 烘焙一张 RGBA8 图像; 已是块压缩格式时原样返回
+     * @note colorFormat 为 BC1 但图像含半透明 alpha 时改用 BC3
+     */
+    static StatusOr<ImageData> cook(const ImageData& source, TextureRole role, const Options& options);
+    static StatusOr<ImageData> cook(const ImageData& source, TextureRole role = TextureRole::Color) {
+        return cook(source, role, Options{});
+    }
+
+    /**
+     * @brief 源文件对应的烘焙文件路径 (完整路径)
+     */
+    static std::string getCookedPath(const std::string& sourcePath);
+
+    /**
+     * @brief 烘焙文件存在且不旧于源文件
+     */
+    static bool isCookedUpToDate(const std::string& sourcePath, const std::string& cookedPath);
+};
+
+} // namespace Core
+} // namespace Nexus
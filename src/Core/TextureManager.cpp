@@ -1,6 +1,11 @@
 #include "TextureManager.h"
 #include "ResourceLoader.h"
+#include "Ktx2.h"
+#include "ImageMips.h"
 #include "Log.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <cmath>
 
 namespace Nexus {
 namespace Core {
@@ -19,6 +24,8 @@ TextureManager::TextureManager(IContext* context) : m_context(context) {
 }
 
 TextureManager::~TextureManager() {
+    // 解码任务持有纹理指针, 需先结束
+    waitForPendingDecodes();
     m_textures.clear();
     m_defaultTexture.reset();
 }
@@ -27,7 +34,7 @@ ITexture* TextureManager::getOrCreateTexture(const std::string& path) {
     auto it = m_textures.find(path);
     if (it != m_textures.end()) {
         NX_CORE_INFO("[TextureDebug] Cache Hit: {}", path);
-        return it->second.get();
+        return it->second.texture.get();
     }
     NX_CORE_INFO("[TextureDebug] Cache Miss: {}", path);
 
@@ -43,29 +50,309 @@ ITexture* TextureManager::getOrCreateTexture(const std::string& path) {
         return nullptr;
     }
 
-    ITexture* ptr = texture.get();
-    m_textures[path] = std::move(texture);
-    return ptr;
+    TextureEntry entry;
+    entry.texture = std::move(texture);
+    return insertTexture(path, std::move(entry));
 }
 
 ITexture* TextureManager::createTextureFromMemory(const std::string& key, const ImageData& data) {
     auto it = m_textures.find(key);
     if (it != m_textures.end()) {
         NX_CORE_INFO("[TextureDebug] Cache Hit for Memory Texture: {}", key);
-        return it->second.get();
+        return it->second.texture.get();
     }
     NX_CORE_INFO("[TextureDebug] Cache Miss for Memory Texture: {}", key);
 
     auto texture = m_context->createTexture(data, TextureUsage::Sampled);
     if (!texture) return nullptr;
 
-    ITexture* ptr = texture.get();
-    m_textures[key] = std::move(texture);
+    TextureEntry entry;
+    entry.texture = std::move(texture);
+    return insertTexture(key, std::move(entry));
+}
+
+ITexture* TextureManager::insertTexture(const std::string& key, TextureEntry entry) {
+    entry.lastUsedFrame = m_frameIndex;
+    if (auto old = m_textures.find(key); old != m_textures.end()) {
+        m_entriesByIndex.erase(old->second.texture->getBindlessTextureIndex());
+    }
+    auto [it, inserted] = m_textures.insert_or_assign(key, std::move(entry));
+    ITexture* ptr = it->second.texture.get();
+    m_entriesByIndex[ptr->getBindlessTextureIndex()] = &it->second;
+    return ptr;
+}
+
+namespace {
+
+/**
+ * @brief 把 MipRange 解析为 levels 级的 mip 链中的 [first, end)
+ */
+Status resolveMipRange(uint32_t width, uint32_t height, uint32_t levels, uint32_t tailExtent,
+                       uint32_t firstLevel, uint32_t endLevel, uint32_t& first, uint32_t& end) {
+    // 不带完整 mip 链的纹理只能从其最后一级开始
+    first = tailExtent > 0 ? std::min(firstMipWithin(width, height, tailExtent), levels - 1) : firstLevel;
+    end = std::min(endLevel, levels);
+    if (first >= end) return InvalidArgumentError("Requested mip levels are not present in the texture");
+    return OkStatus();
+}
+
+} // namespace
+
+/**
+ * @brief 在工作线程解码并提交一张异步纹理
+ *
+ * 完整上传时优先直接解码进后端映射的 staging 内存 (零中间拷贝), 后端无空间时退化为 ImageData 上传.
+ * 已烘焙的 KTX2 只读取所需级别; 需要烘焙的图像先整体烘焙再截取所需级别.
+ */
+Status TextureManager::decodeAndUpload(IContext* context, ITexture* texture, const EncodedSource& source, const CookJob& cook, const MipRange& range) {
+    const uint8_t* encoded = source.data;
+    const size_t size = source.size;
+    uint32_t first = 0, end = 0;
+    if (Ktx2::isKtx2(encoded, size)) {
+        uint32_t width = 0, height = 0, levels = 0;
+        NX_RETURN_IF_ERROR(Ktx2::probe(encoded, size, width, height, levels));
+        NX_RETURN_IF_ERROR(resolveMipRange(width, height, levels, range.tailExtent, range.firstLevel, range.endLevel, first, end));
+        NX_ASSIGN_OR_RETURN(ImageData image, Ktx2::readLevels(encoded, size, first, end - first));
+        context->uploadTextureAsync(texture, std::move(image));
+        return OkStatus();
+    }
+    if (!cook.enabled && range.isFullChain()) {
+        uint32_t width = 0, height = 0;
+        NX_RETURN_IF_ERROR(ResourceLoader::probeImage(encoded, size, width, height));
+        if (void* staging = context->mapTextureUpload(texture, width, height)) {
+            Status status = ResourceLoader::decodeImageInto(encoded, size, static_cast<uint8_t*>(staging), width, height);
+            context->commitTextureUpload(texture, status.ok());
+            return status;
+        }
+    }
+    NX_ASSIGN_OR_RETURN(ImageData image, ResourceLoader::loadImageFromMemory(encoded, size));
+    if (cook.enabled) {
+        NX_ASSIGN_OR_RETURN(image, TextureCooker::cook(image, cook.role, cook.options));
+        if (!cook.outputPath.empty()) {
+            Status status = Ktx2::writeFile(image, cook.outputPath);
+            if (!status.ok()) NX_CORE_WARN("TextureManager: Failed to write cooked texture {}", cook.outputPath);
+        } else if (cook.storeCooked) {
+            // 之后的重新加载与流式请求直接读取烘焙结果, 不再重复压缩
+            if (auto bytes = Ktx2::write(image); bytes.ok()) cook.storeCooked(std::move(bytes).value());
+        }
+    }
+    if (!range.isFullChain()) {
+        if (image.mipLevels == 1) NX_RETURN_IF_ERROR(generateMipChain(image));
+        NX_RETURN_IF_ERROR(resolveMipRange(image.width, image.height, image.mipLevels, range.tailExtent, range.firstLevel, range.endLevel, first, end));
+        NX_ASSIGN_OR_RETURN(image, extractMipLevels(image, first, end - first));
+    }
+    context->uploadTextureAsync(texture, std::move(image));
+    return OkStatus();
+}
+
+ITexture* TextureManager::getOrCreateTextureAsync(const std::string& path, TextureRole role) {
+    const std::string fullPath = ResourceLoader::getBasePath() + path;
+    CookJob cook{m_cookTextures, role, m_cookOptions, TextureCooker::getCookedPath(fullPath)};
+    // 每次打开 (包括换出后重新加载) 时检查烘焙结果是否仍然最新
+    const bool preferCooked = cook.enabled;
+    return createAsync(path, cook, [path, fullPath, preferCooked]() -> StatusOr<EncodedSource> {
+        const std::string cookedPath = TextureCooker::getCookedPath(fullPath);
+        const bool useCooked = preferCooked && TextureCooker::isCookedUpToDate(fullPath, cookedPath);
+        NX_ASSIGN_OR_RETURN(MappedFile file, useCooked ? MappedFile::open(cookedPath) : ResourceLoader::mapFile(path));
+        auto owner = std::make_shared<MappedFile>(std::move(file));
+        return EncodedSource{owner->data(), owner->size(), owner};
+    });
+}
+
+ITexture* TextureManager::createTextureFromMemoryAsync(const std::string& key, std::vector<uint8_t> encoded, TextureRole role) {
+    // 烘焙后用 KTX2 结果替换原始数据, 由工作线程写入, 加锁交换
+    struct MemorySource {
+        std::mutex mutex;
+        std::shared_ptr<const std::vector<uint8_t>> bytes;
+    };
+    auto source = std::make_shared<MemorySource>();
+    source->bytes = std::make_shared<const std::vector<uint8_t>>(std::move(encoded));
+
+    CookJob cook{m_cookTextures, role, m_cookOptions, ""};
+    cook.storeCooked = [source](std::vector<uint8_t>&& cooked) {
+        auto bytes = std::make_shared<const std::vector<uint8_t>>(std::move(cooked));
+        std::lock_guard<std::mutex> lock(source->mutex);
+        source->bytes = std::move(bytes);
+    };
+    return createAsync(key, std::move(cook), [source]() -> StatusOr<EncodedSource> {
+        std::lock_guard<std::mutex> lock(source->mutex);
+        return EncodedSource{source->bytes->data(), source->bytes->size(), source->bytes};
+    });
+}
+
+void TextureManager::setCookTextures(bool enabled, const TextureCooker::Options& options) {
+    m_cookTextures = enabled;
+    m_cookOptions = options;
+}
+
+ITexture* TextureManager::createAsync(const std::string& key, CookJob cook, SourceOpener open) {
+    auto it = m_textures.find(key);
+    if (it != m_textures.end()) {
+        return it->second.texture.get();
+    }
+
+    auto texture = m_context->createTextureAsync(getDefaultTexture());
+    if (!texture) {
+        // 后端不支持异步上传, 在当前线程完成
+        auto source = open();
+        StatusOr<ImageData> imgRes = source.ok() ? ResourceLoader::loadImageFromMemory(source->data, source->size)
+                                                 : StatusOr<ImageData>(source.status());
+        if (!imgRes.ok()) {
+            NX_CORE_WARN("TextureManager: Failed to decode texture: {}", key);
+            return nullptr;
+        }
+        return createTextureFromMemory(key, imgRes.value());
+    }
+
+    TextureEntry entry;
+    entry.texture = std::move(texture);
+    entry.open = std::move(open);
+    entry.cook = std::move(cook);
+    ITexture* ptr = insertTexture(key, std::move(entry));
+    const TextureEntry& inserted = m_textures.at(key);
+    submitDecode(ptr, key, inserted.cook, inserted.open, initialRange());
     return ptr;
 }
 
+void TextureManager::submitDecode(ITexture* texture, const std::string& key, const CookJob& cook, const SourceOpener& open, const MipRange& range) {
+    m_pendingDecodes.fetch_add(1);
+    IContext* context = m_context;
+    // 已驻留纹理的解码是 mip 流入请求
+    const bool streamIn = texture->isResident();
+    JobSystem::get().submit([this, context, texture, key, cook, open, range, streamIn]() {
+        auto source = open();
+        Status status = source.ok() ? decodeAndUpload(context, texture, *source, cook, range) : source.status();
+        if (!status.ok()) {
+            NX_CORE_WARN("TextureManager: Failed to decode texture {}, keeping {}: {}", key, streamIn ? "current mips" : "default", status.message());
+        }
+        std::lock_guard<std::mutex> lock(m_decodeMutex);
+        if (!status.ok() && streamIn) m_failedStreams.push_back(key);
+        m_pendingDecodes.fetch_sub(1);
+        m_decodeCv.notify_all();
+    });
+}
+
+void TextureManager::markUsed(uint32_t bindlessIndex, float uvPerPixel) {
+    auto it = m_entriesByIndex.find(bindlessIndex);
+    if (it == m_entriesByIndex.end()) return;
+    TextureEntry& entry = *it->second;
+    entry.uvPerPixel = entry.lastUsedFrame == m_frameIndex ? std::min(entry.uvPerPixel, uvPerPixel) : uvPerPixel;
+    entry.lastUsedFrame = m_frameIndex;
+}
+
+uint32_t TextureManager::computeDesiredMip(uint32_t width, uint32_t height, float uvPerPixel, float mipBias) {
+    const uint32_t levels = computeMipLevelCount(width, height);
+    const float texelsPerPixel = (float)std::max(width, height) * uvPerPixel;
+    if (!(texelsPerPixel > 0.0f)) return 0;
+    // 每像素覆盖 2^n 个纹素时第 n 级恰好一比一
+    const float mip = std::floor(std::log2(texelsPerPixel) + mipBias);
+    return mip <= 0.0f ? 0u : std::min((uint32_t)mip, levels - 1);
+}
+
+void TextureManager::updateStreaming(const std::string& key, TextureEntry& entry, ResidencyStats& stats) {
+    ITexture* texture = entry.texture.get();
+    const uint32_t residentMip = texture->getResidentMip();
+    if (entry.streaming) {
+        if (residentMip != entry.requestedMip) {
+            ++stats.streamingCount;
+            return;
+        }
+        entry.streaming = false;
+    }
+    if (entry.lastUsedFrame != m_frameIndex) return;
+
+    const uint32_t width = texture->getWidth(), height = texture->getHeight();
+    const uint32_t desiredMip = computeDesiredMip(width, height, entry.uvPerPixel, m_streaming.mipBias);
+    if (desiredMip < residentMip) {
+        if (entry.streamFailed || stats.streamInsLastUpdate >= m_streaming.maxStreamInsPerUpdate) return;
+        // 只解码缺少的精细级别, 更粗的级别由后端从现有图像拷贝
+        submitDecode(texture, key, entry.cook, entry.open, MipRange{0, desiredMip, residentMip});
+        ++stats.streamInsLastUpdate;
+    } else if (desiredMip > residentMip + m_streaming.streamOutHysteresis) {
+        ImageData coarser;
+        coarser.width = width;
+        coarser.height = height;
+        coarser.baseMip = desiredMip;
+        coarser.mipLevels = 0;
+        m_context->uploadTextureAsync(texture, std::move(coarser));
+        ++stats.streamOutsLastUpdate;
+    } else {
+        return;
+    }
+    entry.requestedMip = desiredMip;
+    entry.streaming = true;
+    ++stats.streamingCount;
+}
+
+void TextureManager::updateResidency() {
+    ResidencyStats stats;
+    stats.budgetBytes = m_vramBudget;
+    stats.frameIndex = m_frameIndex;
+
+    std::vector<std::string> failedStreams;
+    {
+        std::lock_guard<std::mutex> lock(m_decodeMutex);
+        failedStreams.swap(m_failedStreams);
+    }
+    for (const auto& key : failedStreams) {
+        auto it = m_textures.find(key);
+        if (it == m_textures.end()) continue;
+        it->second.streaming = false;
+        it->second.streamFailed = true;
+    }
+
+    std::vector<std::pair<const std::string*, TextureEntry*>> candidates;
+    for (auto& [key, entry] : m_textures) {
+        const uint64_t bytes = entry.texture->getMemorySize();
+        if (bytes > 0) entry.lastKnownBytes = bytes;
+        const bool usedThisFrame = entry.lastUsedFrame == m_frameIndex;
+        if (usedThisFrame) stats.requestedBytes += entry.lastKnownBytes;
+
+        if (entry.evicted) {
+            if (!usedThisFrame) continue;
+            // 再次被绘制: 经异步管线重新加载, 完成前继续采样默认纹理
+            entry.evicted = false;
+            submitDecode(entry.texture.get(), key, entry.cook, entry.open, initialRange());
+            ++stats.reloadsLastUpdate;
+            continue;
+        }
+        if (m_streaming.enabled && entry.open && bytes > 0) updateStreaming(key, entry, stats);
+        stats.residentBytes += bytes;
+        if (bytes > 0) ++stats.residentCount;
+        // 流式请求进行中的纹理暂不换出, 以免与替换上传交错
+        if (bytes > 0 && entry.open && !usedThisFrame && !entry.streaming) candidates.emplace_back(&key, &entry);
+    }
+
+    if (m_vramBudget > 0 && stats.residentBytes > m_vramBudget) {
+        std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+            return a.second->lastUsedFrame < b.second->lastUsedFrame;
+        });
+        for (auto& [key, entry] : candidates) {
+            if (stats.residentBytes <= m_vramBudget) break;
+            if (!m_context->evictTexture(entry->texture.get(), getDefaultTexture())) continue;
+            entry->evicted = true;
+            stats.residentBytes -= entry->lastKnownBytes;
+            --stats.residentCount;
+            ++stats.evictionsLastUpdate;
+        }
+    }
+
+    for (const auto& [key, entry] : m_textures) {
+        if (entry.evicted) ++stats.evictedCount;
+    }
+    m_stats = stats;
+    ++m_frameIndex;
+}
+
+void TextureManager::waitForPendingDecodes() {
+    std::unique_lock<std::mutex> lock(m_decodeMutex);
+    m_decodeCv.wait(lock, [this]() { return m_pendingDecodes.load() == 0; });
+}
+
 void TextureManager::addTexture(const std::string& key, std::unique_ptr<ITexture> texture) {
-    m_textures[key] = std::move(texture);
+    TextureEntry entry;
+    entry.texture = std::move(texture);
+    insertTexture(key, std::move(entry));
 }
 
 ITexture* TextureManager::getDefaultTexture() {
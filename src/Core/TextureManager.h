@@ -2,18 +2,57 @@
 
 #include "Base.h"
 #include "../Bridge/Interfaces.h"
+#include "TextureCooker.h"
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
 
 namespace Nexus {
 namespace Core {
 
 /**
  * @brief 纹理管理器，负责纹理的生命周期管理和缓存
+ *
+ * 经异步接口加载的纹理参与驻留管理: 每帧由绘制列表 markUsed, updateResidency 在超出显存预算时
+ * 按最近使用帧换出最久未用的纹理 (槽位改为采样默认纹理), 再次被使用时经异步管线重新加载.
+ * 开启 mip 流式加载时首次只上传尾部的小尺寸级别, 之后按 markUsed 报告的屏幕纹素密度逐步流入更精细的级别,
+ * 期望级别变粗时再丢弃精细级别.
  */
 class TextureManager {
 public:
+    /**
+     * @brief 驻留统计
+     */
+    struct ResidencyStats {
+        uint64_t budgetBytes = 0;     // 0 表示不限
+        uint64_t residentBytes = 0;   // 托管纹理当前占用的显存
+        uint64_t requestedBytes = 0;  // 本帧绘制引用的纹理全部驻留所需的显存
+        uint32_t residentCount = 0;
+        uint32_t evictedCount = 0;
+        uint32_t evictionsLastUpdate = 0;
+        uint32_t reloadsLastUpdate = 0;
+        uint32_t streamInsLastUpdate = 0;  // 本帧发起的精细级别流入
+        uint32_t streamOutsLastUpdate = 0; // 本帧发起的精细级别丢弃
+        uint32_t streamingCount = 0;       // 尚未完成的 mip 流式请求
+        uint64_t frameIndex = 0;
+    };
+
+    /**
+     * @brief mip 流式加载参数
+     */
+    struct MipStreamingSettings {
+        bool enabled = false;
+        uint32_t tailExtent = 64;          // 首次加载只上传最大边不超过该值的级别
+        uint32_t maxStreamInsPerUpdate = 8; // 每帧最多发起的流入请求 (解码开销)
+        float mipBias = 0.0f;              // > 0 时选择更粗的级别
+        uint32_t streamOutHysteresis = 1;  // 期望级别比驻留级别粗超过该值时才丢弃精细级别
+    };
+
     TextureManager(IContext* context);
     ~TextureManager();
 
@@ -32,6 +71,70 @@ public:
      */
     ITexture* createTextureFromMemory(const std::string& key, const ImageData& data);
 
+    /**
+     * @brief 异步获取或创建纹理, 不阻塞调用线程
+     *
+     * 立即返回的纹理拥有独立的 bindless 槽位, 上传完成前采样默认纹理;
+     * 文件以内存映射方式读取, 在 JobSystem 工作线程直接解码到后端的 staging 内存,
+     * 上传在下一次 IContext::sync 时批量提交.
+     * 开启烘焙时优先读取最新的 <path>.ktx2, 否则解码后压缩并写回该文件.
+     * 后端不支持异步纹理时退化为 getOrCreateTexture.
+     */
+    ITexture* getOrCreateTextureAsync(const std::string& path, TextureRole role = TextureRole::Color);
+
+    /**
+     * @brief 异步解码内存中的压缩图像 (如模型内嵌纹理)
+     * @param encoded 编码后的文件数据 (png/jpg/ktx2...), 开启烘焙时仅在内存中压缩
+     */
+    ITexture* createTextureFromMemoryAsync(const std::string& key, std::vector<uint8_t> encoded, TextureRole role = TextureRole::Color);
+
+    /**
+     * @brief 开启/关闭导入期块压缩烘焙 (只影响之后发起的异步加载)
+     */
+    void setCookTextures(bool enabled, const TextureCooker::Options& options = {});
+    bool isCookingTextures() const { return m_cookTextures; }
+
+    /**
+     * @brief 正在解码的纹理数
+     */
+    uint32_t getPendingDecodeCount() const { return m_pendingDecodes.load(); }
+
+    /**
+     * @brief 阻塞直到所有解码任务结束 (上传仍由 sync 驱动)
+     */
+    void waitForPendingDecodes();
+
+    /**
+     * @brief 设置显存预算 (字节, 0 表示不限)
+     */
+    void setVramBudget(uint64_t bytes) { m_vramBudget = bytes; }
+    uint64_t getVramBudget() const { return m_vramBudget; }
+
+    /**
+     * @brief 开启/关闭 mip 流式加载 (初始只加载尾部级别的设置只影响之后发起的加载)
+     */
+    void setMipStreaming(const MipStreamingSettings& settings) { m_streaming = settings; }
+    const MipStreamingSettings& getMipStreaming() const { return m_streaming; }
+
+    /**
+     * @brief 标记 bindless 槽位对应的纹理在本帧被绘制
+     * @param uvPerPixel 屏幕上一个像素跨越的 UV 长度, 0 表示需要最精细的级别; 同一帧内取最小值
+     */
+    void markUsed(uint32_t bindlessIndex, float uvPerPixel = 0.0f);
+
+    /**
+     * @brief uvPerPixel 对应的 mip 级别 (纹理最大边 * uvPerPixel 的 log2, 截断到 [0, levelCount - 1])
+     */
+    static uint32_t computeDesiredMip(uint32_t width, uint32_t height, float uvPerPixel, float mipBias = 0.0f);
+
+    /**
+     * @brief 每帧在同步点调用一次 (在途帧可以仍在执行, 槽位改写由渲染后端推迟到它们完成之后): 重新加载被使用的已换出纹理, 推进 mip 流式加载,
+     * 超出预算时换出最久未用的纹理
+     */
+    void updateResidency();
+
+    ResidencyStats getResidencyStats() const { return m_stats; }
+
     /**
      * @brief 手动添加外部创建的纹理
      */
@@ -43,9 +146,84 @@ public:
     ITexture* getDefaultTexture();
 
 private:
+    /**
+     * @brief 编码后的图像字节 (映射的文件或内存副本), owner 保证解码期间有效
+     */
+    struct EncodedSource {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        std::shared_ptr<const void> owner;
+    };
+
+    /**
+     * @brief 工作线程上的烘焙参数, outputPath 为空时不写回磁盘而是交给 storeCooked (如有) 缓存在内存
+     */
+    struct CookJob {
+        bool enabled = false;
+        TextureRole role = TextureRole::Color;
+        TextureCooker::Options options;
+        std::string outputPath;
+        std::function<void(std::vector<uint8_t>&&)> storeCooked; // 接收 KTX2 编码的烘焙结果
+    };
+
+    /**
+     * @brief 工作线程需要上传的 mip 范围: tailExtent > 0 时为最大边不超过它的尾部级别, 否则为 [firstLevel, endLevel)
+     */
+    struct MipRange {
+        uint32_t tailExtent = 0;
+        uint32_t firstLevel = 0;
+        uint32_t endLevel = UINT32_MAX;
+
+        bool isFullChain() const { return tailExtent == 0 && firstLevel == 0 && endLevel == UINT32_MAX; }
+    };
+
+    using SourceOpener = std::function<StatusOr<EncodedSource>()>;
+
+    /**
+     * @brief 缓存条目; open 为空的纹理 (同步创建或外部添加) 不参与换出
+     */
+    struct TextureEntry {
+        std::unique_ptr<ITexture> texture;
+        SourceOpener open;
+        CookJob cook;
+        uint64_t lastUsedFrame = 0;
+        uint64_t lastKnownBytes = 0; // 最近一次驻留时的显存大小
+        bool evicted = false;
+
+        float uvPerPixel = 0.0f;     // 本帧各次绘制中的最小值
+        uint32_t requestedMip = 0;   // 进行中的流式请求的目标级别
+        bool streaming = false;
+        bool streamFailed = false;   // 流入失败后不再请求更精细的级别
+    };
+
+    ITexture* createAsync(const std::string& key, CookJob cook, SourceOpener open);
+    ITexture* insertTexture(const std::string& key, TextureEntry entry);
+    void submitDecode(ITexture* texture, const std::string& key, const CookJob& cook, const SourceOpener& open, const MipRange& range);
+    MipRange initialRange() const { return m_streaming.enabled ? MipRange{m_streaming.tailExtent} : MipRange{}; }
+    void updateStreaming(const std::string& key, TextureEntry& entry, ResidencyStats& stats);
+
+    /**
+     * @brief 在工作线程解码 range 内的级别并提交上传
+     */
+    static Status decodeAndUpload(IContext* context, ITexture* texture, const EncodedSource& source, const CookJob& cook, const MipRange& range);
+
     IContext* m_context;
-    std::unordered_map<std::string, std::unique_ptr<ITexture>> m_textures;
+    std::unordered_map<std::string, TextureEntry> m_textures;
+    std::unordered_map<uint32_t, TextureEntry*> m_entriesByIndex;
     std::unique_ptr<ITexture> m_defaultTexture;
+
+    uint64_t m_vramBudget = 0;
+    uint64_t m_frameIndex = 0;
+    ResidencyStats m_stats;
+
+    bool m_cookTextures = false;
+    TextureCooker::Options m_cookOptions;
+    MipStreamingSettings m_streaming;
+
+    std::atomic<uint32_t> m_pendingDecodes{0};
+    std::mutex m_decodeMutex;
+    std::condition_variable m_decodeCv;
+    std::vector<std::string> m_failedStreams; // 受 m_decodeMutex 保护
 };
 
 } // namespace Core
@@ -0,0 +1,52 @@
+#include "TextureResidencySystem.h"
+#include "Components.h"
+#include "TextureManager.h"
+#include <cmath>
+
+namespace Nexus {
+
+float TextureResidencySystem::computeUvPerPixel(float uvDensity, float localRadius, const float worldSphere[4], const float eye[3],
+                                                float tanHalfFov, float viewportHeight) {
+    const float worldRadius = worldSphere[3];
+    const float dx = worldSphere[0] - eye[0], dy = worldSphere[1] - eye[1], dz = worldSphere[2] - eye[2];
+    // 取包围球上离相机最近的点, 大网格近处的部分不会被低估
+    const float distance = std::sqrt(dx * dx + dy * dy + dz * dz) - worldRadius;
+    if (distance <= 0.0f || worldRadius <= 0.0f || viewportHeight <= 0.0f) return 0.0f;
+
+    const float worldUvDensity = (uvDensity > 0.0f && localRadius > 0.0f) ? uvDensity * localRadius / worldRadius
+                                                                          : 0.5f / worldRadius;
+    const float worldPerPixel = 2.0f * distance * tanHalfFov / viewportHeight;
+    return worldUvDensity * worldPerPixel;
+}
+
+void TextureResidencySystem::update(Registry& registry, Core::TextureManager& textureManager, std::span<const entt::entity> visible,
+                                    float viewportHeight) {
+    bool hasCamera = false;
+    std::array<float, 3> eye = {0.0f, 0.0f, 0.0f};
+    float tanHalfFov = 0.0f;
+    auto cameraView = registry.view<CameraComponent, TransformComponent>();
+    if (auto cameraIt = cameraView.begin(); cameraIt != cameraView.end()) {
+        hasCamera = true;
+        eye = cameraView.get<TransformComponent>(*cameraIt).getWorldPosition();
+        tanHalfFov = std::tan(cameraView.get<CameraComponent>(*cameraIt).fov * 0.5f * (3.1415926535f / 180.0f));
+    }
+
+    // 可见集合来自上一帧的视锥剔除, 其间被销毁或移除网格的实体直接跳过
+    for (auto entity : visible) {
+        if (!registry.valid(entity) || !registry.has<MeshComponent>(entity)) continue;
+        const auto& mesh = registry.get<MeshComponent>(entity);
+        float uvPerPixel = 0.0f;
+        if (hasCamera && registry.has<BoundsComponent>(entity)) {
+            const auto& bounds = registry.get<BoundsComponent>(entity);
+            uvPerPixel = computeUvPerPixel(mesh.uvDensity, bounds.localSphere[3], bounds.worldSphere.data(), eye.data(), tanHalfFov, viewportHeight);
+        }
+        textureManager.markUsed(mesh.albedoTexture, uvPerPixel);
+        textureManager.markUsed(mesh.normalTexture, uvPerPixel);
+        textureManager.markUsed(mesh.metallicRoughnessTexture, uvPerPixel);
+        textureManager.markUsed(mesh.occlusionTexture, uvPerPixel);
+        textureManager.markUsed(mesh.emissiveTexture, uvPerPixel);
+    }
+    textureManager.updateResidency();
+}
+
+} // namespace Nexus
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../Bridge/ECS.h"
+#include <span>
+
+namespace Nexus {
+namespace Core {
+class TextureManager;
+}
+
+/**
+ * @brief 纹理驻留系统
+ * 把渲染器可见集合中 MeshComponent 引用的纹理标记为已使用, 并按网格的屏幕投影与 UV 密度估计每像素跨越的 UV 长度,
+ * 再由 TextureManager 执行预算内的换出, 重新加载与 mip 流式加载. 视锥外网格的纹理不被标记, 按 LRU 成为换出候选
+ */
+class TextureResidencySystem {
+public:
+    /**
+     * @brief 在同步点调用, 需在 BoundsSystem 之后; 在途帧可以仍在采样被换出的纹理
+     * @param visible 渲染器最近一帧的可见实体 (VK_Renderer::getVisibleEntities), 已销毁的实体被跳过
+     * @param viewportHeight 视口高度 (像素), 用于把世界尺寸换算为屏幕像素
+     */
+    static void update(Registry& registry, Core::TextureManager& textureManager, std::span<const entt::entity> visible,
+                       float viewportHeight = 720.0f);
+
+    /**
+     * @brief 网格表面上一个屏幕像素跨越的 UV 长度
+     * @param uvDensity 模型空间的 UV 密度 (0 时假设纹理恰好覆盖包围球直径一次)
+     * @param localRadius, worldSphere 局部与世界包围球, 两者之比为网格的缩放
+     * @return 相机位于包围球内时为 0 (需要最精细的级别)
+     */
+    static float computeUvPerPixel(float uvDensity, float localRadius, const float worldSphere[4], const float eye[3],
+                                   float tanHalfFov, float viewportHeight);
+};
+
+} // namespace Nexus
@@ -0,0 +1,130 @@
+#include "VertexPacking.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Nexus {
+namespace Core {
+
+uint16_t packHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t absBits = bits & 0x7FFFFFFFu;
+
+    if (absBits >= 0x7F800000u) {
+        // Inf / NaN
+        return (uint16_t)(sign | 0x7C00u | (absBits > 0x7F800000u ? 0x200u : 0u));
+    }
+    if (absBits >= 0x477FF000u) {
+        // 超出 half 范围 (>= 65520), 舍入为 Inf
+        return (uint16_t)(sign | 0x7C00u);
+    }
+    if (absBits < 0x38800000u) {
+        // half 次正规数: 以 2^-24 为单位舍入
+        float absValue;
+        std::memcpy(&absValue, &absBits, sizeof(absValue));
+        return (uint16_t)(sign | (uint32_t)std::nearbyint(absValue * 16777216.0f));
+    }
+
+    // 重新偏置指数 (127 -> 15), 尾数就近舍入到偶数
+    uint32_t half = (absBits - 0x38000000u) >> 13;
+    uint32_t remainder = absBits & 0x1FFFu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) half++;
+    return (uint16_t)(sign | half);
+}
+
+float unpackHalf(uint16_t value) {
+    uint32_t sign = (uint32_t)(value & 0x8000u) << 16;
+    uint32_t exponent = (value >> 10) & 0x1Fu;
+    uint32_t mantissa = value & 0x3FFu;
+
+    if (exponent == 0) {
+        float result = std::ldexp((float)mantissa, -24);
+        return sign ? -result : result;
+    }
+
+    uint32_t bits;
+    if (exponent == 31) {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+    }
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+static int16_t toSnorm16(float v) {
+    return (int16_t)std::lround(std::clamp(v, -1.0f, 1.0f) * 32767.0f);
+}
+
+std::array<int16_t, 2> octEncodeSnorm16(float x, float y, float z) {
+    float l1 = std::fabs(x) + std::fabs(y) + std::fabs(z);
+    if (l1 < 1e-12f) return {0, 0};
+
+    float u = x / l1;
+    float v = y / l1;
+    if (z < 0.0f) {
+        float fu = (1.0f - std::fabs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+        float fv = (1.0f - std::fabs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+        u = fu;
+        v = fv;
+    }
+    return {toSnorm16(u), toSnorm16(v)};
+}
+
+std::array<float, 3> octDecodeSnorm16(int16_t x, int16_t y) {
+    float u = std::max((float)x / 32767.0f, -1.0f);
+    float v = std::max((float)y / 32767.0f, -1.0f);
+    float z = 1.0f - std::fabs(u) - std::fabs(v);
+    float t = std::max(-z, 0.0f);
+    u += u >= 0.0f ? -t : t;
+    v += v >= 0.0f ? -t : t;
+
+    float len = std::sqrt(u * u + v * v + z * z);
+    return {u / len, v / len, z / len};
+}
+
+void packVertices(const std::vector<float>& vertices, std::vector<PackedVertex>& outPacked,
+                  std::array<float, 3>& outPositionOffset, std::array<float, 3>& outPositionScale) {
+    const size_t vertexCount = vertices.size() / 8;
+    outPacked.resize(vertexCount);
+
+    std::array<float, 3> minPos = {0.0f, 0.0f, 0.0f};
+    std::array<float, 3> maxPos = {0.0f, 0.0f, 0.0f};
+    if (vertexCount > 0) {
+        for (int a = 0; a < 3; ++a) minPos[a] = maxPos[a] = vertices[a];
+    }
+    for (size_t i = 0; i < vertexCount; ++i) {
+        const float* v = &vertices[i * 8];
+        for (int a = 0; a < 3; ++a) {
+            minPos[a] = std::min(minPos[a], v[a]);
+            maxPos[a] = std::max(maxPos[a], v[a]);
+        }
+    }
+
+    for (int a = 0; a < 3; ++a) {
+        float extent = maxPos[a] - minPos[a];
+        outPositionOffset[a] = minPos[a];
+        outPositionScale[a] = extent > 0.0f ? extent : 1.0f;
+    }
+
+    for (size_t i = 0; i < vertexCount; ++i) {
+        const float* v = &vertices[i * 8];
+        PackedVertex& p = outPacked[i];
+        for (int a = 0; a < 3; ++a) {
+            float n = (v[a] - outPositionOffset[a]) / outPositionScale[a];
+            p.position[a] = (uint16_t)std::lround(std::clamp(n, 0.0f, 1.0f) * 65535.0f);
+        }
+        p.position[3] = 0;
+        p.uv[0] = packHalf(v[3]);
+        p.uv[1] = packHalf(v[4]);
+        auto oct = octEncodeSnorm16(v[5], v[6], v[7]);
+        p.normal[0] = oct[0];
+        p.normal[1] = oct[1];
+    }
+}
+
+} // namespace Core
+} // namespace Nexus
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Nexus {
+namespace Core {
+
+/**
+ * @brief VertexFormat::Compact 的 CPU 端布局 (16 字节)
+ */
+struct PackedVertex {
+    uint16_t position[4]; // unorm16, 相对网格 AABB, w 未使用
+    uint16_t uv[2];       // half
+    int16_t normal[2];    // snorm16, 八面体编码
+};
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex must be 16 bytes");
+
+/**
+ * @brief float -> IEEE 754 half (就近舍入)
+ */
+uint16_t packHalf(float value);
+float unpackHalf(uint16_t value);
+
+/**
+ * @brief 单位向量八面体编码到两个 snorm16
+ */
+std::array<int16_t, 2> octEncodeSnorm16(float x, float y, float z);
+std::array<float, 3> octDecodeSnorm16(int16_t x, int16_t y);
+
+/**
+ * @brief 将 Pos(3) UV(2) Normal(3) 的浮点顶点压缩为 PackedVertex
+ * @param outPositionOffset 反量化平移 (AABB 最小点)
+ * @param outPositionScale 反量化缩放 (AABB 尺寸), position = offset + unorm * scale
+ */
+void packVertices(const std::vector<float>& vertices, std::vector<PackedVertex>& outPacked,
+                  std::array<float, 3>& outPositionOffset, std::array<float, 3>& outPositionScale);
+
+} // namespace Core
+} // namespace Nexus
@@ -14,6 +14,14 @@ namespace Nexus {
 
 extern std::atomic<uint32_t> g_RenderStats_DrawCalls;
 extern std::atomic<uint32_t> g_RenderStats_Triangles;
+extern std::atomic<uint32_t> g_RenderStats_FrameWaitUs;
+extern std::atomic<uint32_t> g_RenderStats_GpuQueuedFrames;
+extern std::atomic<uint32_t> g_RenderStats_CpuGpuOverlap;
+extern std::atomic<uint32_t> g_RenderStats_GpuFrameUs;
+extern std::atomic<uint32_t> g_RenderStats_GpuCullUs;
+extern std::atomic<uint32_t> g_RenderStats_GpuMainPassUs;
+extern std::atomic<uint32_t> g_RenderStats_GpuUiUs;
+extern std::atomic<uint32_t> g_RenderStats_GpuDepthPyramidUs;
 
 bool EditorUIManager::initialize(VK_UIBridge* uiBridge) {
     m_uiBridge = uiBridge;
@@ -605,6 +613,32 @@ void EditorUIManager::update(Scene* scene) {
     if (trianglesEl) {
         trianglesEl->SetInnerRML(std::to_string(g_RenderStats_Triangles.load(std::memory_order_relaxed)));
     }
+    if (auto* frameWaitEl = m_editorDoc->GetElementById("prop-frame-wait")) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.2f ms", g_RenderStats_FrameWaitUs.load(std::memory_order_relaxed) / 1000.0);
+        frameWaitEl->SetInnerRML(buf);
+    }
+    if (auto* queuedEl = m_editorDoc->GetElementById("prop-gpu-queued")) {
+        queuedEl->SetInnerRML(std::to_string(g_RenderStats_GpuQueuedFrames.load(std::memory_order_relaxed)));
+    }
+    if (auto* overlapEl = m_editorDoc->GetElementById("prop-cpu-gpu-overlap")) {
+        overlapEl->SetInnerRML(std::to_string(g_RenderStats_CpuGpuOverlap.load(std::memory_order_relaxed)) + "%");
+    }
+    // GPU 各 pass 耗时来自时间戳查询, 比当前帧晚在途帧数个帧
+    const std::pair<const char*, const std::atomic<uint32_t>*> gpuTimings[] = {
+        {"prop-gpu-frame", &g_RenderStats_GpuFrameUs},
+        {"prop-gpu-cull", &g_RenderStats_GpuCullUs},
+        {"prop-gpu-main-pass", &g_RenderStats_GpuMainPassUs},
+        {"prop-gpu-ui", &g_RenderStats_GpuUiUs},
+        {"prop-gpu-depth-pyramid", &g_RenderStats_GpuDepthPyramidUs},
+    };
+    for (const auto& [id, stat] : gpuTimings) {
+        if (auto* el = m_editorDoc->GetElementById(id)) {
+            char buf[32];
+            snprintf(buf, sizeof(buf), "%.3f ms", stat->load(std::memory_order_relaxed) / 1000.0);
+            el->SetInnerRML(buf);
+        }
+    }
 }
 
 } // namespace Nexus
@@ -45,12 +45,95 @@ TEST_F(BindlessTest, BindlessRegistration) {
     EXPECT_LT(texIndex, 1024);
     EXPECT_LT(smpIndex, 64);
     
-    // Create another and ensure indices increment
+    // Create another: texture index increments, identical sampler state is shared
     VK_Texture texture2(m_context.get());
     ASSERT_TRUE(texture2.create(dummyData, TextureUsage::Sampled).ok());
     
     EXPECT_EQ(texture2.getBindlessTextureIndex(), texIndex + 1);
-    EXPECT_EQ(texture2.getBindlessSamplerIndex(), smpIndex + 1);
+    EXPECT_EQ(texture2.getBindlessSamplerIndex(), smpIndex);
+    EXPECT_EQ(texture2.getSampler(), texture.getSampler());
+    EXPECT_EQ(m_context->getSamplerCache()->getRefCount(texture.getSampler()), 2u);
+}
+
+TEST_F(BindlessTest, SamplerCacheSharesAndRecyclesSlots) {
+    if (!m_context->getDevice()) GTEST_SKIP() << "No device available";
+
+    auto cache = m_context->getSamplerCache();
+    ASSERT_NE(cache, nullptr);
+
+    SamplerDesc linear;
+    SamplerDesc nearest;
+    nearest.magFilter = vk::Filter::eNearest;
+    nearest.minFilter = vk::Filter::eNearest;
+
+    auto a = cache->acquire(linear);
+    auto b = cache->acquire(linear);
+    auto c = cache->acquire(nearest);
+    ASSERT_TRUE(a.ok() && b.ok() && c.ok());
+    EXPECT_EQ(a->sampler, b->sampler);
+    EXPECT_EQ(a->bindlessIndex, b->bindlessIndex);
+    EXPECT_NE(a->bindlessIndex, c->bindlessIndex);
+    EXPECT_EQ(cache->getSamplerCount(), 2u);
+
+    // 引用归零后槽位在延迟回收后被新状态复用
+    cache->release(c->sampler);
+    EXPECT_EQ(cache->getSamplerCount(), 1u);
+    // 没有在途帧: 下一个同步点即可回收
+    m_context->getBindlessManager()->endFrame();
+    SamplerDesc clamped;
+    clamped.addressModeU = vk::SamplerAddressMode::eClampToEdge;
+    auto d = cache->acquire(clamped);
+    ASSERT_TRUE(d.ok());
+    EXPECT_EQ(d->bindlessIndex, c->bindlessIndex);
+
+    // 大量同状态纹理不会耗尽采样器表
+    const uint32_t registered = m_context->getBindlessManager()->getStats().samplerHighWater;
+    for (int i = 0; i < 200; ++i) ASSERT_TRUE(cache->acquire(linear).ok());
+    EXPECT_EQ(m_context->getBindlessManager()->getStats().samplerHighWater, registered);
+    for (int i = 0; i < 200; ++i) cache->release(a->sampler);
+
+    cache->release(a->sampler);
+    cache->release(b->sampler);
+    cache->release(d->sampler);
+    EXPECT_EQ(cache->getSamplerCount(), 0u);
+}
+
+TEST_F(BindlessTest, ReleasedTextureSlotsAreReusedAfterInFlightFrames) {
+    if (!m_context->getDevice()) GTEST_SKIP() << "No device available";
+
+    ImageData dummyData;
+    dummyData.width = 1;
+    dummyData.height = 1;
+    dummyData.channels = 4;
+    dummyData.pixels = { 0, 255, 0, 255 };
+
+    auto manager = m_context->getBindlessManager();
+    uint32_t freedIndex = 0;
+    {
+        VK_Texture texture(m_context.get());
+        ASSERT_TRUE(texture.create(dummyData, TextureUsage::Sampled).ok());
+        freedIndex = texture.getBindlessTextureIndex();
+        EXPECT_EQ(manager->getStats().texturesInUse, 1u);
+    }
+    auto stats = manager->getStats();
+    EXPECT_EQ(stats.texturesInUse, 0u);
+    EXPECT_EQ(stats.texturesPendingFree, 1u);
+
+    // 同步点回收之前不得复用
+    VK_Texture early(m_context.get());
+    ASSERT_TRUE(early.create(dummyData, TextureUsage::Sampled).ok());
+    EXPECT_NE(early.getBindlessTextureIndex(), freedIndex);
+
+    manager->endFrame();
+    EXPECT_EQ(manager->getStats().texturesPendingFree, 0u);
+
+    VK_Texture reused(m_context.get());
+    ASSERT_TRUE(reused.create(dummyData, TextureUsage::Sampled).ok());
+    EXPECT_EQ(reused.getBindlessTextureIndex(), freedIndex);
+
+    // 一帧内的注册合并为一次 updateDescriptorSets
+    manager->flushWrites();
+    EXPECT_GE(manager->getStats().lastFlushWrites, 1u);
 }
 
 } // namespace Nexus
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include "BlockCompression.h"
+#include "ImageMips.h"
+#include "Ktx2.h"
+#include "TextureCooker.h"
+#include <cmath>
+
+namespace Nexus {
+
+namespace {
+
+/**
+ * @brief 两种颜色之间的对角渐变 (+ 可选 alpha) 的 RGBA8 测试图
+ */
+ImageData makeGradient(uint32_t width, uint32_t height, bool withAlpha) {
+    ImageData image;
+    image.width = width;
+    image.height = height;
+    image.channels = 4;
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            const float t = (float)(x + y) / (float)(width + height - 2);
+            image.pixels.push_back((uint8_t)std::lround(30 + t * 200));
+            image.pixels.push_back((uint8_t)std::lround(220 - t * 150));
+            image.pixels.push_back((uint8_t)std::lround(90 + t * 40));
+            image.pixels.push_back(withAlpha ? (uint8_t)std::lround(t * 255) : 255);
+        }
+    }
+    return image;
+}
+
+double rmse(const ImageData& a, const ImageData& b, int channels) {
+    double sum = 0.0;
+    size_t count = 0;
+    const size_t texels = (size_t)a.width * a.height;
+    for (size_t i = 0; i < texels; ++i) {
+        for (int c = 0; c < channels; ++c) {
+            double d = (double)a.pixels[i * 4 + c] - b.pixels[i * 4 + c];
+            sum += d * d;
+            ++count;
+        }
+    }
+    return std::sqrt(sum / count);
+}
+
+} // namespace
+
+TEST(BlockCompressionTest, RoundTripStaysCloseToSource) {
+    const ImageData source = makeGradient(16, 12, true);
+    struct Case { TextureFormat format; int channels; double maxError; };
+    const Case cases[] = {
+        {TextureFormat::BC7_UNORM_BLOCK, 4, 4.0},
+        {TextureFormat::BC3_UNORM_BLOCK, 4, 6.0},
+        {TextureFormat::BC5_UNORM_BLOCK, 2, 3.0},
+    };
+    for (const auto& c : cases) {
+        auto compressed = compressImage(source, c.format);
+        ASSERT_TRUE(compressed.ok());
+        EXPECT_EQ(compressed->pixels.size(), (16 / 4) * (12 / 4) * getBlockBytes(c.format));
+        auto decoded = decompressImage(*compressed);
+        ASSERT_TRUE(decoded.ok());
+        EXPECT_LT(rmse(source, *decoded, c.channels), c.maxError) << "format " << (int)c.format;
+    }
+}
+
+TEST(BlockCompressionTest, BC1KeepsPunchThroughAlpha) {
+    uint8_t texels[64];
+    for (int i = 0; i < 16; ++i) {
+        texels[i * 4 + 0] = (uint8_t)(i * 16);
+        texels[i * 4 + 1] = 40;
+        texels[i * 4 + 2] = 200;
+        texels[i * 4 + 3] = (i % 3 == 0) ? 0 : 255;
+    }
+    uint8_t block[8], decoded[64];
+    encodeBC1Block(texels, block);
+    decodeBC1Block(block, decoded);
+    for (int i = 0; i < 16; ++i) {
+        EXPECT_EQ(decoded[i * 4 + 3], texels[i * 4 + 3]);
+        if (texels[i * 4 + 3]) {
+            EXPECT_NEAR(decoded[i * 4 + 0], texels[i * 4 + 0], 48);
+        }
+    }
+}
+
+TEST(BlockCompressionTest, BC7SolidBlockIsNearExact) {
+    uint8_t texels[64];
+    for (int i = 0; i < 16; ++i) {
+        texels[i * 4 + 0] = 10;
+        texels[i * 4 + 1] = 128;
+        texels[i * 4 + 2] = 251;
+        texels[i * 4 + 3] = 255;
+    }
+    uint8_t block[16], decoded[64];
+    encodeBC7Block(texels, block);
+    EXPECT_EQ(block[0] & 0x7F, 0x40); // 模式 6
+    ASSERT_TRUE(decodeBC7Block(block, decoded).ok());
+    // 7 位端点 + p 位, 奇偶不同的通道最多差 1
+    for (int i = 0; i < 64; ++i) EXPECT_NEAR(decoded[i], texels[i], 1);
+}
+
+TEST(BlockCompressionTest, MipChainSizesRoundUpToBlocks) {
+    EXPECT_EQ(mipLevelSize(10, 6, 0, TextureFormat::BC1_RGBA_UNORM_BLOCK), 3u * 2u * 8u);
+    EXPECT_EQ(mipLevelSize(10, 6, 3, TextureFormat::BC7_UNORM_BLOCK), 16u);
+    EXPECT_EQ(mipLevelOffset(8, 8, 2, TextureFormat::BC7_UNORM_BLOCK), 4u * 16u + 16u);
+    EXPECT_EQ(mipLevelOffset(8, 8, 2, TextureFormat::R8G8B8A8_UNORM), mipLevelOffset(8, 8, 2));
+}
+
+TEST(Ktx2Test, WriteReadPreservesMipChain) {
+    ImageData source = makeGradient(8, 4, false);
+    ASSERT_TRUE(generateMipChain(source).ok());
+    auto compressed = compressImage(source, TextureFormat::BC1_RGBA_UNORM_BLOCK);
+    ASSERT_TRUE(compressed.ok());
+
+    auto bytes = Ktx2::write(*compressed);
+    ASSERT_TRUE(bytes.ok());
+    EXPECT_TRUE(Ktx2::isKtx2(bytes->data(), bytes->size()));
+
+    auto loaded = Ktx2::read(bytes->data(), bytes->size());
+    ASSERT_TRUE(loaded.ok());
+    EXPECT_EQ(loaded->format, TextureFormat::BC1_RGBA_UNORM_BLOCK);
+    EXPECT_EQ(loaded->width, 8u);
+    EXPECT_EQ(loaded->height, 4u);
+    EXPECT_EQ(loaded->mipLevels, 4u);
+    EXPECT_EQ(loaded->pixels, compressed->pixels);
+
+    // 截断的文件被拒绝
+    EXPECT_FALSE(Ktx2::read(bytes->data(), bytes->size() - 8).ok());
+}
+
+TEST(Ktx2Test, ReadLevelsReturnsPartialChain) {
+    ImageData source = makeGradient(16, 8, false);
+    ASSERT_TRUE(generateMipChain(source).ok());
+    auto compressed = compressImage(source, TextureFormat::BC7_UNORM_BLOCK);
+    ASSERT_TRUE(compressed.ok());
+    auto bytes = Ktx2::write(*compressed);
+    ASSERT_TRUE(bytes.ok());
+
+    // 尾部级别: 与在内存中截取的结果一致
+    auto tail = Ktx2::readLevels(bytes->data(), bytes->size(), 2, UINT32_MAX);
+    ASSERT_TRUE(tail.ok());
+    EXPECT_EQ(tail->baseMip, 2u);
+    EXPECT_EQ(tail->mipLevels, 3u);
+    auto expected = extractMipLevels(*compressed, 2, 3);
+    ASSERT_TRUE(expected.ok());
+    EXPECT_EQ(tail->pixels, expected->pixels);
+
+    // 部分链可以直接解压, 偏移相对 baseMip
+    auto decoded = decompressImage(*tail);
+    ASSERT_TRUE(decoded.ok());
+    EXPECT_EQ(decoded->baseMip, 2u);
+    EXPECT_EQ(decoded->pixels.size(), imageLevelOffset(*decoded, 5));
+    EXPECT_EQ(imageLevelOffset(*decoded, 5), mipLevelOffset(16, 8, 5) - mipLevelOffset(16, 8, 2));
+
+    EXPECT_FALSE(Ktx2::readLevels(bytes->data(), bytes->size(), 5, 1).ok());
+    EXPECT_FALSE(Ktx2::write(*tail).ok());
+    EXPECT_EQ(firstMipWithin(16, 8, 4), 2u);
+}
+
+TEST(TextureCookerTest, PicksFormatByRoleAndAlpha) {
+    const ImageData opaque = makeGradient(8, 8, false);
+    const ImageData translucent = makeGradient(8, 8, true);
+    Core::TextureCooker::Options options;
+    options.colorFormat = TextureFormat::BC1_RGBA_UNORM_BLOCK;
+
+    auto color = Core::TextureCooker::cook(opaque, Core::TextureRole::Color, options);
+    ASSERT_TRUE(color.ok());
+    EXPECT_EQ(color->format, TextureFormat::BC1_RGBA_UNORM_BLOCK);
+    EXPECT_EQ(color->mipLevels, 4u);
+
+    // 半透明图像不能用 BC1 的 1 位 alpha
+    auto alpha = Core::TextureCooker::cook(translucent, Core::TextureRole::Color, options);
+    ASSERT_TRUE(alpha.ok());
+    EXPECT_EQ(alpha->format, TextureFormat::BC3_UNORM_BLOCK);
+
+    auto normal = Core::TextureCooker::cook(opaque, Core::TextureRole::Normal);
+    ASSERT_TRUE(normal.ok());
+    EXPECT_EQ(normal->format, TextureFormat::BC5_UNORM_BLOCK);
+}
+
+} // namespace Nexus
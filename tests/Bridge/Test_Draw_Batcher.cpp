@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include "DrawBatcher.h"
+#include "JobSystem.h"
+
+namespace Nexus {
+
+TEST(DrawBatcherTest, MergesItemsSharingAMeshRange) {
+    DrawBatcher batcher;
+    batcher.add({1, 0, 36, 0, 7, 5.0f, 0});    // 32 位索引的盒子
+    batcher.add({0, 100, 6, 24, 3, 9.0f, 1});  // 16 位索引的平面
+    batcher.add({1, 0, 36, 0, 5, 2.0f, 2});    // 同一盒子, 不同材质
+    batcher.add({1, 36, 36, 24, 5, 1.0f, 3});  // 另一网格
+    batcher.add({1, 0, 36, 0, 5, 3.0f, 4});
+    batcher.build();
+
+    const auto& commands = batcher.getCommands();
+    ASSERT_EQ(commands.size(), 3u);
+    EXPECT_EQ(batcher.getGroupBegin(0), 0u);
+    EXPECT_EQ(batcher.getGroupBegin(1), 1u);
+    EXPECT_EQ(batcher.getGroupBegin(2), 3u);
+
+    EXPECT_EQ(commands[0].firstIndex, 100u);
+    EXPECT_EQ(commands[0].instanceCount, 1u);
+    EXPECT_EQ(commands[0].firstInstance, 0u);
+    // 分组 1 内: 另一网格的实例最近, 排在盒子批次之前
+    EXPECT_EQ(commands[1].firstIndex, 36u);
+    EXPECT_EQ(commands[1].vertexOffset, 24);
+    EXPECT_EQ(commands[1].firstInstance, 1u);
+    EXPECT_EQ(commands[2].indexCount, 36u);
+    EXPECT_EQ(commands[2].firstIndex, 0u);
+    EXPECT_EQ(commands[2].instanceCount, 3u);
+    EXPECT_EQ(commands[2].firstInstance, 2u);
+
+    // 批次内实例由近到远
+    EXPECT_EQ(batcher.getOrder(), (std::vector<uint32_t>{1, 3, 2, 4, 0}));
+}
+
+TEST(DrawBatcherTest, MaterialBreaksDepthTies) {
+    DrawBatcher batcher;
+    batcher.add({0, 0, 36, 0, 9, 4.0f, 0});
+    batcher.add({0, 0, 36, 0, 2, 4.0f, 1});
+    batcher.add({0, 0, 36, 0, 5, 4.0f, 2});
+    batcher.build();
+    ASSERT_EQ(batcher.getCommands().size(), 1u);
+    EXPECT_EQ(batcher.getOrder(), (std::vector<uint32_t>{1, 2, 0}));
+}
+
+TEST(DrawBatcherTest, ThousandsOfIdenticalItemsBecomeOneDraw) {
+    DrawBatcher batcher;
+    JobSystem jobs(3);
+    const uint32_t count = RadixSort::PARALLEL_THRESHOLD * 2;
+    batcher.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) batcher.add({1, 0, 36, 0, 0, (float)(count - i), i});
+    batcher.build(&jobs);
+    ASSERT_EQ(batcher.getCommands().size(), 1u);
+    EXPECT_EQ(batcher.getCommands()[0].instanceCount, count);
+    // 深度量化为 16 位, 远近相差较大的实例仍保持由近到远
+    EXPECT_EQ(batcher.getOrder().front(), count - 1);
+    EXPECT_EQ(batcher.getOrder().back(), 0u);
+
+    batcher.clear();
+    batcher.build();
+    EXPECT_TRUE(batcher.getCommands().empty());
+    EXPECT_EQ(batcher.getGroupBegin(1), 0u);
+}
+
+TEST(DrawBatcherTest, FieldsBeyondKeyBitsAreNotTruncated) {
+    // 分组号超出键中的位数: 截断后与分组 0 相同, 须改用完整字段排序且不合并
+    const uint32_t wideGroup = 1u << DrawBatcher::GROUP_BITS;
+    DrawBatcher batcher;
+    batcher.add({wideGroup, 0, 36, 0, 0, 1.0f, 0});
+    batcher.add({0, 0, 36, 0, 0, 3.0f, 1});
+    batcher.add({wideGroup, 0, 36, 0, 0, 2.0f, 2});
+    batcher.add({0, 0, 36, 0, 0, 4.0f, 3});
+    batcher.build();
+
+    const auto& commands = batcher.getCommands();
+    ASSERT_EQ(commands.size(), 2u);
+    EXPECT_EQ(commands[0].instanceCount, 2u);
+    EXPECT_EQ(commands[1].instanceCount, 2u);
+    EXPECT_EQ(batcher.getGroupBegin(1), 1u);
+    EXPECT_EQ(batcher.getGroupBegin(wideGroup), 1u);
+    EXPECT_EQ(batcher.getOrder(), (std::vector<uint32_t>{1, 3, 0, 2}));
+}
+
+} // namespace Nexus
@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+#include "Vk/VK_Context.h"
+#include "Vk/VK_Buffer.h"
+#include "Vk/VK_FrameTimeline.h"
+#include "Vk/VK_Texture.h"
+#include "Vk/VK_BindlessManager.h"
+
+namespace Nexus {
+
+class FrameTimelineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_context = std::make_unique<VK_Context>();
+        auto status = m_context->initialize();
+        if (!status.ok()) {
+            GTEST_SKIP() << "Vulkan instance not available: " << status.message();
+        }
+        status = m_context->initializeHeadless();
+        if (!status.ok()) {
+            GTEST_SKIP() << "Vulkan device not available: " << status.message();
+        }
+        vk::SemaphoreTypeCreateInfo typeInfo(vk::SemaphoreType::eTimeline, 0);
+        vk::SemaphoreCreateInfo createInfo;
+        createInfo.pNext = &typeInfo;
+        m_gate = m_context->getDevice().createSemaphore(createInfo).value;
+    }
+
+    void TearDown() override {
+        if (m_gate) {
+            openGate();
+            (void)m_context->getDevice().waitIdle();
+            m_context->getDevice().destroySemaphore(m_gate);
+        }
+        if (m_context) m_context->shutdown();
+    }
+
+    // 模拟一帧: 空提交等待闸门打开后信号帧时间线的下一个值
+    uint64_t submitGatedFrame() {
+        auto* timeline = m_context->getFrameTimeline();
+        const uint64_t value = timeline->nextValue();
+        const uint64_t gateValue = 1;
+        const vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eAllCommands;
+        const vk::Semaphore signal = timeline->getSemaphore();
+        vk::TimelineSemaphoreSubmitInfo timelineInfo(1, &gateValue, 1, &value);
+        vk::SubmitInfo submitInfo(1, &m_gate, &waitStage, 0, nullptr, 1, &signal);
+        submitInfo.pNext = &timelineInfo;
+        std::lock_guard<std::mutex> lock(m_context->getGraphicsQueueMutex());
+        EXPECT_EQ(m_context->getGraphicsQueue().submit(1, &submitInfo, nullptr), vk::Result::eSuccess);
+        return value;
+    }
+
+    void openGate() {
+        if (m_context->getDevice().getSemaphoreCounterValue(m_gate).value >= 1) return;
+        vk::SemaphoreSignalInfo signalInfo(m_gate, 1);
+        EXPECT_EQ(m_context->getDevice().signalSemaphore(signalInfo), vk::Result::eSuccess);
+    }
+
+    std::unique_ptr<VK_Context> m_context;
+    vk::Semaphore m_gate;
+};
+
+TEST_F(FrameTimelineTest, RetiredResourcesOutliveInFlightFrames) {
+    auto* timeline = m_context->getFrameTimeline();
+    ASSERT_NE(timeline, nullptr);
+    auto* allocator = m_context->getMemoryAllocator();
+    const uint32_t properties = (uint32_t)(vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+    // 没有在途帧时立即销毁
+    const auto before = allocator->getStats();
+    auto idle = m_context->createBuffer(256, (uint32_t)vk::BufferUsageFlagBits::eStorageBuffer, properties);
+    idle.reset();
+    EXPECT_EQ(allocator->getStats().allocationCount, before.allocationCount);
+
+    const uint64_t frame = submitGatedFrame();
+    EXPECT_EQ(timeline->getSubmittedValue(), frame);
+    EXPECT_FALSE(timeline->isComplete(frame));
+
+    auto buffer = m_context->createBuffer(256, (uint32_t)vk::BufferUsageFlagBits::eStorageBuffer, properties);
+    buffer.reset();
+    EXPECT_EQ(allocator->getStats().allocationCount, before.allocationCount + 1);
+    EXPECT_EQ(timeline->getRetiringCount(), 1u);
+
+    // 同步点不再等待设备空闲: 帧未完成时 sync 直接返回, 资源保留
+    m_context->sync();
+    EXPECT_EQ(timeline->getRetiringCount(), 1u);
+    EXPECT_EQ(m_context->getCompletedFrameValue(), frame - 1);
+
+    openGate();
+    ASSERT_TRUE(timeline->wait(frame).ok());
+    m_context->sync();
+    EXPECT_EQ(timeline->getRetiringCount(), 0u);
+    EXPECT_EQ(allocator->getStats().allocationCount, before.allocationCount);
+}
+
+TEST_F(FrameTimelineTest, HostSignalCompletesFailedSubmission) {
+    auto* timeline = m_context->getFrameTimeline();
+    const uint64_t gated = submitGatedFrame();
+    // 提交失败的帧由主机信号, 但须等之前的帧真正完成
+    const uint64_t failed = timeline->nextValue();
+    bool destroyed = false;
+    timeline->retire(failed, [&destroyed]() { destroyed = true; });
+    EXPECT_EQ(timeline->wait(gated, 1000).code(), absl::StatusCode::kDeadlineExceeded);
+
+    openGate();
+    ASSERT_TRUE(timeline->signal(failed).ok());
+    EXPECT_TRUE(timeline->isComplete(gated));
+    EXPECT_EQ(timeline->getCompletedValue(), failed);
+    EXPECT_EQ(timeline->collect(), 1u);
+    EXPECT_TRUE(destroyed);
+}
+
+TEST_F(FrameTimelineTest, ShutdownRunsPendingRetirements) {
+    auto* timeline = m_context->getFrameTimeline();
+    const uint64_t frame = submitGatedFrame();
+    bool destroyed = false;
+    timeline->retire(frame, [&destroyed]() { destroyed = true; });
+    EXPECT_FALSE(destroyed);
+
+    openGate();
+    timeline->shutdown();
+    EXPECT_TRUE(destroyed);
+}
+
+TEST_F(FrameTimelineTest, LiveSlotRewriteIsDeferredWhileFramesUseIt) {
+    ImageData pixel;
+    pixel.width = 1;
+    pixel.height = 1;
+    pixel.channels = 4;
+    pixel.pixels = {255, 0, 0, 255};
+    VK_Texture texture(m_context.get());
+    VK_Texture replacement(m_context.get());
+    ASSERT_TRUE(texture.create(pixel, TextureUsage::Sampled).ok());
+    ASSERT_TRUE(replacement.create(pixel, TextureUsage::Sampled).ok());
+    auto* bindless = m_context->getBindlessManager();
+    bindless->flushWrites();
+    const uint32_t slot = texture.getBindlessTextureIndex();
+
+    // 在途帧采样该槽位: flushWrites 不等待, 改写留在队列中
+    const uint64_t frame = submitGatedFrame();
+    const uint32_t used[] = {slot};
+    bindless->markTexturesUsed(used, frame);
+    bool replaced = false;
+    bindless->updateTexture(slot, replacement.getView(), [&replaced]() { replaced = true; });
+    bindless->flushWrites();
+    EXPECT_FALSE(replaced);
+    EXPECT_EQ(bindless->getStats().lastFlushWrites, 0u);
+    m_context->sync();
+    EXPECT_FALSE(replaced);
+
+    // 帧完成后的下一次 flushWrites 改写, 回调随之执行
+    openGate();
+    ASSERT_TRUE(m_context->getFrameTimeline()->wait(frame).ok());
+    bindless->flushWrites();
+    EXPECT_TRUE(replaced);
+    EXPECT_EQ(bindless->getStats().lastFlushWrites, 1u);
+}
+
+TEST_F(FrameTimelineTest, DeferredRewriteIsSampledThroughShadowSlot) {
+    ImageData pixel;
+    pixel.width = 1;
+    pixel.height = 1;
+    pixel.channels = 4;
+    pixel.pixels = {0, 0, 255, 255};
+    VK_Texture texture(m_context.get());
+    VK_Texture replacement(m_context.get());
+    ASSERT_TRUE(texture.create(pixel, TextureUsage::Sampled).ok());
+    ASSERT_TRUE(replacement.create(pixel, TextureUsage::Sampled).ok());
+    auto* bindless = m_context->getBindlessManager();
+    bindless->flushWrites();
+    const uint32_t slot = texture.getBindlessTextureIndex();
+
+    // 有渲染器时: 原槽位仍被在途帧采样, 新 view 写入影子槽位, 之后的帧改为采样影子槽位
+    bindless->setDeferLiveWrites(true);
+    const uint64_t frame = submitGatedFrame();
+    const uint32_t used[] = {slot};
+    bindless->markTexturesUsed(used, frame);
+    bool replaced = false;
+    bindless->updateTexture(slot, replacement.getView(), [&replaced]() { replaced = true; });
+    bindless->flushWrites();
+    EXPECT_FALSE(replaced);
+    EXPECT_EQ(bindless->getStats().lastFlushWrites, 1u);
+    std::vector<uint32_t> table;
+    bindless->getTextureSlotTable(table);
+    ASSERT_EQ(table.size(), VK_BindlessManager::MAX_TEXTURES);
+    const uint32_t shadow = table[slot];
+    EXPECT_NE(shadow, slot);
+    EXPECT_EQ(table[replacement.getBindlessTextureIndex()], replacement.getBindlessTextureIndex());
+
+    // 同一 view 不再重复建影子槽位
+    bindless->flushWrites();
+    bindless->getTextureSlotTable(table);
+    EXPECT_EQ(table[slot], shadow);
+    EXPECT_EQ(bindless->getStats().lastFlushWrites, 0u);
+
+    openGate();
+    ASSERT_TRUE(m_context->getFrameTimeline()->wait(frame).ok());
+    bindless->flushWrites();
+    EXPECT_TRUE(replaced);
+    bindless->getTextureSlotTable(table);
+    EXPECT_EQ(table[slot], slot);
+    bindless->setDeferLiveWrites(false);
+}
+
+TEST_F(FrameTimelineTest, ReleasedSlotsWaitForSubmittedFrames) {
+    auto* bindless = m_context->getBindlessManager();
+    ImageData pixel;
+    pixel.width = 1;
+    pixel.height = 1;
+    pixel.channels = 4;
+    pixel.pixels = {0, 255, 0, 255};
+    auto texture = std::make_unique<VK_Texture>(m_context.get());
+    ASSERT_TRUE(texture->create(pixel, TextureUsage::Sampled).ok());
+    const uint32_t freed = texture->getBindlessTextureIndex();
+    const uint64_t frame = submitGatedFrame();
+    texture.reset();
+    // 释放时已提交的帧未完成: 无论经过多少个同步点都不复用
+    for (int i = 0; i < 4; ++i) m_context->sync();
+    EXPECT_EQ(bindless->getStats().texturesPendingFree, 1u);
+
+    openGate();
+    ASSERT_TRUE(m_context->getFrameTimeline()->wait(frame).ok());
+    m_context->sync();
+    EXPECT_EQ(bindless->getStats().texturesPendingFree, 0u);
+    VK_Texture reused(m_context.get());
+    ASSERT_TRUE(reused.create(pixel, TextureUsage::Sampled).ok());
+    EXPECT_EQ(reused.getBindlessTextureIndex(), freed);
+}
+
+} // namespace Nexus
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "FrustumCuller.h"
+#include "JobSystem.h"
+#include <cmath>
+#include <future>
+#include <random>
+#include <vector>
+
+namespace Nexus {
+
+namespace {
+
+constexpr std::array<float, 16> IDENTITY = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+
+// 单位 viewProj 的视锥: x, y in [-1, 1], z in [0, 1]
+bool referenceVisible(const std::array<float, 3>& min, const std::array<float, 3>& max) {
+    return max[0] >= -1.0f && min[0] <= 1.0f && max[1] >= -1.0f && min[1] <= 1.0f && max[2] >= 0.0f && min[2] <= 1.0f;
+}
+
+std::array<float, 4> boundingSphere(const std::array<float, 3>& min, const std::array<float, 3>& max) {
+    const float ex = max[0] - min[0], ey = max[1] - min[1], ez = max[2] - min[2];
+    return {(min[0] + max[0]) * 0.5f, (min[1] + max[1]) * 0.5f, (min[2] + max[2]) * 0.5f, 0.5f * std::sqrt(ex * ex + ey * ey + ez * ez)};
+}
+
+} // namespace
+
+TEST(FrustumCullerTest, RejectsObjectsOutsideAnyPlane) {
+    FrustumCuller culler;
+    auto addBox = [&](std::array<float, 3> min, std::array<float, 3> max) { return culler.add(boundingSphere(min, max), min, max); };
+    addBox({-0.1f, -0.1f, 0.4f}, {0.1f, 0.1f, 0.6f}); // 0: 视锥中心
+    addBox({1.5f, -0.1f, 0.4f}, {1.7f, 0.1f, 0.6f});  // 1: 右侧之外
+    addBox({-0.1f, -0.1f, 1.2f}, {0.1f, 0.1f, 1.4f}); // 2: 远平面之外
+    addBox({0.9f, 0.9f, 0.5f}, {1.1f, 1.1f, 0.6f});   // 3: 跨越右上角
+    culler.addUnbounded();                            // 4: 无包围体
+    addBox({-3.0f, -0.1f, -0.6f}, {-2.0f, 0.1f, -0.4f}); // 5: 左侧与近平面之外
+
+    const auto& visible = culler.cull(IDENTITY);
+    EXPECT_EQ(visible, (std::vector<uint32_t>{0, 3, 4}));
+}
+
+TEST(FrustumCullerTest, AabbTestRejectsWhatTheSphereAccepts) {
+    // 细长盒子在右上角之外, 包围球仍与视锥相交
+    FrustumCuller culler;
+    std::array<float, 3> min = {1.05f, 1.05f, 0.4f}, max = {1.1f, 1.1f, 0.6f};
+    std::array<float, 4> sphere = boundingSphere(min, max);
+    sphere[3] = 0.5f;
+    culler.add(sphere, min, max);
+    EXPECT_TRUE(culler.cull(IDENTITY).empty());
+}
+
+TEST(FrustumCullerTest, ParallelCullingMatchesReference) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> position(-3.0f, 3.0f);
+    std::uniform_real_distribution<float> size(0.01f, 0.5f);
+
+    FrustumCuller culler;
+    std::vector<uint32_t> expected;
+    const uint32_t count = FrustumCuller::CHUNK_SIZE * 5 + 3; // 多块且末尾不足 4 个
+    culler.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        std::array<float, 3> min = {position(rng), position(rng), position(rng)};
+        std::array<float, 3> max = {min[0] + size(rng), min[1] + size(rng), min[2] + size(rng)};
+        culler.add(boundingSphere(min, max), min, max);
+        if (referenceVisible(min, max)) expected.push_back(i);
+    }
+
+    JobSystem jobs(3);
+    EXPECT_EQ(culler.cull(IDENTITY, &jobs), expected);
+    EXPECT_EQ(culler.cull(IDENTITY), expected);
+
+    culler.clear();
+    EXPECT_EQ(culler.size(), 0u);
+    EXPECT_TRUE(culler.cull(IDENTITY, &jobs).empty());
+}
+
+TEST(FrustumCullerTest, ParallelCullingDoesNotWaitBehindQueuedJobs) {
+    // 唯一的工作线程被后台任务占住: 剔除须由调用线程独自完成
+    JobSystem jobs(1);
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    jobs.submit([gate]() { gate.wait(); });
+
+    FrustumCuller culler;
+    const uint32_t count = FrustumCuller::CHUNK_SIZE * 3;
+    for (uint32_t i = 0; i < count; ++i) {
+        const float x = (i % 2 == 0) ? 0.0f : 5.0f; // 偶数项在视锥内
+        culler.add(boundingSphere({x, 0.0f, 0.5f}, {x + 0.1f, 0.1f, 0.6f}), {x, 0.0f, 0.5f}, {x + 0.1f, 0.1f, 0.6f});
+    }
+    auto culled = std::async(std::launch::async, [&]() { return culler.cull(IDENTITY, &jobs).size(); });
+    const bool finished = culled.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+    release.set_value();
+    ASSERT_TRUE(finished);
+    EXPECT_EQ(culled.get(), count / 2);
+}
+
+} // namespace Nexus
@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include "Vk/VK_Context.h"
+#include "Vk/VK_Buffer.h"
+#include "Vk/VK_BindlessManager.h"
+#include "Vk/VK_GpuCuller.h"
+#include "Vk/VK_UploadContext.h"
+#include <cstring>
+
+namespace Nexus {
+
+namespace {
+
+constexpr std::array<float, 16> IDENTITY = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+
+std::array<float, 16> translation(float x, float y, float z) {
+    auto m = IDENTITY;
+    m[12] = x;
+    m[13] = y;
+    m[14] = z;
+    return m;
+}
+
+} // namespace
+
+class GpuCullingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_context = std::make_unique<VK_Context>();
+        auto status = m_context->initialize();
+        if (!status.ok()) {
+            GTEST_SKIP() << "Vulkan instance not available: " << status.message();
+        }
+        status = m_context->initializeHeadless();
+        if (!status.ok()) {
+            GTEST_SKIP() << "Vulkan device not available: " << status.message();
+        }
+        m_culler = std::make_unique<VK_GpuCuller>(m_context.get());
+        status = m_culler->initialize(1);
+        if (!status.ok()) {
+            GTEST_SKIP() << "Cull shaders not available: " << status.message();
+        }
+    }
+
+    void TearDown() override {
+        if (m_context && m_context->getDevice()) (void)m_context->getDevice().waitIdle();
+        m_culler.reset();
+        if (m_instanceBuffer) {
+            m_context->getBindlessManager()->releaseStorageBuffer(m_instanceIndex);
+            m_context->getBindlessManager()->releaseStorageBuffer(m_visibleIndex);
+            m_instanceBuffer.reset();
+            m_visibleBuffer.reset();
+        }
+        if (m_depthView) m_context->getDevice().destroyImageView(m_depthView);
+        if (m_depthImage) m_context->getDevice().destroyImage(m_depthImage);
+        if (m_depthAllocation) m_context->getMemoryAllocator()->free(m_depthAllocation);
+    }
+
+    // 实例缓冲区只含 world 矩阵 (跨度 64 字节); 另建同样实例数的可见实例索引缓冲区
+    void uploadInstances(const std::vector<std::array<float, 16>>& worlds) {
+        const auto host = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+        m_instanceBuffer = std::make_unique<VK_Buffer>(m_context.get());
+        ASSERT_TRUE(m_instanceBuffer->create(worlds.size() * sizeof(worlds[0]), vk::BufferUsageFlagBits::eStorageBuffer, host).ok());
+        std::memcpy(m_instanceBuffer->map(), worlds.data(), worlds.size() * sizeof(worlds[0]));
+        m_visibleBuffer = std::make_unique<VK_Buffer>(m_context.get());
+        ASSERT_TRUE(m_visibleBuffer->create(worlds.size() * sizeof(uint32_t), vk::BufferUsageFlagBits::eStorageBuffer, host).ok());
+        std::memset(m_visibleBuffer->map(), 0xFF, worlds.size() * sizeof(uint32_t));
+        auto index = m_context->getBindlessManager()->registerStorageBuffer(m_instanceBuffer->getHandle());
+        ASSERT_TRUE(index.ok());
+        m_instanceIndex = *index;
+        index = m_context->getBindlessManager()->registerStorageBuffer(m_visibleBuffer->getHandle());
+        ASSERT_TRUE(index.ok());
+        m_visibleIndex = *index;
+    }
+
+    uint32_t visibleInstance(uint32_t slot) const {
+        return static_cast<const uint32_t*>(m_visibleBuffer->map())[slot];
+    }
+
+    void submit(const std::function<void(vk::CommandBuffer)>& record) {
+        m_context->getBindlessManager()->flushWrites();
+        auto* upload = m_context->getUploadContext();
+        auto ticket = upload->submitGraphics(record);
+        ASSERT_TRUE(ticket.ok());
+        ASSERT_TRUE(upload->wait(*ticket).ok());
+    }
+
+    // 按 bounds 的 batch 生成实例化命令 (同一批次的实例须相邻)
+    void cull(std::vector<VK_GpuCuller::InstanceBounds> bounds) {
+        std::vector<DrawIndexedIndirectCommand> commands;
+        for (uint32_t i = 0; i < bounds.size(); ++i) {
+            if (bounds[i].batch == commands.size()) commands.push_back({3, 0, 0, 0, i});
+            commands[bounds[i].batch].instanceCount++;
+        }
+        ASSERT_TRUE(m_culler->prepare(0, bounds, commands, m_instanceIndex, sizeof(IDENTITY), m_visibleIndex, IDENTITY).ok());
+        submit([&](vk::CommandBuffer cmd) {
+            m_culler->recordCull(cmd, 0);
+            vk::MemoryBarrier hostBarrier(vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eHostRead);
+            cmd.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eHost, {}, 1, &hostBarrier, 0, nullptr, 0, nullptr);
+        });
+    }
+
+    std::unique_ptr<VK_Context> m_context;
+    std::unique_ptr<VK_GpuCuller> m_culler;
+    std::unique_ptr<VK_Buffer> m_instanceBuffer;
+    std::unique_ptr<VK_Buffer> m_visibleBuffer;
+    uint32_t m_instanceIndex = 0;
+    uint32_t m_visibleIndex = 0;
+    vk::Image m_depthImage;
+    vk::ImageView m_depthView;
+    VK_MemoryAllocator::Allocation m_depthAllocation;
+};
+
+TEST_F(GpuCullingTest, FrustumCullingCompactsVisibleInstances) {
+    // 单位 viewProj: 视锥为 x,y in [-1,1], z in [0,1]; 批次 0 含实例 0..2, 批次 1 含实例 3
+    uploadInstances({translation(5.0f, 0.0f, 0.0f), IDENTITY, translation(0.0f, -5.0f, 0.0f), IDENTITY});
+    VK_GpuCuller::InstanceBounds box{{-0.1f, -0.1f, 0.4f}, 0, {0.1f, 0.1f, 0.6f}, 0.0f};
+    VK_GpuCuller::InstanceBounds unbounded{{1.0f, 1.0f, 1.0f}, 1, {-1.0f, -1.0f, -1.0f}, 0.0f};
+    cull({box, box, box, unbounded});
+
+    const auto stats = m_culler->getStats(0);
+    EXPECT_EQ(stats.total, 4u);
+    EXPECT_EQ(stats.visible, 2u);
+    EXPECT_EQ(stats.frustumCulled, 2u);
+    EXPECT_EQ(stats.occlusionCulled, 0u);
+    // 各批次的可见实例写在其实例区间的开头
+    EXPECT_EQ(visibleInstance(0), 1u);
+    EXPECT_EQ(visibleInstance(3), 3u);
+}
+
+TEST_F(GpuCullingTest, DepthPyramidOccludesInstancesBehindNearerDepth) {
+    const vk::Format format = vk::Format::eD32Sfloat;
+    const uint32_t size = 64;
+    vk::ImageCreateInfo imageInfo({}, vk::ImageType::e2D, format, vk::Extent3D(size, size, 1), 1, 1, vk::SampleCountFlagBits::e1,
+                                  vk::ImageTiling::eOptimal,
+                                  vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst);
+    auto image = m_context->getDevice().createImage(imageInfo);
+    ASSERT_EQ(image.result, vk::Result::eSuccess);
+    m_depthImage = image.value;
+    auto allocation = m_context->getMemoryAllocator()->allocateForImage(m_depthImage, vk::MemoryPropertyFlagBits::eDeviceLocal);
+    ASSERT_TRUE(allocation.ok());
+    m_depthAllocation = *allocation;
+    const vk::ImageSubresourceRange range(vk::ImageAspectFlagBits::eDepth, 0, 1, 0, 1);
+    auto view = m_context->getDevice().createImageView(vk::ImageViewCreateInfo({}, m_depthImage, vk::ImageViewType::e2D, format, {}, range));
+    ASSERT_EQ(view.result, vk::Result::eSuccess);
+    m_depthView = view.value;
+
+    ASSERT_TRUE(m_culler->setDepthSource(m_depthImage, m_depthView, format, size, size).ok());
+    if (!m_culler->isOcclusionEnabled()) GTEST_SKIP() << "Depth format cannot be sampled";
+
+    // 整幅深度为 0.3: z 在 0.3 之后的包围盒被遮挡
+    submit([&](vk::CommandBuffer cmd) {
+        vk::ImageMemoryBarrier barrier({}, vk::AccessFlagBits::eTransferWrite, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal,
+                                       VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, m_depthImage, range);
+        cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer, {}, 0, nullptr, 0, nullptr, 1, &barrier);
+        cmd.clearDepthStencilImage(m_depthImage, vk::ImageLayout::eTransferDstOptimal, vk::ClearDepthStencilValue(0.3f, 0), range);
+        m_culler->recordDepthPyramid(cmd, IDENTITY, vk::ImageLayout::eTransferDstOptimal);
+    });
+
+    uploadInstances({IDENTITY, IDENTITY});
+    VK_GpuCuller::InstanceBounds behind{{-0.1f, -0.1f, 0.45f}, 0, {0.1f, 0.1f, 0.55f}, 0.0f};
+    VK_GpuCuller::InstanceBounds inFront{{-0.1f, -0.1f, 0.1f}, 0, {0.1f, 0.1f, 0.2f}, 0.0f};
+    cull({behind, inFront});
+
+    const auto stats = m_culler->getStats(0);
+    EXPECT_EQ(stats.total, 2u);
+    EXPECT_EQ(stats.visible, 1u);
+    EXPECT_EQ(stats.frustumCulled, 0u);
+    EXPECT_EQ(stats.occlusionCulled, 1u);
+    EXPECT_EQ(visibleInstance(0), 1u);
+}
+
+} // namespace Nexus
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include "Vk/VK_Context.h"
+#include "Vk/VK_Buffer.h"
+#include "Vk/VK_GpuProfiler.h"
+
+using namespace Nexus;
+
+class GpuProfilerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_context = std::make_unique<VK_Context>();
+        auto status = m_context->initialize();
+        if (!status.ok()) {
+            GTEST_SKIP() << "Vulkan instance not available: " << status.message();
+        }
+        status = m_context->initializeHeadless();
+        if (!status.ok()) {
+            GTEST_SKIP() << "Vulkan device not available: " << status.message();
+        }
+        m_profiler = std::make_unique<VK_GpuProfiler>(m_context.get());
+        status = m_profiler->initialize(2, true);
+        if (absl::IsUnimplemented(status)) {
+            GTEST_SKIP() << status.message();
+        }
+        ASSERT_TRUE(status.ok()) << status.message();
+        // transfer dst
+        m_buffer = m_context->createBuffer(BUFFER_SIZE, 0x0002, (uint32_t)vk::MemoryPropertyFlagBits::eDeviceLocal);
+        ASSERT_TRUE(m_buffer != nullptr);
+    }
+
+    void TearDown() override {
+        if (m_context && m_context->getDevice()) (void)m_context->getDevice().waitIdle();
+        m_profiler.reset();
+        m_buffer.reset();
+        if (m_context) m_context->shutdown();
+    }
+
+    // 在帧槽位 frame 上录制一帧: 两个 fillBuffer 区间, 第二个带管线统计; 返回 beginFrame 是否读回了上一次的结果
+    bool recordFrame(uint32_t frame, bool submit = true) {
+        auto device = m_context->getDevice();
+        vk::CommandBufferAllocateInfo allocInfo(m_context->getCommandPool(), vk::CommandBufferLevel::ePrimary, 1);
+        vk::CommandBuffer cmd = device.allocateCommandBuffers(allocInfo).value[0];
+        (void)cmd.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+        const bool resolved = m_profiler->beginFrame(cmd, frame);
+
+        const vk::Buffer buffer = static_cast<VK_Buffer*>(m_buffer.get())->getHandle();
+        const uint32_t fill = m_profiler->beginScope(cmd, "Fill");
+        cmd.fillBuffer(buffer, 0, BUFFER_SIZE, 0x12345678);
+        m_profiler->endScope(cmd, fill);
+        const uint32_t refill = m_profiler->beginScope(cmd, "Refill", true);
+        cmd.fillBuffer(buffer, 0, BUFFER_SIZE, 0);
+        m_profiler->endScope(cmd, refill);
+        (void)cmd.end();
+
+        if (submit) {
+            vk::SubmitInfo submitInfo({}, {}, {}, 1, &cmd);
+            EXPECT_EQ(m_context->getGraphicsQueue().submit(submitInfo), vk::Result::eSuccess);
+            (void)m_context->getGraphicsQueue().waitIdle();
+        }
+        device.freeCommandBuffers(m_context->getCommandPool(), 1, &cmd);
+        return resolved;
+    }
+
+    static constexpr uint64_t BUFFER_SIZE = 16 * 1024 * 1024;
+    std::unique_ptr<VK_Context> m_context;
+    std::unique_ptr<VK_GpuProfiler> m_profiler;
+    std::unique_ptr<IBuffer> m_buffer;
+};
+
+TEST_F(GpuProfilerTest, ResolvesPassTimingsWhenSlotIsReused) {
+    VK_GpuProfiler::FrameTimings timings;
+    EXPECT_FALSE(m_profiler->getLatest(timings));
+
+    EXPECT_FALSE(recordFrame(0));
+    EXPECT_FALSE(recordFrame(1));
+    EXPECT_FALSE(m_profiler->getLatest(timings));
+
+    // 槽位 0 复用时读回第一帧的结果
+    EXPECT_TRUE(recordFrame(0));
+    ASSERT_TRUE(m_profiler->getLatest(timings));
+    EXPECT_EQ(timings.frameNumber, 1u);
+    ASSERT_EQ(timings.passes.size(), 2u);
+    EXPECT_EQ(timings.passes[0].name, "Fill");
+    EXPECT_EQ(timings.passes[1].name, "Refill");
+    EXPECT_DOUBLE_EQ(timings.passes[0].startMs, 0.0);
+    EXPECT_GE(timings.passes[1].startMs, timings.passes[0].startMs);
+    for (const auto& pass : timings.passes) {
+        EXPECT_GE(pass.durationMs, 0.0);
+        EXPECT_LT(pass.durationMs, 10000.0);
+        EXPECT_LE(pass.startMs + pass.durationMs, timings.gpuMs + 1e-9);
+    }
+
+    EXPECT_FALSE(timings.passes[0].hasStatistics);
+    EXPECT_EQ(timings.passes[1].hasStatistics, m_profiler->hasPipelineStatistics());
+    if (timings.passes[1].hasStatistics) {
+        // 传输命令不经过任何着色器阶段
+        EXPECT_EQ(timings.passes[1].statistics.vertexShaderInvocations, 0u);
+        EXPECT_EQ(timings.passes[1].statistics.fragmentShaderInvocations, 0u);
+        EXPECT_EQ(timings.passes[1].statistics.computeShaderInvocations, 0u);
+    }
+}
+
+TEST_F(GpuProfilerTest, DiscardedFrameIsNotResolved) {
+    // 提交失败的帧: 查询既未重置也未写入, 复用槽位时不得读回
+    EXPECT_FALSE(recordFrame(0, false));
+    m_profiler->discardFrame(0);
+    EXPECT_FALSE(recordFrame(0));
+    VK_GpuProfiler::FrameTimings timings;
+    EXPECT_FALSE(m_profiler->getLatest(timings));
+
+    EXPECT_TRUE(recordFrame(0));
+    ASSERT_TRUE(m_profiler->getLatest(timings));
+    EXPECT_EQ(timings.frameNumber, 2u);
+}
+
+TEST_F(GpuProfilerTest, ScopesBeyondCapacityAreIgnored) {
+    auto device = m_context->getDevice();
+    vk::CommandBufferAllocateInfo allocInfo(m_context->getCommandPool(), vk::CommandBufferLevel::ePrimary, 1);
+    vk::CommandBuffer cmd = device.allocateCommandBuffers(allocInfo).value[0];
+    (void)cmd.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    m_profiler->beginFrame(cmd, 0);
+    for (uint32_t i = 0; i < VK_GpuProfiler::MAX_SCOPES; ++i) {
+        const uint32_t scope = m_profiler->beginScope(cmd, "Scope");
+        EXPECT_EQ(scope, i);
+        m_profiler->endScope(cmd, scope);
+    }
+    const uint32_t overflow = m_profiler->beginScope(cmd, "Overflow");
+    EXPECT_EQ(overflow, VK_GpuProfiler::INVALID_SCOPE);
+    m_profiler->endScope(cmd, overflow);
+    (void)cmd.end();
+    vk::SubmitInfo submitInfo({}, {}, {}, 1, &cmd);
+    EXPECT_EQ(m_context->getGraphicsQueue().submit(submitInfo), vk::Result::eSuccess);
+    (void)m_context->getGraphicsQueue().waitIdle();
+    device.freeCommandBuffers(m_context->getCommandPool(), 1, &cmd);
+
+    EXPECT_TRUE(recordFrame(0));
+    VK_GpuProfiler::FrameTimings timings;
+    ASSERT_TRUE(m_profiler->getLatest(timings));
+    EXPECT_EQ(timings.passes.size(), VK_GpuProfiler::MAX_SCOPES);
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include "Vk/VK_Context.h"
+#include "Vk/VK_Buffer.h"
+#include "Vk/VK_MemoryAllocator.h"
+#include <cstring>
+#include <set>
+
+namespace Nexus {
+
+class MemoryAllocatorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_context = std::make_unique<VK_Context>();
+        auto status = m_context->initialize();
+        if (!status.ok()) {
+            GTEST_SKIP() << "Vulkan instance not available: " << status.message();
+        }
+        status = m_context->initializeHeadless();
+        if (!status.ok()) {
+            GTEST_SKIP() << "Vulkan device not available: " << status.message();
+        }
+    }
+
+    std::unique_ptr<VK_Context> m_context;
+};
+
+TEST_F(MemoryAllocatorTest, SmallBuffersShareDeviceMemoryBlocks) {
+    auto* allocator = m_context->getMemoryAllocator();
+    ASSERT_NE(allocator, nullptr);
+    const auto before = allocator->getStats();
+
+    const uint32_t properties = (uint32_t)(vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+    std::vector<std::unique_ptr<IBuffer>> buffers;
+    std::set<vk::DeviceMemory> memories;
+    for (int i = 0; i < 256; ++i) {
+        buffers.push_back(m_context->createBuffer(4096, (uint32_t)vk::BufferUsageFlagBits::eVertexBuffer, properties));
+        memories.insert(static_cast<VK_Buffer*>(buffers.back().get())->getMemory());
+    }
+    // 256 个缓冲区只占用一个 (或极少数) VkDeviceMemory
+    EXPECT_LE(memories.size(), 2u);
+    const auto during = allocator->getStats();
+    EXPECT_EQ(during.allocationCount, before.allocationCount + 256);
+    EXPECT_LE(during.deviceMemoryCount, before.deviceMemoryCount + 2);
+
+    // 持久映射: 每个缓冲区地址互不重叠, 写入互不干扰
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        uint32_t value = (uint32_t)i;
+        ASSERT_TRUE(buffers[i]->uploadData(&value, sizeof(value), 0).ok());
+    }
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        uint32_t value = 0;
+        std::memcpy(&value, buffers[i]->map(), sizeof(value));
+        EXPECT_EQ(value, (uint32_t)i);
+    }
+
+    buffers.clear();
+    EXPECT_EQ(allocator->getStats().allocationCount, before.allocationCount);
+}
+
+TEST_F(MemoryAllocatorTest, LargeResourcesGetDedicatedMemory) {
+    auto* allocator = m_context->getMemoryAllocator();
+    const auto before = allocator->getStats();
+    vk::MemoryRequirements requirements;
+    requirements.size = VK_MemoryAllocator::DEFAULT_BLOCK_SIZE;
+    requirements.alignment = 256;
+    requirements.memoryTypeBits = ~0u;
+
+    auto allocation = allocator->allocate(requirements, vk::MemoryPropertyFlagBits::eDeviceLocal, VK_MemoryAllocator::Usage::Buffer);
+    ASSERT_TRUE(allocation.ok());
+    EXPECT_EQ(allocation->block, nullptr);
+    EXPECT_EQ(allocation->offset, 0u);
+    EXPECT_EQ(allocator->getStats().dedicatedCount, before.dedicatedCount + 1);
+    allocator->free(*allocation);
+    EXPECT_FALSE((bool)*allocation);
+    EXPECT_EQ(allocator->getStats().dedicatedCount, before.dedicatedCount);
+}
+
+TEST_F(MemoryAllocatorTest, TransientAllocationsAreLinearAndReset) {
+    auto* allocator = m_context->getMemoryAllocator();
+    vk::MemoryRequirements requirements;
+    requirements.size = 1000;
+    requirements.alignment = 64;
+    requirements.memoryTypeBits = ~0u;
+    const auto host = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+
+    auto a = allocator->allocate(requirements, host, VK_MemoryAllocator::Usage::Transient);
+    auto b = allocator->allocate(requirements, host, VK_MemoryAllocator::Usage::Transient);
+    ASSERT_TRUE(a.ok() && b.ok());
+    EXPECT_EQ(a->memory, b->memory);
+    EXPECT_EQ(b->offset, a->offset + 1024);
+    EXPECT_EQ(b->mapped, a->mapped + 1024);
+    allocator->free(*a);
+    allocator->free(*b);
+
+    // 线性块全部释放后从头开始
+    auto c = allocator->allocate(requirements, host, VK_MemoryAllocator::Usage::Transient);
+    ASSERT_TRUE(c.ok());
+    EXPECT_EQ(c->offset, 0u);
+    allocator->free(*c);
+}
+
+TEST_F(MemoryAllocatorTest, ReportsHeapBudgets) {
+    auto heaps = m_context->getMemoryAllocator()->getHeapBudgets();
+    ASSERT_FALSE(heaps.empty());
+    bool anyDeviceLocal = false;
+    for (const auto& heap : heaps) {
+        EXPECT_GT(heap.size, 0u);
+        EXPECT_GT(heap.budget, 0u);
+        anyDeviceLocal |= heap.deviceLocal;
+    }
+    EXPECT_TRUE(anyDeviceLocal);
+}
+
+} // namespace Nexus
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include "Vk/VK_Context.h"
+#include "Vk/VK_Texture.h"
+#include "Vk/VK_Buffer.h"
+#include "Vk/VK_CommandBuffer.h"
+#include "Vk/VK_SecondaryRecorder.h"
+#include "JobSystem.h"
+#include "Log.h"
+#include <chrono>
+#include <memory>
+#include <thread>
+
+using namespace Nexus;
+
+namespace {
+
+constexpr uint32_t WIDTH = 64;
+constexpr uint32_t HEIGHT = 64;
+
+// 用单像素 clearAttachments 代替绘制: 第 d 次 "绘制" 写第 d % (WIDTH * HEIGHT) 个像素, 颜色编码 d
+void recordClears(vk::CommandBuffer cmd, uint32_t first, uint32_t count) {
+    for (uint32_t d = first; d < first + count; ++d) {
+        const uint32_t pixel = d % (WIDTH * HEIGHT);
+        vk::ClearAttachment clear(vk::ImageAspectFlagBits::eColor, 0,
+                                  vk::ClearValue(std::array<float, 4>{(d & 0xFF) / 255.0f, ((d >> 8) & 0xFF) / 255.0f, ((d >> 16) & 0xFF) / 255.0f, 1.0f}));
+        vk::ClearRect rect(vk::Rect2D({(int32_t)(pixel % WIDTH), (int32_t)(pixel / WIDTH)}, {1, 1}), 0, 1);
+        cmd.clearAttachments(1, &clear, 1, &rect);
+    }
+}
+
+} // namespace
+
+class ParallelRecordingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_context = std::make_unique<VK_Context>();
+        auto status = m_context->initialize();
+        if (!status.ok()) {
+            GTEST_SKIP() << "Vulkan instance not available: " << status.message();
+        }
+        status = m_context->initializeHeadless();
+        if (!status.ok()) {
+            GTEST_SKIP() << "Vulkan device not available: " << status.message();
+        }
+        m_recorder = std::make_unique<VK_SecondaryRecorder>(m_context.get());
+        ASSERT_TRUE(m_recorder->initialize(1).ok());
+        m_target = m_context->createTexture(WIDTH, HEIGHT, TextureFormat::R8G8B8A8_UNORM, TextureUsage::Attachment);
+        ASSERT_TRUE(m_target != nullptr);
+        m_readback = m_context->createBuffer(WIDTH * HEIGHT * 4, 0x0002, 0x0006);
+        ASSERT_TRUE(m_readback != nullptr);
+    }
+
+    void TearDown() override {
+        if (m_context && m_context->getDevice()) (void)m_context->getDevice().waitIdle();
+        m_recorder.reset();
+        m_target.reset();
+        m_readback.reset();
+        if (m_context) m_context->shutdown();
+    }
+
+    // 把 drawCount 次绘制切成 taskCount 段录制, 返回录制耗时 (毫秒)
+    double record(JobSystem* jobs, uint32_t drawCount, uint32_t taskCount, std::vector<vk::CommandBuffer>& secondaries) {
+        std::vector<VK_SecondaryRecorder::Task> tasks;
+        const uint32_t perTask = (drawCount + taskCount - 1) / taskCount;
+        for (uint32_t first = 0; first < drawCount; first += perTask) {
+            const uint32_t count = std::min(perTask, drawCount - first);
+            tasks.push_back({[first, count](vk::CommandBuffer cmd) { recordClears(cmd, first, count); }});
+        }
+        const VK_SecondaryRecorder::Formats formats{vk::Format::eR8G8B8A8Unorm, vk::Format::eUndefined};
+        const auto start = std::chrono::steady_clock::now();
+        EXPECT_TRUE(m_recorder->record(0, tasks, formats, jobs, secondaries).ok());
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // 在以 eContentsSecondaryCommandBuffers 开始的渲染 pass 内依次执行二级命令缓冲区并读回
+    const uint8_t* execute(const std::vector<vk::CommandBuffer>& secondaries) {
+        auto device = m_context->getDevice();
+        vk::CommandBufferAllocateInfo allocInfo(m_context->getCommandPool(), vk::CommandBufferLevel::ePrimary, 1);
+        vk::CommandBuffer vkCmd = device.allocateCommandBuffers(allocInfo).value[0];
+        VK_CommandBuffer cmd(vkCmd);
+        cmd.begin();
+        cmd.transitionImageLayout(m_target.get(), ImageLayout::Undefined, ImageLayout::ColorAttachmentOptimal);
+
+        vk::RenderingAttachmentInfo colorAttachment;
+        colorAttachment.imageView = static_cast<VK_Texture*>(m_target.get())->getView();
+        colorAttachment.imageLayout = vk::ImageLayout::eColorAttachmentOptimal;
+        colorAttachment.loadOp = vk::AttachmentLoadOp::eClear;
+        colorAttachment.storeOp = vk::AttachmentStoreOp::eStore;
+        colorAttachment.clearValue = vk::ClearValue(std::array<float, 4>{0.0f, 0.0f, 0.0f, 0.0f});
+        vk::RenderingInfo renderingInfo;
+        renderingInfo.flags = vk::RenderingFlagBits::eContentsSecondaryCommandBuffers;
+        renderingInfo.renderArea = vk::Rect2D({0, 0}, {WIDTH, HEIGHT});
+        renderingInfo.layerCount = 1;
+        renderingInfo.colorAttachmentCount = 1;
+        renderingInfo.pColorAttachments = &colorAttachment;
+        vkCmd.beginRendering(&renderingInfo);
+        vkCmd.executeCommands((uint32_t)secondaries.size(), secondaries.data());
+        vkCmd.endRendering();
+
+        cmd.transitionImageLayout(m_target.get(), ImageLayout::ColorAttachmentOptimal, ImageLayout::TransferSrcOptimal);
+        cmd.copyTextureToBuffer(m_target.get(), m_readback.get());
+        cmd.end();
+        vk::SubmitInfo submit({}, {}, {}, 1, &vkCmd);
+        EXPECT_EQ(m_context->getGraphicsQueue().submit(submit), vk::Result::eSuccess);
+        (void)m_context->getGraphicsQueue().waitIdle();
+        device.freeCommandBuffers(m_context->getCommandPool(), 1, &vkCmd);
+        return static_cast<const uint8_t*>(m_readback->map());
+    }
+
+    // 每个像素应为最后一次写它的绘制
+    void expectLastWriterWins(const uint8_t* pixels, uint32_t drawCount) {
+        for (uint32_t pixel = 0; pixel < WIDTH * HEIGHT; ++pixel) {
+            if (pixel >= drawCount) {
+                ASSERT_EQ(pixels[pixel * 4 + 3], 0) << "pixel " << pixel;
+                continue;
+            }
+            const uint32_t last = pixel + (drawCount - 1 - pixel) / (WIDTH * HEIGHT) * (WIDTH * HEIGHT);
+            ASSERT_EQ(pixels[pixel * 4 + 0], last & 0xFF) << "pixel " << pixel;
+            ASSERT_EQ(pixels[pixel * 4 + 1], (last >> 8) & 0xFF) << "pixel " << pixel;
+            ASSERT_EQ(pixels[pixel * 4 + 2], (last >> 16) & 0xFF) << "pixel " << pixel;
+            ASSERT_EQ(pixels[pixel * 4 + 3], 255) << "pixel " << pixel;
+        }
+    }
+
+    std::unique_ptr<VK_Context> m_context;
+    std::unique_ptr<VK_SecondaryRecorder> m_recorder;
+    std::unique_ptr<ITexture> m_target;
+    std::unique_ptr<IBuffer> m_readback;
+};
+
+TEST_F(ParallelRecordingTest, SecondariesExecuteInTaskOrder) {
+    JobSystem jobs(3);
+    std::vector<vk::CommandBuffer> secondaries;
+    // 绘制数超过像素数, 后面的任务覆盖前面任务写过的像素
+    const uint32_t drawCount = WIDTH * HEIGHT * 3 + 100;
+    record(&jobs, drawCount, 7, secondaries);
+    ASSERT_EQ(secondaries.size(), 7u);
+    EXPECT_GE(m_recorder->getSlotCount(0), 7u);
+    expectLastWriterWins(execute(secondaries), drawCount);
+
+    // 任务变少时复用已有槽位
+    record(&jobs, 1000, 2, secondaries);
+    ASSERT_EQ(secondaries.size(), 2u);
+    EXPECT_EQ(m_recorder->getSlotCount(0), 7u);
+    expectLastWriterWins(execute(secondaries), 1000);
+}
+
+TEST_F(ParallelRecordingTest, SerialTaskStaysOnCallingThread) {
+    JobSystem jobs(2);
+    const auto caller = std::this_thread::get_id();
+    std::thread::id serialThread;
+    std::vector<VK_SecondaryRecorder::Task> tasks;
+    tasks.push_back({[](vk::CommandBuffer cmd) { recordClears(cmd, 0, 10); }});
+    tasks.push_back({[](vk::CommandBuffer cmd) { recordClears(cmd, 10, 10); }});
+    tasks.push_back({[&](vk::CommandBuffer cmd) {
+        serialThread = std::this_thread::get_id();
+        recordClears(cmd, 20, 10);
+    }, false});
+    std::vector<vk::CommandBuffer> secondaries;
+    ASSERT_TRUE(m_recorder->record(0, tasks, {vk::Format::eR8G8B8A8Unorm, vk::Format::eUndefined}, &jobs, secondaries).ok());
+    EXPECT_EQ(serialThread, caller);
+    ASSERT_EQ(secondaries.size(), 3u);
+    expectLastWriterWins(execute(secondaries), 30);
+}
+
+TEST_F(ParallelRecordingTest, SerialVersusParallelRecordingTime) {
+    JobSystem jobs;
+    const uint32_t taskCount = jobs.getWorkerCount() + 1;
+    std::vector<vk::CommandBuffer> secondaries;
+    for (uint32_t drawCount : {1000u, 10000u, 100000u}) {
+        const double serialMs = record(nullptr, drawCount, 1, secondaries);
+        expectLastWriterWins(execute(secondaries), drawCount);
+        const double parallelMs = record(&jobs, drawCount, taskCount, secondaries);
+        expectLastWriterWins(execute(secondaries), drawCount);
+        NX_CORE_INFO("Recording {} draws: serial {:.3f} ms, {} secondaries in parallel {:.3f} ms", drawCount, serialMs, taskCount, parallelMs);
+    }
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "Vk/VK_Context.h"
+#include "Vk/VK_PipelineBuilder.h"
+#include "Vk/VK_ShaderCompiler.h"
+#include "JobSystem.h"
+#include <atomic>
+#include <memory>
+
+using namespace Nexus;
+
+namespace {
+
+const char* kComputeSource = R"(
+RWStructuredBuffer<uint> output : register(u0);
+[numthreads(64, 1, 1)]
+void CSMain(uint3 id : SV_DispatchThreadID) {
+    output[id.x] = id.x * SCALE;
+}
+)";
+
+} // namespace
+
+class PipelineBuilderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_context = std::make_unique<VK_Context>();
+        auto status = m_context->initialize();
+        if (!status.ok()) {
+            GTEST_SKIP() << "Vulkan instance not available: " << status.message();
+        }
+        status = m_context->initializeHeadless();
+        if (!status.ok()) {
+            GTEST_SKIP() << "Vulkan device not available: " << status.message();
+        }
+        // 绕过 SPIR-V 缓存, 保证每个排列都真正在工作线程上编译
+        VK_ShaderCompiler::setCacheDirectory("");
+
+        vk::DescriptorSetLayoutBinding binding(0, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute);
+        m_setLayout = m_context->getDevice().createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo({}, 1, &binding)).value;
+        m_layout = m_context->getDevice().createPipelineLayout(vk::PipelineLayoutCreateInfo({}, 1, &m_setLayout)).value;
+    }
+
+    void TearDown() override {
+        VK_ShaderCompiler::setCacheDirectory(VK_ShaderCompiler::DEFAULT_CACHE_DIRECTORY);
+        if (m_context && m_context->getDevice()) {
+            for (auto pipeline : m_pipelines) m_context->getDevice().destroyPipeline(pipeline);
+            if (m_layout) m_context->getDevice().destroyPipelineLayout(m_layout);
+            if (m_setLayout) m_context->getDevice().destroyDescriptorSetLayout(m_setLayout);
+        }
+        if (m_context) m_context->shutdown();
+    }
+
+    VK_PipelineBuilder::CreateFn computePipeline(std::atomic<uint32_t>* calls = nullptr) {
+        return [this, calls](std::span<const vk::ShaderModule> modules) -> StatusOr<vk::Pipeline> {
+            if (calls) calls->fetch_add(1);
+            vk::ComputePipelineCreateInfo info;
+            info.stage = vk::PipelineShaderStageCreateInfo({}, vk::ShaderStageFlagBits::eCompute, modules[0], "CSMain");
+            info.layout = m_layout;
+            auto result = m_context->getDevice().createComputePipeline(m_context->getPipelineCache(), info);
+            if (result.result != vk::Result::eSuccess) return InternalError("Failed to create compute pipeline");
+            return result.value;
+        };
+    }
+
+    std::unique_ptr<VK_Context> m_context;
+    vk::DescriptorSetLayout m_setLayout;
+    vk::PipelineLayout m_layout;
+    std::vector<vk::Pipeline> m_pipelines;
+};
+
+TEST_F(PipelineBuilderTest, BuildsPermutationsInParallel) {
+    JobSystem jobs(4);
+    VK_PipelineBuilder builder(m_context->getDevice(), &jobs);
+
+    constexpr uint32_t kPermutations = 8;
+    std::vector<VK_PipelineBuilder::SpirvFuture> shaders;
+    std::vector<VK_PipelineBuilder::PipelineFuture> pipelines;
+    for (uint32_t i = 0; i < kPermutations; ++i) {
+        shaders.push_back(builder.compile(kComputeSource, "CSMain", shaderc_compute_shader, {{"SCALE", std::to_string(i + 1)}}));
+        pipelines.push_back(builder.build({shaders.back()}, computePipeline()));
+    }
+
+    for (uint32_t i = 0; i < kPermutations; ++i) {
+        const auto& pipeline = pipelines[i].get();
+        ASSERT_TRUE(pipeline.ok()) << pipeline.status().message();
+        m_pipelines.push_back(*pipeline);
+        EXPECT_TRUE(VK_PipelineBuilder::isReady(shaders[i]));
+    }
+    // 不同的宏排列得到不同的 SPIR-V
+    EXPECT_NE(*shaders[0].get(), *shaders[1].get());
+}
+
+TEST_F(PipelineBuilderTest, CompileErrorPropagatesToPipeline) {
+    JobSystem jobs(2);
+    VK_PipelineBuilder builder(m_context->getDevice(), &jobs);
+    std::atomic<uint32_t> calls{0};
+
+    auto broken = builder.compile("void CSMain( {", "CSMain", shaderc_compute_shader);
+    auto good = builder.compile(kComputeSource, "CSMain", shaderc_compute_shader, {{"SCALE", "1"}});
+    auto pipeline = builder.build({good, broken}, computePipeline(&calls));
+
+    EXPECT_FALSE(pipeline.get().ok());
+    EXPECT_EQ(calls.load(), 0u);
+    EXPECT_TRUE(good.get().ok());
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include "Vk/VK_Context.h"
+#include "Vk/VK_PipelineCache.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+using namespace Nexus;
+
+class PipelineCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_path = (std::filesystem::temp_directory_path() / "nexus_pipeline_cache_test.bin").string();
+        std::filesystem::remove(m_path);
+        m_context = std::make_unique<VK_Context>();
+        auto status = m_context->initialize();
+        if (!status.ok()) {
+            GTEST_SKIP() << "Vulkan instance not available: " << status.message();
+        }
+        status = m_context->initializeHeadless();
+        if (!status.ok()) {
+            GTEST_SKIP() << "Vulkan device not available: " << status.message();
+        }
+    }
+    void TearDown() override {
+        if (m_context) m_context->shutdown();
+        std::filesystem::remove(m_path);
+    }
+
+    std::vector<uint8_t> readFile() const {
+        std::ifstream file(m_path, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), {});
+    }
+
+    std::string m_path;
+    std::unique_ptr<VK_Context> m_context;
+};
+
+TEST_F(PipelineCacheTest, ValidatesHeaderAgainstDevice) {
+    const auto properties = m_context->getPhysicalDevice().getProperties();
+    std::vector<uint8_t> header(16 + VK_UUID_SIZE);
+    const uint32_t fields[] = {(uint32_t)header.size(), (uint32_t)vk::PipelineCacheHeaderVersion::eOne, properties.vendorID, properties.deviceID};
+    std::memcpy(header.data(), fields, sizeof(fields));
+    std::memcpy(header.data() + 16, properties.pipelineCacheUUID.data(), VK_UUID_SIZE);
+    EXPECT_TRUE(VK_PipelineCache::isCompatible(header, properties));
+
+    auto otherDriver = header;
+    otherDriver[16] ^= 0xFF;
+    EXPECT_FALSE(VK_PipelineCache::isCompatible(otherDriver, properties));
+    EXPECT_FALSE(VK_PipelineCache::isCompatible(std::span<const uint8_t>(header).first(20), properties));
+}
+
+TEST_F(PipelineCacheTest, RoundTripsThroughDisk) {
+    auto device = m_context->getDevice();
+    {
+        VK_PipelineCache cache(m_context->getPhysicalDevice(), device);
+        ASSERT_TRUE(cache.initialize(m_path).ok());
+        EXPECT_FALSE(cache.isWarm());
+        EXPECT_TRUE(cache.getHandle());
+    } // 析构时保存
+
+    auto saved = readFile();
+    ASSERT_FALSE(saved.empty());
+    EXPECT_TRUE(VK_PipelineCache::isCompatible(saved, m_context->getPhysicalDevice().getProperties()));
+    {
+        VK_PipelineCache cache(m_context->getPhysicalDevice(), device);
+        ASSERT_TRUE(cache.initialize(m_path).ok());
+        EXPECT_TRUE(cache.isWarm());
+    }
+
+    // 其他驱动写出的数据被丢弃
+    saved[16] ^= 0xFF;
+    std::ofstream(m_path, std::ios::binary | std::ios::trunc).write(reinterpret_cast<const char*>(saved.data()), (std::streamsize)saved.size());
+    VK_PipelineCache cache(m_context->getPhysicalDevice(), device);
+    ASSERT_TRUE(cache.initialize(m_path).ok());
+    EXPECT_FALSE(cache.isWarm());
+}
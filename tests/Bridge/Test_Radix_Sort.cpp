@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "RadixSort.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <future>
+#include <random>
+
+namespace Nexus {
+
+namespace {
+
+std::vector<RadixSort::Entry> randomEntries(uint32_t count, uint64_t keyMask, uint32_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<RadixSort::Entry> entries(count);
+    for (uint32_t i = 0; i < count; ++i) entries[i] = {rng() & keyMask, i};
+    return entries;
+}
+
+// 稳定排序的参考结果
+std::vector<RadixSort::Entry> reference(std::vector<RadixSort::Entry> entries) {
+    std::stable_sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.key < b.key; });
+    return entries;
+}
+
+void expectEqual(const std::vector<RadixSort::Entry>& actual, const std::vector<RadixSort::Entry>& expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        ASSERT_EQ(actual[i].key, expected[i].key) << "at " << i;
+        ASSERT_EQ(actual[i].value, expected[i].value) << "at " << i;
+    }
+}
+
+} // namespace
+
+TEST(RadixSortTest, SortsStablyOnTheCallingThread) {
+    // 键的取值很少, 大量相等的键检验稳定性; 只有部分字节变化, 检验跳过的趟
+    auto entries = randomEntries(5000, 0x00FF00000000000Full, 1);
+    const auto expected = reference(entries);
+    std::vector<RadixSort::Entry> scratch;
+    RadixSort::sort(entries, scratch);
+    expectEqual(entries, expected);
+}
+
+TEST(RadixSortTest, ParallelSortMatchesReference) {
+    JobSystem jobs(3);
+    auto entries = randomEntries(RadixSort::PARALLEL_THRESHOLD * 4 + 17, ~0ull, 2);
+    const auto expected = reference(entries);
+    std::vector<RadixSort::Entry> scratch;
+    RadixSort::sort(entries, scratch, &jobs);
+    expectEqual(entries, expected);
+
+    // 全部相同的键不做任何一趟
+    std::vector<RadixSort::Entry> same(100, {42, 0});
+    for (uint32_t i = 0; i < same.size(); ++i) same[i].value = i;
+    RadixSort::sort(same, scratch, &jobs);
+    for (uint32_t i = 0; i < same.size(); ++i) EXPECT_EQ(same[i].value, i);
+}
+
+TEST(RadixSortTest, ParallelSortDoesNotWaitBehindQueuedJobs) {
+    // 唯一的工作线程被后台任务 (如管线编译) 占住: 排序须由调用线程独自完成
+    JobSystem jobs(1);
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    jobs.submit([gate]() { gate.wait(); });
+
+    auto entries = randomEntries(RadixSort::PARALLEL_THRESHOLD * 2, ~0ull, 3);
+    const auto expected = reference(entries);
+    auto sorted = std::async(std::launch::async, [&]() {
+        std::vector<RadixSort::Entry> scratch;
+        RadixSort::sort(entries, scratch, &jobs);
+    });
+    const bool finished = sorted.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+    release.set_value();
+    sorted.wait();
+    ASSERT_TRUE(finished);
+    expectEqual(entries, expected);
+}
+
+} // namespace Nexus
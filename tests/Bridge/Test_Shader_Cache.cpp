@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include "ShaderCache.h"
+#include <filesystem>
+#include <fstream>
+
+namespace Nexus {
+
+namespace {
+
+class ShaderCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_directory = std::filesystem::temp_directory_path() / "nexus_shader_cache_test";
+        std::filesystem::remove_all(m_directory);
+    }
+    void TearDown() override { std::filesystem::remove_all(m_directory); }
+
+    std::filesystem::path m_directory;
+};
+
+} // namespace
+
+TEST_F(ShaderCacheTest, KeyCoversEveryInput) {
+    const uint64_t key = ShaderCache::computeKey("float4 main()", "VSMain", 0, "hlsl");
+    EXPECT_EQ(key, ShaderCache::computeKey("float4 main()", "VSMain", 0, "hlsl"));
+    EXPECT_NE(key, ShaderCache::computeKey("float4 main() ", "VSMain", 0, "hlsl"));
+    EXPECT_NE(key, ShaderCache::computeKey("float4 main()", "PSMain", 0, "hlsl"));
+    EXPECT_NE(key, ShaderCache::computeKey("float4 main()", "VSMain", 1, "hlsl"));
+    EXPECT_NE(key, ShaderCache::computeKey("float4 main()", "VSMain", 0, "hlsl;A=1"));
+    // 字段边界不同的相同字节串
+    EXPECT_NE(ShaderCache::computeKey("ab", "c", 0, ""), ShaderCache::computeKey("a", "bc", 0, ""));
+}
+
+TEST_F(ShaderCacheTest, StoresAndLoadsSpirv) {
+    const ShaderCache cache(m_directory.string());
+    const uint64_t key = ShaderCache::computeKey("source", "CSMain", 5, "");
+    EXPECT_TRUE(absl::IsNotFound(cache.load(key).status()));
+
+    const std::vector<uint32_t> spirv = {0x07230203, 0x00010600, 0, 42, 0};
+    ASSERT_TRUE(cache.store(key, spirv).ok());
+    auto loaded = cache.load(key);
+    ASSERT_TRUE(loaded.ok());
+    EXPECT_EQ(*loaded, spirv);
+    // 不留临时文件
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator(m_directory), std::filesystem::directory_iterator()), 1);
+}
+
+TEST_F(ShaderCacheTest, RejectsCorruptEntries) {
+    const ShaderCache cache(m_directory.string());
+    const uint32_t notSpirv[] = {0xDEADBEEF, 1};
+    ASSERT_TRUE(cache.store(1, notSpirv).ok());
+    EXPECT_TRUE(absl::IsNotFound(cache.load(1).status()));
+
+    std::filesystem::create_directories(m_directory);
+    std::ofstream(cache.getPath(2), std::ios::binary) << "abcde";
+    EXPECT_TRUE(absl::IsNotFound(cache.load(2).status()));
+}
+
+TEST_F(ShaderCacheTest, IncludeKeyCoversIncludedContents) {
+    const uint64_t sourceKey = ShaderCache::computeKey("#include \"Common.hlsli\"", "VSMain", 0, "hlsl");
+    const ShaderCache::Include includes[] = {{"Data/Shaders/Common.hlsli", "float a;"}};
+    const ShaderCache::Include edited[] = {{"Data/Shaders/Common.hlsli", "float b;"}};
+    const ShaderCache::Include moved[] = {{"Data/Shaders/Other.hlsli", "float a;"}};
+    const uint64_t key = ShaderCache::computeIncludeKey(sourceKey, includes);
+    EXPECT_EQ(key, ShaderCache::computeIncludeKey(sourceKey, includes));
+    EXPECT_NE(key, ShaderCache::computeIncludeKey(sourceKey, edited));
+    EXPECT_NE(key, ShaderCache::computeIncludeKey(sourceKey, moved));
+    EXPECT_NE(key, ShaderCache::computeIncludeKey(sourceKey, {}));
+    EXPECT_NE(key, ShaderCache::computeIncludeKey(sourceKey + 1, includes));
+}
+
+TEST_F(ShaderCacheTest, LoadsIncludesWithCurrentContents) {
+    const ShaderCache cache(m_directory.string());
+    EXPECT_TRUE(absl::IsNotFound(cache.loadIncludes(7).status()));
+
+    // 无包含文件的着色器也记录一个空列表
+    ASSERT_TRUE(cache.storeIncludes(7, {}).ok());
+    auto none = cache.loadIncludes(7);
+    ASSERT_TRUE(none.ok());
+    EXPECT_TRUE(none->empty());
+
+    const std::string header = (m_directory / "Common.hlsli").generic_string();
+    std::ofstream(header, std::ios::binary) << "float a;";
+    const ShaderCache::Include includes[] = {{header, "float a;"}};
+    ASSERT_TRUE(cache.storeIncludes(8, includes).ok());
+    auto loaded = cache.loadIncludes(8);
+    ASSERT_TRUE(loaded.ok());
+    ASSERT_EQ(loaded->size(), 1u);
+    EXPECT_EQ((*loaded)[0].path, header);
+    EXPECT_EQ((*loaded)[0].content, "float a;");
+
+    // 编辑包含文件后读回新内容, 最终键随之变化
+    std::ofstream(header, std::ios::binary | std::ios::trunc) << "float b;";
+    auto edited = cache.loadIncludes(8);
+    ASSERT_TRUE(edited.ok());
+    EXPECT_EQ((*edited)[0].content, "float b;");
+    EXPECT_NE(ShaderCache::computeIncludeKey(8, *edited), ShaderCache::computeIncludeKey(8, *loaded));
+
+    std::filesystem::remove(header);
+    EXPECT_TRUE(absl::IsNotFound(cache.loadIncludes(8).status()));
+}
+
+} // namespace Nexus
@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
 #include "Vk/VK_Context.h"
 #include "Vk/VK_Texture.h"
+#include "Vk/VK_StagingRing.h"
 #include "ResourceLoader.h"
+#include "ImageMips.h"
+#include "BlockCompression.h"
 #include <filesystem>
 #include <fstream>
 
@@ -46,6 +49,307 @@ TEST_F(TextureLoadingTest, TextureCreation) {
     EXPECT_NE(texture.getImage(), nullptr);
     EXPECT_NE(texture.getView(), nullptr);
     EXPECT_NE(texture.getSampler(), nullptr);
+    EXPECT_EQ(texture.getMipLevels(), 2);
+}
+
+TEST_F(TextureLoadingTest, FullMipChainIsGenerated) {
+    if (!m_context->getDevice()) GTEST_SKIP() << "No device available";
+
+    ImageData image;
+    image.width = 256;
+    image.height = 64;
+    image.channels = 4;
+    image.pixels.assign((size_t)image.width * image.height * 4, 128);
+
+    VK_Texture texture(m_context.get());
+    auto status = texture.create(image, TextureUsage::Sampled);
+    ASSERT_TRUE(status.ok()) << status.message();
+    EXPECT_EQ(texture.getMipLevels(), 9);
+    EXPECT_GE(m_context->getSamplerAnisotropy(), 1.0f);
+}
+
+TEST_F(TextureLoadingTest, CompressedMipChainUploadsDirectlyOrDecompresses) {
+    if (!m_context->getDevice()) GTEST_SKIP() << "No device available";
+
+    ImageData image;
+    image.width = 32;
+    image.height = 16;
+    image.channels = 4;
+    image.pixels.assign((size_t)image.width * image.height * 4, 200);
+    ASSERT_TRUE(generateMipChain(image).ok());
+    auto compressed = compressImage(image, TextureFormat::BC7_UNORM_BLOCK);
+    ASSERT_TRUE(compressed.ok());
+
+    VK_Texture texture(m_context.get());
+    auto status = texture.create(*compressed, TextureUsage::Sampled);
+    ASSERT_TRUE(status.ok()) << status.message();
+    // 预生成的 mip 链原样保留, 不支持 BC 时回退为 RGBA8
+    EXPECT_EQ(texture.getMipLevels(), 6u);
+    const bool direct = m_context->supportsCompressedFormat(vk::Format::eBc7UnormBlock);
+    EXPECT_EQ(texture.getFormat(), direct ? TextureFormat::BC7_UNORM_BLOCK : TextureFormat::R8G8B8A8_UNORM);
+}
+
+TEST_F(TextureLoadingTest, DeferredTextureSwapsBindlessSlotAfterUpload) {
+    if (!m_context->getDevice()) GTEST_SKIP() << "No device available";
+
+    ImageData placeholderData;
+    placeholderData.width = 1;
+    placeholderData.height = 1;
+    placeholderData.channels = 4;
+    placeholderData.pixels = {255, 0, 255, 255};
+    VK_Texture placeholder(m_context.get());
+    ASSERT_TRUE(placeholder.create(placeholderData, TextureUsage::Sampled).ok());
+
+    auto texture = m_context->createTextureAsync(&placeholder);
+    ASSERT_NE(texture, nullptr);
+    EXPECT_FALSE(texture->isResident());
+    EXPECT_NE(texture->getBindlessTextureIndex(), placeholder.getBindlessTextureIndex());
+
+    ImageData image;
+    image.width = 64;
+    image.height = 32;
+    image.channels = 4;
+    image.pixels.assign((size_t)image.width * image.height * 4, 200);
+    m_context->uploadTextureAsync(texture.get(), std::move(image));
+
+    auto* streamer = m_context->getTextureStreamer();
+    EXPECT_EQ(streamer->getPendingCount(), 1u);
+    streamer->flush();
+    EXPECT_EQ(streamer->getPendingCount(), 0u);
+    streamer->waitIdle();
+
+    EXPECT_TRUE(texture->isResident());
+    EXPECT_EQ(texture->getWidth(), 64u);
+    EXPECT_EQ(static_cast<VK_Texture*>(texture.get())->getMipLevels(), 7u);
+    EXPECT_EQ(streamer->getInFlightBatchCount(), 0u);
+}
+
+TEST_F(TextureLoadingTest, EvictedTextureKeepsSlotAndReuploads) {
+    if (!m_context->getDevice()) GTEST_SKIP() << "No device available";
+
+    ImageData placeholderData;
+    placeholderData.width = 1;
+    placeholderData.height = 1;
+    placeholderData.channels = 4;
+    placeholderData.pixels = {255, 0, 255, 255};
+    VK_Texture placeholder(m_context.get());
+    ASSERT_TRUE(placeholder.create(placeholderData, TextureUsage::Sampled).ok());
+
+    auto texture = m_context->createTextureAsync(&placeholder);
+    ASSERT_NE(texture, nullptr);
+    auto makeImage = []() {
+        ImageData image;
+        image.width = 32;
+        image.height = 32;
+        image.channels = 4;
+        image.pixels.assign((size_t)image.width * image.height * 4, 90);
+        return image;
+    };
+    auto* streamer = m_context->getTextureStreamer();
+    m_context->uploadTextureAsync(texture.get(), makeImage());
+    streamer->flush();
+    streamer->waitIdle();
+    ASSERT_TRUE(texture->isResident());
+    EXPECT_GT(texture->getMemorySize(), 0u);
+    const uint32_t slot = texture->getBindlessTextureIndex();
+
+    ASSERT_TRUE(m_context->evictTexture(texture.get(), &placeholder));
+    EXPECT_FALSE(texture->isResident());
+    EXPECT_EQ(texture->getMemorySize(), 0u);
+    EXPECT_EQ(texture->getBindlessTextureIndex(), slot);
+
+    m_context->uploadTextureAsync(texture.get(), makeImage());
+    streamer->flush();
+    streamer->waitIdle();
+    EXPECT_TRUE(texture->isResident());
+    EXPECT_EQ(static_cast<VK_Texture*>(texture.get())->getMipLevels(), 6u);
+}
+
+TEST_F(TextureLoadingTest, MipStreamingReplacesFinerLevelsInPlace) {
+    if (!m_context->getDevice()) GTEST_SKIP() << "No device available";
+
+    ImageData placeholderData;
+    placeholderData.width = 1;
+    placeholderData.height = 1;
+    placeholderData.channels = 4;
+    placeholderData.pixels = {255, 0, 255, 255};
+    VK_Texture placeholder(m_context.get());
+    ASSERT_TRUE(placeholder.create(placeholderData, TextureUsage::Sampled).ok());
+
+    ImageData full;
+    full.width = 32;
+    full.height = 32;
+    full.channels = 4;
+    full.pixels.assign((size_t)full.width * full.height * 4, 90);
+    ASSERT_TRUE(generateMipChain(full).ok());
+
+    auto texture = m_context->createTextureAsync(&placeholder);
+    ASSERT_NE(texture, nullptr);
+    auto* vkTexture = static_cast<VK_Texture*>(texture.get());
+    auto* streamer = m_context->getTextureStreamer();
+    auto upload = [&](ImageData image) {
+        m_context->uploadTextureAsync(texture.get(), std::move(image));
+        streamer->flush();
+        streamer->waitIdle();
+    };
+
+    // 先只上传 4x4 及更小的尾部级别
+    upload(extractMipLevels(full, 3, 3).value());
+    ASSERT_TRUE(texture->isResident());
+    EXPECT_EQ(texture->getResidentMip(), 3u);
+    EXPECT_EQ(texture->getWidth(), 32u);
+    EXPECT_EQ(vkTexture->getMipLevels(), 3u);
+    const uint64_t tailBytes = texture->getMemorySize();
+    const uint32_t slot = texture->getBindlessTextureIndex();
+
+    // 流入 mip0..2, 尾部从旧图像拷贝
+    upload(extractMipLevels(full, 0, 3).value());
+    EXPECT_EQ(texture->getResidentMip(), 0u);
+    EXPECT_EQ(vkTexture->getMipLevels(), 6u);
+    EXPECT_GT(texture->getMemorySize(), tailBytes);
+    EXPECT_EQ(texture->getBindlessTextureIndex(), slot);
+
+    // 丢弃 mip0..1
+    ImageData coarser;
+    coarser.width = 32;
+    coarser.height = 32;
+    coarser.baseMip = 2;
+    coarser.mipLevels = 0;
+    upload(std::move(coarser));
+    EXPECT_EQ(texture->getResidentMip(), 2u);
+    EXPECT_EQ(vkTexture->getMipLevels(), 4u);
+    EXPECT_TRUE(texture->isResident());
+}
+
+TEST_F(TextureLoadingTest, MappedUploadWritesStraightIntoStagingRing) {
+    if (!m_context->getDevice()) GTEST_SKIP() << "No device available";
+    if (!m_context->supportsLinearBlit(vk::Format::eR8G8B8A8Unorm)) GTEST_SKIP() << "Linear blit not supported";
+
+    ImageData placeholderData;
+    placeholderData.width = 1;
+    placeholderData.height = 1;
+    placeholderData.channels = 4;
+    placeholderData.pixels = {255, 0, 255, 255};
+    VK_Texture placeholder(m_context.get());
+    ASSERT_TRUE(placeholder.create(placeholderData, TextureUsage::Sampled).ok());
+
+    auto texture = m_context->createTextureAsync(&placeholder);
+    ASSERT_NE(texture, nullptr);
+    auto* streamer = m_context->getTextureStreamer();
+    auto* ring = streamer->getStagingRing();
+    ASSERT_NE(ring, nullptr);
+
+    auto* staging = static_cast<uint8_t*>(m_context->mapTextureUpload(texture.get(), 16, 8));
+    ASSERT_NE(staging, nullptr);
+    EXPECT_EQ(ring->getLiveSliceCount(), 1u);
+    std::fill(staging, staging + 16 * 8 * 4, uint8_t(128));
+    // 提交前不会进入上传队列
+    EXPECT_EQ(streamer->getPendingCount(), 0u);
+    m_context->commitTextureUpload(texture.get(), true);
+    EXPECT_EQ(streamer->getPendingCount(), 1u);
+
+    streamer->flush();
+    streamer->waitIdle();
+    EXPECT_TRUE(texture->isResident());
+    EXPECT_EQ(texture->getWidth(), 16u);
+    EXPECT_EQ(static_cast<VK_Texture*>(texture.get())->getMipLevels(), 5u);
+    EXPECT_EQ(ring->getLiveSliceCount(), 0u);
+    EXPECT_EQ(ring->getUsedBytes(), 0u);
+}
+
+TEST_F(TextureLoadingTest, StagingRingReclaimsInAllocationOrder) {
+    if (!m_context->getDevice()) GTEST_SKIP() << "No device available";
+
+    VK_StagingRing ring(m_context.get());
+    ASSERT_TRUE(ring.initialize(1024).ok());
+
+    auto a = ring.allocate(400);
+    auto b = ring.allocate(400);
+    ASSERT_TRUE(a && b);
+    EXPECT_EQ(b.offset, 400u);
+    EXPECT_FALSE(ring.allocate(400));
+
+    // b 先释放, 但 a 仍在使用, 空间不可复用
+    ring.release(b);
+    EXPECT_FALSE(ring.allocate(400));
+    ring.release(a);
+    EXPECT_EQ(ring.getUsedBytes(), 0u);
+
+    // 尾部放不下时回绕到开头
+    auto c = ring.allocate(600);
+    auto d = ring.allocate(300);
+    ring.release(c);
+    auto e = ring.allocate(500);
+    ASSERT_TRUE(c && d && e);
+    EXPECT_EQ(e.offset, 0u);
+    EXPECT_EQ(e.mapped, c.mapped);
+    EXPECT_FALSE(ring.allocate(200));
+}
+
+TEST(ImageDecodeTest, DecodesMappedFileIntoCallerMemory) {
+    // 2x2 二进制 PPM, 解码后扩展为 RGBA
+    const std::string header = "P6\n2 2\n255\n";
+    const uint8_t rgb[12] = {255, 0, 0, 0, 255, 0, 0, 0, 255, 10, 20, 30};
+    auto path = std::filesystem::temp_directory_path() / "nexus_decode_test.ppm";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(header.data(), header.size());
+        out.write(reinterpret_cast<const char*>(rgb), sizeof(rgb));
+    }
+
+    auto mapped = MappedFile::open(path.string());
+    ASSERT_TRUE(mapped.ok());
+    EXPECT_EQ(mapped->size(), header.size() + sizeof(rgb));
+
+    uint32_t width = 0, height = 0;
+    ASSERT_TRUE(ResourceLoader::probeImage(mapped->data(), mapped->size(), width, height).ok());
+    EXPECT_EQ(width, 2u);
+    EXPECT_EQ(height, 2u);
+
+    std::vector<uint8_t> pixels(width * height * 4, 0);
+    ASSERT_TRUE(ResourceLoader::decodeImageInto(mapped->data(), mapped->size(), pixels.data(), width, height).ok());
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(pixels[i * 4 + 0], rgb[i * 3 + 0]);
+        EXPECT_EQ(pixels[i * 4 + 1], rgb[i * 3 + 1]);
+        EXPECT_EQ(pixels[i * 4 + 2], rgb[i * 3 + 2]);
+        EXPECT_EQ(pixels[i * 4 + 3], 255);
+    }
+
+    auto image = ResourceLoader::loadImageFromMemory(mapped->data(), mapped->size());
+    ASSERT_TRUE(image.ok());
+    EXPECT_EQ(image->pixels, pixels);
+
+    // 尺寸与文件头不符时拒绝写入
+    EXPECT_FALSE(ResourceLoader::decodeImageInto(mapped->data(), mapped->size(), pixels.data(), 1, 1).ok());
+    EXPECT_FALSE(ResourceLoader::probeImage(rgb, sizeof(rgb), width, height).ok());
+
+    *mapped = MappedFile();
+    std::filesystem::remove(path);
+}
+
+TEST(ImageMipsTest, BoxFilterChain) {
+    EXPECT_EQ(computeMipLevelCount(1, 1), 1u);
+    EXPECT_EQ(computeMipLevelCount(5, 3), 3u);
+    EXPECT_EQ(computeMipLevelCount(1024, 1), 11u);
+
+    ImageData image;
+    image.width = 3;
+    image.height = 2;
+    image.channels = 4;
+    // 单通道梯度, 其余通道为常量
+    const uint8_t values[6] = {0, 30, 60, 90, 120, 150};
+    for (uint8_t v : values) {
+        image.pixels.insert(image.pixels.end(), {v, 10, 20, 255});
+    }
+
+    ASSERT_TRUE(generateMipChain(image).ok());
+    EXPECT_EQ(image.mipLevels, 2u);
+    ASSERT_EQ(image.pixels.size(), mipLevelOffset(3, 2, 2));
+    // 3x2 -> 1x1: 奇数宽度时整行参与平均
+    const uint8_t* level1 = image.pixels.data() + mipLevelOffset(3, 2, 1);
+    EXPECT_EQ(level1[0], 75);
+    EXPECT_EQ(level1[1], 10);
+    EXPECT_EQ(level1[3], 255);
 }
 
 } // namespace Nexus
@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
 #include "Threading.h"
+#include "JobSystem.h"
 #include <future>
 #include <chrono>
+#include <thread>
 
 using namespace Nexus;
 
@@ -67,3 +69,47 @@ TEST(ThreadingSafety, RHIThread_Sync_DeadlockDetection) {
     delete context;
 #endif
 }
+
+TEST(ThreadingSafety, JobSystem_RunsAllSubmittedJobs) {
+    std::atomic<int> counter{0};
+    std::vector<std::future<int>> results;
+    {
+        JobSystem jobs(3);
+        EXPECT_EQ(jobs.getWorkerCount(), 3u);
+        for (int i = 0; i < 64; ++i) {
+            jobs.submit([&counter]() { counter.fetch_add(1); });
+            results.push_back(jobs.submitTask([i]() { return i * 2; }));
+        }
+        for (int i = 0; i < 64; ++i) {
+            EXPECT_EQ(results[i].get(), i * 2);
+        }
+    }
+    // 析构时排空队列
+    EXPECT_EQ(counter.load(), 64);
+}
+
+TEST(ThreadingSafety, JobSystem_DispatchDoesNotWaitBehindQueuedJobs) {
+    JobSystem jobs(1);
+    // 唯一的工作线程被后台任务占住, 其后还排着一个任务
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    jobs.submit([gate]() { gate.wait(); });
+    jobs.submit([]() {});
+
+    const auto caller = std::this_thread::get_id();
+    std::vector<std::thread::id> threads(16);
+    bool callerWorkRan = false;
+    auto dispatched = std::async(std::launch::async, [&]() {
+        jobs.dispatch((uint32_t)threads.size(), [&](uint32_t i) { threads[i] = std::this_thread::get_id(); },
+                      [&]() { callerWorkRan = true; });
+        return std::this_thread::get_id();
+    });
+    // 调用线程自行领取全部下标, 不等待被阻塞的工作线程
+    ASSERT_EQ(dispatched.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    const auto dispatcher = dispatched.get();
+    EXPECT_NE(dispatcher, caller);
+    EXPECT_TRUE(callerWorkRan);
+    for (const auto& id : threads) EXPECT_EQ(id, dispatcher);
+
+    release.set_value();
+}
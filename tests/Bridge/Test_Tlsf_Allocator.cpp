@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include "TlsfAllocator.h"
+#include <random>
+#include <vector>
+
+namespace Nexus {
+
+TEST(TlsfAllocatorTest, AllocatesAlignedDisjointRanges) {
+    TlsfAllocator tlsf(1 << 20);
+    uint64_t a = 0, b = 0, c = 0;
+    uint32_t ha = tlsf.allocate(100, 16, a);
+    uint32_t hb = tlsf.allocate(4000, 4096, b);
+    uint32_t hc = tlsf.allocate(1, 256, c);
+    ASSERT_NE(ha, TlsfAllocator::INVALID_HANDLE);
+    ASSERT_NE(hb, TlsfAllocator::INVALID_HANDLE);
+    ASSERT_NE(hc, TlsfAllocator::INVALID_HANDLE);
+    EXPECT_EQ(b % 4096, 0u);
+    EXPECT_EQ(c % 256, 0u);
+    EXPECT_TRUE(a + 100 <= b || b + 4000 <= a);
+    EXPECT_TRUE(c + 1 <= b || b + 4000 <= c);
+    EXPECT_EQ(tlsf.getAllocationCount(), 3u);
+    EXPECT_EQ(tlsf.getUsedBytes(), 112u + 4000u + 16u);
+}
+
+TEST(TlsfAllocatorTest, FreeCoalescesBackToSingleRegion) {
+    TlsfAllocator tlsf(64 * 1024);
+    std::vector<uint32_t> handles;
+    uint64_t offset = 0;
+    for (int i = 0; i < 16; ++i) {
+        uint32_t h = tlsf.allocate(4096, 16, offset);
+        ASSERT_NE(h, TlsfAllocator::INVALID_HANDLE);
+        handles.push_back(h);
+    }
+    // 已满
+    EXPECT_EQ(tlsf.allocate(16, 16, offset), TlsfAllocator::INVALID_HANDLE);
+
+    // 交错释放, 最后整块应重新合并
+    for (size_t i = 0; i < handles.size(); i += 2) tlsf.free(handles[i]);
+    EXPECT_EQ(tlsf.getLargestFreeRegion(), 4096u);
+    for (size_t i = 1; i < handles.size(); i += 2) tlsf.free(handles[i]);
+    EXPECT_TRUE(tlsf.isEmpty());
+    EXPECT_EQ(tlsf.getLargestFreeRegion(), 64u * 1024u);
+
+    uint32_t whole = tlsf.allocate(64 * 1024, 16, offset);
+    EXPECT_NE(whole, TlsfAllocator::INVALID_HANDLE);
+    EXPECT_EQ(offset, 0u);
+}
+
+TEST(TlsfAllocatorTest, RandomWorkloadNeverOverlaps) {
+    constexpr uint64_t capacity = 1 << 22;
+    TlsfAllocator tlsf(capacity);
+    struct Live { uint32_t handle; uint64_t offset, size; };
+    std::vector<Live> live;
+    std::mt19937 rng(7);
+
+    for (int step = 0; step < 4000; ++step) {
+        if (live.empty() || rng() % 3 != 0) {
+            const uint64_t size = 1 + rng() % 20000;
+            const uint64_t alignment = 16ull << (rng() % 8);
+            uint64_t offset = 0;
+            uint32_t h = tlsf.allocate(size, alignment, offset);
+            if (h == TlsfAllocator::INVALID_HANDLE) continue;
+            EXPECT_EQ(offset % alignment, 0u);
+            EXPECT_LE(offset + size, capacity);
+            for (const auto& other : live) {
+                ASSERT_TRUE(offset + size <= other.offset || other.offset + other.size <= offset);
+            }
+            live.push_back({h, offset, size});
+        } else {
+            size_t victim = rng() % live.size();
+            tlsf.free(live[victim].handle);
+            live.erase(live.begin() + victim);
+        }
+    }
+    for (const auto& l : live) tlsf.free(l.handle);
+    EXPECT_TRUE(tlsf.isEmpty());
+    EXPECT_EQ(tlsf.getUsedBytes(), 0u);
+    EXPECT_EQ(tlsf.getLargestFreeRegion(), capacity);
+}
+
+} // namespace Nexus
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include "TraceExporter.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace Nexus {
+
+namespace {
+
+class TraceExporterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_path = std::filesystem::temp_directory_path() / "nexus_trace_test.json";
+        std::filesystem::remove(m_path);
+    }
+    void TearDown() override { std::filesystem::remove(m_path); }
+
+    std::string readTrace() const {
+        std::ifstream file(m_path);
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    std::filesystem::path m_path;
+};
+
+} // namespace
+
+TEST_F(TraceExporterTest, IgnoresEventsWhileClosed) {
+    TraceExporter trace;
+    EXPECT_FALSE(trace.isOpen());
+    trace.addEvent("Dropped", "cpu", TraceExporter::TRACK_CPU, 0.0, 1.0);
+    EXPECT_EQ(trace.getEventCount(), 0u);
+    EXPECT_TRUE(trace.close().ok());
+    EXPECT_FALSE(std::filesystem::exists(m_path));
+    EXPECT_FALSE(trace.open("").ok());
+}
+
+TEST_F(TraceExporterTest, WritesCompleteEventsWithArgs) {
+    TraceExporter trace;
+    ASSERT_TRUE(trace.open(m_path.string()).ok());
+    trace.setTrackName(TraceExporter::TRACK_GPU, "GPU");
+    trace.addEvent("MainPass", "gpu", TraceExporter::TRACK_GPU, 10.5, 250.25);
+    const TraceExporter::Arg args[] = {{"fs_invocations", 4096.0}};
+    trace.addEvent("Quote\"Back\\slash", "gpu", TraceExporter::TRACK_GPU, 300.0, 5.0, args);
+    EXPECT_EQ(trace.getEventCount(), 2u);
+    ASSERT_TRUE(trace.close().ok());
+    EXPECT_FALSE(trace.isOpen());
+
+    const std::string json = readTrace();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}"), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"MainPass\",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":10.500,\"dur\":250.250}"), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"Quote\\\"Back\\\\slash\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"fs_invocations\":4096.000}"), std::string::npos);
+    EXPECT_EQ(json.substr(json.size() - 4), "\n]}\n");
+
+    // 关闭后追加的事件不再写出
+    trace.addEvent("Late", "cpu", TraceExporter::TRACK_CPU, 0.0, 1.0);
+    EXPECT_EQ(trace.getEventCount(), 0u);
+}
+
+TEST_F(TraceExporterTest, ConcurrentEventsAreAllRecorded) {
+    TraceExporter trace;
+    ASSERT_TRUE(trace.open(m_path.string()).ok());
+    const double start = trace.nowUs();
+    EXPECT_GE(start, 0.0);
+
+    constexpr uint32_t threadCount = 4;
+    constexpr uint32_t eventsPerThread = 1000;
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&trace, t]() {
+            for (uint32_t i = 0; i < eventsPerThread; ++i) trace.addEvent("Job", "cpu", 10 + t, trace.nowUs(), 1.0);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(trace.getEventCount(), threadCount * eventsPerThread);
+    EXPECT_EQ(trace.getDroppedCount(), 0u);
+    ASSERT_TRUE(trace.close().ok());
+
+    const std::string json = readTrace();
+    size_t count = 0;
+    for (size_t pos = json.find("\"ph\":\"X\""); pos != std::string::npos; pos = json.find("\"ph\":\"X\"", pos + 1)) ++count;
+    EXPECT_EQ(count, threadCount * eventsPerThread);
+}
+
+} // namespace Nexus
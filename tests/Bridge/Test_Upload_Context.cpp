@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include "Vk/VK_Context.h"
+#include "Vk/VK_Buffer.h"
+#include "Vk/VK_UploadContext.h"
+#include <cstring>
+#include <numeric>
+
+namespace Nexus {
+
+class UploadContextTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_context = std::make_unique<VK_Context>();
+        auto status = m_context->initialize();
+        if (!status.ok()) {
+            GTEST_SKIP() << "Vulkan instance not available: " << status.message();
+        }
+        status = m_context->initializeHeadless();
+        if (!status.ok()) {
+            GTEST_SKIP() << "Vulkan device not available: " << status.message();
+        }
+    }
+
+    // 经图形队列把 device-local 缓冲区拷回 host-visible 缓冲区
+    std::vector<uint32_t> readBack(IBuffer* source, size_t count) {
+        const uint64_t size = count * sizeof(uint32_t);
+        auto readback = m_context->createBuffer(size, (uint32_t)vk::BufferUsageFlagBits::eTransferDst,
+                                                (uint32_t)(vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent));
+        auto* upload = m_context->getUploadContext();
+        auto ticket = upload->submitGraphics([&](vk::CommandBuffer cmd) {
+            cmd.copyBuffer(static_cast<VK_Buffer*>(source)->getHandle(), static_cast<VK_Buffer*>(readback.get())->getHandle(),
+                           vk::BufferCopy(0, 0, size));
+        });
+        EXPECT_TRUE(ticket.ok());
+        EXPECT_TRUE(upload->wait(*ticket).ok());
+        std::vector<uint32_t> values(count);
+        std::memcpy(values.data(), readback->map(), size);
+        return values;
+    }
+
+    std::unique_ptr<VK_Context> m_context;
+};
+
+TEST_F(UploadContextTest, DeviceLocalBufferUploadsAreBatchedUntilFlush) {
+    auto* upload = m_context->getUploadContext();
+    ASSERT_NE(upload, nullptr);
+    const uint32_t usage = (uint32_t)(vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst |
+                                      vk::BufferUsageFlagBits::eTransferSrc);
+    auto buffer = m_context->createBuffer(1024 * sizeof(uint32_t), usage, (uint32_t)vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+    std::vector<uint32_t> values(1024);
+    std::iota(values.begin(), values.end(), 7u);
+    // 分两段写入, 两次拷贝合并在同一次提交中
+    ASSERT_TRUE(buffer->uploadData(values.data(), 512 * sizeof(uint32_t), 0).ok());
+    ASSERT_TRUE(buffer->uploadData(values.data() + 512, 512 * sizeof(uint32_t), 512 * sizeof(uint32_t)).ok());
+    EXPECT_EQ(upload->getPendingCopyCount(), 2u);
+
+    auto ticket = upload->flush();
+    EXPECT_GT(ticket, 0u);
+    EXPECT_EQ(upload->getPendingCopyCount(), 0u);
+    ASSERT_TRUE(upload->wait(ticket).ok());
+    EXPECT_TRUE(upload->isComplete(ticket));
+
+    EXPECT_EQ(readBack(buffer.get(), values.size()), values);
+
+    upload->waitIdle();
+    EXPECT_EQ(upload->getInFlightCount(), 0u);
+    EXPECT_EQ(upload->getStagingRing()->getLiveSliceCount(), 0u);
+}
+
+TEST_F(UploadContextTest, OversizedUploadsFallBackToDedicatedStaging) {
+    auto* upload = m_context->getUploadContext();
+    const uint64_t size = upload->getStagingRing()->getCapacity() + 4096;
+    const uint32_t usage = (uint32_t)(vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eTransferSrc);
+    auto buffer = m_context->createBuffer(size, usage, (uint32_t)vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+    std::vector<uint32_t> values(size / sizeof(uint32_t), 0xA5A5A5A5u);
+    values.front() = 1;
+    values.back() = 2;
+    ASSERT_TRUE(buffer->uploadData(values.data(), size).ok());
+    ASSERT_TRUE(upload->wait(upload->flush()).ok());
+
+    auto head = readBack(buffer.get(), 4);
+    EXPECT_EQ(head[0], 1u);
+    EXPECT_EQ(head[1], 0xA5A5A5A5u);
+}
+
+TEST_F(UploadContextTest, DestroyedBuffersDropPendingCopies) {
+    auto* upload = m_context->getUploadContext();
+    const uint32_t usage = (uint32_t)(vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferDst);
+    auto buffer = m_context->createBuffer(256, usage, (uint32_t)vk::MemoryPropertyFlagBits::eDeviceLocal);
+    uint32_t value = 42;
+    ASSERT_TRUE(buffer->uploadData(&value, sizeof(value)).ok());
+    EXPECT_EQ(upload->getPendingCopyCount(), 1u);
+
+    buffer.reset();
+    EXPECT_EQ(upload->getPendingCopyCount(), 0u);
+    upload->flush();
+    EXPECT_EQ(upload->getStagingRing()->getLiveSliceCount(), 0u);
+}
+
+} // namespace Nexus
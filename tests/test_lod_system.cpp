@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include "../src/Core/LodSystem.h"
+#include "../src/Core/Scene.h"
+#include "../src/Core/HierarchySystem.h"
+
+using namespace Nexus;
+
+TEST(LodSystemTest, SelectsCoarserLodsAsCoverageShrinks) {
+    LodSystem::Settings settings;
+    EXPECT_EQ(LodSystem::selectLod(1.0f, 0, 4, settings), 0u);
+    EXPECT_EQ(LodSystem::selectLod(0.20f, 0, 4, settings), 1u);
+    EXPECT_EQ(LodSystem::selectLod(0.10f, 0, 4, settings), 2u);
+    EXPECT_EQ(LodSystem::selectLod(0.01f, 0, 4, settings), 3u);
+    EXPECT_EQ(LodSystem::selectLod(0.01f, 0, 2, settings), 1u);
+    EXPECT_EQ(LodSystem::selectLod(0.01f, 0, 1, settings), 0u);
+}
+
+TEST(LodSystemTest, HysteresisKeepsCurrentLodNearThreshold) {
+    LodSystem::Settings settings;
+    // 0.29 / 0.31 均位于 0.30 的滞回带内, 保持当前级别
+    EXPECT_EQ(LodSystem::selectLod(0.29f, 0, 4, settings), 0u);
+    EXPECT_EQ(LodSystem::selectLod(0.31f, 1, 4, settings), 1u);
+    // 越过滞回带才切换
+    EXPECT_EQ(LodSystem::selectLod(0.26f, 0, 4, settings), 1u);
+    EXPECT_EQ(LodSystem::selectLod(0.34f, 1, 4, settings), 0u);
+}
+
+TEST(LodSystemTest, UsesCameraWorldPosition) {
+    Scene scene("LodScene");
+    Entity mesh = scene.createEntity("Mesh");
+    auto& meshComp = mesh.addComponent<MeshComponent>();
+    meshComp.lodCount = 4;
+    mesh.addComponent<BoundsComponent>(std::array<float, 3>{-1.0f, -1.0f, -1.0f}, std::array<float, 3>{1.0f, 1.0f, 1.0f},
+                                       std::array<float, 4>{0.0f, 0.0f, 0.0f, 1.0f});
+
+    // 相机局部位置紧贴网格, 但父级把它移到远处
+    Entity rig = scene.createEntity("Rig");
+    Entity camera = scene.createEntity("Camera");
+    camera.addComponent<CameraComponent>();
+    camera.getComponent<TransformComponent>().position = {0.0f, 0.0f, 2.0f};
+    rig.getComponent<TransformComponent>().position = {0.0f, 0.0f, 500.0f};
+    scene.setParent(camera, rig);
+    HierarchySystem::update(scene.getRegistry());
+
+    LodSystem::update(scene.getRegistry());
+    EXPECT_EQ(mesh.getComponent<MeshComponent>().activeLod, 3u);
+
+    rig.getComponent<TransformComponent>().position = {0.0f, 0.0f, 0.0f};
+    HierarchySystem::update(scene.getRegistry());
+    LodSystem::update(scene.getRegistry());
+    EXPECT_EQ(mesh.getComponent<MeshComponent>().activeLod, 0u);
+}
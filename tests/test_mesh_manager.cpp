@@ -0,0 +1,312 @@
+#include <gtest/gtest.h>
+#include "../src/Core/MeshManager.h"
+#include "../src/Core/VertexPacking.h"
+#include "../src/Core/Scene.h"
+#include <cmath>
+#include <cstring>
+
+using namespace Nexus;
+using namespace Nexus::Core;
+
+namespace {
+
+/**
+ * @brief 纯 CPU 缓冲区, 用于脱离 Vulkan 测试 MeshManager
+ */
+class CpuBuffer : public IBuffer {
+public:
+    explicit CpuBuffer(uint64_t size) : m_data(size) {}
+    void* map() override { return m_data.data(); }
+    void unmap() override {}
+    uint64_t getSize() const override { return m_data.size(); }
+    void* getNativeHandle() const override { return nullptr; }
+    Status uploadData(const void* data, uint64_t size, uint64_t offset) override {
+        if (failUploads) return InternalError("staging upload failed");
+        if (offset + size > m_data.size()) return InvalidArgumentError("out of range");
+        std::memcpy(m_data.data() + offset, data, size);
+        return OkStatus();
+    }
+    std::vector<uint8_t> m_data;
+    bool failUploads = false;
+};
+
+class CpuContext : public IContext {
+public:
+    Status initialize() override { return OkStatus(); }
+    Status initializeWindowSurface(void*) override { return OkStatus(); }
+    Status initializeHeadless() override { return OkStatus(); }
+    void sync() override {}
+    void shutdown() override {}
+    uint32_t getGraphicsQueueFamilyIndex() const override { return 0; }
+    std::unique_ptr<IBuffer> createBuffer(uint64_t size, uint32_t, uint32_t) override {
+        return std::make_unique<CpuBuffer>(size);
+    }
+    std::unique_ptr<ITexture> createTexture(const ImageData&, TextureUsage) override { return nullptr; }
+    std::unique_ptr<ITexture> createTexture(uint32_t, uint32_t, TextureFormat, TextureUsage) override { return nullptr; }
+    uint64_t getSubmittedFrameValue() const override { return submittedFrame; }
+    uint64_t getCompletedFrameValue() const override { return completedFrame; }
+
+    uint64_t submittedFrame = 0;
+    uint64_t completedFrame = 0;
+};
+
+std::vector<float> makeTriangle(float z) {
+    return {
+        0.0f, 0.0f, z,  0.0f, 0.0f,  0.0f, 0.0f, 1.0f,
+        1.0f, 0.0f, z,  1.0f, 0.0f,  0.0f, 0.0f, 1.0f,
+        0.0f, 1.0f, z,  0.0f, 1.0f,  0.0f, 0.0f, 1.0f,
+    };
+}
+
+} // namespace
+
+class MeshManagerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        meshManager = std::make_unique<MeshManager>(&context);
+        ASSERT_TRUE(meshManager->initialize().ok());
+    }
+
+    CpuContext context;
+    std::unique_ptr<MeshManager> meshManager;
+    std::vector<uint32_t> indices = {0, 1, 2};
+};
+
+TEST_F(MeshManagerTest, SameKeySharesRange) {
+    std::string key = MeshManager::makeMeshKey("robot/hip.dae", 0x1, 0);
+    auto first = meshManager->registerMesh(key, makeTriangle(0.0f), indices);
+    ASSERT_TRUE(first.ok());
+
+    MeshRange cached;
+    ASSERT_TRUE(meshManager->acquireMesh(key, cached));
+    EXPECT_EQ(cached.meshId, first->meshId);
+    EXPECT_EQ(cached.vertexOffset, first->vertexOffset);
+    EXPECT_EQ(cached.indexOffset, first->indexOffset);
+    EXPECT_EQ(cached.indexCount, 3u);
+    EXPECT_EQ(meshManager->getRefCount(first->meshId), 2u);
+    EXPECT_EQ(meshManager->getRegisteredMeshCount(), 1u);
+}
+
+TEST_F(MeshManagerTest, ContentHashFallback) {
+    auto a = meshManager->registerMesh(MeshManager::makeMeshKey("a.obj", 0x1, 0), makeTriangle(0.0f), indices);
+    auto b = meshManager->registerMesh(MeshManager::makeMeshKey("b.obj", 0x1, 0), makeTriangle(0.0f), indices);
+    auto c = meshManager->registerMesh("", makeTriangle(1.0f), indices);
+    ASSERT_TRUE(a.ok() && b.ok() && c.ok());
+
+    EXPECT_EQ(a->meshId, b->meshId);
+    EXPECT_NE(a->meshId, c->meshId);
+    EXPECT_NE(a->vertexOffset, c->vertexOffset);
+
+    // b 的键也应被登记, 后续可直接命中
+    MeshRange cached;
+    EXPECT_TRUE(meshManager->acquireMesh(MeshManager::makeMeshKey("b.obj", 0x1, 0), cached));
+    EXPECT_FALSE(meshManager->acquireMesh(MeshManager::makeMeshKey("b.obj", 0x2, 0), cached));
+}
+
+TEST_F(MeshManagerTest, ContentHashCoversBytesAndCounts) {
+    const auto hash = MeshManager::hashMeshData(makeTriangle(0.0f), indices);
+    EXPECT_EQ(hash, MeshManager::hashMeshData(makeTriangle(0.0f), indices));
+    // -0 与 0 按位不同
+    EXPECT_NE(hash, MeshManager::hashMeshData(makeTriangle(-0.0f), indices));
+    EXPECT_NE(hash, MeshManager::hashMeshData(makeTriangle(0.0f), {0, 2, 1}));
+    // 相同字节在顶点与索引之间的切分不同
+    std::vector<float> shorter = makeTriangle(0.0f);
+    shorter.pop_back();
+    std::vector<uint32_t> longer = {0x3F800000u, 0, 1, 2};
+    EXPECT_NE(hash, MeshManager::hashMeshData(shorter, longer));
+    EXPECT_NE(hash.low, hash.high);
+
+    auto a = meshManager->registerMesh("", makeTriangle(0.0f), indices);
+    auto b = meshManager->registerMesh("", makeTriangle(-0.0f), indices);
+    ASSERT_TRUE(a.ok() && b.ok());
+    EXPECT_NE(a->meshId, b->meshId);
+}
+
+TEST_F(MeshManagerTest, ReleaseReclaimsRange) {
+    std::string key = MeshManager::makeMeshKey("link.stl", 0x1, 0);
+    auto first = meshManager->registerMesh(key, makeTriangle(0.0f), indices);
+    ASSERT_TRUE(first.ok());
+    MeshRange cached;
+    ASSERT_TRUE(meshManager->acquireMesh(key, cached));
+
+    meshManager->releaseMesh(first->meshId);
+    EXPECT_EQ(meshManager->getRefCount(first->meshId), 1u);
+    meshManager->releaseMesh(first->meshId);
+    EXPECT_EQ(meshManager->getRegisteredMeshCount(), 0u);
+    EXPECT_FALSE(meshManager->acquireMesh(key, cached));
+
+    // 回收的区间被新网格复用
+    auto second = meshManager->registerMesh("", makeTriangle(2.0f), indices);
+    ASSERT_TRUE(second.ok());
+    EXPECT_EQ(second->vertexOffset, first->vertexOffset);
+    EXPECT_EQ(second->indexOffset, first->indexOffset);
+}
+
+TEST_F(MeshManagerTest, FailedUploadReturnsRanges) {
+    // 顶点已写入, 索引上传失败: 两个区间都须归还
+    auto* indexBuffer = static_cast<CpuBuffer*>(meshManager->getIndexBuffer());
+    indexBuffer->failUploads = true;
+    EXPECT_FALSE(meshManager->registerMesh("", makeTriangle(0.0f), indices).ok());
+    EXPECT_EQ(meshManager->getRegisteredMeshCount(), 0u);
+
+    indexBuffer->failUploads = false;
+    auto mesh = meshManager->registerMesh("", makeTriangle(0.0f), indices);
+    ASSERT_TRUE(mesh.ok());
+    EXPECT_EQ(mesh->vertexOffset, 0u);
+    EXPECT_EQ(mesh->indexOffset, 0u);
+}
+
+TEST_F(MeshManagerTest, ReleasedRangeWaitsForInFlightFrames) {
+    auto first = meshManager->registerMesh("", makeTriangle(0.0f), indices);
+    ASSERT_TRUE(first.ok());
+
+    // 帧 5 已提交但 GPU 只完成到帧 3: 释放的区间仍可能被读取
+    context.submittedFrame = 5;
+    context.completedFrame = 3;
+    meshManager->releaseMesh(first->meshId);
+    auto second = meshManager->registerMesh("", makeTriangle(1.0f), indices);
+    ASSERT_TRUE(second.ok());
+    EXPECT_NE(second->vertexOffset, first->vertexOffset);
+    EXPECT_NE(second->indexOffset, first->indexOffset);
+
+    // 帧 5 完成后区间被复用
+    context.completedFrame = 5;
+    auto third = meshManager->registerMesh("", makeTriangle(2.0f), indices);
+    ASSERT_TRUE(third.ok());
+    EXPECT_EQ(third->vertexOffset, first->vertexOffset);
+    EXPECT_EQ(third->indexOffset, first->indexOffset);
+}
+
+TEST_F(MeshManagerTest, DestroyingMeshComponentReleasesRange) {
+    Scene scene("MeshRelease");
+    meshManager->attachRegistry(scene.getRegistry());
+    std::string key = MeshManager::makeMeshKey("arm.dae", 0x1, 0);
+    auto first = meshManager->registerMesh(key, makeTriangle(0.0f), indices);
+    ASSERT_TRUE(first.ok());
+    MeshRange cached;
+    ASSERT_TRUE(meshManager->acquireMesh(key, cached));
+
+    Entity a = scene.createEntity("A");
+    a.addComponent<MeshComponent>().meshId = first->meshId;
+    Entity b = scene.createEntity("B");
+    b.addComponent<MeshComponent>().meshId = cached.meshId;
+    // 未经注册表管理的网格 (meshId 为 0) 不影响引用计数
+    scene.createEntity("Cube").addComponent<MeshComponent>();
+
+    scene.destroyEntity(a);
+    EXPECT_EQ(meshManager->getRefCount(first->meshId), 1u);
+    scene.clear();
+    EXPECT_EQ(meshManager->getRegisteredMeshCount(), 0u);
+
+    // 区间被回收并由新网格复用
+    auto second = meshManager->registerMesh("", makeTriangle(2.0f), indices);
+    ASSERT_TRUE(second.ok());
+    EXPECT_EQ(second->vertexOffset, first->vertexOffset);
+    EXPECT_EQ(second->indexOffset, first->indexOffset);
+    meshManager->detachRegistry(scene.getRegistry());
+}
+
+TEST(VertexPackingTest, HalfRoundTrip) {
+    for (float v : {0.0f, 1.0f, -2.5f, 0.333f, 1024.0f, 6.1e-5f}) {
+        EXPECT_NEAR(unpackHalf(packHalf(v)), v, std::fabs(v) * 1e-3f + 1e-7f);
+    }
+    EXPECT_TRUE(std::isinf(unpackHalf(packHalf(1e6f))));
+}
+
+TEST(VertexPackingTest, OctahedralNormals) {
+    const float normals[][3] = {
+        {0, 0, 1}, {0, 0, -1}, {1, 0, 0}, {0, -1, 0},
+        {0.577f, 0.577f, -0.577f}, {-0.267f, 0.534f, 0.802f}
+    };
+    for (const auto& n : normals) {
+        float len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        auto enc = octEncodeSnorm16(n[0], n[1], n[2]);
+        auto dec = octDecodeSnorm16(enc[0], enc[1]);
+        for (int a = 0; a < 3; ++a) EXPECT_NEAR(dec[a], n[a] / len, 1e-3f);
+    }
+}
+
+TEST_F(MeshManagerTest, CompactFormatQuantizesPositions) {
+    MeshManager compact(&context);
+    ASSERT_TRUE(compact.initialize(VertexFormat::Compact).ok());
+
+    auto vertices = makeTriangle(3.0f);
+    auto range = compact.registerMesh("", vertices, indices);
+    ASSERT_TRUE(range.ok());
+    EXPECT_FLOAT_EQ(range->positionOffset[2], 3.0f);
+    EXPECT_FLOAT_EQ(range->positionScale[0], 1.0f);
+
+    auto* gpu = static_cast<const uint8_t*>(compact.getVertexBuffer()->map());
+    const PackedVertex* packed = reinterpret_cast<const PackedVertex*>(gpu + range->vertexOffset * sizeof(PackedVertex));
+    for (uint32_t i = 0; i < 3; ++i) {
+        for (int a = 0; a < 3; ++a) {
+            float p = range->positionOffset[a] + packed[i].position[a] / 65535.0f * range->positionScale[a];
+            EXPECT_NEAR(p, vertices[i * 8 + a], 1e-4f);
+        }
+        EXPECT_NEAR(unpackHalf(packed[i].uv[0]), vertices[i * 8 + 3], 1e-3f);
+    }
+}
+
+TEST_F(MeshManagerTest, SmallMeshesUseShortIndices) {
+    uint32_t vOffset = 0, iOffset = 0;
+    ASSERT_TRUE(meshManager->addMesh(makeTriangle(0.0f), indices, vOffset, iOffset).ok());
+
+    auto range = meshManager->registerMesh("", makeTriangle(1.0f), indices);
+    ASSERT_TRUE(range.ok());
+    EXPECT_EQ(range->indexType, IndexType::Uint16);
+
+    // 16 位索引的 indexOffset 以 uint16 为单位, 且不与前面的 32 位索引重叠
+    auto* gpu = static_cast<const uint8_t*>(meshManager->getIndexBuffer()->map());
+    EXPECT_GE(range->indexOffset * sizeof(uint16_t), (iOffset + indices.size()) * sizeof(uint32_t));
+    const uint16_t* shortIndices = reinterpret_cast<const uint16_t*>(gpu) + range->indexOffset;
+    for (size_t i = 0; i < indices.size(); ++i) {
+        EXPECT_EQ(shortIndices[i], indices[i]);
+    }
+    EXPECT_TRUE(MeshManager::canUseShortIndices(65536));
+    EXPECT_FALSE(MeshManager::canUseShortIndices(65537));
+}
+
+TEST_F(MeshManagerTest, LodChainSharesVerticesAndIndexAllocation) {
+    std::vector<float> vertices = makeTriangle(0.0f);
+    auto extra = makeTriangle(1.0f);
+    vertices.insert(vertices.end(), extra.begin(), extra.end());
+    std::vector<uint32_t> base = {0, 1, 2, 3, 4, 5};
+    std::vector<MeshLodData> lods = {{{0, 1, 2}, 0.5f}};
+
+    auto range = meshManager->registerMesh("", vertices, base, lods);
+    ASSERT_TRUE(range.ok());
+    ASSERT_EQ(range->lodCount, 2u);
+    EXPECT_EQ(range->lods[0].indexOffset, range->indexOffset);
+    EXPECT_EQ(range->lods[0].indexCount, 6u);
+    EXPECT_EQ(range->lods[1].indexOffset, range->indexOffset + 6);
+    EXPECT_EQ(range->lods[1].indexCount, 3u);
+    EXPECT_FLOAT_EQ(range->lods[1].error, 0.5f);
+
+    // 包围体覆盖全部顶点
+    EXPECT_FLOAT_EQ(range->aabbMin[2], 0.0f);
+    EXPECT_FLOAT_EQ(range->aabbMax[2], 1.0f);
+    EXPECT_NEAR(range->boundingSphere[2], 0.5f, 1e-5f);
+    EXPECT_GE(range->boundingSphere[3], 0.5f);
+
+    // 释放后整段 (基础 + LOD) 被回收
+    meshManager->releaseMesh(range->meshId);
+    auto reused = meshManager->registerMesh("", vertices, base, lods);
+    ASSERT_TRUE(reused.ok());
+    EXPECT_EQ(reused->lods[1].indexOffset, range->lods[1].indexOffset);
+}
+
+TEST_F(MeshManagerTest, UvDensityMatchesTexelMapping) {
+    // UV 与位置一一对应 -> 每模型单位 1 个 UV 单位
+    auto unit = meshManager->registerMesh("", makeTriangle(0.0f), indices);
+    ASSERT_TRUE(unit.ok());
+    EXPECT_NEAR(unit->uvDensity, 1.0f, 1e-5f);
+
+    // 位置放大 4 倍, UV 不变 -> 密度降为 1/4
+    auto scaled = makeTriangle(0.0f);
+    for (size_t i = 0; i < scaled.size(); i += 8) {
+        for (int a = 0; a < 3; ++a) scaled[i + a] *= 4.0f;
+    }
+    auto large = meshManager->registerMesh("", scaled, indices);
+    ASSERT_TRUE(large.ok());
+    EXPECT_NEAR(large->uvDensity, 0.25f, 1e-5f);
+}
@@ -1,8 +1,10 @@
 #include <gtest/gtest.h>
 #include "../src/Core/Scene.h"
 #include "../src/Core/HierarchySystem.h"
+#include "../src/Core/BoundsSystem.h"
 #include "../src/Core/SceneSerializer.h"
 #include "../src/Bridge/ResourceLoader.h"
+#include <cereal/archives/binary.hpp>
 #include <cstdio>
 #include <fstream>
 
@@ -128,3 +130,91 @@ TEST_F(SceneGraphTest, SceneSerialization) {
     // 清理测试文件
     std::remove(testFile.c_str());
 }
+
+TEST_F(SceneGraphTest, WorldBoundsFollowHierarchy) {
+    Scene scene("BoundsScene");
+    Entity root = scene.createEntity("Root");
+    Entity child = scene.createEntity("Child");
+    scene.setParent(child, root);
+
+    root.getComponent<TransformComponent>().position = {10.0f, 0.0f, 0.0f};
+    child.getComponent<TransformComponent>().scale = {2.0f, 1.0f, 1.0f};
+    child.addComponent<BoundsComponent>(std::array<float, 3>{-1.0f, -1.0f, -1.0f}, std::array<float, 3>{1.0f, 1.0f, 1.0f},
+                                        std::array<float, 4>{0.0f, 0.0f, 0.0f, 1.732f});
+
+    HierarchySystem::update(scene.getRegistry());
+    BoundsSystem::update(scene.getRegistry());
+
+    auto& bounds = child.getComponent<BoundsComponent>();
+    EXPECT_FLOAT_EQ(bounds.worldMin[0], 8.0f);
+    EXPECT_FLOAT_EQ(bounds.worldMax[0], 12.0f);
+    EXPECT_FLOAT_EQ(bounds.worldMin[1], -1.0f);
+    EXPECT_FLOAT_EQ(bounds.worldSphere[0], 10.0f);
+    EXPECT_FLOAT_EQ(bounds.worldSphere[3], 1.732f * 2.0f);
+
+    // 局部包围体随场景保存与加载
+    std::string testFile = "test_bounds_scene.bin";
+    EXPECT_TRUE(SceneSerializer(scene).serialize(testFile));
+
+    Scene loadedScene("LoadBoundsScene");
+    EXPECT_TRUE(SceneSerializer(loadedScene).deserialize(testFile));
+    auto view = loadedScene.getRegistry().view<BoundsComponent>();
+    ASSERT_EQ(view.size(), 1u);
+    const auto& loaded = view.get<BoundsComponent>(*view.begin());
+    EXPECT_FLOAT_EQ(loaded.localMax[0], 1.0f);
+    EXPECT_FLOAT_EQ(loaded.localSphere[3], 1.732f);
+    std::remove(testFile.c_str());
+}
+
+TEST_F(SceneGraphTest, LoadsSceneSavedWithoutClassVersions) {
+    // 旧格式: 没有文件标记与类版本号, 网格只有偏移, 索引数, 纹理与 PBR 因子, 实体没有包围体
+    std::string testFile = "test_legacy_scene.bin";
+    {
+        std::ofstream os(testFile, std::ios::binary);
+        cereal::BinaryOutputArchive archive(os);
+        const std::array<float, 3> position = {1.0f, 2.0f, 3.0f}, scale = {1.0f, 1.0f, 1.0f};
+        const std::array<float, 4> rotation = {0.0f, 0.0f, 0.0f, 1.0f}, albedo = {0.5f, 0.5f, 0.5f, 1.0f};
+        archive(uint32_t(1));
+        archive(uint32_t(7), true, std::string("LegacyMesh"), true, position, rotation, scale);
+        archive(false, uint32_t(0), std::vector<uint32_t>{}, false, 45.0f, 1.7777778f, 0.1f, 1000.0f);
+        archive(true, uint32_t(100), uint32_t(200), uint32_t(36));
+        archive(uint32_t(3), uint32_t(0), uint32_t(0), uint32_t(0), uint32_t(0), uint32_t(1), albedo, 0.25f, 0.75f);
+        archive(false, std::string());
+    }
+
+    Scene loadedScene("LegacyScene");
+    ASSERT_TRUE(SceneSerializer(loadedScene).deserialize(testFile));
+    auto view = loadedScene.getRegistry().view<MeshComponent>();
+    ASSERT_EQ(view.size(), 1u);
+    const auto entity = *view.begin();
+    const auto& mesh = view.get<MeshComponent>(entity);
+    EXPECT_EQ(mesh.vertexOffset, 100u);
+    EXPECT_EQ(mesh.indexOffset, 200u);
+    EXPECT_EQ(mesh.indexCount, 36u);
+    EXPECT_EQ(mesh.indexType, IndexType::Uint32);
+    EXPECT_EQ(mesh.lodCount, 0u);
+    EXPECT_FALSE(mesh.hasQuantizedPositions());
+    EXPECT_EQ(mesh.albedoTexture, 3u);
+    EXPECT_EQ(mesh.samplerIndex, 1u);
+    EXPECT_FLOAT_EQ(mesh.roughnessFactor, 0.75f);
+    EXPECT_FLOAT_EQ(loadedScene.getRegistry().get<TransformComponent>(entity).position[2], 3.0f);
+    EXPECT_FALSE(loadedScene.getRegistry().getInternal().all_of<BoundsComponent>(entity));
+
+    // 重新保存后带版本号, 新增字段随之往返
+    auto& saved = loadedScene.getRegistry().get<MeshComponent>(entity);
+    saved.indexType = IndexType::Uint16;
+    saved.lodCount = 2;
+    saved.lods[1] = MeshLod{300, 12, 0.5f};
+    ASSERT_TRUE(SceneSerializer(loadedScene).serialize(testFile));
+    Scene reloaded("Reloaded");
+    ASSERT_TRUE(SceneSerializer(reloaded).deserialize(testFile));
+    auto meshes = reloaded.getRegistry().view<MeshComponent>();
+    ASSERT_EQ(meshes.size(), 1u);
+    const auto& roundTrip = meshes.get<MeshComponent>(*meshes.begin());
+    EXPECT_EQ(roundTrip.indexType, IndexType::Uint16);
+    EXPECT_EQ(roundTrip.lodCount, 2u);
+    EXPECT_EQ(roundTrip.lods[1].indexOffset, 300u);
+    EXPECT_FLOAT_EQ(roundTrip.lods[1].error, 0.5f);
+    EXPECT_EQ(roundTrip.albedoTexture, 3u);
+    std::remove(testFile.c_str());
+}
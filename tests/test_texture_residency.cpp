@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+#include "../src/Core/TextureManager.h"
+#include "../src/Core/TextureResidencySystem.h"
+#include "../src/Core/Scene.h"
+#include "ImageMips.h"
+#include "Ktx2.h"
+#include <atomic>
+
+using namespace Nexus;
+using namespace Nexus::Core;
+
+namespace {
+
+/**
+ * @brief 只记录状态的纹理, 用于脱离 Vulkan 测试驻留管理
+ */
+class FakeTexture : public ITexture {
+public:
+    FakeTexture(uint32_t index, bool resident, uint64_t bytes) : m_index(index), m_resident(resident), m_bytes(bytes) {}
+    uint32_t getWidth() const override { return m_width; }
+    uint32_t getHeight() const override { return m_height; }
+    TextureFormat getFormat() const override { return TextureFormat::R8G8B8A8_UNORM; }
+    uint32_t getBindlessTextureIndex() const override { return m_index; }
+    bool isResident() const override { return m_resident; }
+    uint64_t getMemorySize() const override { return m_resident ? m_bytes.load() : 0; }
+    uint32_t getResidentMip() const override { return m_baseMip; }
+
+    /**
+     * @brief 模拟上传: 已驻留时为 mip 替换, 更粗的级别沿用
+     */
+    void upload(const ImageData& image) {
+        const uint32_t end = m_resident ? std::max(m_endLevel.load(), image.baseMip + image.mipLevels) : image.baseMip + image.mipLevels;
+        m_width = image.width;
+        m_height = image.height;
+        m_baseMip = image.baseMip;
+        m_endLevel = end;
+        m_bytes = mipLevelOffset(image.width, image.height, end) - mipLevelOffset(image.width, image.height, image.baseMip);
+        m_resident = true;
+    }
+
+    uint32_t m_index;
+    std::atomic<bool> m_resident;
+    std::atomic<uint64_t> m_bytes;
+    std::atomic<uint32_t> m_width{1};
+    std::atomic<uint32_t> m_height{1};
+    std::atomic<uint32_t> m_baseMip{0};
+    std::atomic<uint32_t> m_endLevel{0};
+};
+
+class FakeContext : public IContext {
+public:
+    Status initialize() override { return OkStatus(); }
+    Status initializeWindowSurface(void*) override { return OkStatus(); }
+    Status initializeHeadless() override { return OkStatus(); }
+    void sync() override {}
+    void shutdown() override {}
+    uint32_t getGraphicsQueueFamilyIndex() const override { return 0; }
+    std::unique_ptr<IBuffer> createBuffer(uint64_t, uint32_t, uint32_t) override { return nullptr; }
+    std::unique_ptr<ITexture> createTexture(const ImageData& data, TextureUsage) override {
+        return std::make_unique<FakeTexture>(m_nextIndex++, true, data.pixels.size());
+    }
+    std::unique_ptr<ITexture> createTexture(uint32_t, uint32_t, TextureFormat, TextureUsage) override { return nullptr; }
+    std::unique_ptr<ITexture> createTextureAsync(ITexture*) override {
+        return std::make_unique<FakeTexture>(m_nextIndex++, false, 0);
+    }
+    void uploadTextureAsync(ITexture* texture, ImageData&& imageData) override {
+        static_cast<FakeTexture*>(texture)->upload(imageData);
+        ++m_uploads;
+    }
+    bool evictTexture(ITexture* texture, ITexture*) override {
+        static_cast<FakeTexture*>(texture)->m_resident = false;
+        return true;
+    }
+
+    uint32_t m_nextIndex = 0;
+    std::atomic<uint32_t> m_uploads{0};
+};
+
+void setAllTextures(MeshComponent& mesh, uint32_t index) {
+    mesh.albedoTexture = mesh.normalTexture = mesh.metallicRoughnessTexture = mesh.occlusionTexture = mesh.emissiveTexture = index;
+}
+
+std::vector<uint8_t> makeEncodedTexture(uint32_t size, bool withMips = false) {
+    ImageData image;
+    image.width = size;
+    image.height = size;
+    image.channels = 4;
+    image.pixels.assign((size_t)size * size * 4, 128);
+    if (withMips) EXPECT_TRUE(generateMipChain(image).ok());
+    return Ktx2::write(image).value();
+}
+
+} // namespace
+
+TEST(TextureResidencyTest, EvictsLeastRecentlyUsedAndReloadsOnDemand) {
+    FakeContext context;
+    TextureManager manager(&context);
+    const uint64_t textureBytes = 16 * 16 * 4;
+    manager.setVramBudget(textureBytes * 3 / 2);
+
+    ITexture* a = manager.createTextureFromMemoryAsync("a", makeEncodedTexture(16));
+    ITexture* b = manager.createTextureFromMemoryAsync("b", makeEncodedTexture(16));
+    ASSERT_TRUE(a && b);
+    manager.waitForPendingDecodes();
+    ASSERT_TRUE(a->isResident() && b->isResident());
+
+    // 本帧使用中的纹理即使超出预算也不换出
+    manager.markUsed(a->getBindlessTextureIndex());
+    manager.markUsed(b->getBindlessTextureIndex());
+    manager.updateResidency();
+    auto stats = manager.getResidencyStats();
+    EXPECT_EQ(stats.residentBytes, 2 * textureBytes);
+    EXPECT_EQ(stats.requestedBytes, 2 * textureBytes);
+    EXPECT_EQ(stats.evictionsLastUpdate, 0u);
+
+    // b 未被使用 -> 换出到默认纹理
+    manager.markUsed(a->getBindlessTextureIndex());
+    manager.updateResidency();
+    stats = manager.getResidencyStats();
+    EXPECT_FALSE(b->isResident());
+    EXPECT_EQ(stats.evictionsLastUpdate, 1u);
+    EXPECT_EQ(stats.evictedCount, 1u);
+    EXPECT_EQ(stats.residentBytes, textureBytes);
+
+    // b 再次被绘制 -> 经异步管线重新加载; 之后 a 成为最久未用的纹理
+    manager.markUsed(b->getBindlessTextureIndex());
+    manager.updateResidency();
+    EXPECT_EQ(manager.getResidencyStats().reloadsLastUpdate, 1u);
+    manager.waitForPendingDecodes();
+    EXPECT_TRUE(b->isResident());
+    EXPECT_EQ(context.m_uploads.load(), 3u);
+
+    manager.markUsed(b->getBindlessTextureIndex());
+    manager.updateResidency();
+    EXPECT_FALSE(a->isResident());
+    EXPECT_TRUE(b->isResident());
+    EXPECT_EQ(manager.getResidencyStats().residentBytes, textureBytes);
+}
+
+TEST(TextureResidencyTest, EvictsTexturesOfOffScreenMeshes) {
+    FakeContext context;
+    TextureManager manager(&context);
+    const uint64_t textureBytes = 16 * 16 * 4;
+    manager.setVramBudget(textureBytes * 3 / 2);
+
+    ITexture* onScreenTexture = manager.createTextureFromMemoryAsync("on", makeEncodedTexture(16));
+    ITexture* offScreenTexture = manager.createTextureFromMemoryAsync("off", makeEncodedTexture(16));
+    ASSERT_TRUE(onScreenTexture && offScreenTexture);
+    manager.waitForPendingDecodes();
+
+    Scene scene("ResidencyScene");
+    Entity onScreen = scene.createEntity("OnScreen");
+    setAllTextures(onScreen.addComponent<MeshComponent>(), onScreenTexture->getBindlessTextureIndex());
+    Entity offScreen = scene.createEntity("OffScreen");
+    setAllTextures(offScreen.addComponent<MeshComponent>(), offScreenTexture->getBindlessTextureIndex());
+
+    // 两个实体都有 MeshComponent, 但只有 onScreen 在渲染器的可见集合中
+    const std::vector<entt::entity> visible = {onScreen};
+    TextureResidencySystem::update(scene.getRegistry(), manager, visible);
+    EXPECT_TRUE(onScreenTexture->isResident());
+    EXPECT_FALSE(offScreenTexture->isResident());
+    EXPECT_EQ(manager.getResidencyStats().evictionsLastUpdate, 1u);
+    EXPECT_EQ(manager.getResidencyStats().residentBytes, textureBytes);
+
+    // 已销毁的实体不影响标记
+    scene.destroyEntity(offScreen);
+    const std::vector<entt::entity> stale = {onScreen, offScreen};
+    TextureResidencySystem::update(scene.getRegistry(), manager, stale);
+    EXPECT_TRUE(onScreenTexture->isResident());
+    EXPECT_EQ(manager.getResidencyStats().reloadsLastUpdate, 0u);
+}
+
+TEST(TextureResidencyTest, UnlimitedBudgetNeverEvicts) {
+    FakeContext context;
+    TextureManager manager(&context);
+    ITexture* a = manager.createTextureFromMemoryAsync("a", makeEncodedTexture(8));
+    manager.waitForPendingDecodes();
+    for (int frame = 0; frame < 4; ++frame) manager.updateResidency();
+    EXPECT_TRUE(a->isResident());
+    EXPECT_EQ(manager.getResidencyStats().evictedCount, 0u);
+}
+
+TEST(TextureResidencyTest, DesiredMipFollowsTexelsPerPixel) {
+    EXPECT_EQ(TextureManager::computeDesiredMip(1024, 512, 0.0f), 0u);
+    EXPECT_EQ(TextureManager::computeDesiredMip(1024, 512, 1.0f / 1024.0f), 0u);
+    EXPECT_EQ(TextureManager::computeDesiredMip(1024, 512, 4.0f / 1024.0f), 2u);
+    EXPECT_EQ(TextureManager::computeDesiredMip(1024, 512, 5.0f / 1024.0f), 2u);
+    EXPECT_EQ(TextureManager::computeDesiredMip(1024, 512, 4.0f / 1024.0f, 1.0f), 3u);
+    // 整张纹理缩到不足一个像素时截断到最后一级
+    EXPECT_EQ(TextureManager::computeDesiredMip(1024, 512, 8.0f), 10u);
+}
+
+TEST(TextureResidencyTest, StreamsMipsByTexelDensity) {
+    FakeContext context;
+    TextureManager manager(&context);
+    TextureManager::MipStreamingSettings settings;
+    settings.enabled = true;
+    settings.tailExtent = 8;
+    manager.setMipStreaming(settings);
+
+    // 首次加载只上传 8x8 及更小的级别
+    ITexture* texture = manager.createTextureFromMemoryAsync("t", makeEncodedTexture(64, true));
+    manager.waitForPendingDecodes();
+    ASSERT_TRUE(texture->isResident());
+    EXPECT_EQ(texture->getResidentMip(), 3u);
+    EXPECT_EQ(texture->getMemorySize(), mipLevelOffset(64, 64, 7) - mipLevelOffset(64, 64, 3));
+    const uint32_t index = texture->getBindlessTextureIndex();
+
+    // 一个纹素对应一个像素 -> 流入 mip0..2, 更粗的级别保留
+    manager.markUsed(index, 4.0f / 64.0f);
+    manager.markUsed(index, 1.0f / 64.0f);
+    manager.updateResidency();
+    EXPECT_EQ(manager.getResidencyStats().streamInsLastUpdate, 1u);
+    manager.waitForPendingDecodes();
+    EXPECT_EQ(texture->getResidentMip(), 0u);
+    EXPECT_EQ(texture->getMemorySize(), mipLevelOffset(64, 64, 7));
+
+    manager.markUsed(index, 1.0f / 64.0f);
+    manager.updateResidency();
+    EXPECT_EQ(manager.getResidencyStats().streamingCount, 0u);
+    EXPECT_EQ(manager.getResidencyStats().streamInsLastUpdate, 0u);
+
+    // 变远到期望 mip2, 超出滞回带 -> 丢弃 mip0..1
+    manager.markUsed(index, 4.0f / 64.0f);
+    manager.updateResidency();
+    EXPECT_EQ(manager.getResidencyStats().streamOutsLastUpdate, 1u);
+    EXPECT_EQ(texture->getResidentMip(), 2u);
+
+    // 期望 mip3 仍在滞回带内, 保持不变
+    manager.markUsed(index, 8.0f / 64.0f);
+    manager.updateResidency();
+    EXPECT_EQ(manager.getResidencyStats().streamOutsLastUpdate, 0u);
+    EXPECT_EQ(texture->getResidentMip(), 2u);
+}